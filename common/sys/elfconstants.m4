@@ -66,6 +66,21 @@ _(`CA_SUNW_NULL',	0,	`ignored')
 _(`CA_SUNW_HW_1',	1,	`hardware capability')
 _(`CA_SUNW_SW_1',	2,	`software capability')')
 
+#
+# Types of section compression.
+#
+define(`DEFINE_COMPRESSION_TYPES',`
+_(`ELFCOMPRESS_ZLIB',	1,	`ZLIB/DEFLATE algorithm')
+_(`ELFCOMPRESS_ZSTD',	2,	`Zstandard algorithm')
+_(`ELFCOMPRESS_LOOS',	0x60000000UL,
+	`start of OS-specific types')
+_(`ELFCOMPRESS_HIOS',	0x6FFFFFFFUL,
+	`end of OS-specific types')
+_(`ELFCOMPRESS_LOPROC',	0x70000000UL,
+	`start of processor-specific types')
+_(`ELFCOMPRESS_HIPROC',	0x7FFFFFFFUL,
+	`end of processor-specific types')')
+
 #
 # Flags used with dynamic linking entries.
 #
@@ -59,6 +59,11 @@ divert(0)dnl
  */
 DEFINE_CAPABILITIES()
 
+/*
+ * Types of section compression.
+ */
+DEFINE_COMPRESSION_TYPES()
+
 /*
  * Flags used with dynamic linking entries.
  */
@@ -263,6 +268,26 @@ typedef struct {
 	} c_un;
 } Elf64_Cap;
 
+/*
+ * Compression headers, found at the start of sections with the
+ * SHF_COMPRESSED flag set.
+ */
+
+/* 32-bit compression header. */
+typedef struct {
+	Elf32_Word	ch_type;	/* Compression algorithm. */
+	Elf32_Word	ch_size;	/* Uncompressed size. */
+	Elf32_Word	ch_addralign;	/* Uncompressed alignment. */
+} Elf32_Chdr;
+
+/* 64-bit compression header. */
+typedef struct {
+	Elf64_Word	ch_type;	/* Compression algorithm. */
+	Elf64_Word	ch_reserved;
+	Elf64_Xword	ch_size;	/* Uncompressed size. */
+	Elf64_Xword	ch_addralign;	/* Uncompressed alignment. */
+} Elf64_Chdr;
+
 /*
  * MIPS .conflict section entries.
  */
@@ -42,6 +42,7 @@ ELFTC_VCSID("$Id$");
 static int stripus = 0;
 static int noparam = 0;
 static int format = 0;
+static Elftc_Demangle_Ctx *dctx;
 
 enum options
 {
@@ -122,7 +123,8 @@ demangle(char *name)
 	if (strlen(name) == 0)
 		return (NULL);
 
-	if (elftc_demangle(name, dem, sizeof(dem), (unsigned) format) < 0)
+	if (elftc_demangle_r(dctx, name, dem, sizeof(dem),
+	    (unsigned) format) < 0)
 		return (NULL);
 
 	return (dem);
@@ -165,6 +167,9 @@ main(int argc, char **argv)
 	argv += optind;
 	argc -= optind;
 
+	if ((dctx = elftc_demangle_ctx_create()) == NULL)
+		err(EXIT_FAILURE, "elftc_demangle_ctx_create");
+
 	if (*argv != NULL) {
 		for (n = 0; n < argc; n++) {
 			if ((dem = demangle(argv[n])) == NULL)
@@ -199,5 +204,7 @@ main(int argc, char **argv)
 		}
 	}
 
+	elftc_demangle_ctx_destroy(dctx);
+
 	exit(0);
 }
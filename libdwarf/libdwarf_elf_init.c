@@ -196,19 +196,32 @@ _dwarf_elf_relocate(Dwarf_Debug dbg, Elf *elf, Dwarf_Elf_Data *ed, size_t shndx,
 	return (DW_DLE_NONE);
 }
 
+static int
+_dwarf_elf_ndx_cmp(const void *a, const void *b)
+{
+	size_t x, y;
+
+	x = *(const size_t *) a;
+	y = *(const size_t *) b;
+
+	return (x < y ? -1 : x > y);
+}
+
 int
 _dwarf_elf_init(Dwarf_Debug dbg, Elf *elf, Dwarf_Error *error)
 {
 	Dwarf_Obj_Access_Interface *iface;
 	Dwarf_Elf_Object *e;
-	const char *name;
 	GElf_Shdr sh;
 	Elf_Scn *scn;
 	Elf_Data *symtab_data;
-	size_t symtab_ndx;
+	size_t symtab_ndx, *ndx;
+	unsigned int eflags;
 	int elferr, i, j, n, ret;
 
 	ret = DW_DLE_NONE;
+	ndx = NULL;
+	eflags = ELF_F_DECOMPRESS;	/* Nothing to restore yet. */
 
 	if ((iface = calloc(1, sizeof(*iface))) == NULL) {
 		DWARF_SET_ERROR(dbg, error, DW_DLE_MEMORY);
@@ -251,40 +264,25 @@ _dwarf_elf_init(Dwarf_Debug dbg, Elf *elf, Dwarf_Error *error)
 	n = 0;
 	symtab_ndx = 0;
 	symtab_data = NULL;
-	scn = NULL;
 	(void) elf_errno();
-	while ((scn = elf_nextscn(elf, scn)) != NULL) {
-		if (gelf_getshdr(scn, &sh) == NULL) {
-			DWARF_SET_ELF_ERROR(dbg, error);
-			ret = DW_DLE_ELF;
-			goto fail_cleanup;
-		}
-
-		if ((name = elf_strptr(elf, e->eo_strndx, sh.sh_name)) ==
-		    NULL) {
-			DWARF_SET_ELF_ERROR(dbg, error);
-			ret = DW_DLE_ELF;
-			goto fail_cleanup;
-		}
-
-		if (!strcmp(name, ".symtab")) {
-			symtab_ndx = elf_ndxscn(scn);
-			if ((symtab_data = elf_getdata(scn, NULL)) == NULL) {
-				elferr = elf_errno();
-				if (elferr != 0) {
-					_DWARF_SET_ERROR(NULL, error,
-					    DW_DLE_ELF, elferr);
-					ret = DW_DLE_ELF;
-					goto fail_cleanup;
-				}
+	for (scn = elf_getscn_byname(elf, ".symtab"); scn != NULL;
+	    scn = elf_nextscn_byname(elf, scn)) {
+		symtab_ndx = elf_ndxscn(scn);
+		if ((symtab_data = elf_getdata(scn, NULL)) == NULL) {
+			elferr = elf_errno();
+			if (elferr != 0) {
+				_DWARF_SET_ERROR(NULL, error, DW_DLE_ELF,
+				    elferr);
+				ret = DW_DLE_ELF;
+				goto fail_cleanup;
 			}
-			continue;
 		}
+	}
 
-		for (i = 0; debug_name[i] != NULL; i++) {
-			if (!strcmp(name, debug_name[i]))
-				n++;
-		}
+	for (i = 0; debug_name[i] != NULL; i++) {
+		for (scn = elf_getscn_byname(elf, debug_name[i]); scn != NULL;
+		    scn = elf_nextscn_byname(elf, scn))
+			n++;
 	}
 	elferr = elf_errno();
 	if (elferr != 0) {
@@ -298,16 +296,34 @@ _dwarf_elf_init(Dwarf_Debug dbg, Elf *elf, Dwarf_Error *error)
 		return (DW_DLE_NONE);
 
 	if ((e->eo_data = calloc(n, sizeof(Dwarf_Elf_Data))) == NULL ||
-	    (e->eo_shdr = calloc(n, sizeof(GElf_Shdr))) == NULL) {
+	    (e->eo_shdr = calloc(n, sizeof(GElf_Shdr))) == NULL ||
+	    (ndx = calloc(n, sizeof(*ndx))) == NULL) {
 		DWARF_SET_ERROR(NULL, error, DW_DLE_MEMORY);
 		ret = DW_DLE_MEMORY;
 		goto fail_cleanup;
 	}
 
-	scn = NULL;
+	/* Load the debug sections in the order they appear in the object. */
 	j = 0;
-	while ((scn = elf_nextscn(elf, scn)) != NULL && j < n) {
-		if (gelf_getshdr(scn, &sh) == NULL) {
+	for (i = 0; debug_name[i] != NULL; i++) {
+		for (scn = elf_getscn_byname(elf, debug_name[i]);
+		    scn != NULL && j < n; scn = elf_nextscn_byname(elf, scn))
+			ndx[j++] = elf_ndxscn(scn);
+	}
+	assert(j == n);
+	qsort(ndx, (size_t) n, sizeof(*ndx), _dwarf_elf_ndx_cmp);
+
+	/*
+	 * Have libelf decompress SHF_COMPRESSED debug sections while
+	 * they are loaded.  The caller's setting of the flag is restored
+	 * afterwards.
+	 */
+	eflags = elf_flagelf(elf, ELF_C_SET, 0);
+	(void) elf_flagelf(elf, ELF_C_SET, ELF_F_DECOMPRESS);
+
+	for (j = 0; j < n; j++) {
+		if ((scn = elf_getscn(elf, ndx[j])) == NULL ||
+		    gelf_getshdr(scn, &sh) == NULL) {
 			DWARF_SET_ELF_ERROR(dbg, error);
 			ret = DW_DLE_ELF;
 			goto fail_cleanup;
@@ -315,46 +331,48 @@ _dwarf_elf_init(Dwarf_Debug dbg, Elf *elf, Dwarf_Error *error)
 
 		memcpy(&e->eo_shdr[j], &sh, sizeof(sh));
 
-		if ((name = elf_strptr(elf, e->eo_strndx, sh.sh_name)) ==
-		    NULL) {
-			DWARF_SET_ELF_ERROR(dbg, error);
-			ret = DW_DLE_ELF;
-			goto fail_cleanup;
-		}
-
-		for (i = 0; debug_name[i] != NULL; i++) {
-			if (strcmp(name, debug_name[i]))
-				continue;
-
-			(void) elf_errno();
-			if ((e->eo_data[j].ed_data = elf_getdata(scn, NULL)) ==
-			    NULL) {
-				elferr = elf_errno();
-				if (elferr != 0) {
-					_DWARF_SET_ERROR(dbg, error,
-					    DW_DLE_ELF, elferr);
-					ret = DW_DLE_ELF;
-					goto fail_cleanup;
-				}
+		(void) elf_errno();
+		if ((e->eo_data[j].ed_data = elf_getdata(scn, NULL)) == NULL) {
+			elferr = elf_errno();
+			if (elferr != 0) {
+				_DWARF_SET_ERROR(dbg, error, DW_DLE_ELF,
+				    elferr);
+				ret = DW_DLE_ELF;
+				goto fail_cleanup;
 			}
+		}
 
-			if (_libdwarf.applyreloc) {
-				if (_dwarf_elf_relocate(dbg, elf,
-				    &e->eo_data[j], elf_ndxscn(scn), symtab_ndx,
-				    symtab_data, error) != DW_DLE_NONE)
-					goto fail_cleanup;
-			}
+		/*
+		 * The data of a compressed section is returned
+		 * decompressed; record its uncompressed size.
+		 */
+		if ((sh.sh_flags & SHF_COMPRESSED) != 0 &&
+		    e->eo_data[j].ed_data != NULL) {
+			e->eo_shdr[j].sh_size = e->eo_data[j].ed_data->d_size;
+			e->eo_shdr[j].sh_flags &= ~(uint64_t) SHF_COMPRESSED;
+		}
 
-			j++;
+		if (_libdwarf.applyreloc) {
+			if (_dwarf_elf_relocate(dbg, elf, &e->eo_data[j],
+			    ndx[j], symtab_ndx, symtab_data, error) !=
+			    DW_DLE_NONE)
+				goto fail_cleanup;
 		}
 	}
 
-	assert(j == n);
+	if ((eflags & ELF_F_DECOMPRESS) == 0)
+		(void) elf_flagelf(elf, ELF_C_CLR, ELF_F_DECOMPRESS);
+
+	free(ndx);
 
 	return (DW_DLE_NONE);
 
 fail_cleanup:
 
+	if ((eflags & ELF_F_DECOMPRESS) == 0)
+		(void) elf_flagelf(elf, ELF_C_CLR, ELF_F_DECOMPRESS);
+
+	free(ndx);
 	_dwarf_elf_deinit(dbg);
 
 	return (ret);
@@ -31,6 +31,8 @@
 
 #include <sys/queue.h>
 
+#include <pthread.h>
+
 #include "_libelf_config.h"
 
 #include "_elftc.h"
@@ -41,20 +43,109 @@
 
 #define LIBELF_MSG_SIZE	256
 
+/*
+ * Library-wide settings.  These are shared by all threads.
+ */
 struct _libelf_globals {
 	int		libelf_arch;
 	unsigned int	libelf_byteorder;
 	int		libelf_class;
-	int		libelf_error;
 	int		libelf_fillchar;
+	unsigned int	libelf_isa;	/* see _libelf_isa() */
 	unsigned int	libelf_version;
-	unsigned char	libelf_msg[LIBELF_MSG_SIZE];
+	Elf_Stats	libelf_stats;	/* totals of released descriptors */
+	LIST_HEAD(, _Elf) libelf_descriptors; /* live descriptors */
+	pthread_mutex_t	libelf_stats_mutex; /* protects the two above */
 };
 
 extern struct _libelf_globals _libelf;
 
 #define	LIBELF_PRIVATE(N)	(_libelf.libelf_##N)
 
+/*
+ * The settings changed by elf_version(3) and elf_fill(3) may be read
+ * by other threads while they are being updated, so they are accessed
+ * atomically where the compiler supports doing so.
+ */
+#if	defined(__ATOMIC_RELAXED)
+#define	LIBELF_GET_PRIVATE(N)	__atomic_load_n(&LIBELF_PRIVATE(N),	\
+	__ATOMIC_RELAXED)
+#define	LIBELF_SET_PRIVATE(N,V)	__atomic_store_n(&LIBELF_PRIVATE(N),	\
+	(V), __ATOMIC_RELAXED)
+#else
+#define	LIBELF_GET_PRIVATE(N)	LIBELF_PRIVATE(N)
+#define	LIBELF_SET_PRIVATE(N,V)	(LIBELF_PRIVATE(N) = (V))
+#endif
+
+/*
+ * Vector instruction sets used by the library, see _libelf_isa().
+ */
+#if	defined(__GNUC__) && (defined(__clang__) || __GNUC__ >= 5) && \
+	(defined(__i386__) || defined(__x86_64__))
+#define	LIBELF_HAVE_X86_VECTOR	1
+#endif
+
+#define	LIBELF_ISA_SSE2		0x1U
+#define	LIBELF_ISA_SSSE3	0x2U
+#define	LIBELF_ISA_AVX2		0x4U
+#define	LIBELF_ISA_UNKNOWN	0x80000000U
+
+/*
+ * Atomic operations on descriptor state that may be shared between
+ * threads, such as the child count of an archive.
+ */
+#if	defined(__ATOMIC_RELAXED)
+#define	LIBELF_ATOMIC_ADD(V,N)	__atomic_add_fetch(&(V), (N),		\
+	__ATOMIC_ACQ_REL)
+#define	LIBELF_ATOMIC_LOAD_PTR(P)	__atomic_load_n(&(P),		\
+	__ATOMIC_ACQUIRE)
+#define	LIBELF_ATOMIC_CAS_PTR(P,O,N)	__atomic_compare_exchange_n(&(P), \
+	&(O), (N), 0, __ATOMIC_ACQ_REL, __ATOMIC_ACQUIRE)
+#else
+#define	LIBELF_ATOMIC_ADD(V,N)	((V) += (N))
+#define	LIBELF_ATOMIC_LOAD_PTR(P)	(P)
+#define	LIBELF_ATOMIC_CAS_PTR(P,O,N)	((P) == (O) ? ((P) = (N), 1) :	\
+	((O) = (P), 0))
+#endif
+
+/*
+ * Statistics counters are kept per descriptor, and are updated by the
+ * threads writing out sections in parallel.  They are only ever added
+ * to, so no ordering is needed.  The counters of a descriptor are added
+ * to the process-wide totals when it is released.
+ */
+#if	defined(__ATOMIC_RELAXED)
+#define	LIBELF_STATS_INC(V,N)	((void) __atomic_add_fetch(&(V),	\
+	(uint64_t) (N), __ATOMIC_RELAXED))
+#define	LIBELF_STATS_GET(V)	__atomic_load_n(&(V), __ATOMIC_RELAXED)
+#else
+#define	LIBELF_STATS_INC(V,N)	((void) ((V) += (uint64_t) (N)))
+#define	LIBELF_STATS_GET(V)	(V)
+#endif
+
+#define	LIBELF_STATS_ADD(E,F,N)	LIBELF_STATS_INC((E)->e_stats.F, (N))
+
+/*
+ * Error state is kept per thread.
+ */
+#if	defined(__STDC_VERSION__) && __STDC_VERSION__ >= 201112L && \
+	!defined(__STDC_NO_THREADS__)
+#define	LIBELF_THREAD_LOCAL	_Thread_local
+#elif	defined(__GNUC__)
+#define	LIBELF_THREAD_LOCAL	__thread
+#else
+#define	LIBELF_THREAD_LOCAL
+#endif
+
+struct _libelf_thread_globals {
+	int		libelf_error;
+	unsigned char	libelf_msg[LIBELF_MSG_SIZE];
+};
+
+extern LIBELF_THREAD_LOCAL struct _libelf_thread_globals _libelf_thread;
+
+#define	LIBELF_THREAD_PRIVATE(N)	(_libelf_thread.libelf_##N)
+
 #define	LIBELF_ELF_ERROR_MASK			0xFF
 #define	LIBELF_OS_ERROR_SHIFT			8
 
@@ -62,11 +153,20 @@ extern struct _libelf_globals _libelf;
 	((O) << LIBELF_OS_ERROR_SHIFT))
 
 #define	LIBELF_SET_ERROR(E, O) do {					\
-		LIBELF_PRIVATE(error) = LIBELF_ERROR(ELF_E_##E, (O));	\
+		LIBELF_THREAD_PRIVATE(error) =				\
+		    LIBELF_ERROR(ELF_E_##E, (O));			\
 	} while (/* CONSTCOND */ 0)
 
 #define	LIBELF_ADJUST_AR_SIZE(S)	(((S) + 1U) & ~1U)
 
+/*
+ * The ELF_C_*_MMAP commands only differ from ELF_C_READ and ELF_C_RDWR
+ * in how the underlying file is mapped in.  ELF descriptors record the
+ * base command in their `e_cmd' field.
+ */
+#define	LIBELF_BASE_CMD(C)	((C) == ELF_C_READ_MMAP ? ELF_C_READ :	\
+	((C) == ELF_C_RDWR_MMAP ? ELF_C_RDWR : (C)))
+
 /*
  * Flags for library internal use.  These use the upper 16 bits of the
  * `e_flags' field.
@@ -79,6 +179,138 @@ extern struct _libelf_globals _libelf;
 #define	LIBELF_F_RAWFILE_MMAP	0x100000U /* whether e_rawfile was mmap'ed */
 #define	LIBELF_F_SHDRS_LOADED	0x200000U /* whether all shdrs were read in */
 #define	LIBELF_F_SPECIAL_FILE	0x400000U /* non-regular file */
+#define	LIBELF_F_RAWFILE_COPY	0x800000U /* copy data out of e_rawfile */
+#define	LIBELF_F_RAWFILE_SHARED	0x1000000U /* e_rawfile is a shared mapping */
+#define	LIBELF_F_RAWFILE_LAZY	0x2000000U /* file contents read on demand */
+#define	LIBELF_F_RAWFILE_RDONLY	0x4000000U /* e_rawfile is mapped read-only */
+#define	LIBELF_F_PARALLEL	0x8000000U /* write sections in parallel */
+
+/*
+ * Access advice for the pages backing a range of an ELF object, see
+ * _libelf_advise().
+ */
+enum {
+	LIBELF_ADVISE_NORMAL,
+	LIBELF_ADVISE_SEQUENTIAL,
+	LIBELF_ADVISE_RANDOM,
+	LIBELF_ADVISE_WILLNEED,
+	LIBELF_ADVISE_DONTNEED,
+	LIBELF_ADVISE_HUGEPAGE
+};
+
+/*
+ * Sections smaller than this size are not worth a system call when
+ * their contents are first accessed or released.
+ */
+#define	LIBELF_ADVISE_MINSIZE	(64 * 1024)
+
+/*
+ * Whether the contents of an ELF object are available, either in
+ * `e_rawfile' or on demand from its file descriptor.
+ */
+#define	LIBELF_HAS_RAWFILE(E)	((E)->e_rawfile != NULL ||		\
+	((E)->e_flags & LIBELF_F_RAWFILE_LAZY))
+
+/*
+ * A slot in the hash index over an archive symbol table.  Each
+ * occupied slot describes one distinct symbol name; the offsets of
+ * the archive members defining that name are stored contiguously in
+ * the archive's `e_symoff' array.
+ */
+struct _Libelf_Arsym_Slot {
+	size_t		ah_sym;		/* first entry in e_symtab */
+	size_t		ah_start;	/* first offset in e_symoff */
+	size_t		ah_count;	/* #offsets, zero if slot is free */
+};
+
+/*
+ * State for ELF objects whose contents are read on demand, used when
+ * a file cannot be mapped in.  Small reads of file metadata go
+ * through a cache of fixed-size blocks with LRU replacement.
+ */
+#define	LIBELF_LAZY_BLOCKSIZE	(16*1024)
+#define	LIBELF_LAZY_NBLOCKS	8
+
+struct _Libelf_Lazy_Block {
+	unsigned char	*lb_buf;	/* block contents, or NULL */
+	off_t		lb_off;		/* file offset of the block */
+	size_t		lb_size;	/* #valid bytes in the block */
+	uint64_t	lb_stamp;	/* time of last use */
+};
+
+struct _Libelf_Lazy {
+	unsigned char	lz_ident[EI_NIDENT];	/* for elf_getident() */
+	uint64_t	lz_clock;	/* LRU clock */
+	struct _Libelf_Lazy_Block lz_blocks[LIBELF_LAZY_NBLOCKS];
+};
+
+/*
+ * The table of members of an archive, built by elf_getarmembers().
+ */
+struct _Libelf_Ar_Members {
+	size_t		am_count;	/* #members */
+	Elf_Armember	*am_members;	/* member descriptors */
+	Elf_Arhdr	*am_arhdrs;	/* translated headers */
+};
+
+/*
+ * The index used by gelf_lookup_dynsym(), built on first use and
+ * discarded when the object is updated or gains sections.  The
+ * in-memory table of slots is only built for objects that lack a
+ * usable hash section.
+ */
+struct _Libelf_Dynsym_Slot {
+	uint32_t	ds_hash;	/* elf_gnu_hash() value for name */
+	size_t		ds_ndx;		/* symbol index, zero if slot is free */
+};
+
+struct _Libelf_Dynsym {
+	size_t		dy_symndx;	/* .dynsym section, or SHN_UNDEF */
+	size_t		dy_strndx;	/* its string table */
+	size_t		dy_hashndx;	/* hash section, or SHN_UNDEF */
+	uint32_t	dy_hashtype;	/* SHT_GNU_HASH or SHT_HASH */
+	size_t		dy_versymndx;	/* SHT_GNU_versym, or SHN_UNDEF */
+	struct _Libelf_Dynsym_Slot *dy_slots; /* in-memory table, or NULL */
+	size_t		dy_nslots;	/* #slots, a power of 2 */
+};
+
+/*
+ * The index used by elf_getscn_byname(), built on first use and
+ * discarded when the object is updated or gains sections.  Each slot
+ * holds the lowest numbered section with a given name; the other
+ * sections sharing that name are chained through `sn_next' in
+ * ascending order.
+ */
+struct _Libelf_Scnname_Slot {
+	uint32_t	ss_hash;	/* elf_gnu_hash() value for name */
+	size_t		ss_ndx;		/* section index, zero if slot is free */
+};
+
+struct _Libelf_Scnname {
+	size_t		sn_strndx;	/* section name string table */
+	size_t		sn_nscn;	/* #sections indexed */
+	size_t		*sn_next;	/* next section with the same name */
+	struct _Libelf_Scnname_Slot *sn_slots;
+	size_t		sn_nslots;	/* #slots, a power of 2 */
+};
+
+/*
+ * The arena holding the section and data descriptors of an ELF object.
+ * Descriptors are carved out of chunks of memory that are only returned
+ * to the system when the arena is released.  Descriptors that are
+ * released earlier are kept on free lists for reuse.  Data descriptors
+ * may be allocated by threads working on different sections of the
+ * same object, so the arena is protected by a mutex.
+ */
+struct _Libelf_Arena {
+	pthread_mutex_t	a_mutex;	/* protects the fields below */
+	struct _Libelf_Arena_Chunk *a_chunks;	/* allocated chunks */
+	unsigned char	*a_next;	/* free space in the current chunk */
+	size_t		a_avail;	/* #bytes free at `a_next' */
+	size_t		a_chunksz;	/* size of the next chunk */
+	struct _Libelf_Data *a_freedata; /* released data descriptors */
+	struct _Elf_Scn	*a_freescn;	/* released section descriptors */
+};
 
 struct _Elf {
 	int		e_activations;	/* activation count */
@@ -91,7 +323,10 @@ struct _Elf {
 	Elf		*e_parent; 	/* non-NULL for archive members */
 	unsigned char	*e_rawfile;	/* uninterpreted bytes */
 	off_t		e_rawsize;	/* size of uninterpreted bytes */
+	struct _Libelf_Lazy *e_lazy;	/* see LIBELF_F_RAWFILE_LAZY */
 	unsigned int	e_version;	/* file version */
+	Elf_Stats	e_stats;	/* see elf_getstats(3) */
+	LIST_ENTRY(_Elf) e_live;	/* list of live descriptors */
 
 	/*
 	 * Header information for archive members.  See the
@@ -105,13 +340,18 @@ struct _Elf {
 	union {
 		struct {		/* ar(1) archives */
 			off_t	e_next;	/* set by elf_rand()/elf_next() */
-			int	e_nchildren;
+			int	e_nrefs;	/* open children, +1 if active */
 			unsigned char *e_rawstrtab; /* file name strings */
 			size_t	e_rawstrtabsz;
 			unsigned char *e_rawsymtab;	/* symbol table */
 			size_t	e_rawsymtabsz;
 			Elf_Arsym *e_symtab;
 			size_t	e_symtabsz;
+			struct _Libelf_Arsym_Slot *e_symhash; /* name index */
+			size_t	e_symhashsz;	/* #slots, a power of 2 */
+			off_t	*e_symoff;	/* offsets grouped by name */
+			off_t	e_first;	/* offset of the first member */
+			struct _Libelf_Ar_Members *e_members;
 		} e_ar;
 		struct {		/* regular ELF files */
 			union {
@@ -123,6 +363,11 @@ struct _Elf {
 				Elf64_Phdr *e_phdr64;
 			} e_phdr;
 			STAILQ_HEAD(, _Elf_Scn)	e_scn;	/* section list */
+			Elf_Scn	**e_scntab;	/* sections indexed by s_ndx */
+			size_t	e_scntabsz;	/* #slots in e_scntab */
+			struct _Libelf_Arena e_arena; /* scn & data descriptors */
+			struct _Libelf_Dynsym *e_dynsym; /* symbol name index */
+			struct _Libelf_Scnname *e_scnname; /* section name index */
 			size_t	e_nphdr;	/* number of Phdr entries */
 			size_t	e_nscn;		/* number of sections */
 			size_t	e_strndx;	/* string table section index */
@@ -154,6 +399,13 @@ struct _Elf_Scn {
 	uint64_t	s_offset;	/* managed by elf_update() */
 	uint64_t	s_rawoff;	/* original offset in the file */
 	uint64_t	s_size;		/* managed by elf_update() */
+	struct _Libelf_Data *s_strdata;	/* string data cached by elf_strptr() */
+	uint64_t	s_strsize;	/* section size when cached */
+	int		s_ctype;	/* compression applied by elf_update() */
+	unsigned int	s_cflags;	/* flags set by elf_compress() */
+	Elf64_Chdr	s_chdr;		/* compression header, if known */
+	unsigned char	*s_zbuf;	/* compressed contents */
+	size_t		s_zsize;	/* size of the compressed contents */
 };
 
 
@@ -200,16 +452,22 @@ typedef int _libelf_translator_function(unsigned char *_dst, size_t dsz,
 #ifdef __cplusplus
 extern "C" {
 #endif
+void	_libelf_advise(Elf *_e, uint64_t _off, uint64_t _sz, int _advice);
 struct _Libelf_Data *_libelf_allocate_data(Elf_Scn *_s);
 Elf	*_libelf_allocate_elf(void);
 Elf_Scn	*_libelf_allocate_scn(Elf *_e, size_t _ndx);
+Elf_Scn	*_libelf_allocate_scn_block(Elf *_e, Elf_Scn *_prev, size_t _ndx,
+    size_t _count);
 Elf_Arhdr *_libelf_ar_gethdr(Elf *_e);
+struct _Libelf_Ar_Members *_libelf_ar_index_members(Elf *_ar);
 Elf	*_libelf_ar_open(Elf *_e, int _reporterror);
-Elf	*_libelf_ar_open_member(int _fd, Elf_Cmd _c, Elf *_ar);
+Elf	*_libelf_ar_open_member(int _fd, Elf_Cmd _c, Elf *_ar, off_t _off);
 Elf_Arsym *_libelf_ar_process_bsd_symtab(Elf *_ar, size_t *_dst);
 Elf_Arsym *_libelf_ar_process_svr4_symtab(Elf *_ar, size_t *_dst);
 long	 _libelf_checksum(Elf *_e, int _elfclass);
 void	*_libelf_ehdr(Elf *_e, int _elfclass, int _allocate);
+int	_libelf_compress_scn(Elf_Scn *_s);
+int	_libelf_decompress_scn(Elf_Scn *_s);
 int	_libelf_elfmachine(Elf *_e);
 unsigned int _libelf_falign(Elf_Type _t, int _elfclass);
 size_t	_libelf_fsize(Elf_Type _t, int _elfclass, unsigned int _version,
@@ -219,15 +477,36 @@ _libelf_translator_function *_libelf_get_translator(Elf_Type _t,
 void	*_libelf_getphdr(Elf *_e, int _elfclass);
 void	*_libelf_getshdr(Elf_Scn *_scn, int _elfclass);
 void	_libelf_init_elf(Elf *_e, Elf_Kind _kind);
+size_t	_libelf_hash_nslots(size_t _n);
+size_t	_libelf_hash_slot(uint32_t _h, size_t _mask);
+unsigned int _libelf_isa(void);
+int	_libelf_lazy_load(Elf *_e);
+int	_libelf_lazy_open(int _fd, size_t _fsize, int _reporterror,
+    Elf **_ep);
+int	_libelf_lazy_read(Elf *_e, void *_dst, uint64_t _off, size_t _sz,
+    int _cached);
+void	_libelf_lazy_release(Elf *_e);
 int	_libelf_load_section_headers(Elf *e, void *ehdr);
 unsigned int _libelf_malign(Elf_Type _t, int _elfclass);
 Elf	*_libelf_memory(unsigned char *_image, size_t _sz, int _reporterror);
+unsigned char *_libelf_rawbytes(Elf *_e, uint64_t _off, size_t _sz,
+    unsigned char **_buf);
 size_t	_libelf_msize(Elf_Type _t, int _elfclass, unsigned int _version);
 void	*_libelf_newphdr(Elf *_e, int _elfclass, size_t _count);
 Elf	*_libelf_open_object(int _fd, Elf_Cmd _c, int _reporterror);
+int	_libelf_parallel(size_t _njobs, int (*_fn)(void *_arg, size_t _i),
+    void *_arg);
 struct _Libelf_Data *_libelf_release_data(struct _Libelf_Data *_d);
+void	_libelf_release_ar_members(struct _Libelf_Ar_Members *_m);
+void	_libelf_release_arena(Elf *_e);
+void	_libelf_release_dynsym(Elf *_e);
 void	_libelf_release_elf(Elf *_e);
+void	_libelf_release_scnname(Elf *_e);
+void	_libelf_release_zbuf(Elf_Scn *_s);
 Elf_Scn	*_libelf_release_scn(Elf_Scn *_s);
+uint64_t _libelf_stats_clock(void);
+void	_libelf_stats_link(Elf *_e);
+void	_libelf_stats_unlink(Elf *_e);
 int	_libelf_setphnum(Elf *_e, void *_eh, int _elfclass, size_t _phnum);
 int	_libelf_setshnum(Elf *_e, void *_eh, int _elfclass, size_t _shnum);
 int	_libelf_setshstrndx(Elf *_e, void *_eh, int _elfclass,
@@ -235,6 +514,8 @@ int	_libelf_setshstrndx(Elf *_e, void *_eh, int _elfclass,
 Elf_Data *_libelf_xlate(Elf_Data *_d, const Elf_Data *_s,
     unsigned int _encoding, int _elfclass, int _elfmachine, int _direction);
 int	_libelf_xlate_shtype(uint32_t _sht);
+int	_libelf_zchdr(Elf *_e, unsigned char *_src, size_t _sz,
+    Elf64_Chdr *_dst);
 #ifdef __cplusplus
 }
 #endif
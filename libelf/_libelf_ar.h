@@ -53,5 +53,7 @@ char	*_libelf_ar_get_raw_name(const struct ar_hdr *_arh);
 char	*_libelf_ar_get_translated_name(const struct ar_hdr *_arh, Elf *_ar);
 int	_libelf_ar_get_number(const char *_buf, size_t _sz,
     unsigned int _base, size_t *_ret);
+int	_libelf_ar_translate_hdr(Elf *_ar, const struct ar_hdr *_arh,
+    Elf_Arhdr *_eh);
 
 #endif	/* __LIBELF_AR_H_ */
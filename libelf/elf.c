@@ -36,7 +36,13 @@ ELFTC_VCSID("$Id$");
 
 struct _libelf_globals _libelf = {
 	.libelf_byteorder	= LIBELF_BYTEORDER,
-	.libelf_error		= 0,
 	.libelf_fillchar	= 0,
-	.libelf_version		= EV_NONE
+	.libelf_isa		= LIBELF_ISA_UNKNOWN,
+	.libelf_version		= EV_NONE,
+	.libelf_descriptors	= LIST_HEAD_INITIALIZER(_libelf.libelf_descriptors),
+	.libelf_stats_mutex	= PTHREAD_MUTEX_INITIALIZER
+};
+
+LIBELF_THREAD_LOCAL struct _libelf_thread_globals _libelf_thread = {
+	.libelf_error		= 0
 };
@@ -41,7 +41,7 @@ elf_begin(int fd, Elf_Cmd c, Elf *a)
 
 	e = NULL;
 
-	if (LIBELF_PRIVATE(version) == EV_NONE) {
+	if (LIBELF_GET_PRIVATE(version) == EV_NONE) {
 		LIBELF_SET_ERROR(SEQUENCE, 0);
 		return (NULL);
 	}
@@ -59,12 +59,14 @@ elf_begin(int fd, Elf_Cmd c, Elf *a)
 		break;
 
 	case ELF_C_RDWR:
+	case ELF_C_RDWR_MMAP:
 		if (a != NULL) { /* not allowed for ar(1) archives. */
 			LIBELF_SET_ERROR(ARGUMENT, 0);
 			return (NULL);
 		}
 		/*FALLTHROUGH*/
 	case ELF_C_READ:
+	case ELF_C_READ_MMAP:
 		/*
 		 * Descriptor `a' could be for a regular ELF file, or
 		 * for an ar(1) archive.  If descriptor `a' was opened
@@ -72,7 +74,8 @@ elf_begin(int fd, Elf_Cmd c, Elf *a)
 		 * the passed in `fd' value matches the original one.
 		 */
 		if (a &&
-		    ((a->e_fd != -1 && a->e_fd != fd) || c != a->e_cmd)) {
+		    ((a->e_fd != -1 && a->e_fd != fd) ||
+		    LIBELF_BASE_CMD(c) != a->e_cmd)) {
 			LIBELF_SET_ERROR(ARGUMENT, 0);
 			return (NULL);
 		}
@@ -87,9 +90,12 @@ elf_begin(int fd, Elf_Cmd c, Elf *a)
 	if (a == NULL)
 		e = _libelf_open_object(fd, c, 1);
 	else if (a->e_kind == ELF_K_AR)
-		e = _libelf_ar_open_member(a->e_fd, c, a);
-	else
-		(e = a)->e_activations++;
+		e = _libelf_ar_open_member(a->e_fd, LIBELF_BASE_CMD(c), a,
+		    a->e_u.e_ar.e_next);
+	else {
+		(void) LIBELF_ATOMIC_ADD(a->e_activations, 1);
+		e = a;
+	}
 
 	return (e);
 }
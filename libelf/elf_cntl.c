@@ -37,8 +37,41 @@ ELFTC_VCSID("$Id$");
 int
 elf_cntl(Elf *e, Elf_Cmd c)
 {
-	if (e == NULL ||
-	    (c != ELF_C_FDDONE && c != ELF_C_FDREAD)) {
+	int advice;
+
+	if (e == NULL) {
+		LIBELF_SET_ERROR(ARGUMENT, 0);
+		return (-1);
+	}
+
+	switch (c) {
+	case ELF_C_FDDONE:
+	case ELF_C_FDREAD:
+		break;
+	case ELF_C_ACCESS_NORMAL:
+	case ELF_C_ACCESS_SEQUENTIAL:
+	case ELF_C_ACCESS_RANDOM:
+	case ELF_C_HUGEPAGES:
+		/*
+		 * Access hints apply to the whole of the object, and
+		 * are permitted for archive members.
+		 */
+		if (c == ELF_C_ACCESS_NORMAL)
+			advice = LIBELF_ADVISE_NORMAL;
+		else if (c == ELF_C_ACCESS_SEQUENTIAL)
+			advice = LIBELF_ADVISE_SEQUENTIAL;
+		else if (c == ELF_C_ACCESS_RANDOM)
+			advice = LIBELF_ADVISE_RANDOM;
+		else
+			advice = LIBELF_ADVISE_HUGEPAGE;
+
+		_libelf_advise(e, 0, (uint64_t) e->e_rawsize, advice);
+		return (0);
+	case ELF_C_PARALLEL:
+		/* Used by a subsequent elf_update(3). */
+		e->e_flags |= LIBELF_F_PARALLEL;
+		return (0);
+	default:
 		LIBELF_SET_ERROR(ARGUMENT, 0);
 		return (-1);
 	}
@@ -54,9 +87,12 @@ elf_cntl(Elf *e, Elf_Cmd c)
 			return (-1);
 		}
 		else
-			return (0);
+			return (_libelf_lazy_load(e) ? 0 : -1);
 	}
 
+	if (!_libelf_lazy_load(e))
+		return (-1);
+
 	e->e_fd = -1;
 	return 0;
 }
@@ -0,0 +1,144 @@
+/*-
+ * Copyright (c) 2026, Elftoolchain Project Contributors.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE AUTHOR AND CONTRIBUTORS ``AS IS'' AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED.  IN NO EVENT SHALL THE AUTHOR OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS
+ * OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY
+ * OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+ * SUCH DAMAGE.
+ */
+
+#include <sys/cdefs.h>
+
+#include <assert.h>
+#include <libelf.h>
+#include <stdlib.h>
+
+#include "_libelf.h"
+
+ELFTC_VCSID("$Id$");
+
+/*@ELFTC-DOWNSTREAM-VCSID@*/
+
+int
+elf_compress(Elf_Scn *s, int type, unsigned int flags)
+{
+	Elf *e;
+	void *sh;
+	int ec;
+	uint32_t sh_type;
+	uint64_t align, sh_flags;
+	struct _Libelf_Data *ld;
+
+	if ((flags & ~ELF_CHF_FORCE) != 0) {
+		LIBELF_SET_ERROR(ARGUMENT, 0);
+		return (-1);
+	}
+
+	switch (type) {
+	case 0:
+		break;
+	case ELFCOMPRESS_ZLIB:
+#if	defined(LIBELF_HAVE_ZLIB)
+		break;
+#else
+		LIBELF_SET_ERROR(UNIMPL, 0);
+		return (-1);
+#endif
+	case ELFCOMPRESS_ZSTD:
+#if	defined(LIBELF_HAVE_ZSTD)
+		break;
+#else
+		LIBELF_SET_ERROR(UNIMPL, 0);
+		return (-1);
+#endif
+	default:
+		LIBELF_SET_ERROR(ARGUMENT, 0);
+		return (-1);
+	}
+
+	if ((sh = _libelf_getshdr(s, ELFCLASSNONE)) == NULL)
+		return (-1);
+
+	e = s->s_elf;
+	ec = e->e_class;
+	assert(ec == ELFCLASS32 || ec == ELFCLASS64);
+
+	if (ec == ELFCLASS32) {
+		sh_type  = ((Elf32_Shdr *) sh)->sh_type;
+		sh_flags = (uint64_t) ((Elf32_Shdr *) sh)->sh_flags;
+	} else {
+		sh_type  = ((Elf64_Shdr *) sh)->sh_type;
+		sh_flags = ((Elf64_Shdr *) sh)->sh_flags;
+	}
+
+	if (sh_type == SHT_NULL || sh_type == SHT_NOBITS) {
+		LIBELF_SET_ERROR(ARGUMENT, 0);
+		return (-1);
+	}
+
+	if ((sh_flags & SHF_COMPRESSED) == 0 && type == 0)
+		return (0);
+
+	/*
+	 * Bring in the uncompressed contents of a section that is
+	 * currently compressed.
+	 */
+	if ((sh_flags & SHF_COMPRESSED) && s->s_ctype == 0 &&
+	    _libelf_decompress_scn(s) == 0)
+		return (-1);
+
+	_libelf_release_zbuf(s);
+	s->s_chdr.ch_type = 0;
+
+	if (type == 0) {
+		/*
+		 * The section is to be written out uncompressed, with
+		 * the alignment needed by its data.
+		 */
+		align = 1;
+		STAILQ_FOREACH(ld, &s->s_data, d_next)
+			if (ld->d_data.d_align > align)
+				align = ld->d_data.d_align;
+
+		s->s_ctype = 0;
+		s->s_cflags = 0;
+		sh_flags &= ~(uint64_t) SHF_COMPRESSED;
+	} else {
+		/* The compression itself is done by elf_update(3). */
+		s->s_ctype = type;
+		s->s_cflags = flags;
+		sh_flags |= SHF_COMPRESSED;
+	}
+
+	if (ec == ELFCLASS32) {
+		((Elf32_Shdr *) sh)->sh_flags = (uint32_t) sh_flags;
+		if (type == 0)
+			((Elf32_Shdr *) sh)->sh_addralign = (uint32_t) align;
+	} else {
+		((Elf64_Shdr *) sh)->sh_flags = sh_flags;
+		if (type == 0)
+			((Elf64_Shdr *) sh)->sh_addralign = align;
+	}
+
+	(void) elf_flagshdr(s, ELF_C_SET, ELF_F_DIRTY);
+	(void) elf_flagscn(s, ELF_C_SET, ELF_F_DIRTY);
+
+	return (1);
+}
@@ -38,15 +38,60 @@ ELFTC_VCSID("$Id$");
 
 /*@ELFTC-DOWNSTREAM-VCSID@*/
 
+/*
+ * Return non-zero if the file representation of a section's contents
+ * can be used directly as its memory representation.
+ *
+ * This is the case when the translator for the section's type would
+ * only copy bytes: the file and memory sizes of the type agree, the
+ * object uses the host's byte order and the data is suitably aligned.
+ * Types with internal structure are always translated, since their
+ * translators also validate the data.  The file image also needs to
+ * be owned by the library, so that an application's changes to the
+ * returned buffer are not visible to the underlying file or to the
+ * creator of an image passed to elf_memory(3), and writable by the
+ * application unless it asked for a read-only mapping with
+ * ELF_C_READ_MMAP.  Buffers filled in by on-demand reads are private
+ * to the data descriptor.
+ */
+static int
+_libelf_data_in_place(Elf *e, int elftype, size_t fsz, size_t msz,
+    const unsigned char *src)
+{
+	Elf *p;
+
+	p = e->e_parent ? e->e_parent : e;
+	if ((p->e_flags & (LIBELF_F_RAWFILE_MALLOC |
+	    LIBELF_F_RAWFILE_MMAP | LIBELF_F_RAWFILE_LAZY)) == 0 ||
+	    (p->e_flags & LIBELF_F_RAWFILE_COPY))
+		return (0);
+
+	switch (elftype) {
+	case ELF_T_BYTE:
+		return (1);
+	case ELF_T_GNUHASH:
+	case ELF_T_NOTE:
+	case ELF_T_VDEF:
+	case ELF_T_VNEED:
+		return (0);
+	default:
+		break;
+	}
+
+	return (e->e_byteorder == LIBELF_PRIVATE(byteorder) && fsz == msz &&
+	    ((uintptr_t) src % _libelf_malign(elftype, e->e_class)) == 0);
+}
+
 Elf_Data *
 elf_getdata(Elf_Scn *s, Elf_Data *ed)
 {
 	Elf *e;
 	unsigned int sh_type;
 	int elfclass, elftype;
-	size_t count, fsz, msz;
+	size_t bufsz, count, fsz, msz;
+	unsigned char *src;
 	struct _Libelf_Data *d;
-	uint64_t sh_align, sh_offset, sh_size, raw_size;
+	uint64_t sh_align, sh_flags, sh_offset, sh_size, raw_size, t0;
 	_libelf_translator_function *xlate;
 
 	d = (struct _Libelf_Data *) ed;
@@ -66,7 +111,7 @@ elf_getdata(Elf_Scn *s, Elf_Data *ed)
 		return (STAILQ_NEXT(d, d_next) ?
 		    &STAILQ_NEXT(d, d_next)->d_data : NULL);
 
-	if (e->e_rawfile == NULL) {
+	if (!LIBELF_HAS_RAWFILE(e)) {
 		/*
 		 * In the ELF_C_WRITE case, there is no source that
 		 * can provide data for the section.
@@ -81,11 +126,13 @@ elf_getdata(Elf_Scn *s, Elf_Data *ed)
 
 	if (elfclass == ELFCLASS32) {
 		sh_type   = s->s_shdr.s_shdr32.sh_type;
+		sh_flags  = (uint64_t) s->s_shdr.s_shdr32.sh_flags;
 		sh_offset = (uint64_t) s->s_shdr.s_shdr32.sh_offset;
 		sh_size   = (uint64_t) s->s_shdr.s_shdr32.sh_size;
 		sh_align  = (uint64_t) s->s_shdr.s_shdr32.sh_addralign;
 	} else {
 		sh_type   = s->s_shdr.s_shdr64.sh_type;
+		sh_flags  = s->s_shdr.s_shdr64.sh_flags;
 		sh_offset = s->s_shdr.s_shdr64.sh_offset;
 		sh_size   = s->s_shdr.s_shdr64.sh_size;
 		sh_align  = s->s_shdr.s_shdr64.sh_addralign;
@@ -96,6 +143,19 @@ elf_getdata(Elf_Scn *s, Elf_Data *ed)
 		return (NULL);
 	}
 
+	/*
+	 * The contents of a compressed section are returned as bytes,
+	 * unless the application asked for them to be decompressed.
+	 * Sections marked by elf_compress(3) hold uncompressed data.
+	 */
+	if ((sh_flags & SHF_COMPRESSED) && sh_type != SHT_NOBITS &&
+	    s->s_ctype == 0) {
+		if (e->e_flags & ELF_F_DECOMPRESS)
+			return (_libelf_decompress_scn(s) ?
+			    &STAILQ_FIRST(&s->s_data)->d_data : NULL);
+		sh_type = SHT_PROGBITS;
+	}
+
 	raw_size = (uint64_t) e->e_rawsize;
 	if ((elftype = _libelf_xlate_shtype(sh_type)) < ELF_T_FIRST ||
 	    elftype > ELF_T_LAST || (sh_type != SHT_NOBITS &&
@@ -149,23 +209,76 @@ elf_getdata(Elf_Scn *s, Elf_Data *ed)
 		return (&d->d_data);
         }
 
-	if ((d->d_data.d_buf = malloc(msz * count)) == NULL) {
-		(void) _libelf_release_data(d);
-		LIBELF_SET_ERROR(RESOURCE, 0);
-		return (NULL);
-	}
+	if (sh_size >= LIBELF_ADVISE_MINSIZE)
+		_libelf_advise(e, sh_offset, sh_size, LIBELF_ADVISE_WILLNEED);
 
-	d->d_flags  |= LIBELF_F_DATA_MALLOCED;
+	if (e->e_flags & LIBELF_F_RAWFILE_LAZY) {
+		/*
+		 * Read the section's contents straight into the
+		 * descriptor's buffer, and translate them in place if
+		 * needed.
+		 */
+		bufsz = msz * count;
+		if (bufsz < (size_t) sh_size)
+			bufsz = (size_t) sh_size;
+
+		if ((src = malloc(bufsz)) == NULL) {
+			(void) _libelf_release_data(d);
+			LIBELF_SET_ERROR(RESOURCE, 0);
+			return (NULL);
+		}
+
+		d->d_data.d_buf = src;
+		d->d_flags |= LIBELF_F_DATA_MALLOCED;
+		LIBELF_STATS_ADD(e, es_allocated[elftype], bufsz);
+
+		if (!_libelf_lazy_read(e, src, sh_offset, (size_t) sh_size,
+		    0)) {
+			(void) _libelf_release_data(d);
+			return (NULL);
+		}
+
+		if (_libelf_data_in_place(e, elftype, fsz, msz, src)) {
+			STAILQ_INSERT_TAIL(&s->s_data, d, d_next);
+			return (&d->d_data);
+		}
+	} else {
+		src = e->e_rawfile + sh_offset;
+
+		/*
+		 * Avoid a copy if the data does not need translation.
+		 * A writable file image is mapped in privately, so any
+		 * changes made by the application cause the affected
+		 * pages to be copied.
+		 */
+		if (_libelf_data_in_place(e, elftype, fsz, msz, src)) {
+			d->d_data.d_buf = src;
+			STAILQ_INSERT_TAIL(&s->s_data, d, d_next);
+			return (&d->d_data);
+		}
+
+		if ((d->d_data.d_buf = malloc(msz * count)) == NULL) {
+			(void) _libelf_release_data(d);
+			LIBELF_SET_ERROR(RESOURCE, 0);
+			return (NULL);
+		}
+
+		d->d_flags |= LIBELF_F_DATA_MALLOCED;
+		LIBELF_STATS_ADD(e, es_allocated[elftype], msz * count);
+	}
 
 	xlate = _libelf_get_translator(elftype, ELF_TOMEMORY, elfclass,
 	    _libelf_elfmachine(e));
-	if (!(*xlate)(d->d_data.d_buf, (size_t) d->d_data.d_size,
-	    e->e_rawfile + sh_offset, count,
+	t0 = _libelf_stats_clock();
+	if (!(*xlate)(d->d_data.d_buf, (size_t) d->d_data.d_size, src, count,
 	    e->e_byteorder != LIBELF_PRIVATE(byteorder))) {
 		_libelf_release_data(d);
 		LIBELF_SET_ERROR(DATA, 0);
 		return (NULL);
 	}
+	LIBELF_STATS_ADD(e, es_xlate_nsec, _libelf_stats_clock() - t0);
+	LIBELF_STATS_ADD(e, es_xlate_calls, 1);
+	LIBELF_STATS_ADD(e, es_xlate_bytes, sh_size);
 
 	STAILQ_INSERT_TAIL(&s->s_data, d, d_next);
 
@@ -189,13 +302,15 @@ elf_newdata(Elf_Scn *s)
 	 * elf_newdata() has to append a data descriptor, so
 	 * bring in existing section data if not already present.
 	 */
-	if (e->e_rawfile && s->s_size > 0 && STAILQ_EMPTY(&s->s_data))
+	if (LIBELF_HAS_RAWFILE(e) && s->s_size > 0 &&
+	    STAILQ_EMPTY(&s->s_data))
 		if (elf_getdata(s, NULL) == NULL)
 			return (NULL);
 
 	if ((d = _libelf_allocate_data(s)) == NULL)
 		return (NULL);
 
+	s->s_strdata = NULL;
 	STAILQ_INSERT_TAIL(&s->s_data, d, d_next);
 
 	d->d_data.d_align = 1;
@@ -203,7 +318,7 @@ elf_newdata(Elf_Scn *s)
 	d->d_data.d_off = (uint64_t) ~0;
 	d->d_data.d_size = 0;
 	d->d_data.d_type = ELF_T_BYTE;
-	d->d_data.d_version = LIBELF_PRIVATE(version);
+	d->d_data.d_version = LIBELF_GET_PRIVATE(version);
 
 	(void) elf_flagscn(s, ELF_C_SET, ELF_F_DIRTY);
 
@@ -224,7 +339,7 @@ elf_rawdata(Elf_Scn *s, Elf_Data *ed)
 	struct _Libelf_Data *d;
 	uint64_t sh_align, sh_offset, sh_size, raw_size;
 
-	if (s == NULL || (e = s->s_elf) == NULL || e->e_rawfile == NULL) {
+	if (s == NULL || (e = s->s_elf) == NULL || !LIBELF_HAS_RAWFILE(e)) {
 		LIBELF_SET_ERROR(ARGUMENT, 0);
 		return (NULL);
 	}
@@ -270,8 +385,28 @@ elf_rawdata(Elf_Scn *s, Elf_Data *ed)
 	if ((d = _libelf_allocate_data(s)) == NULL)
 		return (NULL);
 
-	d->d_data.d_buf = (sh_type == SHT_NOBITS || sh_size == 0) ? NULL :
-	    e->e_rawfile + sh_offset;
+	d->d_data.d_buf = NULL;
+	if (sh_type != SHT_NOBITS && sh_size > 0) {
+		if (sh_size >= LIBELF_ADVISE_MINSIZE)
+			_libelf_advise(e, sh_offset, sh_size,
+			    LIBELF_ADVISE_WILLNEED);
+		if ((e->e_flags & LIBELF_F_RAWFILE_LAZY) == 0)
+			d->d_data.d_buf = e->e_rawfile + sh_offset;
+		else if ((d->d_data.d_buf = malloc((size_t) sh_size)) ==
+		    NULL) {
+			(void) _libelf_release_data(d);
+			LIBELF_SET_ERROR(RESOURCE, 0);
+			return (NULL);
+		} else {
+			d->d_flags |= LIBELF_F_DATA_MALLOCED;
+			LIBELF_STATS_ADD(e, es_allocated[ELF_T_BYTE], sh_size);
+			if (!_libelf_lazy_read(e, d->d_data.d_buf, sh_offset,
+			    (size_t) sh_size, 0)) {
+				(void) _libelf_release_data(d);
+				return (NULL);
+			}
+		}
+	}
 	d->d_data.d_off     = 0;
 	d->d_data.d_align   = sh_align;
 	d->d_data.d_size    = sh_size;
@@ -43,27 +43,29 @@ ELFTC_VCSID("$Id$");
 int
 elf_end(Elf *e)
 {
+	int n;
 	Elf *sv;
 	Elf_Scn *scn, *tscn;
 
 	if (e == NULL || e->e_activations == 0)
 		return (0);
 
-	if (--e->e_activations > 0)
-		return (e->e_activations);
+	if ((n = LIBELF_ATOMIC_ADD(e->e_activations, -1)) > 0)
+		return (n);
 
-	assert(e->e_activations == 0);
+	assert(n == 0);
 
-	while (e && e->e_activations == 0) {
+	while (e != NULL) {
 		switch (e->e_kind) {
 		case ELF_K_AR:
 			/*
-			 * If we still have open child descriptors, we
-			 * need to defer reclaiming resources till all
-			 * the child descriptors for the archive are
-			 * closed.
+			 * An archive holds a reference to itself until
+			 * its last activation ends, and each open child
+			 * descriptor holds one more.  Whoever drops the
+			 * last reference reclaims the archive's
+			 * resources.
 			 */
-			if (e->e_u.e_ar.e_nchildren > 0)
+			if (LIBELF_ATOMIC_ADD(e->e_u.e_ar.e_nrefs, -1) > 0)
 				return (0);
 			break;
 		case ELF_K_ELF:
@@ -89,9 +91,12 @@ elf_end(Elf *e)
 #endif
 		}
 
+		/*
+		 * Drop the reference that a child descriptor holds on
+		 * its parent archive.
+		 */
 		sv = e;
-		if ((e = e->e_parent) != NULL)
-			e->e_u.e_ar.e_nchildren--;
+		e = e->e_parent;
 		_libelf_release_elf(sv);
 	}
 
@@ -67,10 +67,10 @@ elf_errmsg(int error)
 	int oserr;
 
 	if (error == ELF_E_NONE &&
-	    (error = LIBELF_PRIVATE(error)) == 0)
+	    (error = LIBELF_THREAD_PRIVATE(error)) == 0)
 	    return NULL;
 	else if (error == -1)
-	    error = LIBELF_PRIVATE(error);
+	    error = LIBELF_THREAD_PRIVATE(error);
 
 	oserr = error >> LIBELF_OS_ERROR_SHIFT;
 	error &= LIBELF_ELF_ERROR_MASK;
@@ -78,10 +78,10 @@ elf_errmsg(int error)
 	if (error < ELF_E_NONE || error >= ELF_E_NUM)
 		return _libelf_errors[ELF_E_NUM];
 	if (oserr) {
-		(void) snprintf((char *) LIBELF_PRIVATE(msg),
-		    sizeof(LIBELF_PRIVATE(msg)), "%s: %s",
+		(void) snprintf((char *) LIBELF_THREAD_PRIVATE(msg),
+		    sizeof(LIBELF_THREAD_PRIVATE(msg)), "%s: %s",
 		    _libelf_errors[error], strerror(oserr));
-		return (const char *)&LIBELF_PRIVATE(msg);
+		return (const char *)&LIBELF_THREAD_PRIVATE(msg);
 	}
 	return _libelf_errors[error];
 }
@@ -73,6 +73,12 @@ elf_flagdata(Elf_Data *d, Elf_Cmd c, unsigned int flags)
 
 	ld = (struct _Libelf_Data *) d;
 
+	if (ld->d_scn != NULL) {
+		ld->d_scn->s_strdata = NULL;
+		if (c == ELF_C_SET && (flags & ELF_F_DIRTY))
+			_libelf_release_zbuf(ld->d_scn);
+	}
+
 	if (c == ELF_C_SET)
 		r = ld->d_flags |= flags;
 	else
@@ -121,7 +127,7 @@ elf_flagelf(Elf *e, Elf_Cmd c, unsigned int flags)
 	if ((c != ELF_C_SET && c != ELF_C_CLR) ||
 	    (e->e_kind != ELF_K_ELF) ||
 	    (flags & ~(ELF_F_ARCHIVE | ELF_F_ARCHIVE_SYSV |
-	    ELF_F_DIRTY | ELF_F_LAYOUT)) != 0) {
+	    ELF_F_DECOMPRESS | ELF_F_DIRTY | ELF_F_LAYOUT)) != 0) {
 		LIBELF_SET_ERROR(ARGUMENT, 0);
 		return (0);
 	}
@@ -186,6 +192,10 @@ elf_flagscn(Elf_Scn *s, Elf_Cmd c, unsigned int flags)
 		return (0);
 	}
 
+	s->s_strdata = NULL;
+	if (c == ELF_C_SET && (flags & ELF_F_DIRTY))
+		_libelf_release_zbuf(s);
+
 	if (c == ELF_C_SET)
 		r = s->s_flags |= flags;
 	else
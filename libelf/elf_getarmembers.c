@@ -0,0 +1,105 @@
+/*-
+ * Copyright (c) 2026, Elftoolchain Project Contributors.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE AUTHOR AND CONTRIBUTORS ``AS IS'' AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED.  IN NO EVENT SHALL THE AUTHOR OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS
+ * OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY
+ * OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+ * SUCH DAMAGE.
+ */
+
+#include <sys/cdefs.h>
+
+#include <libelf.h>
+
+#include "_libelf.h"
+
+ELFTC_VCSID("$Id$");
+
+/*@ELFTC-DOWNSTREAM-VCSID@*/
+
+/*
+ * Return the table of members of an archive, building it on first use.
+ *
+ * The table is published atomically, so that threads racing to build
+ * it agree on a single copy.
+ */
+static struct _Libelf_Ar_Members *
+_libelf_ar_members(Elf *ar)
+{
+	struct _Libelf_Ar_Members *expected, *m;
+
+	if ((m = LIBELF_ATOMIC_LOAD_PTR(ar->e_u.e_ar.e_members)) != NULL)
+		return (m);
+
+	if ((m = _libelf_ar_index_members(ar)) == NULL)
+		return (NULL);
+
+	expected = NULL;
+	if (!LIBELF_ATOMIC_CAS_PTR(ar->e_u.e_ar.e_members, expected, m)) {
+		_libelf_release_ar_members(m);
+		m = expected;
+	}
+
+	return (m);
+}
+
+Elf_Armember *
+elf_getarmembers(Elf *ar, size_t *count)
+{
+	struct _Libelf_Ar_Members *m;
+
+	if (count)
+		*count = 0;
+
+	if (ar == NULL || ar->e_kind != ELF_K_AR) {
+		LIBELF_SET_ERROR(ARGUMENT, 0);
+		return (NULL);
+	}
+
+	if ((m = _libelf_ar_members(ar)) == NULL)
+		return (NULL);
+
+	if (count)
+		*count = m->am_count;
+
+	return (m->am_members);
+}
+
+Elf *
+elf_openarmember(Elf *ar, size_t ndx)
+{
+	struct _Libelf_Ar_Members *m;
+
+	if (ar == NULL || ar->e_kind != ELF_K_AR) {
+		LIBELF_SET_ERROR(ARGUMENT, 0);
+		return (NULL);
+	}
+
+	if ((m = _libelf_ar_members(ar)) == NULL)
+		return (NULL);
+
+	if (ndx >= m->am_count) {
+		LIBELF_SET_ERROR(ARGUMENT, 0);
+		return (NULL);
+	}
+
+	return (_libelf_ar_open_member(ar->e_fd, ar->e_cmd, ar,
+	    m->am_members[ndx].am_off));
+}
@@ -27,6 +27,9 @@
 #include <sys/cdefs.h>
 
 #include <libelf.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
 
 #include "_libelf.h"
 
@@ -58,3 +61,116 @@ elf_getarsym(Elf *ar, size_t *ptr)
 		*ptr = n;
 	return (symtab);
 }
+
+/*
+ * Build the hash index over the symbol table of archive `ar'.
+ *
+ * Each distinct symbol name gets a slot in an open-addressed table.
+ * The member offsets for each name are then laid out contiguously in
+ * the order in which they appear in the archive's symbol table.
+ */
+static int
+_libelf_ar_index_symtab(Elf *ar)
+{
+	Elf_Arsym *sym, *symtab;
+	struct _Libelf_Arsym_Slot *hash, *slot;
+	size_t i, j, mask, n, nslots, nsyms, start, *slotof;
+	off_t *symoff;
+
+	if ((symtab = elf_getarsym(ar, &n)) == NULL)
+		return (0);
+
+	nsyms = n - 1;		/* Skip the sentinel entry. */
+
+	nslots = _libelf_hash_nslots(nsyms);
+	mask = nslots - 1;
+
+	hash = NULL;
+	symoff = NULL;
+	slotof = NULL;
+
+	if ((hash = calloc(nslots, sizeof(*hash))) == NULL ||
+	    (symoff = malloc((nsyms + 1) * sizeof(*symoff))) == NULL ||
+	    (slotof = malloc((nsyms + 1) * sizeof(*slotof))) == NULL) {
+		free(hash);
+		free(symoff);
+		LIBELF_SET_ERROR(RESOURCE, 0);
+		return (0);
+	}
+
+	/* Assign each symbol to the slot for its name. */
+	for (i = 0, sym = symtab; i < nsyms; i++, sym++) {
+		for (j = _libelf_hash_slot((uint32_t) sym->as_hash, mask);; j =
+		    (j + 1) & mask) {
+			slot = &hash[j];
+			if (slot->ah_count == 0) {
+				slot->ah_sym = i;
+				break;
+			}
+			if (symtab[slot->ah_sym].as_hash == sym->as_hash &&
+			    strcmp(symtab[slot->ah_sym].as_name,
+			    sym->as_name) == 0)
+				break;
+		}
+		slot->ah_count++;
+		slotof[i] = j;
+	}
+
+	/* Reserve space for the offsets of each distinct name. */
+	for (j = 0, start = 0; j < nslots; j++) {
+		hash[j].ah_start = start;
+		start += hash[j].ah_count;
+		hash[j].ah_count = 0;
+	}
+
+	for (i = 0; i < nsyms; i++) {
+		slot = &hash[slotof[i]];
+		symoff[slot->ah_start + slot->ah_count++] = symtab[i].as_off;
+	}
+
+	free(slotof);
+
+	ar->e_u.e_ar.e_symhash = hash;
+	ar->e_u.e_ar.e_symhashsz = nslots;
+	ar->e_u.e_ar.e_symoff = symoff;
+
+	return (1);
+}
+
+off_t *
+elf_arsym_lookup(Elf *ar, const char *name, size_t *count)
+{
+	Elf_Arsym *symtab;
+	struct _Libelf_Arsym_Slot *slot;
+	unsigned long h;
+	size_t j, mask;
+
+	if (count)
+		*count = 0;
+
+	if (ar == NULL || ar->e_kind != ELF_K_AR || name == NULL) {
+		LIBELF_SET_ERROR(ARGUMENT, 0);
+		return (NULL);
+	}
+
+	if (ar->e_u.e_ar.e_symhash == NULL && !_libelf_ar_index_symtab(ar))
+		return (NULL);
+
+	symtab = ar->e_u.e_ar.e_symtab;
+	mask = ar->e_u.e_ar.e_symhashsz - 1;
+	h = elf_hash(name);
+
+	for (j = _libelf_hash_slot((uint32_t) h, mask);; j = (j + 1) & mask) {
+		slot = &ar->e_u.e_ar.e_symhash[j];
+		if (slot->ah_count == 0)
+			return (NULL);
+		if (symtab[slot->ah_sym].as_hash == h &&
+		    strcmp(symtab[slot->ah_sym].as_name, name) == 0)
+			break;
+	}
+
+	if (count)
+		*count = slot->ah_count;
+
+	return (ar->e_u.e_ar.e_symoff + slot->ah_start);
+}
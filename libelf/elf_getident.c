@@ -61,6 +61,9 @@ elf_getident(Elf *e, size_t *sz)
 			*sz = (size_t) e->e_rawsize;
 	}
 
+	if (e->e_flags & LIBELF_F_RAWFILE_LAZY)
+		return ((char *) e->e_lazy->lz_ident);
+
 	return ((char *) e->e_rawfile);
 
  error:
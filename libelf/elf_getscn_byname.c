@@ -0,0 +1,242 @@
+/*-
+ * Copyright (c) 2026, Elftoolchain Project Contributors.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE AUTHOR AND CONTRIBUTORS ``AS IS'' AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED.  IN NO EVENT SHALL THE AUTHOR OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS
+ * OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY
+ * OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+ * SUCH DAMAGE.
+ */
+
+#include <sys/cdefs.h>
+
+#include <libelf.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "_libelf.h"
+
+ELFTC_VCSID("$Id$");
+
+/*@ELFTC-DOWNSTREAM-VCSID@*/
+
+/*
+ * Section lookup by name.
+ *
+ * On first use, a hash table over the names of the sections of an ELF
+ * object is built from its section name string table.  Later lookups
+ * then take constant time on average, instead of requiring a walk
+ * over all sections.
+ */
+
+/*
+ * Return the name of section `ndx', or NULL if it has none.
+ */
+static const char *
+_libelf_scnname_name(Elf *e, size_t strndx, size_t ndx)
+{
+	Elf_Scn *s;
+	uint64_t sh_name;
+
+	if ((s = elf_getscn(e, ndx)) == NULL)
+		return (NULL);
+
+	sh_name = e->e_class == ELFCLASS32 ? s->s_shdr.s_shdr32.sh_name :
+	    s->s_shdr.s_shdr64.sh_name;
+
+	return (elf_strptr(e, strndx, (size_t) sh_name));
+}
+
+/*
+ * Build the index over section names.  Sections are entered in
+ * descending order, so that the chain of sections sharing a name ends
+ * up in ascending order.  Sections whose names cannot be retrieved
+ * are left out.
+ */
+static struct _Libelf_Scnname *
+_libelf_scnname_init(Elf *e, size_t strndx)
+{
+	const char *s, *t;
+	uint32_t h;
+	int error;
+	size_t i, j, mask, nscn, nslots;
+	struct _Libelf_Scnname *sn;
+	struct _Libelf_Scnname_Slot *slot;
+
+	if (elf_getshdrnum(e, &nscn) < 0)
+		return (NULL);
+
+	if ((sn = calloc((size_t) 1, sizeof(*sn))) == NULL) {
+		LIBELF_SET_ERROR(RESOURCE, 0);
+		return (NULL);
+	}
+
+	nslots = _libelf_hash_nslots(nscn);
+	mask = nslots - 1;
+
+	if ((sn->sn_slots = calloc(nslots, sizeof(*sn->sn_slots))) == NULL ||
+	    (sn->sn_next = calloc(nscn > 0 ? nscn : 1,
+	    sizeof(*sn->sn_next))) == NULL) {
+		LIBELF_SET_ERROR(RESOURCE, 0);
+		goto error;
+	}
+
+	sn->sn_strndx = strndx;
+	sn->sn_nscn = nscn;
+	sn->sn_nslots = nslots;
+
+	/* Sections left out of the index do not cause lookups to fail. */
+	error = LIBELF_THREAD_PRIVATE(error);
+
+	for (i = nscn; strndx != SHN_UNDEF && i > 1; i--) {
+		if ((s = _libelf_scnname_name(e, strndx, i - 1)) == NULL)
+			continue;
+
+		h = (uint32_t) elf_gnu_hash(s);
+		for (j = _libelf_hash_slot(h, mask);; j = (j + 1) & mask) {
+			slot = &sn->sn_slots[j];
+			if (slot->ss_ndx == 0) {
+				slot->ss_hash = h;
+				break;
+			}
+			if (slot->ss_hash == h &&
+			    (t = _libelf_scnname_name(e, strndx,
+			    slot->ss_ndx)) != NULL && strcmp(s, t) == 0) {
+				sn->sn_next[i - 1] = slot->ss_ndx;
+				break;
+			}
+		}
+		slot->ss_ndx = i - 1;
+	}
+
+	LIBELF_THREAD_PRIVATE(error) = error;
+
+	e->e_u.e_elf.e_scnname = sn;
+	return (sn);
+
+error:
+	free(sn->sn_slots);
+	free(sn->sn_next);
+	free(sn);
+	return (NULL);
+}
+
+/*
+ * Retrieve the index of the section name string table from the ELF
+ * header.  Unlike elf_getshdrstrndx(), this reflects changes made by
+ * the application since the object was read in.
+ */
+static int
+_libelf_scnname_strndx(Elf *e, size_t *strndx)
+{
+	void *eh;
+	Elf_Scn *s;
+	int ec;
+
+	ec = e->e_class;
+	if ((eh = _libelf_ehdr(e, ec, 0)) == NULL)
+		return (-1);
+
+	*strndx = ec == ELFCLASS32 ? ((Elf32_Ehdr *) eh)->e_shstrndx :
+	    ((Elf64_Ehdr *) eh)->e_shstrndx;
+
+	if (*strndx == SHN_XINDEX) {
+		if ((s = elf_getscn(e, (size_t) SHN_UNDEF)) == NULL)
+			return (-1);
+		*strndx = ec == ELFCLASS32 ? s->s_shdr.s_shdr32.sh_link :
+		    s->s_shdr.s_shdr64.sh_link;
+	}
+
+	return (0);
+}
+
+/*
+ * Return the index for `e', building it if needed.
+ */
+static struct _Libelf_Scnname *
+_libelf_scnname_get(Elf *e)
+{
+	size_t strndx;
+	struct _Libelf_Scnname *sn;
+
+	if (_libelf_scnname_strndx(e, &strndx) < 0)
+		return (NULL);
+
+	/* The section name string table may have been changed. */
+	if ((sn = e->e_u.e_elf.e_scnname) != NULL) {
+		if (sn->sn_strndx == strndx)
+			return (sn);
+		_libelf_release_scnname(e);
+	}
+
+	return (_libelf_scnname_init(e, strndx));
+}
+
+Elf_Scn *
+elf_getscn_byname(Elf *e, const char *name)
+{
+	const char *s;
+	uint32_t h;
+	size_t j, mask;
+	struct _Libelf_Scnname *sn;
+	struct _Libelf_Scnname_Slot *slot;
+
+	if (e == NULL || e->e_kind != ELF_K_ELF || name == NULL) {
+		LIBELF_SET_ERROR(ARGUMENT, 0);
+		return (NULL);
+	}
+
+	if ((sn = _libelf_scnname_get(e)) == NULL)
+		return (NULL);
+
+	h = (uint32_t) elf_gnu_hash(name);
+	mask = sn->sn_nslots - 1;
+
+	for (j = _libelf_hash_slot(h, mask);; j = (j + 1) & mask) {
+		slot = &sn->sn_slots[j];
+		if (slot->ss_ndx == 0)
+			return (NULL);
+		if (slot->ss_hash == h &&
+		    (s = _libelf_scnname_name(e, sn->sn_strndx,
+		    slot->ss_ndx)) != NULL && strcmp(s, name) == 0)
+			return (elf_getscn(e, slot->ss_ndx));
+	}
+}
+
+Elf_Scn *
+elf_nextscn_byname(Elf *e, Elf_Scn *s)
+{
+	size_t ndx;
+	struct _Libelf_Scnname *sn;
+
+	if (e == NULL || e->e_kind != ELF_K_ELF || s == NULL ||
+	    s->s_elf != e) {
+		LIBELF_SET_ERROR(ARGUMENT, 0);
+		return (NULL);
+	}
+
+	if ((sn = _libelf_scnname_get(e)) == NULL)
+		return (NULL);
+
+	if (s->s_ndx >= sn->sn_nscn || (ndx = sn->sn_next[s->s_ndx]) == 0)
+		return (NULL);
+
+	return (elf_getscn(e, ndx));
+}
@@ -0,0 +1,137 @@
+/*-
+ * Copyright (c) 2026, Elftoolchain Project Contributors.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE AUTHOR AND CONTRIBUTORS ``AS IS'' AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED.  IN NO EVENT SHALL THE AUTHOR OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS
+ * OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY
+ * OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+ * SUCH DAMAGE.
+ */
+
+#include <sys/cdefs.h>
+
+#include <assert.h>
+#include <libelf.h>
+#include <string.h>
+#include <time.h>
+
+#include "_libelf.h"
+
+ELFTC_VCSID("$Id$");
+
+/*@ELFTC-DOWNSTREAM-VCSID@*/
+
+/*
+ * Return a timestamp in nanoseconds, used to measure the time spent
+ * in translation.
+ */
+uint64_t
+_libelf_stats_clock(void)
+{
+	struct timespec ts;
+
+	if (clock_gettime(CLOCK_MONOTONIC, &ts) < 0)
+		return (0);
+
+	return ((uint64_t) ts.tv_sec * 1000000000U + (uint64_t) ts.tv_nsec);
+}
+
+/*
+ * Add the counters in `src' to those in `dst'.
+ */
+static void
+_libelf_stats_sum(Elf_Stats *dst, Elf_Stats *src)
+{
+	int t;
+
+	/*
+	 * The counters in `src' may be updated concurrently, so each
+	 * is read atomically.
+	 */
+	dst->es_mapped		+= LIBELF_STATS_GET(src->es_mapped);
+	dst->es_read		+= LIBELF_STATS_GET(src->es_read);
+	for (t = 0; t < ELF_T_NUM; t++)
+		dst->es_allocated[t] += LIBELF_STATS_GET(src->es_allocated[t]);
+	dst->es_sections	+= LIBELF_STATS_GET(src->es_sections);
+	dst->es_xlate_calls	+= LIBELF_STATS_GET(src->es_xlate_calls);
+	dst->es_xlate_bytes	+= LIBELF_STATS_GET(src->es_xlate_bytes);
+	dst->es_xlate_nsec	+= LIBELF_STATS_GET(src->es_xlate_nsec);
+	dst->es_updates		+= LIBELF_STATS_GET(src->es_updates);
+	dst->es_update_extents	+= LIBELF_STATS_GET(src->es_update_extents);
+	dst->es_update_bytes	+= LIBELF_STATS_GET(src->es_update_bytes);
+}
+
+/*
+ * The process-wide counters are the sum of those of the live
+ * descriptors and of the totals of the descriptors released so far,
+ * so that updating a counter only touches its descriptor.
+ */
+void
+_libelf_stats_link(Elf *e)
+{
+	(void) pthread_mutex_lock(&LIBELF_PRIVATE(stats_mutex));
+	LIST_INSERT_HEAD(&LIBELF_PRIVATE(descriptors), e, e_live);
+	(void) pthread_mutex_unlock(&LIBELF_PRIVATE(stats_mutex));
+}
+
+void
+_libelf_stats_unlink(Elf *e)
+{
+	(void) pthread_mutex_lock(&LIBELF_PRIVATE(stats_mutex));
+	LIST_REMOVE(e, e_live);
+	_libelf_stats_sum(&LIBELF_PRIVATE(stats), &e->e_stats);
+	(void) pthread_mutex_unlock(&LIBELF_PRIVATE(stats_mutex));
+}
+
+int
+elf_getstats(Elf *e, Elf_Stats *dst)
+{
+	size_t sz;
+	Elf *le;
+	Elf_Stats st;
+
+	assert(ELF_T_NUM <= ELF_STATS_NTYPES);
+
+	if (dst == NULL || dst->es_size < sizeof(dst->es_size)) {
+		LIBELF_SET_ERROR(ARGUMENT, 0);
+		return (-1);
+	}
+
+	(void) memset(&st, 0, sizeof(st));
+
+	if (e != NULL)
+		_libelf_stats_sum(&st, &e->e_stats);
+	else {
+		(void) pthread_mutex_lock(&LIBELF_PRIVATE(stats_mutex));
+		_libelf_stats_sum(&st, &LIBELF_PRIVATE(stats));
+		LIST_FOREACH(le, &LIBELF_PRIVATE(descriptors), e_live)
+			_libelf_stats_sum(&st, &le->e_stats);
+		(void) pthread_mutex_unlock(&LIBELF_PRIVATE(stats_mutex));
+	}
+
+	/*
+	 * Only return as much of the structure as the caller knows
+	 * about.
+	 */
+	sz = dst->es_size < sizeof(st) ? dst->es_size : sizeof(st);
+	st.es_size = sz;
+	(void) memcpy(dst, &st, sz);
+
+	return (0);
+}
@@ -27,6 +27,7 @@
 #include <sys/cdefs.h>
 
 #include <libelf.h>
+#include <stdint.h>
 
 #include "_libelf.h"
 
@@ -56,3 +57,21 @@ elf_hash(const char *name)
 
 	return (h);
 }
+
+/*
+ * This hash function is used by the GNU hash section (SHT_GNU_HASH).
+ */
+
+unsigned long
+elf_gnu_hash(const char *name)
+{
+	uint32_t h;
+	const unsigned char *s;
+
+	s = (const unsigned char *) name;
+
+	for (h = 5381; *s != '\0'; s++)
+		h = (h << 5) + h + *s;
+
+	return (h);
+}
@@ -37,7 +37,7 @@ ELFTC_VCSID("$Id$");
 Elf *
 elf_memory(char *image, size_t sz)
 {
-	if (LIBELF_PRIVATE(version) == EV_NONE) {
+	if (LIBELF_GET_PRIVATE(version) == EV_NONE) {
 		LIBELF_SET_ERROR(SEQUENCE, 0);
 		return (NULL);
 	}
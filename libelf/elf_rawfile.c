@@ -43,6 +43,8 @@ elf_rawfile(Elf *e, size_t *sz)
 
 	if (e == NULL)
 		LIBELF_SET_ERROR(ARGUMENT, 0);
+	else if (!_libelf_lazy_load(e))
+		e = NULL;
 	else if ((ptr = e->e_rawfile) == NULL && e->e_cmd == ELF_C_WRITE)
 		LIBELF_SET_ERROR(SEQUENCE, 0);
 
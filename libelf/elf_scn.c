@@ -42,24 +42,60 @@ ELFTC_VCSID("$Id$");
 /*@ELFTC-DOWNSTREAM-VCSID@*/
 
 /*
- * Load an ELF section table and create a list of Elf_Scn structures.
+ * The section headers of an existing object are read in on demand, in
+ * chunks of LIBELF_SCN_CHUNK consecutive sections.  An application
+ * that looks up a few sections of an object with a large number of
+ * sections thus only pays for translating the headers it needs.
+ * Chunks may be read in any order; the section list is kept sorted
+ * by section index.
  */
-int
-_libelf_load_section_headers(Elf *e, void *ehdr)
+#define	LIBELF_SCN_CHUNK	1024
+
+/*
+ * Return the index one past the last section in chunk `c'.
+ */
+static size_t
+_libelf_scn_chunk_end(Elf *e, size_t c)
 {
-	Elf_Scn *scn;
-	uint64_t shoff;
+	size_t end;
+
+	end = (c + 1) * LIBELF_SCN_CHUNK;
+
+	return (end < e->e_u.e_elf.e_nscn ? end : e->e_u.e_elf.e_nscn);
+}
+
+/*
+ * Return non-zero if the sections in chunk `c' have been read in.
+ * Section #0 may have been read in ahead of the rest of its chunk, so
+ * the last section of the chunk is checked.
+ */
+static int
+_libelf_scn_chunk_loaded(Elf *e, size_t c)
+{
+	size_t last;
+
+	last = _libelf_scn_chunk_end(e, c) - 1;
+
+	return (last < e->e_u.e_elf.e_scntabsz &&
+	    e->e_u.e_elf.e_scntab[last] != NULL);
+}
+
+/*
+ * Read in the section headers in chunk `c' and create section
+ * descriptors for them.
+ */
+static int
+_libelf_load_scn_chunk(Elf *e, void *ehdr, size_t c)
+{
+	Elf_Scn *prev, *scn;
+	uint64_t shoff, t0;
 	Elf32_Ehdr *eh32;
 	Elf64_Ehdr *eh64;
 	int ec, swapbytes;
-	unsigned char *src;
-	size_t fsz, i, shnum;
+	unsigned char *buf, *src;
+	size_t end, fsz, i, k, shnum;
 	_libelf_translator_function *xlator;
 
-	assert(e != NULL);
-	assert(ehdr != NULL);
-	assert((e->e_flags & LIBELF_F_SHDRS_LOADED) == 0);
-
 #define	CHECK_EHDR(E,EH)	do {				\
 		uintmax_t rawsize = (uintmax_t) e->e_rawsize;	\
 		if (shoff > (uintmax_t) e->e_rawsize ||		\
@@ -91,25 +127,52 @@ _libelf_load_section_headers(Elf *e, void *ehdr)
 	    _libelf_elfmachine(e));
 
 	swapbytes = e->e_byteorder != LIBELF_PRIVATE(byteorder);
-	src = e->e_rawfile + shoff;
 
 	/*
-	 * If the file is using extended numbering then section #0
-	 * would have already been read in.
+	 * Find the section that the new descriptors go after.  If the
+	 * file is using extended numbering then section #0 would have
+	 * already been read in.
 	 */
+	prev = NULL;
+	for (k = c; k > 0; k--)
+		if (_libelf_scn_chunk_loaded(e, k - 1)) {
+			prev = e->e_u.e_elf.e_scntab[
+			    _libelf_scn_chunk_end(e, k - 1) - 1];
+			break;
+		}
+	if (prev == NULL && e->e_u.e_elf.e_scntabsz > 0)
+		prev = e->e_u.e_elf.e_scntab[0];
 
-	i = 0;
-	if (!STAILQ_EMPTY(&e->e_u.e_elf.e_scn)) {
-		assert(STAILQ_FIRST(&e->e_u.e_elf.e_scn) ==
-		    STAILQ_LAST(&e->e_u.e_elf.e_scn, _Elf_Scn, s_next));
+	i = c * LIBELF_SCN_CHUNK;
+	end = _libelf_scn_chunk_end(e, c);
 
+	if (i == 0 && prev != NULL) {
+		assert(prev->s_ndx == SHN_UNDEF);
 		i = 1;
-		src += fsz;
 	}
 
-	for (; i < shnum; i++, src += fsz) {
-		if ((scn = _libelf_allocate_scn(e, i)) == NULL)
-			return (0);
+	if (i >= end)
+		return (1);
+
+	if ((src = _libelf_rawbytes(e, shoff + i * fsz, (end - i) * fsz,
+	    &buf)) == NULL)
+		return (0);
+
+	if ((scn = _libelf_allocate_scn_block(e, prev, i, end - i)) ==
+	    NULL) {
+		free(buf);
+		return (0);
+	}
+
+	LIBELF_STATS_ADD(e, es_allocated[ELF_T_SHDR],
+	    (end - i) * sizeof(scn->s_shdr));
+	LIBELF_STATS_ADD(e, es_sections, end - i);
+	LIBELF_STATS_ADD(e, es_xlate_calls, end - i);
+	LIBELF_STATS_ADD(e, es_xlate_bytes, (end - i) * fsz);
+
+	t0 = _libelf_stats_clock();
+	for (; i < end; i++, scn++, src += fsz) {
+		assert(scn->s_ndx == i);
 
 		(*xlator)((unsigned char *) &scn->s_shdr, sizeof(scn->s_shdr),
 		    src, (size_t) 1, swapbytes);
@@ -125,11 +188,49 @@ _libelf_load_section_headers(Elf *e, void *ehdr)
 		}
 	}
 
+	LIBELF_STATS_ADD(e, es_xlate_nsec, _libelf_stats_clock() - t0);
+
+	free(buf);
+
+	return (1);
+}
+
+/*
+ * Read in the section headers that have not been read in yet.  This
+ * is needed before sections are added or the object is laid out.
+ */
+int
+_libelf_load_section_headers(Elf *e, void *ehdr)
+{
+	size_t c, nchunks;
+
+	assert(e != NULL);
+	assert(ehdr != NULL);
+	assert((e->e_flags & LIBELF_F_SHDRS_LOADED) == 0);
+
+	nchunks = (e->e_u.e_elf.e_nscn + LIBELF_SCN_CHUNK - 1) /
+	    LIBELF_SCN_CHUNK;
+
+	for (c = 0; c < nchunks; c++)
+		if (!_libelf_scn_chunk_loaded(e, c) &&
+		    _libelf_load_scn_chunk(e, ehdr, c) == 0)
+			return (0);
+
 	e->e_flags |= LIBELF_F_SHDRS_LOADED;
 
 	return (1);
 }
 
+/*
+ * Return non-zero if some section headers of `e' may not have been
+ * read in yet.
+ */
+static int
+_libelf_scn_partial(Elf *e)
+{
+	return (e->e_cmd != ELF_C_WRITE &&
+	    (e->e_flags & LIBELF_F_SHDRS_LOADED) == 0);
+}
 
 Elf_Scn *
 elf_getscn(Elf *e, size_t index)
@@ -147,14 +248,18 @@ elf_getscn(Elf *e, size_t index)
 	if ((ehdr = _libelf_ehdr(e, ec, 0)) == NULL)
 		return (NULL);
 
-	if (e->e_cmd != ELF_C_WRITE &&
-	    (e->e_flags & LIBELF_F_SHDRS_LOADED) == 0 &&
-	    _libelf_load_section_headers(e, ehdr) == 0)
-		return (NULL);
+	if (index < e->e_u.e_elf.e_scntabsz &&
+	    (s = e->e_u.e_elf.e_scntab[index]) != NULL)
+		return (s);
 
-	STAILQ_FOREACH(s, &e->e_u.e_elf.e_scn, s_next)
-		if (s->s_ndx == index)
-			return (s);
+	if (_libelf_scn_partial(e) && index < e->e_u.e_elf.e_nscn) {
+		if (_libelf_load_scn_chunk(e, ehdr,
+		    index / LIBELF_SCN_CHUNK) == 0)
+			return (NULL);
+		s = e->e_u.e_elf.e_scntab[index];
+		assert(s != NULL);
+		return (s);
+	}
 
 	LIBELF_SET_ERROR(ARGUMENT, 0);
 	return (NULL);
@@ -205,6 +310,9 @@ elf_newscn(Elf *e)
 	    _libelf_load_section_headers(e, ehdr) == 0)
 		return (NULL);
 
+	_libelf_release_dynsym(e);
+	_libelf_release_scnname(e);
+
 	if (STAILQ_EMPTY(&e->e_u.e_elf.e_scn)) {
 		assert(e->e_u.e_elf.e_nscn == 0);
 		if ((scn = _libelf_allocate_scn(e, (size_t) SHN_UNDEF)) ==
@@ -234,6 +342,13 @@ elf_nextscn(Elf *e, Elf_Scn *s)
 		return (NULL);
 	}
 
-	return (s == NULL ? elf_getscn(e, (size_t) 1) :
-	    STAILQ_NEXT(s, s_next));
+	if (s == NULL)
+		return (elf_getscn(e, (size_t) 1));
+
+	/* The next section may not have been read in yet. */
+	if (_libelf_scn_partial(e))
+		return (s->s_ndx + 1 < e->e_u.e_elf.e_nscn ?
+		    elf_getscn(e, s->s_ndx + 1) : NULL);
+
+	return (STAILQ_NEXT(s, s_next));
 }
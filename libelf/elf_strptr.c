@@ -36,6 +36,27 @@ ELFTC_VCSID("$Id$");
 
 /*@ELFTC-DOWNSTREAM-VCSID@*/
 
+/*
+ * Remember the data descriptor for a string table section that has
+ * exactly one, so that subsequent lookups need only a bounds check.
+ * The cache is cleared when the section or its data descriptors are
+ * changed using the API.
+ */
+static char *
+_libelf_strptr_cache(Elf_Scn *s, Elf_Data *d, uint64_t size, char *p)
+{
+	struct _Libelf_Data *ld;
+
+	ld = (struct _Libelf_Data *) d;
+	if (STAILQ_FIRST(&s->s_data) == ld &&
+	    STAILQ_NEXT(ld, d_next) == NULL) {
+		s->s_strdata = ld;
+		s->s_strsize = size;
+	}
+
+	return (p);
+}
+
 /*
  * Convert an ELF section#,offset pair to a string pointer.
  */
@@ -46,13 +67,23 @@ elf_strptr(Elf *e, size_t scndx, size_t offset)
 	Elf_Scn *s;
 	Elf_Data *d;
 	GElf_Shdr shdr;
-	uint64_t alignment, count;
+	uint64_t alignment, base, count;
 
 	if (e == NULL || e->e_kind != ELF_K_ELF) {
 		LIBELF_SET_ERROR(ARGUMENT, 0);
 		return (NULL);
 	}
 
+	if (scndx < e->e_u.e_elf.e_scntabsz &&
+	    (s = e->e_u.e_elf.e_scntab[scndx]) != NULL &&
+	    s->s_strdata != NULL) {
+		d = &s->s_strdata->d_data;
+		base = (e->e_flags & ELF_F_LAYOUT) ? d->d_off : 0;
+		if (offset < s->s_strsize && offset >= base &&
+		    offset - base < d->d_size && d->d_buf != NULL)
+			return ((char *) d->d_buf + (offset - base));
+	}
+
 	if ((s = elf_getscn(e, scndx)) == NULL ||
 	    gelf_getshdr(s, &shdr) == NULL)
 		return (NULL);
@@ -84,7 +115,9 @@ elf_strptr(Elf *e, size_t scndx, size_t offset)
 
 			if (offset >= d->d_off &&
 			    offset < d->d_off + d->d_size)
-				return ((char *) d->d_buf + offset - d->d_off);
+				return (_libelf_strptr_cache(s, d,
+				    shdr.sh_size, (char *) d->d_buf +
+				    offset - d->d_off));
 		}
 	} else {
 		/*
@@ -120,8 +153,9 @@ elf_strptr(Elf *e, size_t scndx, size_t offset)
 
 			if (offset < count + d->d_size) {
 				if (d->d_buf != NULL)
-					return ((char *) d->d_buf +
-					    offset - count);
+					return (_libelf_strptr_cache(s, d,
+					    shdr.sh_size, (char *) d->d_buf +
+					    offset - count));
 				LIBELF_SET_ERROR(DATA, 0);
 				return (NULL);
 			}
@@ -38,6 +38,7 @@ define(`ELF_TYPE_LIST',
 	``ADDR,		Addr',
 	`BYTE,		Byte',
 	`CAP,		Cap',
+	`CHDR,		Chdr',
 	`DYN,		Dyn',
 	`EHDR,		Ehdr',
 	`GNUHASH,	-',
@@ -88,6 +89,19 @@ DEFINE_STRUCT(`Elf64_Cap',
 	`c_un.c_val,	XWORD',
 	`_,_'')
 
+DEFINE_STRUCT(`Elf32_Chdr',
+	``ch_type,	WORD',
+	`ch_size,	WORD',
+	`ch_addralign,	WORD',
+	`_,_'')
+
+DEFINE_STRUCT(`Elf64_Chdr',
+	``ch_type,	WORD',
+	`ch_reserved,	WORD',
+	`ch_size,	XWORD',
+	`ch_addralign,	XWORD',
+	`_,_'')
+
 DEFINE_STRUCT(`Elf32_Dyn',
 	``d_tag,	SWORD',
 	`d_un.d_ptr,	WORD',
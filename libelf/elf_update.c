@@ -106,89 +106,23 @@ struct _Elf_Extent {
 SLIST_HEAD(_Elf_Extent_List, _Elf_Extent);
 
 /*
- * Compute the extents of a section, by looking at the data
- * descriptors associated with it.  The function returns 1
- * if successful, or zero if an error was detected.
+ * Lay out the data descriptors of a section, and compute the size and
+ * alignment of the section's contents.  The function returns 1 if
+ * successful, or zero if an error was detected.
  */
 static int
-_libelf_compute_section_extents(Elf *e, Elf_Scn *s, off_t rc)
+_libelf_layout_section_data(Elf *e, Elf_Scn *s, uint64_t *size,
+    uint64_t *alignment)
 {
 	Elf_Data *d;
 	size_t fsz, msz;
-	int ec, elftype;
-	uint32_t sh_type;
+	int ec;
 	uint64_t d_align;
-	Elf32_Shdr *shdr32;
-	Elf64_Shdr *shdr64;
 	struct _Libelf_Data *ld;
 	uint64_t scn_size, scn_alignment;
-	uint64_t sh_align, sh_entsize, sh_offset, sh_size;
 
 	ec = e->e_class;
 
-	shdr32 = &s->s_shdr.s_shdr32;
-	shdr64 = &s->s_shdr.s_shdr64;
-	if (ec == ELFCLASS32) {
-		sh_type    = shdr32->sh_type;
-		sh_align   = (uint64_t) shdr32->sh_addralign;
-		sh_entsize = (uint64_t) shdr32->sh_entsize;
-		sh_offset  = (uint64_t) shdr32->sh_offset;
-		sh_size    = (uint64_t) shdr32->sh_size;
-	} else {
-		sh_type    = shdr64->sh_type;
-		sh_align   = shdr64->sh_addralign;
-		sh_entsize = shdr64->sh_entsize;
-		sh_offset  = shdr64->sh_offset;
-		sh_size    = shdr64->sh_size;
-	}
-
-	assert(sh_type != SHT_NULL && sh_type != SHT_NOBITS);
-
-	elftype = _libelf_xlate_shtype(sh_type);
-	if (elftype < ELF_T_FIRST || elftype > ELF_T_LAST) {
-		LIBELF_SET_ERROR(SECTION, 0);
-		return (0);
-	}
-
-	if (sh_align == 0)
-		sh_align = _libelf_falign(elftype, ec);
-
-	/*
-	 * Compute the section's size and alignment using the data
-	 * descriptors associated with the section.
-	 */
-	if (STAILQ_EMPTY(&s->s_data)) {
-		/*
-		 * The section's content (if any) has not been read in
-		 * yet.  If section is not dirty marked dirty, we can
-		 * reuse the values in the 'sh_size' and 'sh_offset'
-		 * fields of the section header.
-		 */
-		if ((s->s_flags & ELF_F_DIRTY) == 0) {
-			/*
-			 * If the library is doing the layout, then we
-			 * compute the new start offset for the
-			 * section based on the current offset and the
-			 * section's alignment needs.
-			 *
-			 * If the application is doing the layout, we
-			 * can use the value in the 'sh_offset' field
-			 * in the section header directly.
-			 */
-			if (e->e_flags & ELF_F_LAYOUT)
-				goto updatedescriptor;
-			else
-				goto computeoffset;
-		}
-
-		/*
-		 * Otherwise, we need to bring in the section's data
-		 * from the underlying ELF object.
-		 */
-		if (e->e_cmd != ELF_C_WRITE && elf_getdata(s, NULL) == NULL)
-			return (0);
-	}
-
 	/*
 	 * Loop through the section's data descriptors.
 	 */
@@ -273,7 +207,109 @@ _libelf_compute_section_extents(Elf *e, Elf_Scn *s, off_t rc)
 			scn_alignment = d_align;
 	}
 
+	*size = scn_size;
+	*alignment = scn_alignment;
+
+	return (1);
+}
+
+/*
+ * Compute the extents of a section, by looking at the data
+ * descriptors associated with it.  The function returns 1
+ * if successful, or zero if an error was detected.
+ */
+static int
+_libelf_compute_section_extents(Elf *e, Elf_Scn *s, off_t rc)
+{
+	int ec, elftype;
+	uint32_t sh_type;
+	Elf32_Shdr *shdr32;
+	Elf64_Shdr *shdr64;
+	uint64_t scn_size, scn_alignment;
+	uint64_t sh_align, sh_entsize, sh_offset, sh_size;
+
+	ec = e->e_class;
+
+	shdr32 = &s->s_shdr.s_shdr32;
+	shdr64 = &s->s_shdr.s_shdr64;
+	if (ec == ELFCLASS32) {
+		sh_type    = shdr32->sh_type;
+		sh_align   = (uint64_t) shdr32->sh_addralign;
+		sh_entsize = (uint64_t) shdr32->sh_entsize;
+		sh_offset  = (uint64_t) shdr32->sh_offset;
+		sh_size    = (uint64_t) shdr32->sh_size;
+	} else {
+		sh_type    = shdr64->sh_type;
+		sh_align   = shdr64->sh_addralign;
+		sh_entsize = shdr64->sh_entsize;
+		sh_offset  = shdr64->sh_offset;
+		sh_size    = shdr64->sh_size;
+	}
+
+	assert(sh_type != SHT_NULL && sh_type != SHT_NOBITS);
+
+	elftype = _libelf_xlate_shtype(sh_type);
+	if (elftype < ELF_T_FIRST || elftype > ELF_T_LAST) {
+		LIBELF_SET_ERROR(SECTION, 0);
+		return (0);
+	}
+
+	if (sh_align == 0)
+		sh_align = _libelf_falign(elftype, ec);
+
+	/*
+	 * The contents of a section compressed by
+	 * _libelf_compress_sections() start with a compression header,
+	 * which determines the section's alignment.
+	 */
+	if (s->s_zbuf != NULL) {
+		scn_size = s->s_zsize;
+		scn_alignment = _libelf_falign(ELF_T_CHDR, ec);
+		if ((e->e_flags & ELF_F_LAYOUT) == 0)
+			sh_align = scn_alignment;
+		goto checklayout;
+	}
+
+	/*
+	 * Compute the section's size and alignment using the data
+	 * descriptors associated with the section.
+	 */
+	if (STAILQ_EMPTY(&s->s_data)) {
+		/*
+		 * The section's content (if any) has not been read in
+		 * yet.  If section is not dirty marked dirty, we can
+		 * reuse the values in the 'sh_size' and 'sh_offset'
+		 * fields of the section header.
+		 */
+		if ((s->s_flags & ELF_F_DIRTY) == 0) {
+			/*
+			 * If the library is doing the layout, then we
+			 * compute the new start offset for the
+			 * section based on the current offset and the
+			 * section's alignment needs.
+			 *
+			 * If the application is doing the layout, we
+			 * can use the value in the 'sh_offset' field
+			 * in the section header directly.
+			 */
+			if (e->e_flags & ELF_F_LAYOUT)
+				goto updatedescriptor;
+			else
+				goto computeoffset;
+		}
+
+		/*
+		 * Otherwise, we need to bring in the section's data
+		 * from the underlying ELF object.
+		 */
+		if (e->e_cmd != ELF_C_WRITE && elf_getdata(s, NULL) == NULL)
+			return (0);
+	}
+
+	if (!_libelf_layout_section_data(e, s, &scn_size, &scn_alignment))
+		return (0);
 
+checklayout:
 	/*
 	 * If the application is requesting full control over the
 	 * layout of the section, check the section's specified size,
@@ -444,6 +480,139 @@ _libelf_insert_extent(struct _Elf_Extent_List *extents, int type,
 	return (1);
 }
 
+static int
+_libelf_compress_job(void *arg, size_t i)
+{
+	return (_libelf_compress_scn(((Elf_Scn **) arg)[i]));
+}
+
+/*
+ * Compress the contents of the sections marked by elf_compress(3).
+ * Sections are independent of each other, and are compressed in
+ * parallel.
+ *
+ * The compressed contents of a section are kept until the section or
+ * one of its data descriptors is next flagged dirty, so that a call
+ * to elf_update(ELF_C_NULL) followed by one to elf_update(ELF_C_WRITE)
+ * compresses each section only once.
+ *
+ * A section whose size would not be reduced by compression is written
+ * out uncompressed, unless the application asked for it to be
+ * compressed regardless.
+ */
+static int
+_libelf_compress_sections(Elf *e)
+{
+	int ec;
+	Elf_Scn *s, **scns;
+	Elf_Data *d;
+	size_t fsz, msz, n;
+	uint32_t sh_type;
+	uint64_t align, size;
+	struct _Libelf_Data *ld;
+
+	ec = e->e_class;
+
+	n = 0;
+	STAILQ_FOREACH(s, &e->e_u.e_elf.e_scn, s_next) {
+		if (ec == ELFCLASS32)
+			sh_type = s->s_shdr.s_shdr32.sh_type;
+		else
+			sh_type = s->s_shdr.s_shdr64.sh_type;
+
+		if (s->s_ctype == 0 || sh_type == SHT_NOBITS ||
+		    sh_type == SHT_NULL) {
+			_libelf_release_zbuf(s);
+			continue;
+		}
+
+		if (s->s_zbuf == NULL)
+			n++;
+	}
+
+	if (n == 0)
+		return (1);
+
+	if ((scns = malloc(n * sizeof(*scns))) == NULL) {
+		LIBELF_SET_ERROR(RESOURCE, errno);
+		return (0);
+	}
+
+	n = 0;
+	STAILQ_FOREACH(s, &e->e_u.e_elf.e_scn, s_next) {
+		if (ec == ELFCLASS32)
+			sh_type = s->s_shdr.s_shdr32.sh_type;
+		else
+			sh_type = s->s_shdr.s_shdr64.sh_type;
+
+		if (s->s_ctype == 0 || sh_type == SHT_NOBITS ||
+		    sh_type == SHT_NULL || s->s_zbuf != NULL)
+			continue;
+
+		if (STAILQ_EMPTY(&s->s_data) && LIBELF_HAS_RAWFILE(e) &&
+		    elf_getdata(s, NULL) == NULL)
+			goto error;
+
+		if (!_libelf_layout_section_data(e, s, &size, &align))
+			goto error;
+
+		/*
+		 * Compute the size of the file representation of the
+		 * section's data.
+		 */
+		size = 0;
+		STAILQ_FOREACH(ld, &s->s_data, d_next) {
+			d = &ld->d_data;
+			msz = _libelf_msize(d->d_type, ec, e->e_version);
+			fsz = _libelf_fsize(d->d_type, ec, e->e_version,
+			    (size_t) d->d_size / msz);
+			if (d->d_off + fsz > size)
+				size = d->d_off + fsz;
+		}
+
+		s->s_chdr.ch_type      = (Elf64_Word) s->s_ctype;
+		s->s_chdr.ch_reserved  = 0;
+		s->s_chdr.ch_size      = size;
+		s->s_chdr.ch_addralign = align > 0 ? align : 1;
+
+		scns[n++] = s;
+	}
+
+	if (!_libelf_parallel(n, _libelf_compress_job, scns))
+		goto error;
+
+	/*
+	 * Revert the sections that were not worth compressing.
+	 */
+	while (n > 0) {
+		s = scns[--n];
+		if (s->s_zbuf != NULL)
+			continue;
+
+		align = s->s_chdr.ch_addralign;
+		s->s_ctype = 0;
+		s->s_cflags = 0;
+		s->s_chdr.ch_type = 0;
+
+		if (ec == ELFCLASS32) {
+			s->s_shdr.s_shdr32.sh_flags &= ~(uint32_t)
+			    SHF_COMPRESSED;
+			s->s_shdr.s_shdr32.sh_addralign = (uint32_t) align;
+		} else {
+			s->s_shdr.s_shdr64.sh_flags &= ~(uint64_t)
+			    SHF_COMPRESSED;
+			s->s_shdr.s_shdr64.sh_addralign = align;
+		}
+	}
+
+	free(scns);
+	return (1);
+
+error:
+	free(scns);
+	return (0);
+}
+
 /*
  * Recompute section layout.
  */
@@ -457,6 +626,9 @@ _libelf_resync_sections(Elf *e, off_t rc, struct _Elf_Extent_List *extents)
 
 	ec = e->e_class;
 
+	if (!_libelf_compress_sections(e))
+		return ((off_t) -1);
+
 	/*
 	 * Make a pass through sections, computing the extent of each
 	 * section.
@@ -715,26 +887,422 @@ _libelf_resync_elf(Elf *e, struct _Elf_Extent_List *extents)
 }
 
 /*
- * Write out the contents of an ELF section.
+ * Output state used by _libelf_write_elf().
+ *
+ * The new image of an ELF object is either assembled in a buffer
+ * holding the whole file (`o_image'), or streamed out to the file
+ * one extent at a time.  When streaming, translated data and small
+ * pieces of content are staged in the bounce buffer `o_buf', which
+ * holds the `o_len' bytes of content starting at file offset `o_off'.
+ *
+ * If `o_diff' is set, the object is being updated in place and the
+ * streamed content is compared against the current file image in
+ * `e_rawfile'.  Only the byte ranges that differ are written out.
  */
+struct _Elf_Output {
+	Elf		*o_elf;		/* The ELF object being written. */
+	unsigned char	*o_image;	/* Image of the file, if any. */
+	unsigned char	*o_buf;		/* Bounce buffer. */
+	size_t		o_bufsz;	/* Size of the bounce buffer. */
+	size_t		o_len;		/* Bytes staged in the buffer. */
+	off_t		o_off;		/* File offset of staged bytes. */
+	int		o_diff;		/* Only write out changes. */
+};
 
-static off_t
-_libelf_write_scn(Elf *e, unsigned char *nf, struct _Elf_Extent *ex)
+#define	LIBELF_OUTPUT_BUFSZ	(64 * 1024)
+
+/*
+ * Write out `sz' bytes at offset `off' of the underlying file.
+ */
+static int
+_libelf_output_pwrite(Elf *e, const unsigned char *buf, size_t sz,
+    off_t off)
 {
-	off_t rc;
-	int ec, em;
-	Elf_Scn *s;
-	int elftype;
-	Elf_Data *d, dst;
-	uint32_t sh_type;
-	struct _Libelf_Data *ld;
-	uint64_t sh_off, sh_size;
-	size_t fsz, msz, nobjects;
+	ssize_t n;
+
+	while (sz > 0) {
+		if ((n = pwrite(e->e_fd, buf, sz, off)) <= 0) {
+			if (n < 0 && errno == EINTR)
+				continue;
+			LIBELF_SET_ERROR(IO, n < 0 ? errno : 0);
+			return (-1);
+		}
 
-	assert(ex->ex_type == ELF_EXTENT_SECTION);
+		LIBELF_STATS_ADD(e, es_update_bytes, n);
 
-	s = ex->ex_desc;
-	rc = (off_t) ex->ex_start;
+		buf += n;
+		sz  -= (size_t) n;
+		off += (off_t) n;
+	}
+
+	return (0);
+}
+
+/*
+ * Write out those parts of the `n' bytes of content in `buf' that
+ * differ from the current content `cur' at offset `off' of the file.
+ * Returns 1 if anything was written out, 0 if nothing needed to be
+ * written, and -1 on error.
+ */
+static int
+_libelf_output_delta(Elf *e, const unsigned char *cur,
+    const unsigned char *buf, size_t n, off_t off)
+{
+	size_t hi, lo;
+
+	if (memcmp(cur, buf, n) == 0)
+		return (0);
+
+	for (lo = 0; cur[lo] == buf[lo]; lo++)
+		;
+	for (hi = n; cur[hi - 1] == buf[hi - 1]; hi--)
+		;
+
+	if (_libelf_output_pwrite(e, buf + lo, hi - lo, off + (off_t) lo) < 0)
+		return (-1);
+
+	return (1);
+}
+
+/*
+ * Bring the `sz' bytes at offset `off' of the underlying file up to
+ * date with the content in `buf', writing out only those parts that
+ * differ from the current file image.  The file image is updated to
+ * match.
+ */
+static int
+_libelf_output_update(struct _Elf_Output *o, const unsigned char *buf,
+    size_t sz, off_t off)
+{
+	int r;
+	size_t n;
+	unsigned char *p;
+
+	p = o->o_elf->e_rawfile + off;
+
+	for (; sz > 0; buf += n, p += n, off += (off_t) n, sz -= n) {
+		n = sz < LIBELF_OUTPUT_BUFSZ ? sz : LIBELF_OUTPUT_BUFSZ;
+
+		if ((r = _libelf_output_delta(o->o_elf, p, buf, n, off)) < 0)
+			return (-1);
+		if (r > 0)
+			(void) memcpy(p, buf, n);
+	}
+
+	return (0);
+}
+
+/*
+ * Write out the contents of the bounce buffer.
+ */
+static int
+_libelf_output_flush(struct _Elf_Output *o)
+{
+	if (o->o_len == 0)
+		return (0);
+
+	if (o->o_diff) {
+		if (_libelf_output_update(o, o->o_buf, o->o_len, o->o_off) < 0)
+			return (-1);
+	} else if (_libelf_output_pwrite(o->o_elf, o->o_buf, o->o_len,
+	    o->o_off) < 0)
+		return (-1);
+
+	o->o_len = 0;
+
+	return (0);
+}
+
+/*
+ * Return a pointer to the space that will hold the `sz' bytes of
+ * content at offset `off' in the new file.  When streaming, content
+ * that is contiguous with the bytes already staged is appended to
+ * the bounce buffer; otherwise the buffer is flushed and reused.
+ */
+static unsigned char *
+_libelf_output_reserve(struct _Elf_Output *o, off_t off, size_t sz)
+{
+	size_t bufsz;
+	unsigned char *p;
+
+	if (o->o_image != NULL)
+		return (o->o_image + off);
+
+	if (o->o_len > 0 && off == o->o_off + (off_t) o->o_len &&
+	    sz <= o->o_bufsz - o->o_len) {
+		p = o->o_buf + o->o_len;
+		o->o_len += sz;
+		return (p);
+	}
+
+	if (_libelf_output_flush(o) < 0)
+		return (NULL);
+
+	if (sz > o->o_bufsz) {
+		bufsz = sz > LIBELF_OUTPUT_BUFSZ ? sz : LIBELF_OUTPUT_BUFSZ;
+		if ((p = realloc(o->o_buf, bufsz)) == NULL) {
+			LIBELF_SET_ERROR(RESOURCE, errno);
+			return (NULL);
+		}
+		o->o_buf = p;
+		o->o_bufsz = bufsz;
+	}
+
+	o->o_off = off;
+	o->o_len = sz;
+
+	return (o->o_buf);
+}
+
+/*
+ * Copy `sz' bytes of file content to offset `off' in the new file.
+ * Large buffers are written out directly when streaming.
+ */
+static int
+_libelf_output_copy(struct _Elf_Output *o, off_t off, const unsigned char *src,
+    size_t sz)
+{
+	unsigned char *p;
+
+	if (o->o_image != NULL) {
+		/*
+		 * When updating a file in place, unmoved content is
+		 * already where it needs to be.
+		 */
+		if (o->o_image + off != src)
+			(void) memcpy(o->o_image + off, src, sz);
+		return (0);
+	}
+
+	/*
+	 * Content that is at its own location in the file image is
+	 * unchanged as far as the library can tell.
+	 */
+	if (o->o_diff && o->o_elf->e_rawfile + off == src)
+		return (0);
+
+	if (sz < LIBELF_OUTPUT_BUFSZ) {
+		if ((p = _libelf_output_reserve(o, off, sz)) == NULL)
+			return (-1);
+		(void) memcpy(p, src, sz);
+		return (0);
+	}
+
+	if (_libelf_output_flush(o) < 0)
+		return (-1);
+
+	if (o->o_diff)
+		return (_libelf_output_update(o, src, sz, off));
+
+	return (_libelf_output_pwrite(o->o_elf, src, sz, off));
+}
+
+/*
+ * Write out the `sz' bytes at offset `off' of the file image.  Content
+ * flagged as modified by the application is written out as is; other
+ * content is compared against the underlying file first.
+ */
+static int
+_libelf_output_sync(struct _Elf_Output *o, off_t off, size_t sz,
+    unsigned int flags)
+{
+	Elf *e;
+	size_t n;
+	ssize_t r;
+	unsigned char *p;
+
+	if (_libelf_output_flush(o) < 0)
+		return (-1);
+
+	e = o->o_elf;
+	p = e->e_rawfile + off;
+
+	if (flags & ELF_F_DIRTY)
+		return (_libelf_output_pwrite(e, p, sz, off));
+
+	if (o->o_bufsz < LIBELF_OUTPUT_BUFSZ) {
+		if ((p = realloc(o->o_buf, LIBELF_OUTPUT_BUFSZ)) == NULL) {
+			LIBELF_SET_ERROR(RESOURCE, errno);
+			return (-1);
+		}
+		o->o_buf = p;
+		o->o_bufsz = LIBELF_OUTPUT_BUFSZ;
+		p = e->e_rawfile + off;
+	}
+
+	for (; sz > 0; p += n, off += (off_t) n, sz -= n) {
+		n = sz < LIBELF_OUTPUT_BUFSZ ? sz : LIBELF_OUTPUT_BUFSZ;
+
+		if ((r = pread(e->e_fd, o->o_buf, n, off)) < 0) {
+			LIBELF_SET_ERROR(IO, errno);
+			return (-1);
+		}
+
+		if ((size_t) r < n) {
+			if (_libelf_output_pwrite(e, p, n, off) < 0)
+				return (-1);
+		} else if (_libelf_output_delta(e, o->o_buf, p, n, off) < 0)
+			return (-1);
+	}
+
+	return (0);
+}
+
+/*
+ * Fill `sz' bytes at offset `off' in the new file with the fill
+ * character set by elf_fill(3).
+ */
+static int
+_libelf_output_fill(struct _Elf_Output *o, off_t off, size_t sz)
+{
+	size_t n;
+	unsigned char *p;
+
+	while (sz > 0) {
+		n = (o->o_image != NULL || sz < LIBELF_OUTPUT_BUFSZ) ? sz :
+		    LIBELF_OUTPUT_BUFSZ;
+		if ((p = _libelf_output_reserve(o, off, n)) == NULL)
+			return (-1);
+		(void) memset(p, LIBELF_GET_PRIVATE(fillchar), n);
+		off += (off_t) n;
+		sz  -= n;
+	}
+
+	return (0);
+}
+
+/*
+ * Translate the contents of data descriptor `src' into the buffer
+ * described by `dst', keeping count of the work done.
+ */
+static int
+_libelf_output_tofile(Elf *e, Elf_Data *dst, const Elf_Data *src)
+{
+	uint64_t t0;
+
+	t0 = _libelf_stats_clock();
+	if (_libelf_xlate(dst, src, e->e_byteorder, e->e_class,
+	    _libelf_elfmachine(e), ELF_TOFILE) == NULL)
+		return (-1);
+
+	LIBELF_STATS_ADD(e, es_xlate_nsec, _libelf_stats_clock() - t0);
+	LIBELF_STATS_ADD(e, es_xlate_calls, 1);
+	LIBELF_STATS_ADD(e, es_xlate_bytes, dst->d_size);
+
+	return (0);
+}
+
+/*
+ * Translate the contents of data descriptor `src' to their file
+ * representation, which takes `fsz' bytes, at offset `off' in the
+ * new file.
+ *
+ * When streaming, data that does not need translation is written out
+ * from the application's buffer, and other data is translated into
+ * the bounce buffer a chunk at a time.  Types whose contents have
+ * internal structure are translated as a whole.
+ */
+static int
+_libelf_output_xlate(struct _Elf_Output *o, off_t off, const Elf_Data *src,
+    size_t fsz)
+{
+	Elf *e;
+	int ec, em;
+	Elf_Data dst, s;
+	size_t n, nobj, msz, ofsz;
+
+	e = o->o_elf;
+	ec = e->e_class;
+	em = _libelf_elfmachine(e);
+
+	(void) memset(&dst, 0, sizeof(dst));
+	dst.d_version = src->d_version;
+
+	if (o->o_image != NULL) {
+		dst.d_buf  = o->o_image + off;
+		dst.d_size = fsz;
+		return (_libelf_output_tofile(e, &dst, src));
+	}
+
+	switch (src->d_type) {
+	case ELF_T_GNUHASH:
+	case ELF_T_NOTE:
+	case ELF_T_VDEF:
+	case ELF_T_VNEED:
+		if ((dst.d_buf = _libelf_output_reserve(o, off, fsz)) == NULL)
+			return (-1);
+		dst.d_size = fsz;
+		return (_libelf_output_tofile(e, &dst, src));
+	default:
+		break;
+	}
+
+	if ((msz = _libelf_msize(src->d_type, ec, e->e_version)) == 0)
+		return (-1);
+	ofsz = _libelf_fsize(src->d_type, ec, e->e_version, (size_t) 1);
+
+	/*
+	 * Data that needs no translation is written out as is.  The
+	 * call to _libelf_xlate() with identical source and destination
+	 * buffers only validates the descriptor.
+	 */
+	if (e->e_byteorder == LIBELF_PRIVATE(byteorder) && ofsz == msz) {
+		dst.d_buf  = src->d_buf;
+		dst.d_size = src->d_size;
+		if (_libelf_xlate(&dst, src, e->e_byteorder, ec, em,
+		    ELF_TOFILE) == NULL)
+			return (-1);
+		return (_libelf_output_copy(o, off, src->d_buf, fsz));
+	}
+
+	s = *src;
+	nobj = (size_t) (src->d_size / msz);
+	while (nobj > 0) {
+		n = LIBELF_OUTPUT_BUFSZ / ofsz;
+		if (n == 0)
+			n = 1;
+		if (n > nobj)
+			n = nobj;
+
+		s.d_size = n * msz;
+		dst.d_size = n * ofsz;
+		if ((dst.d_buf = _libelf_output_reserve(o, off, dst.d_size)) ==
+		    NULL)
+			return (-1);
+		if (_libelf_output_tofile(e, &dst, &s) < 0)
+			return (-1);
+
+		s.d_buf = (unsigned char *) s.d_buf + n * msz;
+		off += (off_t) (n * ofsz);
+		nobj -= n;
+	}
+
+	return (0);
+}
+
+/*
+ * Write out the contents of an ELF section.
+ */
+
+static off_t
+_libelf_write_scn(struct _Elf_Output *o, struct _Elf_Extent *ex)
+{
+	Elf *e;
+	off_t rc;
+	int ec;
+	Elf_Scn *s;
+	int elftype;
+	Elf_Data *d;
+	uint32_t sh_type;
+	struct _Libelf_Data *ld;
+	uint64_t sh_off, sh_size;
+	size_t fsz, msz, nobjects;
+
+	assert(ex->ex_type == ELF_EXTENT_SECTION);
+
+	e = o->o_elf;
+	s = ex->ex_desc;
+	rc = (off_t) ex->ex_start;
 
 	if ((ec = e->e_class) == ELFCLASS32) {
 		sh_type = s->s_shdr.s_shdr32.sh_type;
@@ -756,7 +1324,15 @@ _libelf_write_scn(Elf *e, unsigned char *nf, struct _Elf_Extent *ex)
 	sh_off = s->s_offset;
 	assert(sh_off % _libelf_falign(elftype, ec) == 0);
 
-	em = _libelf_elfmachine(e);
+	/*
+	 * Compressed sections are written out from the buffer set up
+	 * by _libelf_compress_sections().
+	 */
+	if (s->s_zbuf != NULL) {
+		if (_libelf_output_copy(o, rc, s->s_zbuf, s->s_zsize) < 0)
+			return ((off_t) -1);
+		return (rc + (off_t) s->s_zsize);
+	}
 
 	/*
 	 * If the section has a `rawdata' descriptor, and the section
@@ -775,20 +1351,25 @@ _libelf_write_scn(Elf *e, unsigned char *nf, struct _Elf_Extent *ex)
 
 			d = &ld->d_data;
 
-			if ((uint64_t) rc < sh_off + d->d_off)
-				(void) memset(nf + rc,
-				    LIBELF_PRIVATE(fillchar),
-				    (size_t) (sh_off + d->d_off -
-					(uint64_t) rc));
+			if ((uint64_t) rc < sh_off + d->d_off &&
+			    _libelf_output_fill(o, rc, (size_t) (sh_off +
+				d->d_off - (uint64_t) rc)) < 0)
+				return ((off_t) -1);
 			rc = (off_t) (sh_off + d->d_off);
 
 			assert(d->d_buf != NULL);
 			assert(d->d_type == ELF_T_BYTE);
 			assert(d->d_version == e->e_version);
 
-			(void) memcpy(nf + rc,
+			if (o->o_diff &&
+			    ((s->s_flags | ld->d_flags) & ELF_F_DIRTY)) {
+				if (_libelf_output_sync(o, rc,
+				    (size_t) d->d_size, ELF_F_DIRTY) < 0)
+					return ((off_t) -1);
+			} else if (_libelf_output_copy(o, rc,
 			    e->e_rawfile + s->s_rawoff + d->d_off,
-			    (size_t) d->d_size);
+			    (size_t) d->d_size) < 0)
+				return ((off_t) -1);
 
 			rc += (off_t) d->d_size;
 		}
@@ -802,8 +1383,6 @@ _libelf_write_scn(Elf *e, unsigned char *nf, struct _Elf_Extent *ex)
 	 * descriptors for this step.
 	 */
 
-	dst.d_version = e->e_version;
-
 	STAILQ_FOREACH(ld, &s->s_data, d_next) {
 
 		d = &ld->d_data;
@@ -811,10 +1390,10 @@ _libelf_write_scn(Elf *e, unsigned char *nf, struct _Elf_Extent *ex)
 		if ((msz = _libelf_msize(d->d_type, ec, e->e_version)) == 0)
 			return ((off_t) -1);
 
-		if ((uint64_t) rc < sh_off + d->d_off)
-			(void) memset(nf + rc,
-			    LIBELF_PRIVATE(fillchar),
-			    (size_t) (sh_off + d->d_off - (uint64_t) rc));
+		if ((uint64_t) rc < sh_off + d->d_off &&
+		    _libelf_output_fill(o, rc, (size_t) (sh_off + d->d_off -
+			(uint64_t) rc)) < 0)
+			return ((off_t) -1);
 
 		rc = (off_t) (sh_off + d->d_off);
 
@@ -827,11 +1406,17 @@ _libelf_write_scn(Elf *e, unsigned char *nf, struct _Elf_Extent *ex)
 
 		fsz = _libelf_fsize(d->d_type, ec, e->e_version, nobjects);
 
-		dst.d_buf    = nf + rc;
-		dst.d_size   = fsz;
-
-		if (_libelf_xlate(&dst, d, e->e_byteorder, ec, em, ELF_TOFILE)
-		    == NULL)
+		/*
+		 * When only writing out changes, data that was handed out
+		 * in place by elf_getdata() is already part of the file
+		 * image, and can only be checked against the file itself.
+		 */
+		if (o->o_diff &&
+		    (unsigned char *) d->d_buf == e->e_rawfile + rc) {
+			if (_libelf_output_sync(o, rc, fsz,
+			    s->s_flags | ld->d_flags) < 0)
+				return ((off_t) -1);
+		} else if (_libelf_output_xlate(o, rc, d, fsz) < 0)
 			return ((off_t) -1);
 
 		rc += (off_t) fsz;
@@ -845,16 +1430,18 @@ _libelf_write_scn(Elf *e, unsigned char *nf, struct _Elf_Extent *ex)
  */
 
 static off_t
-_libelf_write_ehdr(Elf *e, unsigned char *nf, struct _Elf_Extent *ex)
+_libelf_write_ehdr(struct _Elf_Output *o, struct _Elf_Extent *ex)
 {
-	int ec, em;
+	Elf *e;
+	int ec;
 	void *ehdr;
 	size_t fsz, msz;
-	Elf_Data dst, src;
+	Elf_Data src;
 
 	assert(ex->ex_type == ELF_EXTENT_EHDR);
 	assert(ex->ex_start == 0); /* Ehdr always comes first. */
 
+	e = o->o_elf;
 	ec = e->e_class;
 
 	ehdr = _libelf_ehdr(e, ec, 0);
@@ -864,21 +1451,14 @@ _libelf_write_ehdr(Elf *e, unsigned char *nf, struct _Elf_Extent *ex)
 	if ((msz = _libelf_msize(ELF_T_EHDR, ec, e->e_version)) == 0)
 		return ((off_t) -1);
 
-	em = _libelf_elfmachine(e);
-
-	(void) memset(&dst, 0, sizeof(dst));
 	(void) memset(&src, 0, sizeof(src));
 
 	src.d_buf     = ehdr;
 	src.d_size    = msz;
 	src.d_type    = ELF_T_EHDR;
-	src.d_version = dst.d_version = e->e_version;
+	src.d_version = e->e_version;
 
-	dst.d_buf     = nf;
-	dst.d_size    = fsz;
-
-	if (_libelf_xlate(&dst, &src, e->e_byteorder, ec, em, ELF_TOFILE) ==
-	    NULL)
+	if (_libelf_output_xlate(o, (off_t) 0, &src, fsz) < 0)
 		return ((off_t) -1);
 
 	return ((off_t) fsz);
@@ -889,18 +1469,20 @@ _libelf_write_ehdr(Elf *e, unsigned char *nf, struct _Elf_Extent *ex)
  */
 
 static off_t
-_libelf_write_phdr(Elf *e, unsigned char *nf, struct _Elf_Extent *ex)
+_libelf_write_phdr(struct _Elf_Output *o, struct _Elf_Extent *ex)
 {
-	int ec, em;
+	Elf *e;
+	int ec;
 	void *ehdr;
 	Elf32_Ehdr *eh32;
 	Elf64_Ehdr *eh64;
-	Elf_Data dst, src;
+	Elf_Data src;
 	size_t fsz, msz, phnum;
 	uint64_t phoff;
 
 	assert(ex->ex_type == ELF_EXTENT_PHDR);
 
+	e = o->o_elf;
 	ec = e->e_class;
 
 	ehdr = _libelf_ehdr(e, ec, 0);
@@ -917,13 +1499,10 @@ _libelf_write_phdr(Elf *e, unsigned char *nf, struct _Elf_Extent *ex)
 		phoff = eh64->e_phoff;
 	}
 
-	em = _libelf_elfmachine(e);
-
 	assert(phoff > 0);
 	assert(ex->ex_start == phoff);
 	assert(phoff % _libelf_falign(ELF_T_PHDR, ec) == 0);
 
-	(void) memset(&dst, 0, sizeof(dst));
 	(void) memset(&src, 0, sizeof(src));
 
 	if ((msz = _libelf_msize(ELF_T_PHDR, ec, e->e_version)) == 0)
@@ -932,15 +1511,11 @@ _libelf_write_phdr(Elf *e, unsigned char *nf, struct _Elf_Extent *ex)
 	assert(fsz > 0);
 
 	src.d_buf = _libelf_getphdr(e, ec);
-	src.d_version = dst.d_version = e->e_version;
+	src.d_version = e->e_version;
 	src.d_type = ELF_T_PHDR;
 	src.d_size = phnum * msz;
 
-	dst.d_size = fsz;
-	dst.d_buf = nf + ex->ex_start;
-
-	if (_libelf_xlate(&dst, &src, e->e_byteorder, ec, em, ELF_TOFILE) ==
-	    NULL)
+	if (_libelf_output_xlate(o, (off_t) phoff, &src, fsz) < 0)
 		return ((off_t) -1);
 
 	return ((off_t) (phoff + fsz));
@@ -951,19 +1526,21 @@ _libelf_write_phdr(Elf *e, unsigned char *nf, struct _Elf_Extent *ex)
  */
 
 static off_t
-_libelf_write_shdr(Elf *e, unsigned char *nf, struct _Elf_Extent *ex)
+_libelf_write_shdr(struct _Elf_Output *o, struct _Elf_Extent *ex)
 {
-	int ec, em;
+	Elf *e;
+	int ec;
 	void *ehdr;
 	Elf_Scn *scn;
 	uint64_t shoff;
 	Elf32_Ehdr *eh32;
 	Elf64_Ehdr *eh64;
 	size_t fsz, msz, nscn;
-	Elf_Data dst, src;
+	Elf_Data src;
 
 	assert(ex->ex_type == ELF_EXTENT_SHDR);
 
+	e = o->o_elf;
 	ec = e->e_class;
 
 	ehdr = _libelf_ehdr(e, ec, 0);
@@ -979,13 +1556,10 @@ _libelf_write_shdr(Elf *e, unsigned char *nf, struct _Elf_Extent *ex)
 		shoff = eh64->e_shoff;
 	}
 
-	em = _libelf_elfmachine(e);
-
 	assert(nscn > 0);
 	assert(shoff % _libelf_falign(ELF_T_SHDR, ec) == 0);
 	assert(ex->ex_start == shoff);
 
-	(void) memset(&dst, 0, sizeof(dst));
 	(void) memset(&src, 0, sizeof(src));
 
 	if ((msz = _libelf_msize(ELF_T_SHDR, ec, e->e_version)) == 0)
@@ -993,7 +1567,7 @@ _libelf_write_shdr(Elf *e, unsigned char *nf, struct _Elf_Extent *ex)
 
 	src.d_type = ELF_T_SHDR;
 	src.d_size = msz;
-	src.d_version = dst.d_version = e->e_version;
+	src.d_version = e->e_version;
 
 	fsz = _libelf_fsize(ELF_T_SHDR, ec, e->e_version, (size_t) 1);
 
@@ -1003,17 +1577,185 @@ _libelf_write_shdr(Elf *e, unsigned char *nf, struct _Elf_Extent *ex)
 		else
 			src.d_buf = &scn->s_shdr.s_shdr64;
 
-		dst.d_size = fsz;
-		dst.d_buf = nf + ex->ex_start + scn->s_ndx * fsz;
-
-		if (_libelf_xlate(&dst, &src, e->e_byteorder, ec, em,
-			ELF_TOFILE) == NULL)
+		if (_libelf_output_xlate(o, (off_t) (ex->ex_start +
+		    scn->s_ndx * fsz), &src, fsz) < 0)
 			return ((off_t) -1);
 	}
 
 	return ((off_t) (ex->ex_start + nscn * fsz));
 }
 
+/*
+ * Check if an ELF object opened for update can be updated in place,
+ * without rewriting its file image from scratch.
+ *
+ * This is possible if the size of the file is unchanged, and if every
+ * section whose contents come from the file image has stayed in place.
+ * Data descriptors that point into the image need to be at their
+ * final location, and need no translation.  Since extents do not
+ * overlap, writing out an extent can then not overwrite content that
+ * is yet to be written out.
+ */
+static int
+_libelf_can_update_in_place(Elf *e, off_t newsize,
+    struct _Elf_Extent_List *extents)
+{
+	int ec;
+	Elf_Data *d;
+	Elf_Scn *s;
+	size_t fsz, msz;
+	struct _Elf_Extent *ex;
+	struct _Libelf_Data *ld;
+	uintptr_t db, fb, fe;
+
+	if (e->e_rawfile == NULL || newsize != e->e_rawsize)
+		return (0);
+
+	ec = e->e_class;
+	fb = (uintptr_t) e->e_rawfile;
+	fe = fb + (size_t) e->e_rawsize;
+
+	SLIST_FOREACH(ex, extents, ex_next) {
+		if (ex->ex_type != ELF_EXTENT_SECTION)
+			continue;
+
+		s = ex->ex_desc;
+
+		/* Compressed contents are not taken from the image. */
+		if (s->s_zbuf != NULL)
+			continue;
+
+		if (STAILQ_EMPTY(&s->s_data)) {
+			if (s->s_offset != s->s_rawoff)
+				return (0);
+			continue;
+		}
+
+		STAILQ_FOREACH(ld, &s->s_data, d_next) {
+			d = &ld->d_data;
+
+			db = (uintptr_t) d->d_buf;
+			if (db < fb || db >= fe)
+				continue;
+
+			if (db != fb + s->s_offset + d->d_off)
+				return (0);
+
+			if (d->d_type == ELF_T_BYTE)
+				continue;
+
+			fsz = _libelf_fsize(d->d_type, ec, e->e_version,
+			    (size_t) 1);
+			msz = _libelf_msize(d->d_type, ec, e->e_version);
+			if (e->e_byteorder != LIBELF_PRIVATE(byteorder) ||
+			    fsz != msz)
+				return (0);
+		}
+	}
+
+	return (1);
+}
+
+/*
+ * State shared by the jobs that write out sections in parallel.  Each
+ * job writes out one section extent using its own output state, which
+ * is derived from `wj_out'.
+ */
+struct _Elf_Write_Jobs {
+	const struct _Elf_Output *wj_out;
+	struct _Elf_Extent	**wj_ext;
+	size_t			wj_n;
+};
+
+static int
+_libelf_write_scn_job(void *arg, size_t i)
+{
+	off_t rc;
+	struct _Elf_Extent *ex;
+	struct _Elf_Output out;
+	struct _Elf_Write_Jobs *wj;
+
+	wj = arg;
+	ex = wj->wj_ext[i];
+
+	(void) memset(&out, 0, sizeof(out));
+	out.o_elf = wj->wj_out->o_elf;
+	out.o_image = wj->wj_out->o_image;
+	out.o_diff = wj->wj_out->o_diff;
+
+	if ((rc = _libelf_write_scn(&out, ex)) >= 0 &&
+	    _libelf_output_flush(&out) < 0)
+		rc = (off_t) -1;
+
+	free(out.o_buf);
+
+	assert(rc < 0 || ex->ex_start + ex->ex_size == (uint64_t) rc);
+
+	return (rc >= 0);
+}
+
+/*
+ * Collect the section extents of an ELF object, so that they can be
+ * written out in parallel.  The section extents of an object do not
+ * overlap, and once the layout of the object has been computed they
+ * can be translated and written out independently of each other.
+ *
+ * Sections whose contents are still in the underlying file get their
+ * raw data descriptors here, since allocating these is not safe to do
+ * concurrently.
+ */
+static int
+_libelf_write_jobs_init(Elf *e, struct _Elf_Extent_List *extents,
+    struct _Elf_Write_Jobs *wj)
+{
+	Elf_Scn *s;
+	size_t n;
+	uint32_t sh_type;
+	uint64_t sh_size;
+	struct _Elf_Extent *ex;
+
+	n = 0;
+	SLIST_FOREACH(ex, extents, ex_next)
+		if (ex->ex_type == ELF_EXTENT_SECTION)
+			n++;
+
+	/* There is nothing to be gained for fewer than two sections. */
+	if (n < 2)
+		return (1);
+
+	if ((wj->wj_ext = malloc(n * sizeof(*wj->wj_ext))) == NULL) {
+		LIBELF_SET_ERROR(RESOURCE, errno);
+		return (0);
+	}
+
+	SLIST_FOREACH(ex, extents, ex_next) {
+		if (ex->ex_type != ELF_EXTENT_SECTION)
+			continue;
+
+		s = ex->ex_desc;
+
+		if (e->e_class == ELFCLASS32) {
+			sh_type = s->s_shdr.s_shdr32.sh_type;
+			sh_size = (uint64_t) s->s_shdr.s_shdr32.sh_size;
+		} else {
+			sh_type = s->s_shdr.s_shdr64.sh_type;
+			sh_size = s->s_shdr.s_shdr64.sh_size;
+		}
+
+		if (sh_type != SHT_NOBITS && sh_type != SHT_NULL &&
+		    sh_size > 0 && s->s_zbuf == NULL &&
+		    STAILQ_EMPTY(&s->s_data) && elf_rawdata(s, NULL) == NULL) {
+			free(wj->wj_ext);
+			wj->wj_ext = NULL;
+			return (0);
+		}
+
+		wj->wj_ext[wj->wj_n++] = ex;
+	}
+
+	return (1);
+}
+
 /*
  * Write out the file image.
  *
@@ -1027,8 +1769,32 @@ _libelf_write_shdr(Elf *e, unsigned char *nf, struct _Elf_Extent *ex)
  * in ELF_C_RDWR and only retrieved/modified a few sections.  We take
  * care to avoid translating file sections unnecessarily.
  *
+ * The exception is a file mapped in with ELF_C_RDWR_MMAP whose layout
+ * is unchanged (see _libelf_can_update_in_place() above).  Such files
+ * are updated through their mapping, which is then flushed to disk
+ * using msync(2).  Content outside the file's extents is left as is.
+ * Other files opened with ELF_C_RDWR whose layout is unchanged are
+ * also updated in place: their new content is streamed out, compared
+ * against the current file image, and only the byte ranges that
+ * changed are written to the file.  Content that was handed out in
+ * place by elf_getdata() is written out directly if it has been flagged
+ * with ELF_F_DIRTY, and is compared against the file otherwise.  Raw
+ * section contents are only written out if flagged.
+ *
+ * Objects opened with ELF_C_WRITE have no prior content that could be
+ * overwritten, and the library does not need to retain their image.
+ * If the underlying file is a regular file, the extents of such an
+ * object are streamed to the file in order, so that the memory needed
+ * does not depend on the size of the object.
+ *
  * Gaps in the coverage of the file by the file's sections will be
  * filled with the fill character set by elf_fill(3).
+ *
+ * If the application asked for it using elf_cntl(3), or if the
+ * LIBELF_PARALLEL environment variable is set, the sections of the
+ * object are written out by a pool of threads once the rest of the
+ * object has been written out.  Since every byte of the file is written
+ * out exactly once either way, the resulting file is identical.
  */
 
 static off_t
@@ -1036,44 +1802,83 @@ _libelf_write_elf(Elf *e, off_t newsize, struct _Elf_Extent_List *extents)
 {
 	off_t nrc, rc;
 	Elf_Scn *scn, *tscn;
+	int canupdate, diff, inplace, special, stream;
 	struct _Elf_Extent *ex;
+	struct _Elf_Output out;
+	struct _Elf_Write_Jobs wj;
 	unsigned char *newfile;
+#if	ELFTC_HAVE_MMAP
+	int mapflags;
+#endif
 
 	assert(e->e_kind == ELF_K_ELF);
 	assert(e->e_cmd == ELF_C_RDWR || e->e_cmd == ELF_C_WRITE);
 	assert(e->e_fd >= 0);
 
-	if ((newfile = malloc((size_t) newsize)) == NULL) {
+	newfile = NULL;
+	diff = inplace = stream = 0;
+
+	(void) memset(&out, 0, sizeof(out));
+	(void) memset(&wj, 0, sizeof(wj));
+	if (((e->e_flags & LIBELF_F_PARALLEL) ||
+	    getenv("LIBELF_PARALLEL") != NULL) &&
+	    !_libelf_write_jobs_init(e, extents, &wj))
+		return ((off_t) -1);
+
+	canupdate = _libelf_can_update_in_place(e, newsize, extents);
+	special = (e->e_flags & LIBELF_F_SPECIAL_FILE) != 0;
+
+	if (canupdate && (e->e_flags & LIBELF_F_RAWFILE_SHARED)) {
+		inplace = 1;
+		newfile = e->e_rawfile;
+	} else if (canupdate && !special) {
+		diff = stream = 1;
+	} else if (e->e_cmd == ELF_C_WRITE && !special) {
+		stream = 1;
+		if (ftruncate(e->e_fd, (off_t) 0) < 0) {
+			LIBELF_SET_ERROR(IO, errno);
+			goto error;
+		}
+	} else if ((newfile = malloc((size_t) newsize)) == NULL) {
 		LIBELF_SET_ERROR(RESOURCE, errno);
 		return ((off_t) -1);
 	}
 
+	(void) memset(&out, 0, sizeof(out));
+	out.o_elf = e;
+	out.o_image = newfile;
+	out.o_diff = diff;
+
 	nrc = rc = 0;
 	SLIST_FOREACH(ex, extents, ex_next) {
 
 		/* Fill inter-extent gaps. */
-		if (ex->ex_start > (size_t) rc)
-			(void) memset(newfile + rc, LIBELF_PRIVATE(fillchar),
-			    (size_t) (ex->ex_start - (uint64_t) rc));
+		if (!inplace && ex->ex_start > (size_t) rc &&
+		    _libelf_output_fill(&out, rc, (size_t) (ex->ex_start -
+			(uint64_t) rc)) < 0)
+			goto error;
 
 		switch (ex->ex_type) {
 		case ELF_EXTENT_EHDR:
-			if ((nrc = _libelf_write_ehdr(e, newfile, ex)) < 0)
+			if ((nrc = _libelf_write_ehdr(&out, ex)) < 0)
 				goto error;
 			break;
 
 		case ELF_EXTENT_PHDR:
-			if ((nrc = _libelf_write_phdr(e, newfile, ex)) < 0)
+			if ((nrc = _libelf_write_phdr(&out, ex)) < 0)
 				goto error;
 			break;
 
 		case ELF_EXTENT_SECTION:
-			if ((nrc = _libelf_write_scn(e, newfile, ex)) < 0)
+			/* Sections are written out in parallel below. */
+			if (wj.wj_ext != NULL)
+				nrc = (off_t) (ex->ex_start + ex->ex_size);
+			else if ((nrc = _libelf_write_scn(&out, ex)) < 0)
 				goto error;
 			break;
 
 		case ELF_EXTENT_SHDR:
-			if ((nrc = _libelf_write_shdr(e, newfile, ex)) < 0)
+			if ((nrc = _libelf_write_shdr(&out, ex)) < 0)
 				goto error;
 			break;
 
@@ -1085,11 +1890,45 @@ _libelf_write_elf(Elf *e, off_t newsize, struct _Elf_Extent_List *extents)
 		assert(ex->ex_start + ex->ex_size == (size_t) nrc);
 		assert(rc < nrc);
 
+		LIBELF_STATS_ADD(e, es_update_extents, 1);
+
 		rc = nrc;
 	}
 
 	assert(rc == newsize);
 
+	if (wj.wj_ext != NULL) {
+		wj.wj_out = &out;
+		if (!_libelf_parallel(wj.wj_n, _libelf_write_scn_job, &wj))
+			goto error;
+	}
+
+	/*
+	 * Write out any remaining staged content, and leave the file
+	 * offset at the end of the object as write(2) would have.  Files
+	 * updated in place keep their current file image.
+	 */
+	if (stream) {
+		if (_libelf_output_flush(&out) < 0)
+			goto error;
+		if (lseek(e->e_fd, newsize, SEEK_SET) < 0) {
+			LIBELF_SET_ERROR(IO, errno);
+			goto error;
+		}
+		goto done;
+	}
+
+	if (inplace) {
+		newfile = NULL;
+#if	ELFTC_HAVE_MMAP
+		if (msync(e->e_rawfile, (size_t) newsize, MS_SYNC) < 0) {
+			LIBELF_SET_ERROR(IO, errno);
+			goto error;
+		}
+#endif
+		goto done;
+	}
+
 	/*
 	 * For regular files, throw away existing file content and
 	 * unmap any existing mappings.
@@ -1120,6 +1959,8 @@ _libelf_write_elf(Elf *e, off_t newsize, struct _Elf_Extent_List *extents)
 		goto error;
 	}
 
+	LIBELF_STATS_ADD(e, es_update_bytes, newsize);
+
 	/*
 	 * For files opened in ELF_C_RDWR mode, set up the new 'raw'
 	 * contents.
@@ -1137,12 +1978,15 @@ _libelf_write_elf(Elf *e, off_t newsize, struct _Elf_Extent_List *extents)
 #if	ELFTC_HAVE_MMAP
 		else if (e->e_flags & LIBELF_F_RAWFILE_MMAP) {
 			assert((e->e_flags & LIBELF_F_RAWFILE_MALLOC) == 0);
+			mapflags = (e->e_flags & LIBELF_F_RAWFILE_SHARED) ?
+			    MAP_SHARED : MAP_PRIVATE;
 			if ((e->e_rawfile = mmap(NULL, (size_t) newsize,
-			    PROT_READ, MAP_PRIVATE, e->e_fd, (off_t) 0)) ==
-			    MAP_FAILED) {
+			    PROT_READ | PROT_WRITE, mapflags, e->e_fd,
+			    (off_t) 0)) == MAP_FAILED) {
 				LIBELF_SET_ERROR(IO, errno);
 				goto error;
 			}
+			LIBELF_STATS_ADD(e, es_mapped, newsize);
 		}
 #endif	/* ELFTC_HAVE_MMAP */
 
@@ -1153,16 +1997,18 @@ _libelf_write_elf(Elf *e, off_t newsize, struct _Elf_Extent_List *extents)
 		assert(e->e_rawfile == NULL);
 	}
 
+ done:
 	/*
 	 * Reset flags, remove existing section descriptors and
 	 * {E,P}HDR pointers so that a subsequent elf_get{e,p}hdr()
 	 * and elf_getscn() will function correctly.
 	 */
 
-	e->e_flags &= ~ELF_F_DIRTY;
+	e->e_flags &= ~(ELF_F_DIRTY | LIBELF_F_SHDRS_LOADED);
 
 	STAILQ_FOREACH_SAFE(scn, &e->e_u.e_elf.e_scn, s_next, tscn)
 		_libelf_release_scn(scn);
+	_libelf_release_arena(e);
 
 	if (e->e_class == ELFCLASS32) {
 		free(e->e_u.e_elf.e_ehdr.e_ehdr32);
@@ -1180,14 +2026,19 @@ _libelf_write_elf(Elf *e, off_t newsize, struct _Elf_Extent_List *extents)
 		e->e_u.e_elf.e_phdr.e_phdr64 = NULL;
 	}
 
-	/* Free the temporary buffer. */
+	/* Free the temporary buffers. */
 	if (newfile)
 		free(newfile);
+	free(out.o_buf);
+	free(wj.wj_ext);
 
 	return (rc);
 
  error:
-	free(newfile);
+	if (!inplace)
+		free(newfile);
+	free(out.o_buf);
+	free(wj.wj_ext);
 
 	return ((off_t) -1);
 }
@@ -1226,6 +2077,10 @@ elf_update(Elf *e, Elf_Cmd c)
 
 	SLIST_INIT(&extents);
 
+	/* The application may have changed the symbol or section names. */
+	_libelf_release_dynsym(e);
+	_libelf_release_scnname(e);
+
 	if ((rc = _libelf_resync_elf(e, &extents)) < 0)
 		goto done;
 
@@ -1238,7 +2093,8 @@ elf_update(Elf *e, Elf_Cmd c)
 		goto done;
 	}
 
-	rc = _libelf_write_elf(e, rc, &extents);
+	if ((rc = _libelf_write_elf(e, rc, &extents)) >= 0)
+		LIBELF_STATS_ADD(e, es_updates, 1);
 
 done:
 	_libelf_release_extents(&extents);
@@ -39,7 +39,7 @@ elf_version(unsigned int v)
 {
 	unsigned int old;
 
-	if ((old = LIBELF_PRIVATE(version)) == EV_NONE)
+	if ((old = LIBELF_GET_PRIVATE(version)) == EV_NONE)
 		old = EV_CURRENT;
 
 	if (v == EV_NONE)
@@ -49,6 +49,6 @@ elf_version(unsigned int v)
 		return EV_NONE;
 	}
 
-	LIBELF_PRIVATE(version) = v;
+	LIBELF_SET_PRIVATE(version, v);
 	return (old);
 }
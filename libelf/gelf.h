@@ -48,6 +48,7 @@ typedef Elf64_Rel	GElf_Rel;	/* Relocation entries */
 typedef Elf64_Rela	GElf_Rela;	/* Relocation entries with addend */
 
 typedef	Elf64_Cap	GElf_Cap;	/* SW/HW capabilities */
+typedef Elf64_Chdr	GElf_Chdr;	/* Compressed section header */
 typedef Elf64_Move	GElf_Move;	/* Move entries */
 typedef Elf64_Syminfo	GElf_Syminfo;	/* Symbol information */
 
@@ -98,8 +99,16 @@ Elf_Data 	*gelf_xlatetof(Elf *_elf, Elf_Data *_dst, const Elf_Data *_src, unsign
 Elf_Data 	*gelf_xlatetom(Elf *_elf, Elf_Data *_dst, const Elf_Data *_src, unsigned int _encode);
 
 GElf_Cap	*gelf_getcap(Elf_Data *_data, int _index, GElf_Cap *_cap);
+GElf_Chdr	*gelf_getchdr(Elf_Scn *_scn, GElf_Chdr *_dst);
 GElf_Move	*gelf_getmove(Elf_Data *_src, int _index, GElf_Move *_dst);
+const GElf_Rel	*gelf_getrels(Elf_Data *_src, size_t _first, size_t _count,
+			GElf_Rel *_dst);
+const GElf_Rela	*gelf_getrelas(Elf_Data *_src, size_t _first, size_t _count,
+			GElf_Rela *_dst);
 GElf_Syminfo	*gelf_getsyminfo(Elf_Data *_src, int _index, GElf_Syminfo *_dst);
+const GElf_Sym	*gelf_getsyms(Elf_Data *_src, size_t _first, size_t _count,
+			GElf_Sym *_dst);
+GElf_Sym	*gelf_lookup_dynsym(Elf *_elf, const char *_name, GElf_Sym *_dst);
 int		gelf_update_cap(Elf_Data *_dst, int _index, GElf_Cap *_src);
 int		gelf_update_move(Elf_Data *_dst, int _index, GElf_Move *_src);
 int		gelf_update_syminfo(Elf_Data *_dst, int _index, GElf_Syminfo *_src);
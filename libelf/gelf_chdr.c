@@ -0,0 +1,120 @@
+/*-
+ * Copyright (c) 2026, Elftoolchain Project Contributors.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE AUTHOR AND CONTRIBUTORS ``AS IS'' AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED.  IN NO EVENT SHALL THE AUTHOR OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS
+ * OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY
+ * OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+ * SUCH DAMAGE.
+ */
+
+#include <sys/cdefs.h>
+
+#include <assert.h>
+#include <gelf.h>
+#include <libelf.h>
+#include <stdlib.h>
+
+#include "_libelf.h"
+
+ELFTC_VCSID("$Id$");
+
+/*@ELFTC-DOWNSTREAM-VCSID@*/
+
+GElf_Chdr *
+gelf_getchdr(Elf_Scn *s, GElf_Chdr *d)
+{
+	Elf *e;
+	void *sh;
+	int ec, r;
+	size_t chsz;
+	uint64_t sh_flags, sh_offset, sh_size;
+	struct _Libelf_Data *ld;
+	unsigned char *buf, *src;
+
+	if (d == NULL) {
+		LIBELF_SET_ERROR(ARGUMENT, 0);
+		return (NULL);
+	}
+
+	if ((sh = _libelf_getshdr(s, ELFCLASSNONE)) == NULL)
+		return (NULL);
+
+	e = s->s_elf;
+	ec = e->e_class;
+	assert(ec == ELFCLASS32 || ec == ELFCLASS64);
+
+	if (ec == ELFCLASS32) {
+		sh_flags  = (uint64_t) ((Elf32_Shdr *) sh)->sh_flags;
+		sh_offset = (uint64_t) ((Elf32_Shdr *) sh)->sh_offset;
+		sh_size   = (uint64_t) ((Elf32_Shdr *) sh)->sh_size;
+	} else {
+		sh_flags  = ((Elf64_Shdr *) sh)->sh_flags;
+		sh_offset = ((Elf64_Shdr *) sh)->sh_offset;
+		sh_size   = ((Elf64_Shdr *) sh)->sh_size;
+	}
+
+	if ((sh_flags & SHF_COMPRESSED) == 0) {
+		LIBELF_SET_ERROR(ARGUMENT, 0);
+		return (NULL);
+	}
+
+	/*
+	 * Use the header of a section that was decompressed, or that
+	 * was compressed by a prior elf_update(3) call.
+	 */
+	if (s->s_chdr.ch_type != 0) {
+		*d = s->s_chdr;
+		return (d);
+	}
+
+	/* The section is yet to be compressed by elf_update(3). */
+	if (s->s_ctype != 0) {
+		LIBELF_SET_ERROR(SEQUENCE, 0);
+		return (NULL);
+	}
+
+	if ((ld = STAILQ_FIRST(&s->s_data)) != NULL) {
+		if (ld->d_data.d_type != ELF_T_BYTE) {
+			LIBELF_SET_ERROR(DATA, 0);
+			return (NULL);
+		}
+		return (_libelf_zchdr(e, ld->d_data.d_buf,
+		    (size_t) ld->d_data.d_size, d) ? d : NULL);
+	}
+
+	chsz = _libelf_fsize(ELF_T_CHDR, ec, e->e_version, (size_t) 1);
+	if (sh_size < chsz)
+		chsz = (size_t) sh_size;
+
+	if (!LIBELF_HAS_RAWFILE(e) || sh_offset > (uint64_t) e->e_rawsize ||
+	    chsz > (uint64_t) e->e_rawsize - sh_offset) {
+		LIBELF_SET_ERROR(SECTION, 0);
+		return (NULL);
+	}
+
+	if ((src = _libelf_rawbytes(e, sh_offset, chsz, &buf)) == NULL)
+		return (NULL);
+
+	r = _libelf_zchdr(e, src, chsz, d);
+
+	free(buf);
+
+	return (r ? d : NULL);
+}
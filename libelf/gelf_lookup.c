@@ -0,0 +1,397 @@
+/*-
+ * Copyright (c) 2026, Elftoolchain Project Contributors.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE AUTHOR AND CONTRIBUTORS ``AS IS'' AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED.  IN NO EVENT SHALL THE AUTHOR OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS
+ * OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY
+ * OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+ * SUCH DAMAGE.
+ */
+
+#include <sys/cdefs.h>
+
+#include <assert.h>
+#include <gelf.h>
+#include <limits.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "_libelf.h"
+
+ELFTC_VCSID("$Id$");
+
+/*@ELFTC-DOWNSTREAM-VCSID@*/
+
+/*
+ * Symbol lookup by name in the dynamic symbol table of an ELF object.
+ *
+ * Lookups use the object's SHT_GNU_HASH section if it has one, or its
+ * SHT_HASH section otherwise.  For objects that lack both, or whose
+ * hash sections are malformed, a hash table over the symbol names is
+ * built in memory on first use.
+ *
+ * As with the run-time linker, symbols marked hidden in the object's
+ * SHT_GNU_versym section are skipped, so that a name defined in several
+ * versions resolves to its default version.
+ */
+
+/*
+ * Return 1 if the symbol at index `ndx' is defined, is not a hidden
+ * version and is named `name', retrieving it into `dst'.  `vd' holds
+ * the contents of the SHT_GNU_versym section, if any.
+ */
+static int
+_libelf_dynsym_match(Elf *e, struct _Libelf_Dynsym *dy, Elf_Data *sd,
+    Elf_Data *vd, size_t ndx, const char *name, GElf_Sym *dst)
+{
+	const char *s;
+
+	if (ndx > INT_MAX || gelf_getsym(sd, (int) ndx, dst) == NULL)
+		return (0);
+
+	if (vd != NULL && ndx < vd->d_size / sizeof(uint16_t) &&
+	    (((const uint16_t *) vd->d_buf)[ndx] & VERSYM_HIDDEN))
+		return (0);
+
+	if (dst->st_shndx == SHN_UNDEF || dst->st_name == 0)
+		return (0);
+
+	if ((s = elf_strptr(e, dy->dy_strndx, dst->st_name)) == NULL)
+		return (0);
+
+	return (strcmp(s, name) == 0);
+}
+
+/*
+ * Look up `name' using a SHT_GNU_HASH section.  Return -1 if the
+ * section is malformed, 0 if the name was not found and 1 otherwise.
+ */
+static int
+_libelf_dynsym_gnu_hash(Elf *e, struct _Libelf_Dynsym *dy, Elf_Data *hd,
+    Elf_Data *sd, Elf_Data *vd, size_t nsyms, const char *name,
+    GElf_Sym *dst)
+{
+	const Elf_GNU_Hash_Header *gh;
+	const unsigned char *bloom;
+	const uint32_t *buckets, *chains;
+	uint32_t c, h, nbits, symoff;
+	uint64_t mask, word;
+	size_t i, nchains, sz, wordsz;
+
+	if (hd->d_size < sizeof(*gh))
+		return (-1);
+
+	gh = (const Elf_GNU_Hash_Header *) hd->d_buf;
+	wordsz = e->e_class == ELFCLASS32 ? sizeof(uint32_t) :
+	    sizeof(uint64_t);
+	nbits = (uint32_t) (wordsz * CHAR_BIT);
+	symoff = gh->gh_symndx;
+
+	sz = sizeof(*gh) + (size_t) gh->gh_maskwords * wordsz +
+	    (size_t) gh->gh_nbuckets * sizeof(uint32_t);
+	if (gh->gh_nbuckets == 0 || gh->gh_maskwords == 0 ||
+	    gh->gh_shift2 >= 32 || sz > hd->d_size || symoff > nsyms)
+		return (-1);
+
+	nchains = (hd->d_size - sz) / sizeof(uint32_t);
+	bloom = (const unsigned char *) hd->d_buf + sizeof(*gh);
+	buckets = (const uint32_t *) (uintptr_t) (bloom +
+	    gh->gh_maskwords * wordsz);
+	chains = buckets + gh->gh_nbuckets;
+
+	h = (uint32_t) elf_gnu_hash(name);
+
+	/* Names rejected by the bloom filter are not in the table. */
+	i = (h / nbits) % gh->gh_maskwords;
+	if (e->e_class == ELFCLASS32)
+		word = ((const uint32_t *) (uintptr_t) bloom)[i];
+	else
+		word = ((const uint64_t *) (uintptr_t) bloom)[i];
+	mask = ((uint64_t) 1 << (h % nbits)) |
+	    ((uint64_t) 1 << ((h >> gh->gh_shift2) % nbits));
+	if ((word & mask) != mask)
+		return (0);
+
+	/*
+	 * Walk the chain for the bucket.  Chain entries hold the hash
+	 * values of successive symbols, with the low bit marking the
+	 * last symbol in the chain.
+	 */
+	if ((i = buckets[h % gh->gh_nbuckets]) == 0)
+		return (0);
+
+	for (; i >= symoff && i - symoff < nchains && i < nsyms; i++) {
+		c = chains[i - symoff];
+		if ((c | 1) == (h | 1) &&
+		    _libelf_dynsym_match(e, dy, sd, vd, i, name, dst))
+			return (1);
+		if (c & 1)
+			break;
+	}
+
+	return (0);
+}
+
+/*
+ * Look up `name' using a SHT_HASH section.  Return values are as for
+ * _libelf_dynsym_gnu_hash().
+ */
+static int
+_libelf_dynsym_sysv_hash(Elf *e, struct _Libelf_Dynsym *dy, Elf_Data *hd,
+    Elf_Data *sd, Elf_Data *vd, size_t nsyms, const char *name,
+    GElf_Sym *dst)
+{
+	const uint32_t *buckets, *chains, *w;
+	size_t i, n, nbuckets, nchains;
+
+	n = hd->d_size / sizeof(uint32_t);
+	w = (const uint32_t *) hd->d_buf;
+
+	if (n < 2)
+		return (-1);
+
+	nbuckets = w[0];
+	nchains = w[1];
+	if (nbuckets == 0 || nbuckets > n - 2 || nchains > n - 2 - nbuckets)
+		return (-1);
+
+	buckets = w + 2;
+	chains = buckets + nbuckets;
+
+	/* Bound the walk in case the chains contain a cycle. */
+	for (i = buckets[elf_hash(name) % nbuckets], n = 0;
+	     i != 0 && i < nchains && i < nsyms && n < nchains;
+	     i = chains[i], n++)
+		if (_libelf_dynsym_match(e, dy, sd, vd, i, name, dst))
+			return (1);
+
+	return (0);
+}
+
+/*
+ * Build the in-memory hash table over the names of the defined
+ * symbols in `sd'.  Symbols sharing a name are entered in index
+ * order, so that a probe finds the one with the lowest index first.
+ */
+static int
+_libelf_dynsym_index(Elf *e, struct _Libelf_Dynsym *dy, Elf_Data *sd,
+    size_t nsyms)
+{
+	GElf_Sym sym;
+	const char *s;
+	uint32_t h;
+	struct _Libelf_Dynsym_Slot *slots;
+	size_t i, j, mask, nslots;
+
+	nslots = _libelf_hash_nslots(nsyms);
+	mask = nslots - 1;
+
+	if ((slots = calloc(nslots, sizeof(*slots))) == NULL) {
+		LIBELF_SET_ERROR(RESOURCE, 0);
+		return (0);
+	}
+
+	for (i = 1; i < nsyms && i <= INT_MAX; i++) {
+		if (gelf_getsym(sd, (int) i, &sym) == NULL)
+			goto error;
+
+		if (sym.st_shndx == SHN_UNDEF || sym.st_name == 0)
+			continue;
+
+		if ((s = elf_strptr(e, dy->dy_strndx, sym.st_name)) == NULL)
+			goto error;
+
+		h = (uint32_t) elf_gnu_hash(s);
+		for (j = _libelf_hash_slot(h, mask); slots[j].ds_ndx != 0;
+		     j = (j + 1) & mask)
+			;
+		slots[j].ds_hash = h;
+		slots[j].ds_ndx = i;
+	}
+
+	dy->dy_slots = slots;
+	dy->dy_nslots = nslots;
+
+	return (1);
+
+error:
+	free(slots);
+	return (0);
+}
+
+/*
+ * Look up `name' in the in-memory hash table.
+ */
+static int
+_libelf_dynsym_lookup(Elf *e, struct _Libelf_Dynsym *dy, Elf_Data *sd,
+    Elf_Data *vd, const char *name, GElf_Sym *dst)
+{
+	struct _Libelf_Dynsym_Slot *slot;
+	uint32_t h;
+	size_t j, mask;
+
+	h = (uint32_t) elf_gnu_hash(name);
+	mask = dy->dy_nslots - 1;
+
+	for (j = _libelf_hash_slot(h, mask);; j = (j + 1) & mask) {
+		slot = &dy->dy_slots[j];
+		if (slot->ds_ndx == 0)
+			return (0);
+		if (slot->ds_hash == h &&
+		    _libelf_dynsym_match(e, dy, sd, vd, slot->ds_ndx, name,
+		    dst))
+			return (1);
+	}
+}
+
+/*
+ * Locate the dynamic symbol table of `e', its string table, its
+ * version section and the hash section to use.  A SHT_GNU_HASH section
+ * is preferred.
+ */
+static struct _Libelf_Dynsym *
+_libelf_dynsym_init(Elf *e)
+{
+	Elf_Scn *scn;
+	GElf_Shdr sh;
+	size_t i, nscn;
+	struct _Libelf_Dynsym *dy;
+
+	if (elf_getshdrnum(e, &nscn) < 0)
+		return (NULL);
+
+	if ((dy = calloc((size_t) 1, sizeof(*dy))) == NULL) {
+		LIBELF_SET_ERROR(RESOURCE, 0);
+		return (NULL);
+	}
+
+	dy->dy_symndx = dy->dy_hashndx = dy->dy_versymndx = SHN_UNDEF;
+
+	for (i = 1; i < nscn; i++) {
+		if ((scn = elf_getscn(e, i)) == NULL ||
+		    gelf_getshdr(scn, &sh) == NULL)
+			goto error;
+		if (sh.sh_type == SHT_DYNSYM) {
+			dy->dy_symndx = i;
+			dy->dy_strndx = sh.sh_link;
+			break;
+		}
+	}
+
+	for (i = 1; dy->dy_symndx != SHN_UNDEF && i < nscn; i++) {
+		if ((scn = elf_getscn(e, i)) == NULL ||
+		    gelf_getshdr(scn, &sh) == NULL)
+			goto error;
+		if (sh.sh_link != dy->dy_symndx)
+			continue;
+		if (sh.sh_type == SHT_GNU_versym &&
+		    dy->dy_versymndx == SHN_UNDEF)
+			dy->dy_versymndx = i;
+		if (sh.sh_type == SHT_GNU_HASH &&
+		    dy->dy_hashtype != SHT_GNU_HASH) {
+			dy->dy_hashndx = i;
+			dy->dy_hashtype = SHT_GNU_HASH;
+		}
+		/* Some 64-bit ABIs use 8-byte SHT_HASH entries. */
+		if (sh.sh_type == SHT_HASH && sh.sh_entsize == 4 &&
+		    dy->dy_hashndx == SHN_UNDEF) {
+			dy->dy_hashndx = i;
+			dy->dy_hashtype = SHT_HASH;
+		}
+	}
+
+	e->e_u.e_elf.e_dynsym = dy;
+	return (dy);
+
+error:
+	free(dy);
+	return (NULL);
+}
+
+GElf_Sym *
+gelf_lookup_dynsym(Elf *e, const char *name, GElf_Sym *dst)
+{
+	int r;
+	size_t msz, nsyms;
+	Elf_Scn *scn;
+	Elf_Data *hd, *sd, *vd;
+	GElf_Sym sym;
+	struct _Libelf_Dynsym *dy;
+
+	if (e == NULL || e->e_kind != ELF_K_ELF || name == NULL ||
+	    dst == NULL) {
+		LIBELF_SET_ERROR(ARGUMENT, 0);
+		return (NULL);
+	}
+
+	if (e->e_class != ELFCLASS32 && e->e_class != ELFCLASS64) {
+		LIBELF_SET_ERROR(CLASS, 0);
+		return (NULL);
+	}
+
+	if ((dy = e->e_u.e_elf.e_dynsym) == NULL &&
+	    (dy = _libelf_dynsym_init(e)) == NULL)
+		return (NULL);
+
+	if (dy->dy_symndx == SHN_UNDEF)
+		return (NULL);
+
+	if ((scn = elf_getscn(e, dy->dy_symndx)) == NULL ||
+	    (sd = elf_getdata(scn, NULL)) == NULL)
+		return (NULL);
+
+	msz = _libelf_msize(ELF_T_SYM, e->e_class, e->e_version);
+	assert(msz > 0);
+	nsyms = sd->d_size / msz;
+
+	vd = NULL;
+	if (dy->dy_versymndx != SHN_UNDEF &&
+	    ((scn = elf_getscn(e, dy->dy_versymndx)) == NULL ||
+	    (vd = elf_getdata(scn, NULL)) == NULL))
+		return (NULL);
+	if (vd != NULL && vd->d_type != ELF_T_HALF)
+		vd = NULL;
+
+	r = -1;
+
+	if (dy->dy_slots == NULL && dy->dy_hashndx != SHN_UNDEF) {
+		if ((scn = elf_getscn(e, dy->dy_hashndx)) == NULL ||
+		    (hd = elf_getdata(scn, NULL)) == NULL)
+			return (NULL);
+		r = dy->dy_hashtype == SHT_GNU_HASH ?
+		    _libelf_dynsym_gnu_hash(e, dy, hd, sd, vd, nsyms, name,
+		    &sym) :
+		    _libelf_dynsym_sysv_hash(e, dy, hd, sd, vd, nsyms, name,
+		    &sym);
+	}
+
+	if (r < 0) {
+		if (dy->dy_slots == NULL &&
+		    _libelf_dynsym_index(e, dy, sd, nsyms) == 0)
+			return (NULL);
+		r = _libelf_dynsym_lookup(e, dy, sd, vd, name, &sym);
+	}
+
+	if (r == 0)
+		return (NULL);
+
+	*dst = sym;
+	return (dst);
+}
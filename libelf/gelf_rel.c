@@ -99,6 +99,72 @@ gelf_getrel(Elf_Data *ed, int ndx, GElf_Rel *dst)
 	return (dst);
 }
 
+/*
+ * Retrieve the relocation entries at indices `first' to
+ * `first' + `count' - 1 in one call.  For ELFCLASS64 objects, whose
+ * entries need no conversion, a pointer into the data buffer is
+ * returned and `dst' is left untouched.
+ */
+const GElf_Rel *
+gelf_getrels(Elf_Data *ed, size_t first, size_t count, GElf_Rel *dst)
+{
+	int ec;
+	Elf *e;
+	Elf_Scn *scn;
+	size_t i, msz, n;
+	uint32_t sh_type;
+	const Elf32_Rel *rel32;
+	struct _Libelf_Data *d;
+
+	d = (struct _Libelf_Data *) ed;
+
+	if (d == NULL || dst == NULL ||
+	    (scn = d->d_scn) == NULL ||
+	    (e = scn->s_elf) == NULL) {
+		LIBELF_SET_ERROR(ARGUMENT, 0);
+		return (NULL);
+	}
+
+	ec = e->e_class;
+	assert(ec == ELFCLASS32 || ec == ELFCLASS64);
+
+	if (ec == ELFCLASS32)
+		sh_type = scn->s_shdr.s_shdr32.sh_type;
+	else
+		sh_type = scn->s_shdr.s_shdr64.sh_type;
+
+	if (_libelf_xlate_shtype(sh_type) != ELF_T_REL) {
+		LIBELF_SET_ERROR(ARGUMENT, 0);
+		return (NULL);
+	}
+
+	if ((msz = _libelf_msize(ELF_T_REL, ec, e->e_version)) == 0)
+		return (NULL);
+
+	n = (size_t) (d->d_data.d_size / msz);
+	if (first > n || count > n - first) {
+		LIBELF_SET_ERROR(ARGUMENT, 0);
+		return (NULL);
+	}
+
+	if (count == 0)
+		return (dst);
+
+	if (ec == ELFCLASS64)
+		return ((const Elf64_Rel *) d->d_data.d_buf + first);
+
+	rel32 = (const Elf32_Rel *) d->d_data.d_buf + first;
+
+	for (i = 0; i < count; i++) {
+		dst[i].r_offset = (Elf64_Addr) rel32[i].r_offset;
+		dst[i].r_info   = ELF64_R_INFO(
+		    (Elf64_Xword) ELF32_R_SYM(rel32[i].r_info),
+		    ELF32_R_TYPE(rel32[i].r_info));
+	}
+
+	return (dst);
+}
+
 int
 gelf_update_rel(Elf_Data *ed, int ndx, GElf_Rel *dr)
 {
@@ -100,6 +100,73 @@ gelf_getrela(Elf_Data *ed, int ndx, GElf_Rela *dst)
 	return (dst);
 }
 
+/*
+ * Retrieve the relocation entries with addends at indices `first' to
+ * `first' + `count' - 1 in one call.  For ELFCLASS64 objects, whose
+ * entries need no conversion, a pointer into the data buffer is
+ * returned and `dst' is left untouched.
+ */
+const GElf_Rela *
+gelf_getrelas(Elf_Data *ed, size_t first, size_t count, GElf_Rela *dst)
+{
+	int ec;
+	Elf *e;
+	Elf_Scn *scn;
+	size_t i, msz, n;
+	uint32_t sh_type;
+	const Elf32_Rela *rela32;
+	struct _Libelf_Data *d;
+
+	d = (struct _Libelf_Data *) ed;
+
+	if (d == NULL || dst == NULL ||
+	    (scn = d->d_scn) == NULL ||
+	    (e = scn->s_elf) == NULL) {
+		LIBELF_SET_ERROR(ARGUMENT, 0);
+		return (NULL);
+	}
+
+	ec = e->e_class;
+	assert(ec == ELFCLASS32 || ec == ELFCLASS64);
+
+	if (ec == ELFCLASS32)
+		sh_type = scn->s_shdr.s_shdr32.sh_type;
+	else
+		sh_type = scn->s_shdr.s_shdr64.sh_type;
+
+	if (_libelf_xlate_shtype(sh_type) != ELF_T_RELA) {
+		LIBELF_SET_ERROR(ARGUMENT, 0);
+		return (NULL);
+	}
+
+	if ((msz = _libelf_msize(ELF_T_RELA, ec, e->e_version)) == 0)
+		return (NULL);
+
+	n = (size_t) (d->d_data.d_size / msz);
+	if (first > n || count > n - first) {
+		LIBELF_SET_ERROR(ARGUMENT, 0);
+		return (NULL);
+	}
+
+	if (count == 0)
+		return (dst);
+
+	if (ec == ELFCLASS64)
+		return ((const Elf64_Rela *) d->d_data.d_buf + first);
+
+	rela32 = (const Elf32_Rela *) d->d_data.d_buf + first;
+
+	for (i = 0; i < count; i++) {
+		dst[i].r_offset = (Elf64_Addr) rela32[i].r_offset;
+		dst[i].r_info   = ELF64_R_INFO(
+		    (Elf64_Xword) ELF32_R_SYM(rela32[i].r_info),
+		    ELF32_R_TYPE(rela32[i].r_info));
+		dst[i].r_addend = (Elf64_Sxword) rela32[i].r_addend;
+	}
+
+	return (dst);
+}
+
 int
 gelf_update_rela(Elf_Data *ed, int ndx, GElf_Rela *dr)
 {
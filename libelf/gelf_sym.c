@@ -99,6 +99,74 @@ gelf_getsym(Elf_Data *ed, int ndx, GElf_Sym *dst)
 	return (dst);
 }
 
+/*
+ * Retrieve the symbols at indices `first' to `first' + `count' - 1
+ * in one call.  For ELFCLASS64 objects, whose symbols need no
+ * conversion, a pointer into the data buffer is returned and `dst' is
+ * left untouched.
+ */
+const GElf_Sym *
+gelf_getsyms(Elf_Data *ed, size_t first, size_t count, GElf_Sym *dst)
+{
+	int ec;
+	Elf *e;
+	Elf_Scn *scn;
+	size_t i, msz, n;
+	uint32_t sh_type;
+	const Elf32_Sym *sym32;
+	struct _Libelf_Data *d;
+
+	d = (struct _Libelf_Data *) ed;
+
+	if (d == NULL || dst == NULL ||
+	    (scn = d->d_scn) == NULL ||
+	    (e = scn->s_elf) == NULL) {
+		LIBELF_SET_ERROR(ARGUMENT, 0);
+		return (NULL);
+	}
+
+	ec = e->e_class;
+	assert(ec == ELFCLASS32 || ec == ELFCLASS64);
+
+	if (ec == ELFCLASS32)
+		sh_type = scn->s_shdr.s_shdr32.sh_type;
+	else
+		sh_type = scn->s_shdr.s_shdr64.sh_type;
+
+	if (_libelf_xlate_shtype(sh_type) != ELF_T_SYM) {
+		LIBELF_SET_ERROR(ARGUMENT, 0);
+		return (NULL);
+	}
+
+	if ((msz = _libelf_msize(ELF_T_SYM, ec, e->e_version)) == 0)
+		return (NULL);
+
+	n = (size_t) (d->d_data.d_size / msz);
+	if (first > n || count > n - first) {
+		LIBELF_SET_ERROR(ARGUMENT, 0);
+		return (NULL);
+	}
+
+	if (count == 0)
+		return (dst);
+
+	if (ec == ELFCLASS64)
+		return ((const Elf64_Sym *) d->d_data.d_buf + first);
+
+	sym32 = (const Elf32_Sym *) d->d_data.d_buf + first;
+
+	for (i = 0; i < count; i++) {
+		dst[i].st_name  = sym32[i].st_name;
+		dst[i].st_value = (Elf64_Addr) sym32[i].st_value;
+		dst[i].st_size  = (Elf64_Xword) sym32[i].st_size;
+		dst[i].st_info  = sym32[i].st_info;
+		dst[i].st_other = sym32[i].st_other;
+		dst[i].st_shndx = sym32[i].st_shndx;
+	}
+
+	return (dst);
+}
+
 int
 gelf_update_sym(Elf_Data *ed, int ndx, GElf_Sym *gs)
 {
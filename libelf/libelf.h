@@ -74,11 +74,12 @@ typedef enum {
 	ELF_T_WORD,
 	ELF_T_XWORD,
 	ELF_T_GNUHASH,	/* GNU style hash tables. */
+	ELF_T_CHDR,	/* Compression headers. */
 	ELF_T_NUM
 } Elf_Type;
 
 #define	ELF_T_FIRST	ELF_T_ADDR
-#define	ELF_T_LAST	ELF_T_GNUHASH
+#define	ELF_T_LAST	ELF_T_CHDR
 
 /* Commands */
 typedef enum {
@@ -90,6 +91,13 @@ typedef enum {
 	ELF_C_READ,
 	ELF_C_SET,
 	ELF_C_WRITE,
+	ELF_C_READ_MMAP,	/* ELF_C_READ, using a read-only mapping */
+	ELF_C_RDWR_MMAP,	/* ELF_C_RDWR, using a shared mapping */
+	ELF_C_ACCESS_NORMAL,	/* elf_cntl(): no particular access pattern */
+	ELF_C_ACCESS_SEQUENTIAL, /* elf_cntl(): sequential access */
+	ELF_C_ACCESS_RANDOM,	/* elf_cntl(): random access */
+	ELF_C_HUGEPAGES,	/* elf_cntl(): prefer huge pages */
+	ELF_C_PARALLEL,		/* elf_cntl(): write sections in parallel */
 	ELF_C_NUM
 } Elf_Cmd;
 
@@ -141,6 +149,38 @@ typedef struct {
 	char		*as_name; 	/* null terminated symbol name */
 } Elf_Arsym;
 
+/*
+ * An `Elf_Armember' describes a member of an archive.
+ */
+typedef struct {
+	Elf_Arhdr	*am_arhdr;	/* translated member header */
+	off_t		am_off;		/* byte offset to member's header */
+	off_t		am_dataoff;	/* byte offset to member's contents */
+	size_t		am_size;	/* size of member's contents */
+} Elf_Armember;
+
+/*
+ * An `Elf_Stats' holds the statistics counters kept for an ELF
+ * descriptor, or for the process as a whole.  Its `es_size' member is
+ * set by the caller, so that members may be added to the structure
+ * without breaking existing binaries.
+ */
+#define	ELF_STATS_NTYPES	32	/* room for future Elf_Type values */
+
+typedef struct {
+	size_t		es_size;	/* size of the structure */
+	uint64_t	es_mapped;	/* bytes of file mapped in */
+	uint64_t	es_read;	/* bytes of file read in */
+	uint64_t	es_allocated[ELF_STATS_NTYPES]; /* bytes, by type */
+	uint64_t	es_sections;	/* section headers read in */
+	uint64_t	es_xlate_calls;	/* translator invocations */
+	uint64_t	es_xlate_bytes;	/* bytes translated */
+	uint64_t	es_xlate_nsec;	/* time spent translating */
+	uint64_t	es_updates;	/* calls to elf_update(ELF_C_WRITE) */
+	uint64_t	es_update_extents; /* extents laid out and written */
+	uint64_t	es_update_bytes; /* bytes written to the file */
+} Elf_Stats;
+
 /*
  * Error numbers.
  */
@@ -174,12 +214,19 @@ enum Elf_Error {
 /* ELF(3) API extensions. */
 #define	ELF_F_ARCHIVE	   0x100U /* archive creation */
 #define	ELF_F_ARCHIVE_SYSV 0x200U /* SYSV style archive */
+#define	ELF_F_DECOMPRESS   0x400U /* decompress SHF_COMPRESSED sections */
+
+/* Flags for elf_compress(). */
+#define	ELF_CHF_FORCE	0x1U	/* compress even if the section grows */
 
 #ifdef __cplusplus
 extern "C" {
 #endif
+off_t		*elf_arsym_lookup(Elf *_elf, const char *_name,
+		    size_t *_count);
 Elf		*elf_begin(int _fd, Elf_Cmd _cmd, Elf *_elf);
 int		elf_cntl(Elf *_elf, Elf_Cmd _cmd);
+int		elf_compress(Elf_Scn *_scn, int _type, unsigned int _flags);
 int		elf_end(Elf *_elf);
 const char	*elf_errmsg(int _error);
 int		elf_errno(void);
@@ -194,6 +241,7 @@ unsigned int	elf_flagphdr(Elf *_elf, Elf_Cmd _cmd, unsigned int _flags);
 unsigned int	elf_flagscn(Elf_Scn *_scn, Elf_Cmd _cmd, unsigned int _flags);
 unsigned int	elf_flagshdr(Elf_Scn *_scn, Elf_Cmd _cmd, unsigned int _flags);
 Elf_Arhdr	*elf_getarhdr(Elf *_elf);
+Elf_Armember	*elf_getarmembers(Elf *_elf, size_t *_count);
 Elf_Arsym	*elf_getarsym(Elf *_elf, size_t *_ptr);
 off_t		elf_getbase(Elf *_elf);
 Elf_Data	*elf_getdata(Elf_Scn *, Elf_Data *);
@@ -201,11 +249,14 @@ char		*elf_getident(Elf *_elf, size_t *_ptr);
 int		elf_getphdrnum(Elf *_elf, size_t *_dst);
 int		elf_getphnum(Elf *_elf, size_t *_dst);	/* Deprecated */
 Elf_Scn		*elf_getscn(Elf *_elf, size_t _index);
+Elf_Scn		*elf_getscn_byname(Elf *_elf, const char *_name);
 int		elf_getshdrnum(Elf *_elf, size_t *_dst);
 int		elf_getshnum(Elf *_elf, size_t *_dst);	/* Deprecated */
 int		elf_getshdrstrndx(Elf *_elf, size_t *_dst);
 int		elf_getshstrndx(Elf *_elf, size_t *_dst); /* Deprecated */
+int		elf_getstats(Elf *_elf, Elf_Stats *_dst);
 unsigned int	elf_getversion(Elf *_elf);
+unsigned long	elf_gnu_hash(const char *_name);
 unsigned long	elf_hash(const char *_name);
 Elf_Kind	elf_kind(Elf *_elf);
 Elf		*elf_memory(char *_image, size_t _size);
@@ -213,8 +264,10 @@ size_t		elf_ndxscn(Elf_Scn *_scn);
 Elf_Data	*elf_newdata(Elf_Scn *_scn);
 Elf_Scn		*elf_newscn(Elf *_elf);
 Elf_Scn		*elf_nextscn(Elf *_elf, Elf_Scn *_scn);
+Elf_Scn		*elf_nextscn_byname(Elf *_elf, Elf_Scn *_scn);
 Elf_Cmd		elf_next(Elf *_elf);
 Elf		*elf_open(int _fd);
+Elf		*elf_openarmember(Elf *_elf, size_t _ndx);
 Elf		*elf_openmemory(char *_image, size_t _size);
 off_t		elf_rand(Elf *_elf, off_t _off);
 Elf_Data	*elf_rawdata(Elf_Scn *_scn, Elf_Data *_data);
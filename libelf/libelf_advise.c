@@ -0,0 +1,153 @@
+/*-
+ * Copyright (c) 2026, Elftoolchain Project Contributors.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE AUTHOR AND CONTRIBUTORS ``AS IS'' AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED.  IN NO EVENT SHALL THE AUTHOR OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS
+ * OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY
+ * OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+ * SUCH DAMAGE.
+ */
+
+
+#include <sys/cdefs.h>
+#include <sys/types.h>
+
+#include <fcntl.h>
+#include <libelf.h>
+#include <unistd.h>
+
+#include "_libelf.h"
+
+#if	ELFTC_HAVE_MMAP
+#include <sys/mman.h>
+#endif
+
+ELFTC_VCSID("$Id$");
+
+/*@ELFTC-DOWNSTREAM-VCSID@*/
+
+/*
+ * Pass on advice about the expected use of the `sz' bytes at offset
+ * `off' in ELF descriptor `e' to the operating system.
+ *
+ * For files that have been mapped in, the advice applies to the pages
+ * of the mapping holding the byte range.  For files being read in on
+ * demand, the advice applies to the underlying file descriptor.  The
+ * advice is ignored for images held in malloc'ed memory, and for
+ * advice that the host does not support.
+ *
+ * Advice to discard the pages holding the range is only followed for
+ * read-only or shared mappings, as pages of a private mapping may
+ * hold modifications made by the application.  Only pages lying
+ * entirely within the range are discarded.
+ */
+void
+_libelf_advise(Elf *e, uint64_t off, uint64_t sz, int advice)
+{
+	Elf *p;
+	int adv;
+#if	ELFTC_HAVE_MMAP
+	uintptr_t end, pgmask, start;
+#endif
+
+	if (sz == 0)
+		return;
+
+	p = e->e_parent ? e->e_parent : e;
+
+#if	defined(POSIX_FADV_NORMAL)
+	if (p->e_flags & LIBELF_F_RAWFILE_LAZY) {
+		switch (advice) {
+		case LIBELF_ADVISE_NORMAL:
+			adv = POSIX_FADV_NORMAL;
+			break;
+		case LIBELF_ADVISE_SEQUENTIAL:
+			adv = POSIX_FADV_SEQUENTIAL;
+			break;
+		case LIBELF_ADVISE_RANDOM:
+			adv = POSIX_FADV_RANDOM;
+			break;
+		default:
+			/*
+			 * Section contents are read in as soon as they
+			 * are needed, and are then held in memory owned
+			 * by the library.
+			 */
+			return;
+		}
+
+		(void) posix_fadvise(p->e_fd, (off_t) off, (off_t) sz, adv);
+		return;
+	}
+#endif
+
+#if	ELFTC_HAVE_MMAP
+	if ((p->e_flags & LIBELF_F_RAWFILE_MMAP) == 0)
+		return;
+
+	switch (advice) {
+	case LIBELF_ADVISE_NORMAL:
+		adv = MADV_NORMAL;
+		break;
+	case LIBELF_ADVISE_SEQUENTIAL:
+		adv = MADV_SEQUENTIAL;
+		break;
+	case LIBELF_ADVISE_RANDOM:
+		adv = MADV_RANDOM;
+		break;
+	case LIBELF_ADVISE_WILLNEED:
+		adv = MADV_WILLNEED;
+		break;
+	case LIBELF_ADVISE_DONTNEED:
+		if ((p->e_flags & (LIBELF_F_RAWFILE_RDONLY |
+		    LIBELF_F_RAWFILE_SHARED)) == 0)
+			return;
+		adv = MADV_DONTNEED;
+		break;
+#if	defined(MADV_HUGEPAGE)
+	case LIBELF_ADVISE_HUGEPAGE:
+		adv = MADV_HUGEPAGE;
+		break;
+#endif
+	default:
+		return;
+	}
+
+	pgmask = (uintptr_t) sysconf(_SC_PAGESIZE) - 1;
+	start = (uintptr_t) e->e_rawfile + (uintptr_t) off;
+	end = start + (uintptr_t) sz;
+
+	if (advice == LIBELF_ADVISE_DONTNEED) {
+		start = (start + pgmask) & ~pgmask;
+		end &= ~pgmask;
+		if (start >= end)
+			return;
+	} else {
+		start &= ~pgmask;
+		end = (end + pgmask) & ~pgmask;
+	}
+
+	(void) madvise((void *) start, (size_t) (end - start), adv);
+#else
+	(void) adv;
+	(void) off;
+	(void) advice;
+	(void) p;
+#endif
+}
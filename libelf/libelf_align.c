@@ -68,6 +68,7 @@ static struct align malign[ELF_T_NUM] = {
 	[ELF_T_ADDR]	= MALIGN(Addr),
 	[ELF_T_BYTE]	= { .a32 = 1, .a64 = 1 },
 	[ELF_T_CAP]	= MALIGN(Cap),
+	[ELF_T_CHDR]	= MALIGN(Chdr),
 	[ELF_T_DYN]	= MALIGN(Dyn),
 	[ELF_T_EHDR]	= MALIGN(Ehdr),
 	[ELF_T_HALF]	= MALIGN(Half),
@@ -107,6 +108,7 @@ static struct align falign[ELF_T_NUM] = {
 	[ELF_T_ADDR]	= FALIGN(4,8),
 	[ELF_T_BYTE]	= FALIGN(1,1),
 	[ELF_T_CAP]	= FALIGN(4,8),
+	[ELF_T_CHDR]	= FALIGN(4,8),
 	[ELF_T_DYN]	= FALIGN(4,8),
 	[ELF_T_EHDR]	= FALIGN(4,8),
 	[ELF_T_HALF]	= FALIGN(2,2),
@@ -33,6 +33,7 @@
 #include <assert.h>
 #include <errno.h>
 #include <libelf.h>
+#include <stdint.h>
 #include <stdlib.h>
 #include <string.h>
 
@@ -58,7 +59,9 @@ _libelf_allocate_elf(void)
 	e->e_cmd         = ELF_C_NULL;
 	e->e_fd          = -1;
 	e->e_kind        = ELF_K_NONE;
-	e->e_version     = LIBELF_PRIVATE(version);
+	e->e_version     = LIBELF_GET_PRIVATE(version);
+
+	_libelf_stats_link(e);
 
 	return (e);
 }
@@ -74,20 +77,77 @@ _libelf_init_elf(Elf *e, Elf_Kind kind)
 	switch (kind) {
 	case ELF_K_ELF:
 		STAILQ_INIT(&e->e_u.e_elf.e_scn);
+		(void) pthread_mutex_init(&e->e_u.e_elf.e_arena.a_mutex, NULL);
 		break;
 	default:
 		break;
 	}
 }
 
+void
+_libelf_release_ar_members(struct _Libelf_Ar_Members *m)
+{
+	size_t n;
+
+	for (n = 0; n < m->am_count; n++) {
+		free(m->am_arhdrs[n].ar_name);
+		free(m->am_arhdrs[n].ar_rawname);
+	}
+
+	free(m->am_members);
+	free(m->am_arhdrs);
+	free(m);
+}
+
+/*
+ * Discard the index built by gelf_lookup_dynsym().
+ */
+void
+_libelf_release_dynsym(Elf *e)
+{
+	struct _Libelf_Dynsym *dy;
+
+	if ((dy = e->e_u.e_elf.e_dynsym) == NULL)
+		return;
+
+	free(dy->dy_slots);
+	free(dy);
+
+	e->e_u.e_elf.e_dynsym = NULL;
+}
+
+/*
+ * Discard the index built by elf_getscn_byname().
+ */
+void
+_libelf_release_scnname(Elf *e)
+{
+	struct _Libelf_Scnname *sn;
+
+	if ((sn = e->e_u.e_elf.e_scnname) == NULL)
+		return;
+
+	free(sn->sn_next);
+	free(sn->sn_slots);
+	free(sn);
+
+	e->e_u.e_elf.e_scnname = NULL;
+}
+
 void
 _libelf_release_elf(Elf *e)
 {
 	Elf_Arhdr *arh;
 
+	_libelf_lazy_release(e);
+
 	switch (e->e_kind) {
 	case ELF_K_AR:
 		free(e->e_u.e_ar.e_symtab);
+		free(e->e_u.e_ar.e_symhash);
+		free(e->e_u.e_ar.e_symoff);
+		if (e->e_u.e_ar.e_members)
+			_libelf_release_ar_members(e->e_u.e_ar.e_members);
 		break;
 
 	case ELF_K_ELF:
@@ -104,6 +164,12 @@ _libelf_release_elf(Elf *e)
 
 		assert(STAILQ_EMPTY(&e->e_u.e_elf.e_scn));
 
+		_libelf_release_dynsym(e);
+		_libelf_release_scnname(e);
+		_libelf_release_arena(e);
+		(void) pthread_mutex_destroy(&e->e_u.e_elf.e_arena.a_mutex);
+		free(e->e_u.e_elf.e_scntab);
+
 		if (e->e_flags & LIBELF_F_AR_HEADER) {
 			arh = e->e_hdr.e_arhdr;
 			free(arh->ar_name);
@@ -117,18 +183,136 @@ _libelf_release_elf(Elf *e)
 		break;
 	}
 
+	_libelf_stats_unlink(e);
+
 	free(e);
 }
 
+/*
+ * Section and data descriptors are allocated from a per-descriptor
+ * arena, since objects with many sections would otherwise need many
+ * small allocations, each freed separately by elf_end(3).
+ *
+ * The arena's chunks start small, so that small objects do not pay
+ * for large chunks, and double in size up to a limit.
+ */
+
+struct _Libelf_Arena_Chunk {
+	struct _Libelf_Arena_Chunk *c_next;
+};
+
+#define	LIBELF_ARENA_ALIGN	16
+#define	LIBELF_ARENA_MINCHUNK	1024
+#define	LIBELF_ARENA_MAXCHUNK	(64 * 1024)
+
+#define	LIBELF_ARENA_ROUNDUP(N)	(((N) + LIBELF_ARENA_ALIGN - 1) &	\
+	~((size_t) LIBELF_ARENA_ALIGN - 1))
+
+/*
+ * Allocate `sz' bytes of zeroed memory from the arena of ELF
+ * descriptor 'e'.  Requests that do not fit in a chunk get a chunk
+ * of their own.  The caller holds the arena's mutex.
+ */
+static void *
+_libelf_arena_alloc(Elf *e, size_t sz)
+{
+	size_t csz, hsz;
+	unsigned char *p;
+	struct _Libelf_Arena *a;
+	struct _Libelf_Arena_Chunk *c;
+
+	a = &e->e_u.e_elf.e_arena;
+	hsz = LIBELF_ARENA_ROUNDUP(sizeof(*c));
+
+	if (sz > SIZE_MAX - hsz - LIBELF_ARENA_ALIGN) {
+		LIBELF_SET_ERROR(RESOURCE, 0);
+		return (NULL);
+	}
+
+	sz = LIBELF_ARENA_ROUNDUP(sz);
+
+	if (sz > a->a_avail) {
+		if ((csz = a->a_chunksz) == 0)
+			csz = LIBELF_ARENA_MINCHUNK;
+
+		if ((c = malloc(hsz + (sz > csz ? sz : csz))) == NULL) {
+			LIBELF_SET_ERROR(RESOURCE, errno);
+			return (NULL);
+		}
+
+		c->c_next = a->a_chunks;
+		a->a_chunks = c;
+		p = (unsigned char *) c + hsz;
+
+		/*
+		 * Large requests are given a chunk of their own, leaving
+		 * the current chunk in use.
+		 */
+		if (sz > csz) {
+			(void) memset(p, 0, sz);
+			return (p);
+		}
+
+		a->a_next = p;
+		a->a_avail = csz;
+		if (csz < LIBELF_ARENA_MAXCHUNK)
+			a->a_chunksz = 2 * csz;
+	}
+
+	p = a->a_next;
+	a->a_next += sz;
+	a->a_avail -= sz;
+
+	(void) memset(p, 0, sz);
+
+	return (p);
+}
+
+/*
+ * Release all the memory held by the arena of ELF descriptor 'e'.
+ * All its section descriptors need to have been released.
+ */
+void
+_libelf_release_arena(Elf *e)
+{
+	struct _Libelf_Arena *a;
+	struct _Libelf_Arena_Chunk *c, *tc;
+
+	assert(STAILQ_EMPTY(&e->e_u.e_elf.e_scn));
+
+	a = &e->e_u.e_elf.e_arena;
+
+	for (c = a->a_chunks; c != NULL; c = tc) {
+		tc = c->c_next;
+		free(c);
+	}
+
+	a->a_chunks = NULL;
+	a->a_next = NULL;
+	a->a_avail = 0;
+	a->a_chunksz = 0;
+	a->a_freedata = NULL;
+	a->a_freescn = NULL;
+}
+
 struct _Libelf_Data *
 _libelf_allocate_data(Elf_Scn *s)
 {
+	struct _Libelf_Arena *a;
 	struct _Libelf_Data *d;
 
-	if ((d = calloc((size_t) 1, sizeof(*d))) == NULL) {
-		LIBELF_SET_ERROR(RESOURCE, 0);
+	a = &s->s_elf->e_u.e_elf.e_arena;
+
+	(void) pthread_mutex_lock(&a->a_mutex);
+	if ((d = a->a_freedata) != NULL) {
+		a->a_freedata = STAILQ_NEXT(d, d_next);
+		(void) memset(d, 0, sizeof(*d));
+	} else
+		d = _libelf_arena_alloc(s->s_elf, sizeof(*d));
+	(void) pthread_mutex_unlock(&a->a_mutex);
+
+	if (d == NULL)
 		return (NULL);
-	}
 
 	d->d_scn = s;
 
@@ -138,62 +322,196 @@ _libelf_allocate_data(Elf_Scn *s)
 struct _Libelf_Data *
 _libelf_release_data(struct _Libelf_Data *d)
 {
+	struct _Libelf_Arena *a;
+
+	assert(d->d_scn != NULL);
+
+	if (d->d_scn->s_strdata == d)
+		d->d_scn->s_strdata = NULL;
 
 	if (d->d_flags & LIBELF_F_DATA_MALLOCED)
 		free(d->d_data.d_buf);
 
-	free(d);
+	a = &d->d_scn->s_elf->e_u.e_elf.e_arena;
+	(void) pthread_mutex_lock(&a->a_mutex);
+	STAILQ_NEXT(d, d_next) = a->a_freedata;
+	a->a_freedata = d;
+	(void) pthread_mutex_unlock(&a->a_mutex);
 
 	return (NULL);
 }
 
-Elf_Scn *
-_libelf_allocate_scn(Elf *e, size_t ndx)
+/*
+ * Make sure that the section table for ELF descriptor 'e' has room
+ * for section indices up to, but not including, 'nslots'.
+ */
+static int
+_libelf_grow_scntab(Elf *e, size_t nslots)
 {
-	Elf_Scn *s;
+	Elf_Scn **tab;
+	size_t newsz, oldsz;
+
+	if ((oldsz = e->e_u.e_elf.e_scntabsz) >= nslots)
+		return (1);
 
-	if ((s = calloc((size_t) 1, sizeof(Elf_Scn))) == NULL) {
+	if (nslots > SIZE_MAX / 2 / sizeof(*tab)) {
+		LIBELF_SET_ERROR(RESOURCE, 0);
+		return (0);
+	}
+
+	for (newsz = oldsz > 0 ? oldsz : 16; newsz < nslots; newsz *= 2)
+		;
+
+	if ((tab = realloc(e->e_u.e_elf.e_scntab, newsz * sizeof(*tab))) ==
+	    NULL) {
 		LIBELF_SET_ERROR(RESOURCE, errno);
-		return (NULL);
+		return (0);
 	}
 
+	(void) memset(tab + oldsz, 0, (newsz - oldsz) * sizeof(*tab));
+
+	e->e_u.e_elf.e_scntab = tab;
+	e->e_u.e_elf.e_scntabsz = newsz;
+
+	return (1);
+}
+
+static void
+_libelf_init_scn(Elf *e, Elf_Scn *s, size_t ndx)
+{
+	assert(ndx < e->e_u.e_elf.e_scntabsz);
+	assert(e->e_u.e_elf.e_scntab[ndx] == NULL);
+
 	s->s_elf = e;
 	s->s_ndx = ndx;
 
 	STAILQ_INIT(&s->s_data);
 	STAILQ_INIT(&s->s_rawdata);
 
+	e->e_u.e_elf.e_scntab[ndx] = s;
+}
+
+Elf_Scn *
+_libelf_allocate_scn(Elf *e, size_t ndx)
+{
+	Elf_Scn *s;
+	struct _Libelf_Arena *a;
+
+	if (ndx == SIZE_MAX || _libelf_grow_scntab(e, ndx + 1) == 0)
+		return (NULL);
+
+	a = &e->e_u.e_elf.e_arena;
+
+	(void) pthread_mutex_lock(&a->a_mutex);
+	if ((s = a->a_freescn) != NULL) {
+		a->a_freescn = STAILQ_NEXT(s, s_next);
+		(void) memset(s, 0, sizeof(*s));
+	} else
+		s = _libelf_arena_alloc(e, sizeof(*s));
+	(void) pthread_mutex_unlock(&a->a_mutex);
+
+	if (s == NULL)
+		return (NULL);
+
+	_libelf_init_scn(e, s, ndx);
 	STAILQ_INSERT_TAIL(&e->e_u.e_elf.e_scn, s, s_next);
 
 	return (s);
 }
 
+/*
+ * Allocate 'count' section descriptors with consecutive indices
+ * starting at 'ndx' using a single allocation from the arena, and
+ * insert them into the section list after 'prev', or at its head if
+ * 'prev' is NULL.  This is used when reading in the section header
+ * table of an existing object.
+ */
+Elf_Scn *
+_libelf_allocate_scn_block(Elf *e, Elf_Scn *prev, size_t ndx, size_t count)
+{
+	size_t i;
+	Elf_Scn *s;
+	struct _Libelf_Arena *a;
+
+	assert(count > 0);
+
+	if (count > SIZE_MAX - ndx || count > SIZE_MAX / sizeof(*s) ||
+	    _libelf_grow_scntab(e, ndx + count) == 0)
+		return (NULL);
+
+	a = &e->e_u.e_elf.e_arena;
+
+	(void) pthread_mutex_lock(&a->a_mutex);
+	s = _libelf_arena_alloc(e, count * sizeof(*s));
+	(void) pthread_mutex_unlock(&a->a_mutex);
+
+	if (s == NULL)
+		return (NULL);
+
+	for (i = 0; i < count; i++) {
+		_libelf_init_scn(e, &s[i], ndx + i);
+		if (prev == NULL)
+			STAILQ_INSERT_HEAD(&e->e_u.e_elf.e_scn, &s[i], s_next);
+		else
+			STAILQ_INSERT_AFTER(&e->e_u.e_elf.e_scn, prev, &s[i],
+			    s_next);
+		prev = &s[i];
+	}
+
+	return (s);
+}
+
 Elf_Scn *
 _libelf_release_scn(Elf_Scn *s)
 {
 	Elf *e;
+	uint32_t sh_type;
+	struct _Libelf_Arena *a;
 	struct _Libelf_Data *d, *td;
 
 	assert(s != NULL);
 
+	e = s->s_elf;
+
+	assert(e != NULL);
+
+	/*
+	 * The mapping of an archive outlives the descriptors for its
+	 * members, so hint that the pages holding the contents of a
+	 * member's sections are no longer needed.
+	 */
+	if (e->e_parent != NULL && s->s_size >= LIBELF_ADVISE_MINSIZE &&
+	    (!STAILQ_EMPTY(&s->s_data) || !STAILQ_EMPTY(&s->s_rawdata))) {
+		sh_type = e->e_class == ELFCLASS32 ?
+		    s->s_shdr.s_shdr32.sh_type : s->s_shdr.s_shdr64.sh_type;
+		if (sh_type != SHT_NOBITS)
+			_libelf_advise(e, s->s_rawoff, s->s_size,
+			    LIBELF_ADVISE_DONTNEED);
+	}
+
 	STAILQ_FOREACH_SAFE(d, &s->s_data, d_next, td) {
 		STAILQ_REMOVE(&s->s_data, d, _Libelf_Data, d_next);
 		d = _libelf_release_data(d);
 	}
 
 	STAILQ_FOREACH_SAFE(d, &s->s_rawdata, d_next, td) {
-		assert((d->d_flags & LIBELF_F_DATA_MALLOCED) == 0);
 		STAILQ_REMOVE(&s->s_rawdata, d, _Libelf_Data, d_next);
 		d = _libelf_release_data(d);
 	}
 
-	e = s->s_elf;
+	free(s->s_zbuf);
 
-	assert(e != NULL);
+	assert(s->s_ndx < e->e_u.e_elf.e_scntabsz);
+	assert(e->e_u.e_elf.e_scntab[s->s_ndx] == s);
 
 	STAILQ_REMOVE(&e->e_u.e_elf.e_scn, s, _Elf_Scn, s_next);
+	e->e_u.e_elf.e_scntab[s->s_ndx] = NULL;
 
-	free(s);
+	a = &e->e_u.e_elf.e_arena;
+	(void) pthread_mutex_lock(&a->a_mutex);
+	STAILQ_NEXT(s, s_next) = a->a_freescn;
+	a->a_freescn = s;
+	(void) pthread_mutex_unlock(&a->a_mutex);
 
 	return (NULL);
 }
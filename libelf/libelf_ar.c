@@ -105,71 +105,40 @@ ELFTC_VCSID("$Id$");
 
 
 /*
- * Retrieve an archive header descriptor.
+ * Translate the archive header `arh' of a member of archive `ar' into
+ * the descriptor pointed to by `eh'.
  */
 
-Elf_Arhdr *
-_libelf_ar_gethdr(Elf *e)
+int
+_libelf_ar_translate_hdr(Elf *ar, const struct ar_hdr *arh, Elf_Arhdr *eh)
 {
-	Elf *parent;
-	Elf_Arhdr *eh;
-	char *namelen;
+	const char *namelen;
 	size_t n, nlen;
-	struct ar_hdr *arh;
-
-	if ((parent = e->e_parent) == NULL) {
-		LIBELF_SET_ERROR(ARGUMENT, 0);
-		return (NULL);
-	}
-
-	assert((e->e_flags & LIBELF_F_AR_HEADER) == 0);
-
-	arh = (struct ar_hdr *) (uintptr_t) e->e_hdr.e_rawhdr;
-
-	assert((uintptr_t) arh >= (uintptr_t) parent->e_rawfile + SARMAG);
-
-	/*
-	 * There needs to be enough space remaining in the file for the
-	 * archive header.
-	 */
-	if ((uintptr_t) arh > (uintptr_t) parent->e_rawfile +
-	    (uintptr_t) parent->e_rawsize - sizeof(struct ar_hdr)) {
-		LIBELF_SET_ERROR(ARCHIVE, 0);
-		return (NULL);
-	}
-
-	if ((eh = malloc(sizeof(Elf_Arhdr))) == NULL) {
-		LIBELF_SET_ERROR(RESOURCE, 0);
-		return (NULL);
-	}
-
-	e->e_hdr.e_arhdr = eh;
-	e->e_flags |= LIBELF_F_AR_HEADER;
 
 	eh->ar_name = eh->ar_rawname = NULL;
 
-	if ((eh->ar_name = _libelf_ar_get_translated_name(arh, parent)) ==
+	if ((eh->ar_name = _libelf_ar_get_translated_name(arh, ar)) ==
 	    NULL)
 		goto error;
 
 	if (_libelf_ar_get_number(arh->ar_uid, sizeof(arh->ar_uid), 10,
 	    &n) == 0)
-		goto error;
+		goto fail;
 	eh->ar_uid = (uid_t) n;
 
 	if (_libelf_ar_get_number(arh->ar_gid, sizeof(arh->ar_gid), 10,
 	    &n) == 0)
-		goto error;
+		goto fail;
 	eh->ar_gid = (gid_t) n;
 
 	if (_libelf_ar_get_number(arh->ar_mode, sizeof(arh->ar_mode), 8,
 	    &n) == 0)
-		goto error;
+		goto fail;
 	eh->ar_mode = (mode_t) n;
 
 	if (_libelf_ar_get_number(arh->ar_size, sizeof(arh->ar_size), 10,
 	    &n) == 0)
-		goto error;
+		goto fail;
 
 	/*
 	 * Get the true size of the member if extended naming is being used.
@@ -179,7 +148,7 @@ _libelf_ar_gethdr(Elf *e)
 		    LIBELF_AR_BSD_EXTENDED_NAME_PREFIX_SIZE;
 		if (_libelf_ar_get_number(namelen, sizeof(arh->ar_name) -
 		    LIBELF_AR_BSD_EXTENDED_NAME_PREFIX_SIZE, 10, &nlen) == 0)
-			goto error;
+			goto fail;
 		n -= nlen;
 	}
 
@@ -190,36 +159,86 @@ _libelf_ar_gethdr(Elf *e)
 
 	eh->ar_flags = 0;
 
-	return (eh);
+	return (1);
 
+ fail:
+	LIBELF_SET_ERROR(ARCHIVE, 0);
  error:
-	if (eh) {
-		if (eh->ar_name)
-			free(eh->ar_name);
-		if (eh->ar_rawname)
-			free(eh->ar_rawname);
+	free(eh->ar_name);
+	free(eh->ar_rawname);
+	eh->ar_name = eh->ar_rawname = NULL;
+
+	return (0);
+}
+
+/*
+ * Retrieve an archive header descriptor.
+ */
+
+Elf_Arhdr *
+_libelf_ar_gethdr(Elf *e)
+{
+	Elf *parent;
+	Elf_Arhdr *eh;
+	struct ar_hdr *arh;
+
+	if ((parent = e->e_parent) == NULL) {
+		LIBELF_SET_ERROR(ARGUMENT, 0);
+		return (NULL);
+	}
+
+	assert((e->e_flags & LIBELF_F_AR_HEADER) == 0);
+
+	arh = (struct ar_hdr *) (uintptr_t) e->e_hdr.e_rawhdr;
+
+	assert((uintptr_t) arh >= (uintptr_t) parent->e_rawfile + SARMAG);
+
+	/*
+	 * There needs to be enough space remaining in the file for the
+	 * archive header.
+	 */
+	if ((uintptr_t) arh > (uintptr_t) parent->e_rawfile +
+	    (uintptr_t) parent->e_rawsize - sizeof(struct ar_hdr)) {
+		LIBELF_SET_ERROR(ARCHIVE, 0);
+		return (NULL);
+	}
+
+	if ((eh = malloc(sizeof(Elf_Arhdr))) == NULL) {
+		LIBELF_SET_ERROR(RESOURCE, 0);
+		return (NULL);
+	}
+
+	if (_libelf_ar_translate_hdr(parent, arh, eh) == 0) {
 		free(eh);
+		return (NULL);
 	}
 
-	e->e_flags &= ~LIBELF_F_AR_HEADER;
-	e->e_hdr.e_rawhdr = (unsigned char *) arh;
+	e->e_hdr.e_arhdr = eh;
+	e->e_flags |= LIBELF_F_AR_HEADER;
 
-	return (NULL);
+	return (eh);
 }
 
+/*
+ * Open the archive member whose header is at offset `next' in
+ * archive `elf'.
+ *
+ * This function does not change the archive descriptor other than to
+ * count the new child descriptor, so distinct members of an archive
+ * may be opened concurrently.
+ */
+
 Elf *
-_libelf_ar_open_member(int fd, Elf_Cmd c, Elf *elf)
+_libelf_ar_open_member(int fd, Elf_Cmd c, Elf *elf, off_t next)
 {
 	Elf *e;
 	size_t nsz, sz;
-	off_t next, end;
+	off_t end;
 	struct ar_hdr *arh;
 	char *member, *namelen;
 
 	assert(elf->e_kind == ELF_K_AR);
 
-	next = elf->e_u.e_ar.e_next;
-
 	/*
 	 * `next' is only set to zero by elf_next() when the last
 	 * member of an archive is processed.
@@ -288,12 +307,102 @@ _libelf_ar_open_member(int fd, Elf_Cmd c, Elf *elf)
 	e->e_cmd = c;
 	e->e_hdr.e_rawhdr = (unsigned char *) arh;
 
-	elf->e_u.e_ar.e_nchildren++;
+	(void) LIBELF_ATOMIC_ADD(elf->e_u.e_ar.e_nrefs, 1);
 	e->e_parent = elf;
 
 	return (e);
 }
 
+/*
+ * Build a table describing the members of archive `ar', in the order
+ * in which elf_next() would visit them.
+ */
+
+struct _Libelf_Ar_Members *
+_libelf_ar_index_members(Elf *ar)
+{
+	void *p;
+	off_t end, next;
+	Elf_Armember *am;
+	size_t n, nalloc, nsz, sz;
+	struct ar_hdr *arh;
+	struct _Libelf_Ar_Members *m;
+
+	assert(ar->e_kind == ELF_K_AR);
+
+	if ((m = calloc((size_t) 1, sizeof(*m))) == NULL) {
+		LIBELF_SET_ERROR(RESOURCE, 0);
+		return (NULL);
+	}
+
+	nalloc = 0;
+
+	for (next = ar->e_u.e_ar.e_first; next < (off_t) ar->e_rawsize;
+	     next = (end + 1) & ~1) {
+		end = next + (off_t) sizeof(struct ar_hdr);
+		if (end > (off_t) ar->e_rawsize)
+			goto archive_error;
+
+		arh = (struct ar_hdr *) (ar->e_rawfile + next);
+
+		if (arh->ar_fmag[0] != '`' || arh->ar_fmag[1] != '\n' ||
+		    _libelf_ar_get_number(arh->ar_size, sizeof(arh->ar_size),
+		    10, &sz) == 0)
+			goto archive_error;
+
+		end += (off_t) sz;
+		if (end < next || end > (off_t) ar->e_rawsize)
+			goto archive_error;
+
+		nsz = 0;
+		if (IS_EXTENDED_BSD_NAME(arh->ar_name) &&
+		    (_libelf_ar_get_number(arh->ar_name +
+		    LIBELF_AR_BSD_EXTENDED_NAME_PREFIX_SIZE,
+		    sizeof(arh->ar_name) -
+		    LIBELF_AR_BSD_EXTENDED_NAME_PREFIX_SIZE, 10, &nsz) == 0 ||
+		    nsz > sz))
+			goto archive_error;
+
+		if (m->am_count == nalloc) {
+			nalloc = nalloc ? 2 * nalloc : LIBELF_NALLOC_SIZE;
+			if ((p = realloc(m->am_members, nalloc *
+			    sizeof(Elf_Armember))) == NULL)
+				goto resource_error;
+			m->am_members = p;
+			if ((p = realloc(m->am_arhdrs, nalloc *
+			    sizeof(Elf_Arhdr))) == NULL)
+				goto resource_error;
+			m->am_arhdrs = p;
+		}
+
+		if (_libelf_ar_translate_hdr(ar, arh,
+		    &m->am_arhdrs[m->am_count]) == 0)
+			goto error;
+
+		am = &m->am_members[m->am_count++];
+		am->am_off = next;
+		am->am_dataoff = next + (off_t) (sizeof(struct ar_hdr) + nsz);
+		am->am_size = sz - nsz;
+	}
+
+	/* The header array is not moved after this point. */
+	for (n = 0; n < m->am_count; n++)
+		m->am_members[n].am_arhdr = &m->am_arhdrs[n];
+
+	return (m);
+
+ resource_error:
+	LIBELF_SET_ERROR(RESOURCE, 0);
+	goto error;
+
+ archive_error:
+	LIBELF_SET_ERROR(ARCHIVE, 0);
+
+ error:
+	_libelf_release_ar_members(m);
+	return (NULL);
+}
+
 /*
  * A BSD-style ar(1) symbol table has the following layout:
  *
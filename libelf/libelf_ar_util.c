@@ -239,7 +239,7 @@ _libelf_ar_open(Elf *e, int reporterror)
 
 	_libelf_init_elf(e, ELF_K_AR);
 
-	e->e_u.e_ar.e_nchildren = 0;
+	e->e_u.e_ar.e_nrefs = 1;
 	e->e_u.e_ar.e_next = (off_t) -1;
 
 	/*
@@ -349,7 +349,8 @@ _libelf_ar_open(Elf *e, int reporterror)
 	 * Update the 'next' offset, so that a subsequent elf_begin()
 	 * works as expected.
 	 */
-	e->e_u.e_ar.e_next = (off_t) (s - e->e_rawfile);
+	e->e_u.e_ar.e_first = e->e_u.e_ar.e_next =
+	    (off_t) (s - e->e_rawfile);
 
 	return (e);
 
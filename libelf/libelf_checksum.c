@@ -27,6 +27,7 @@
 #include <sys/cdefs.h>
 
 #include <gelf.h>
+#include <stdint.h>
 
 #include "_libelf.h"
 
@@ -34,12 +35,121 @@ ELFTC_VCSID("$Id$");
 
 /*@ELFTC-DOWNSTREAM-VCSID@*/
 
+/*
+ * Summing the bytes of section contents using vector instructions.
+ *
+ * The PSADBW instruction adds up groups of eight unsigned bytes into
+ * 64 bit lanes, which cannot overflow for any section that fits in
+ * memory.  Since the checksum is a plain sum, modulo the width of an
+ * `unsigned long', adding the vector sums to it in any order gives the
+ * same result as adding the bytes one at a time.  The instruction set
+ * to use is chosen at run time by _libelf_isa().
+ */
+
+#if	defined(LIBELF_HAVE_X86_VECTOR)
+
+#include <immintrin.h>
+
+#define	LIBELF_VSUM_MINSIZE	256	/* Smallest buffer worth summing. */
+
+__attribute__((__target__("sse2")))
+static size_t
+_libelf_vsum_sse2(const unsigned char *s, size_t size, uint64_t *sum)
+{
+	__m128i a0, a1, z;
+	size_t off;
+
+	a0 = a1 = z = _mm_setzero_si128();
+
+	for (off = 0; off + 32 <= size; off += 32) {
+		a0 = _mm_add_epi64(a0, _mm_sad_epu8(_mm_loadu_si128(
+		    (const __m128i *) (const void *) (s + off)), z));
+		a1 = _mm_add_epi64(a1, _mm_sad_epu8(_mm_loadu_si128(
+		    (const __m128i *) (const void *) (s + off + 16)), z));
+	}
+
+	a0 = _mm_add_epi64(a0, a1);
+	a0 = _mm_add_epi64(a0, _mm_unpackhi_epi64(a0, a0));
+	_mm_storel_epi64((__m128i *) (void *) sum, a0);
+
+	return (off);
+}
+
+__attribute__((__target__("avx2")))
+static size_t
+_libelf_vsum_avx2(const unsigned char *s, size_t size, uint64_t *sum)
+{
+	__m256i a0, a1, z;
+	__m128i a;
+	size_t off;
+
+	a0 = a1 = z = _mm256_setzero_si256();
+
+	for (off = 0; off + 64 <= size; off += 64) {
+		a0 = _mm256_add_epi64(a0, _mm256_sad_epu8(_mm256_loadu_si256(
+		    (const __m256i *) (const void *) (s + off)), z));
+		a1 = _mm256_add_epi64(a1, _mm256_sad_epu8(_mm256_loadu_si256(
+		    (const __m256i *) (const void *) (s + off + 32)), z));
+	}
+
+	a0 = _mm256_add_epi64(a0, a1);
+	a = _mm_add_epi64(_mm256_castsi256_si128(a0),
+	    _mm256_extracti128_si256(a0, 1));
+	a = _mm_add_epi64(a, _mm_unpackhi_epi64(a, a));
+	_mm_storel_epi64((__m128i *) (void *) sum, a);
+
+	return (off);
+}
+
+/*
+ * Sum the leading bytes of a buffer using vector instructions, if
+ * possible.  Returns the number of bytes summed.
+ */
+static size_t
+_libelf_vsum(const unsigned char *s, size_t size, uint64_t *sum)
+{
+	unsigned int isa;
+
+	if (size < LIBELF_VSUM_MINSIZE)
+		return (0);
+
+	isa = _libelf_isa();
+	if (isa & LIBELF_ISA_AVX2)
+		return (_libelf_vsum_avx2(s, size, sum));
+	if (isa & LIBELF_ISA_SSE2)
+		return (_libelf_vsum_sse2(s, size, sum));
+	return (0);
+}
+
+#else
+
+static size_t
+_libelf_vsum(const unsigned char *s, size_t size, uint64_t *sum)
+{
+	(void) s;
+	(void) size;
+	(void) sum;
+
+	return (0);
+}
+
+#endif	/* LIBELF_HAVE_X86_VECTOR */
+
 static unsigned long
 _libelf_sum(unsigned long c, const unsigned char *s, size_t size)
 {
+	size_t n;
+	uint64_t sum;
+
 	if (s == NULL || size == 0)
 		return (c);
 
+	if ((n = _libelf_vsum(s, size, &sum)) > 0) {
+		c += (unsigned long) sum;
+		s += n;
+		size -= n;
+	}
+
 	while (size--)
 		c += *s++;
 
@@ -49,12 +159,12 @@ _libelf_sum(unsigned long c, const unsigned char *s, size_t size)
 long
 _libelf_checksum(Elf *e, int elfclass)
 {
-	size_t shn;
 	Elf_Scn *scn;
 	Elf_Data *d;
+	void *ehdr;
+	uint32_t sh_type;
+	uint64_t sh_flags;
 	unsigned long checksum;
-	GElf_Ehdr eh;
-	GElf_Shdr shdr;
 
 	if (e == NULL) {
 		LIBELF_SET_ERROR(ARGUMENT, 0);
@@ -66,12 +176,17 @@ _libelf_checksum(Elf *e, int elfclass)
 		return (0L);
 	}
 
-	if (gelf_getehdr(e, &eh) == NULL)
+	if ((ehdr = _libelf_ehdr(e, elfclass, 0)) == NULL)
+		return (0);
+
+	if (e->e_cmd != ELF_C_WRITE &&
+	    (e->e_flags & LIBELF_F_SHDRS_LOADED) == 0 &&
+	    _libelf_load_section_headers(e, ehdr) == 0)
 		return (0);
 
 	/*
-	 * Iterate over all sections in the ELF file, computing the
-	 * checksum along the way.
+	 * Make a single pass over the sections in the ELF file,
+	 * computing the checksum along the way.
 	 *
 	 * The first section is always SHN_UNDEF and can be skipped.
 	 * Non-allocatable sections are skipped, as are sections that
@@ -79,14 +194,20 @@ _libelf_checksum(Elf *e, int elfclass)
 	 */
 
 	checksum = 0;
-	for (shn = 1; shn < e->e_u.e_elf.e_nscn; shn++) {
-		if ((scn = elf_getscn(e, shn)) == NULL)
-			return (0);
-		if (gelf_getshdr(scn, &shdr) == NULL)
-			return (0);
-		if ((shdr.sh_flags & SHF_ALLOC) == 0 ||
-		    shdr.sh_type == SHT_DYNAMIC ||
-		    shdr.sh_type == SHT_DYNSYM)
+	STAILQ_FOREACH(scn, &e->e_u.e_elf.e_scn, s_next) {
+		if (scn->s_ndx == SHN_UNDEF)
+			continue;
+
+		if (elfclass == ELFCLASS32) {
+			sh_flags = scn->s_shdr.s_shdr32.sh_flags;
+			sh_type  = scn->s_shdr.s_shdr32.sh_type;
+		} else {
+			sh_flags = scn->s_shdr.s_shdr64.sh_flags;
+			sh_type  = scn->s_shdr.s_shdr64.sh_type;
+		}
+
+		if ((sh_flags & SHF_ALLOC) == 0 || sh_type == SHT_DYNAMIC ||
+		    sh_type == SHT_DYNSYM)
 			continue;
 
 		d = NULL;
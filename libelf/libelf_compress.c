@@ -0,0 +1,486 @@
+/*-
+ * Copyright (c) 2026, Elftoolchain Project Contributors.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE AUTHOR AND CONTRIBUTORS ``AS IS'' AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED.  IN NO EVENT SHALL THE AUTHOR OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS
+ * OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY
+ * OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+ * SUCH DAMAGE.
+ */
+
+#include <sys/cdefs.h>
+
+#include <assert.h>
+#include <libelf.h>
+#include <limits.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+#if	defined(LIBELF_HAVE_ZLIB)
+#include <zlib.h>
+#endif
+#if	defined(LIBELF_HAVE_ZSTD)
+#include <zstd.h>
+#endif
+
+#include "_libelf.h"
+
+ELFTC_VCSID("$Id$");
+
+/*@ELFTC-DOWNSTREAM-VCSID@*/
+
+/*
+ * Support for sections with the SHF_COMPRESSED flag set.  The contents
+ * of such sections consist of an Elf_Chdr header followed by the
+ * compressed form of the section's data.
+ */
+
+/*
+ * Translate the compression header at the start of the `sz' bytes
+ * at `src' to its generic form.
+ */
+int
+_libelf_zchdr(Elf *e, unsigned char *src, size_t sz, Elf64_Chdr *dst)
+{
+	int ec;
+	size_t fsz;
+	Elf32_Chdr ch32;
+	_libelf_translator_function *xlate;
+
+	ec = e->e_class;
+	fsz = _libelf_fsize(ELF_T_CHDR, ec, e->e_version, (size_t) 1);
+
+	if (src == NULL || sz < fsz) {
+		LIBELF_SET_ERROR(SECTION, 0);
+		return (0);
+	}
+
+	xlate = _libelf_get_translator(ELF_T_CHDR, ELF_TOMEMORY, ec,
+	    _libelf_elfmachine(e));
+
+	if (ec == ELFCLASS32) {
+		(void) (*xlate)((unsigned char *) &ch32, sizeof(ch32), src,
+		    (size_t) 1, e->e_byteorder != LIBELF_PRIVATE(byteorder));
+		dst->ch_type      = ch32.ch_type;
+		dst->ch_reserved  = 0;
+		dst->ch_size      = (Elf64_Xword) ch32.ch_size;
+		dst->ch_addralign = (Elf64_Xword) ch32.ch_addralign;
+	} else
+		(void) (*xlate)((unsigned char *) dst, sizeof(*dst), src,
+		    (size_t) 1, e->e_byteorder != LIBELF_PRIVATE(byteorder));
+
+	return (1);
+}
+
+/*
+ * Translate the generic compression header `src' to its file
+ * representation at `dst'.
+ */
+static int
+_libelf_zchdr_tofile(Elf *e, unsigned char *dst, const Elf64_Chdr *src)
+{
+	int ec;
+	Elf32_Chdr ch32;
+	Elf64_Chdr ch64;
+	unsigned char *p;
+	_libelf_translator_function *xlate;
+
+	if ((ec = e->e_class) == ELFCLASS32) {
+		ch32.ch_type = src->ch_type;
+		LIBELF_COPY_U32(&ch32, src, ch_size);
+		LIBELF_COPY_U32(&ch32, src, ch_addralign);
+		p = (unsigned char *) &ch32;
+	} else {
+		ch64 = *src;
+		p = (unsigned char *) &ch64;
+	}
+
+	xlate = _libelf_get_translator(ELF_T_CHDR, ELF_TOFILE, ec,
+	    _libelf_elfmachine(e));
+
+	(void) (*xlate)(dst, _libelf_fsize(ELF_T_CHDR, ec, e->e_version,
+	    (size_t) 1), p, (size_t) 1,
+	    e->e_byteorder != LIBELF_PRIVATE(byteorder));
+
+	return (1);
+}
+
+/*
+ * Replace the compressed contents of section `s' by a data descriptor
+ * holding their decompressed form, translated to the memory
+ * representation of the section's type.
+ *
+ * The compressed contents are taken from the section's data
+ * descriptor if the application has retrieved or supplied one, and
+ * from the underlying file otherwise.
+ *
+ * On success, the section is marked as needing to be compressed again
+ * by elf_update(3) using the same compression type.  Its compressed
+ * contents are retained in `s_zbuf' and written out as they are, until
+ * the section or its data is next flagged as modified.
+ */
+int
+_libelf_decompress_scn(Elf_Scn *s)
+{
+	Elf *e;
+	Elf64_Chdr ch;
+	int ec, elftype;
+	uint32_t sh_type;
+	struct _Libelf_Data *d, *od;
+	uint64_t sh_offset, sh_size, t0;
+	size_t bufsz, chsz, count, fsz, msz, srcsz;
+	unsigned char *buf, *dst, *src, *zbuf;
+	_libelf_translator_function *xlate;
+#if	defined(LIBELF_HAVE_ZLIB)
+	uLongf dlen;
+	int r;
+#endif
+
+	e = s->s_elf;
+	ec = e->e_class;
+
+	if (ec == ELFCLASS32) {
+		sh_type   = s->s_shdr.s_shdr32.sh_type;
+		sh_offset = (uint64_t) s->s_shdr.s_shdr32.sh_offset;
+		sh_size   = (uint64_t) s->s_shdr.s_shdr32.sh_size;
+	} else {
+		sh_type   = s->s_shdr.s_shdr64.sh_type;
+		sh_offset = s->s_shdr.s_shdr64.sh_offset;
+		sh_size   = s->s_shdr.s_shdr64.sh_size;
+	}
+
+	if (sh_type == SHT_NULL || sh_type == SHT_NOBITS ||
+	    (elftype = _libelf_xlate_shtype(sh_type)) < ELF_T_FIRST ||
+	    elftype > ELF_T_LAST) {
+		LIBELF_SET_ERROR(SECTION, 0);
+		return (0);
+	}
+
+	buf = dst = zbuf = NULL;
+
+	if ((od = STAILQ_FIRST(&s->s_data)) != NULL) {
+		if (STAILQ_NEXT(od, d_next) != NULL ||
+		    od->d_data.d_type != ELF_T_BYTE) {
+			LIBELF_SET_ERROR(DATA, 0);
+			return (0);
+		}
+		src = od->d_data.d_buf;
+		srcsz = (size_t) od->d_data.d_size;
+	} else {
+		if (!LIBELF_HAS_RAWFILE(e) ||
+		    sh_offset > (uint64_t) e->e_rawsize ||
+		    sh_size > (uint64_t) e->e_rawsize - sh_offset) {
+			LIBELF_SET_ERROR(SECTION, 0);
+			return (0);
+		}
+		srcsz = (size_t) sh_size;
+		if ((e->e_flags & LIBELF_F_RAWFILE_LAZY) == 0)
+			src = e->e_rawfile + sh_offset;
+		else if ((src = buf = malloc(srcsz > 0 ? srcsz : 1)) ==
+		    NULL) {
+			LIBELF_SET_ERROR(RESOURCE, 0);
+			return (0);
+		} else if (!_libelf_lazy_read(e, buf, sh_offset, srcsz, 0))
+			goto error;
+	}
+
+	if (!_libelf_zchdr(e, src, srcsz, &ch))
+		goto error;
+
+	chsz = _libelf_fsize(ELF_T_CHDR, ec, e->e_version, (size_t) 1);
+	fsz = _libelf_fsize(elftype, ec, e->e_version, (size_t) 1);
+	if ((msz = _libelf_msize(elftype, ec, e->e_version)) == 0)
+		goto error;
+
+	if (ch.ch_addralign == 0)
+		ch.ch_addralign = 1;
+
+	if (ch.ch_size % fsz || (ch.ch_addralign & (ch.ch_addralign - 1))) {
+		LIBELF_SET_ERROR(SECTION, 0);
+		goto error;
+	}
+
+	count = (size_t) (ch.ch_size / fsz);
+	if (ch.ch_size > SIZE_MAX || ch.ch_size > ULONG_MAX ||
+	    srcsz - chsz > ULONG_MAX || (count > 0 && msz > SIZE_MAX / count)) {
+		LIBELF_SET_ERROR(RANGE, 0);
+		goto error;
+	}
+
+	/*
+	 * The buffer is large enough for both representations of the
+	 * section's data, which is translated in place.
+	 */
+	bufsz = msz * count;
+	if (bufsz < (size_t) ch.ch_size)
+		bufsz = (size_t) ch.ch_size;
+
+	if ((dst = malloc(bufsz > 0 ? bufsz : 1)) == NULL) {
+		LIBELF_SET_ERROR(RESOURCE, 0);
+		goto error;
+	}
+
+	switch (ch.ch_type) {
+#if	defined(LIBELF_HAVE_ZLIB)
+	case ELFCOMPRESS_ZLIB:
+		dlen = (uLongf) ch.ch_size;
+		r = uncompress(dst, &dlen, src + chsz, (uLong) (srcsz - chsz));
+		if (r == Z_MEM_ERROR) {
+			LIBELF_SET_ERROR(RESOURCE, 0);
+			goto error;
+		}
+		if (r != Z_OK || dlen != ch.ch_size) {
+			LIBELF_SET_ERROR(DATA, 0);
+			goto error;
+		}
+		break;
+#endif
+#if	defined(LIBELF_HAVE_ZSTD)
+	case ELFCOMPRESS_ZSTD:
+		if (ZSTD_decompress(dst, (size_t) ch.ch_size, src + chsz,
+		    srcsz - chsz) != ch.ch_size) {
+			LIBELF_SET_ERROR(DATA, 0);
+			goto error;
+		}
+		break;
+#endif
+	default:
+		LIBELF_SET_ERROR(UNIMPL, 0);
+		goto error;
+	}
+
+	if (elftype != ELF_T_BYTE) {
+		xlate = _libelf_get_translator(elftype, ELF_TOMEMORY, ec,
+		    _libelf_elfmachine(e));
+		t0 = _libelf_stats_clock();
+		if (!(*xlate)(dst, msz * count, dst, count,
+		    e->e_byteorder != LIBELF_PRIVATE(byteorder))) {
+			LIBELF_SET_ERROR(DATA, 0);
+			goto error;
+		}
+		LIBELF_STATS_ADD(e, es_xlate_nsec, _libelf_stats_clock() - t0);
+		LIBELF_STATS_ADD(e, es_xlate_calls, 1);
+		LIBELF_STATS_ADD(e, es_xlate_bytes, ch.ch_size);
+	}
+
+	/* Keep the compressed contents; a buffer read in can be reused. */
+	if (buf != NULL) {
+		zbuf = buf;
+		buf = NULL;
+	} else if ((zbuf = malloc(srcsz)) == NULL) {
+		LIBELF_SET_ERROR(RESOURCE, 0);
+		goto error;
+	} else
+		(void) memcpy(zbuf, src, srcsz);
+
+	if ((d = _libelf_allocate_data(s)) == NULL)
+		goto error;
+
+	d->d_data.d_align   = ch.ch_addralign;
+	d->d_data.d_buf     = dst;
+	d->d_data.d_off     = 0;
+	d->d_data.d_size    = msz * count;
+	d->d_data.d_type    = elftype;
+	d->d_data.d_version = e->e_version;
+	d->d_flags |= LIBELF_F_DATA_MALLOCED;
+	LIBELF_STATS_ADD(e, es_allocated[elftype], bufsz);
+
+	if (od != NULL) {
+		STAILQ_REMOVE(&s->s_data, od, _Libelf_Data, d_next);
+		(void) _libelf_release_data(od);
+	}
+
+	STAILQ_INSERT_TAIL(&s->s_data, d, d_next);
+
+	_libelf_release_zbuf(s);
+
+	s->s_ctype = (int) ch.ch_type;
+	s->s_chdr = ch;
+	s->s_strdata = NULL;
+	s->s_zbuf = zbuf;
+	s->s_zsize = srcsz;
+
+	free(buf);
+
+	return (1);
+
+error:
+	free(zbuf);
+	free(dst);
+	free(buf);
+
+	return (0);
+}
+
+/*
+ * Discard the compressed contents of section `s', if any.
+ */
+void
+_libelf_release_zbuf(Elf_Scn *s)
+{
+	free(s->s_zbuf);
+	s->s_zbuf = NULL;
+	s->s_zsize = 0;
+}
+
+/*
+ * Compress the contents of section `s' for elf_update(3).
+ *
+ * The caller lays out the section's data descriptors, and describes
+ * the uncompressed contents of the section in `s_chdr'.  On success,
+ * `s_zbuf' holds the file representation of the compressed section,
+ * header included.  It is left NULL if compression would not reduce
+ * the size of the section and the application did not ask for the
+ * section to be compressed regardless.
+ *
+ * This function may be invoked concurrently for different sections
+ * of an ELF object.
+ */
+int
+_libelf_compress_scn(Elf_Scn *s)
+{
+	Elf *e;
+	int ec, em;
+	Elf_Data dst, *d;
+	struct _Libelf_Data *ld;
+	size_t chsz, size, zlen;
+	unsigned char *img, *zbuf;
+	uint64_t t0;
+#if	defined(LIBELF_HAVE_ZLIB) || defined(LIBELF_HAVE_ZSTD)
+	size_t zcap;
+#endif
+#if	defined(LIBELF_HAVE_ZLIB)
+	uLongf zl;
+	int r;
+#endif
+
+	e = s->s_elf;
+	ec = e->e_class;
+	em = _libelf_elfmachine(e);
+
+	assert(s->s_zbuf == NULL);
+	assert(s->s_chdr.ch_type == (Elf64_Word) s->s_ctype);
+
+	if (s->s_chdr.ch_size > SIZE_MAX) {
+		LIBELF_SET_ERROR(RANGE, 0);
+		return (0);
+	}
+
+	size = (size_t) s->s_chdr.ch_size;
+	chsz = _libelf_fsize(ELF_T_CHDR, ec, e->e_version, (size_t) 1);
+	zbuf = NULL;
+
+	/*
+	 * Build the file representation of the section's contents.
+	 */
+	if ((img = malloc(size > 0 ? size : 1)) == NULL) {
+		LIBELF_SET_ERROR(RESOURCE, 0);
+		return (0);
+	}
+
+	(void) memset(img, LIBELF_GET_PRIVATE(fillchar), size);
+
+	(void) memset(&dst, 0, sizeof(dst));
+	STAILQ_FOREACH(ld, &s->s_data, d_next) {
+		d = &ld->d_data;
+		if (d->d_size == 0)
+			continue;
+		assert(d->d_off <= size);
+		dst.d_buf     = img + d->d_off;
+		dst.d_size    = size - (size_t) d->d_off;
+		dst.d_version = d->d_version;
+		t0 = _libelf_stats_clock();
+		if (_libelf_xlate(&dst, d, e->e_byteorder, ec, em,
+		    ELF_TOFILE) == NULL)
+			goto error;
+		LIBELF_STATS_ADD(e, es_xlate_nsec, _libelf_stats_clock() - t0);
+		LIBELF_STATS_ADD(e, es_xlate_calls, 1);
+		LIBELF_STATS_ADD(e, es_xlate_bytes, dst.d_size);
+	}
+
+	switch (s->s_ctype) {
+#if	defined(LIBELF_HAVE_ZLIB)
+	case ELFCOMPRESS_ZLIB:
+		if (size > ULONG_MAX) {
+			LIBELF_SET_ERROR(RANGE, 0);
+			goto error;
+		}
+		zcap = (size_t) compressBound((uLong) size);
+		if ((zbuf = malloc(chsz + zcap)) == NULL) {
+			LIBELF_SET_ERROR(RESOURCE, 0);
+			goto error;
+		}
+		zl = (uLongf) zcap;
+		r = compress2(zbuf + chsz, &zl, img, (uLong) size,
+		    Z_DEFAULT_COMPRESSION);
+		if (r == Z_MEM_ERROR) {
+			LIBELF_SET_ERROR(RESOURCE, 0);
+			goto error;
+		}
+		if (r != Z_OK) {
+			LIBELF_SET_ERROR(DATA, 0);
+			goto error;
+		}
+		zlen = (size_t) zl;
+		break;
+#endif
+#if	defined(LIBELF_HAVE_ZSTD)
+	case ELFCOMPRESS_ZSTD:
+		zcap = ZSTD_compressBound(size);
+		if ((zbuf = malloc(chsz + zcap)) == NULL) {
+			LIBELF_SET_ERROR(RESOURCE, 0);
+			goto error;
+		}
+		zlen = ZSTD_compress(zbuf + chsz, zcap, img, size,
+		    ZSTD_CLEVEL_DEFAULT);
+		if (ZSTD_isError(zlen)) {
+			LIBELF_SET_ERROR(DATA, 0);
+			goto error;
+		}
+		break;
+#endif
+	default:
+		LIBELF_SET_ERROR(UNIMPL, 0);
+		goto error;
+	}
+
+	free(img);
+	img = NULL;
+
+	if (chsz + zlen >= size && (s->s_cflags & ELF_CHF_FORCE) == 0 &&
+	    (e->e_flags & ELF_F_LAYOUT) == 0) {
+		free(zbuf);
+		return (1);
+	}
+
+	if (!_libelf_zchdr_tofile(e, zbuf, &s->s_chdr))
+		goto error;
+
+	s->s_zbuf = zbuf;
+	s->s_zsize = chsz + zlen;
+
+	return (1);
+
+error:
+	free(img);
+	free(zbuf);
+
+	return (0);
+}
@@ -144,6 +144,8 @@ define(`SIZEDEP_OFF',	1)
 #
 # Generates a pair of conversion functions.
 define(`MAKEPRIMFUNCS',`
+static const unsigned char _libelf_fields_$1$4[] = { sizeof(Elf$3_$2), 0 };
+
 static int
 _libelf_cvt_$1$4_tof(unsigned char *dst, size_t dsz, unsigned char *src,
     size_t count, int byteswap)
@@ -158,7 +160,11 @@ _libelf_cvt_$1$4_tof(unsigned char *dst, size_t dsz, unsigned char *src,
 		return (1);
 	}
 
-	for (c = 0; c < count; c++) {
+	c = _libelf_vswap(dst, src, count, sizeof(*s), _libelf_fields_$1$4);
+	s += c;
+	dst += c * sizeof(*s);
+
+	for (; c < count; c++) {
 		t = *s++;
 		SWAP_$1$4(t);
 		WRITE_$1$4(dst,t);
@@ -182,7 +188,11 @@ _libelf_cvt_$1$4_tom(unsigned char *dst, size_t dsz, unsigned char *src,
 		return (1);
 	}
 
-	for (c = 0; c < count; c++) {
+	c = _libelf_vswap(dst, src, count, sizeof(*d), _libelf_fields_$1$4);
+	d += c;
+	src += c * sizeof(*d);
+
+	for (; c < count; c++) {
 		READ_$1$4(src,t);
 		SWAP_$1$4(t);
 		*d++ = t;
@@ -250,6 +260,34 @@ define(`READ_STRUCT',
   `pushdef(`SZ',$2)/* Read an Elf$2_$1 */
 		READ_MEMBERS(Elf$2_$1_DEF)popdef(`SZ')')
 
+# FSZ_<TYPE> -- The file sizes of the basic types, as seen by the
+# vector byte swapper.  An IDENT is an array of bytes.
+define(`FSZ_ADDR32',	4)
+define(`FSZ_ADDR64',	8)
+define(`FSZ_BYTE',	1)
+define(`FSZ_HALF',	2)
+define(`FSZ_IDENT',	`1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1')
+define(`FSZ_LWORD',	8)
+define(`FSZ_OFF32',	4)
+define(`FSZ_OFF64',	8)
+define(`FSZ_SWORD',	4)
+define(`FSZ_SXWORD',	8)
+define(`FSZ_WORD',	4)
+define(`FSZ_XWORD',	8)
+
+# FIELD_SIZE(FIELDNAME,ELFTYPE) -- Generate the file size of one field.
+define(`FIELD_SIZE',
+  `ifdef(`SIZEDEP_'$2,`FSZ_$2'SZ(),`FSZ_$2'), ')
+
+# FIELD_SIZE_MEMBERS(ELFTYPELIST) -- Iterate over a structure definition.
+define(`FIELD_SIZE_MEMBERS',
+  `ifelse($#,1,`',
+    `FIELD_SIZE($1)FIELD_SIZE_MEMBERS(shift($@))')')
+
+# FIELD_SIZES(CTYPE,SIZE) -- Generate the list of field sizes of an
+# ELF structure, in file order.
+define(`FIELD_SIZES',
+  `pushdef(`SZ',$2)FIELD_SIZE_MEMBERS(Elf$2_$1_DEF)popdef(`SZ')')
 
 # MAKECOMPFUNCS -- Generate converters for composite ELF structures.
 #
@@ -268,6 +306,10 @@ define(`READ_STRUCT',
 # `$2': C structure name suffix.
 # `$3': ELF class specifier, one of [`', `32', `64']
 define(`MAKECOMPFUNCS', `ifdef(`NOFUNC_'$1$3,`',`
+static const unsigned char _libelf_fields_$1$3[] = {
+	FIELD_SIZES($2,$3)0
+};
+
 static int
 _libelf_cvt_$1$3_tof(unsigned char *dst, size_t dsz, unsigned char *src,
     size_t count, int byteswap)
@@ -278,7 +320,15 @@ _libelf_cvt_$1$3_tof(unsigned char *dst, size_t dsz, unsigned char *src,
 	(void) dsz;
 
 	s = (Elf$3_$2 *) (uintptr_t) src;
-	for (c = 0; c < count; c++) {
+	c = 0;
+	if (byteswap) {
+		c = _libelf_vswap(dst, src, count, sizeof(t),
+		    _libelf_fields_$1$3);
+		s += c;
+		dst += c * sizeof(t);
+	}
+
+	for (; c < count; c++) {
 		t = *s++;
 		if (byteswap) {
 			SWAP_STRUCT($2,$3)
@@ -295,15 +345,23 @@ _libelf_cvt_$1$3_tom(unsigned char *dst, size_t dsz, unsigned char *src,
 {
 	Elf$3_$2	t, *d;
 	unsigned char	*s,*s0;
-	size_t		fsz;
+	size_t		c, fsz;
+
+	if (dsz < count * sizeof(Elf$3_$2))
+		return (0);
+
+	if (byteswap) {
+		c = _libelf_vswap(dst, src, count, sizeof(t),
+		    _libelf_fields_$1$3);
+		dst += c * sizeof(t);
+		src += c * sizeof(t);
+		count -= c;
+	}
 
 	fsz = elf$3_fsize(ELF_T_$1, (size_t) 1, EV_CURRENT);
 	d   = ((Elf$3_$2 *) (uintptr_t) dst) + (count - 1);
 	s0  = src + (count - 1) * fsz;
 
-	if (dsz < count * sizeof(Elf$3_$2))
-		return (0);
-
 	while (count--) {
 		s = s0;
 		READ_STRUCT($2,$3)
@@ -699,6 +757,165 @@ divert(0)
 
 #define	ROUNDUP2(V,N)	(V) = ((((V) + (N) - 1)) & ~((N) - 1))
 
+/*
+ * Byte swapping arrays of fixed size ELF types using vector byte
+ * shuffles.
+ *
+ * A record of an ELF type is described by the list of the file sizes
+ * of its fields.  Swapping the bytes of each field of an array of
+ * records is then a fixed permutation of the bytes in every group of
+ * "period" bytes, where "period" is the least common multiple of the
+ * record size and the vector width.  The PSHUFB instruction permutes
+ * bytes within 16 byte lanes, so the permutation can be used only if
+ * no field straddles a lane boundary.  This holds for the naturally
+ * aligned ELF types.
+ *
+ * The vector code is used only if the file and memory representations
+ * of a type have the same size, that is, if the type has no padding.
+ * The instruction set to use is chosen at run time by _libelf_isa();
+ * the scalar converters handle any records left over.
+ */
+
+#if	defined(LIBELF_HAVE_X86_VECTOR)
+
+#include <immintrin.h>
+
+#define	LIBELF_VSWAP_MAXPERIOD	256	/* Largest permutation handled. */
+#define	LIBELF_VSWAP_MINSIZE	512	/* Smallest array worth swapping. */
+
+/*
+ * Fill in a shuffle mask of "period" bytes that reverses the bytes of
+ * each field of consecutive records of size "rsz".  Return 0 if a field
+ * straddles a 16 byte lane.
+ */
+static int
+_libelf_vswap_mask(unsigned char *mask, size_t period, size_t rsz,
+    const unsigned char *fields)
+{
+	size_t base, f, i, off, sz;
+
+	for (base = 0; base < period; base += rsz) {
+		off = base;
+		for (f = 0; (sz = fields[f]) != 0; f++) {
+			if (off / 16 != (off + sz - 1) / 16)
+				return (0);
+			for (i = 0; i < sz; i++)
+				mask[off + i] = (unsigned char)
+				    ((off + sz - 1 - i) % 16);
+			off += sz;
+		}
+	}
+
+	return (1);
+}
+
+__attribute__((__target__("ssse3")))
+static size_t
+_libelf_vswap_ssse3(unsigned char *dst, const unsigned char *src,
+    size_t sz, const unsigned char *mask, size_t period)
+{
+	__m128i m[LIBELF_VSWAP_MAXPERIOD / 16], v;
+	size_t i, n, off;
+
+	n = period / 16;
+	for (i = 0; i < n; i++)
+		m[i] = _mm_loadu_si128((const __m128i *) (const void *)
+		    (mask + i * 16));
+
+	for (off = 0; off + period <= sz; off += period)
+		for (i = 0; i < n; i++) {
+			v = _mm_loadu_si128((const __m128i *) (const void *)
+			    (src + off + i * 16));
+			v = _mm_shuffle_epi8(v, m[i]);
+			_mm_storeu_si128((__m128i *) (void *)
+			    (dst + off + i * 16), v);
+		}
+
+	return (off);
+}
+
+__attribute__((__target__("avx2")))
+static size_t
+_libelf_vswap_avx2(unsigned char *dst, const unsigned char *src,
+    size_t sz, const unsigned char *mask, size_t period)
+{
+	__m256i m[LIBELF_VSWAP_MAXPERIOD / 32], v;
+	size_t i, n, off;
+
+	n = period / 32;
+	for (i = 0; i < n; i++)
+		m[i] = _mm256_loadu_si256((const __m256i *) (const void *)
+		    (mask + i * 32));
+
+	for (off = 0; off + period <= sz; off += period)
+		for (i = 0; i < n; i++) {
+			v = _mm256_loadu_si256((const __m256i *) (const void *)
+			    (src + off + i * 32));
+			v = _mm256_shuffle_epi8(v, m[i]);
+			_mm256_storeu_si256((__m256i *) (void *)
+			    (dst + off + i * 32), v);
+		}
+
+	return (off);
+}
+
+/*
+ * Byte swap the leading records of an array of "count" records of size
+ * "rsz" with the layout described by "fields".  Return the number of
+ * records converted.  The source and destination may be identical.
+ */
+static size_t
+_libelf_vswap(unsigned char *dst, const unsigned char *src, size_t count,
+    size_t rsz, const unsigned char *fields)
+{
+	unsigned char mask[LIBELF_VSWAP_MAXPERIOD];
+	size_t f, fsz, period, vsz;
+	unsigned int isa;
+
+	if (count * rsz < LIBELF_VSWAP_MINSIZE)
+		return (0);
+
+	if ((isa = _libelf_isa()) & LIBELF_ISA_AVX2)
+		isa = LIBELF_ISA_AVX2;
+	else if (isa & LIBELF_ISA_SSSE3)
+		isa = LIBELF_ISA_SSSE3;
+	else
+		return (0);
+
+	for (f = fsz = 0; fields[f] != 0; f++)
+		fsz += fields[f];
+	if (fsz != rsz)
+		return (0);
+
+	vsz = (isa == LIBELF_ISA_AVX2) ? 32 : 16;
+	for (period = rsz; period % vsz != 0; period += rsz)
+		if (period > LIBELF_VSWAP_MAXPERIOD)
+			return (0);
+	if (period > LIBELF_VSWAP_MAXPERIOD ||
+	    !_libelf_vswap_mask(mask, period, rsz, fields))
+		return (0);
+
+	if (isa == LIBELF_ISA_AVX2)
+		return (_libelf_vswap_avx2(dst, src, count * rsz, mask,
+		    period) / rsz);
+	else
+		return (_libelf_vswap_ssse3(dst, src, count * rsz, mask,
+		    period) / rsz);
+}
+
+#else
+
+static size_t
+_libelf_vswap(unsigned char *dst, const unsigned char *src, size_t count,
+    size_t rsz, const unsigned char *fields)
+{
+	(void) dst; (void) src; (void) count; (void) rsz; (void) fields;
+
+	return (0);
+}
+
+#endif	/* LIBELF_HAVE_X86_VECTOR */
+
 /*[*/
 MAKE_TYPE_CONVERTERS(ELF_TYPE_LIST)
 MAKE_VERSION_CONVERTERS(VDEF,Verdef,Verdaux,vd)
@@ -48,6 +48,8 @@ _libelf_load_extended(Elf *e, int ec, uint64_t shoff, uint16_t phnum,
 	size_t fsz;
 	Elf_Scn *scn;
 	uint32_t shtype;
+	uint64_t t0;
+	unsigned char *buf, *src;
 	_libelf_translator_function *xlator;
 
 	assert(STAILQ_EMPTY(&e->e_u.e_elf.e_scn));
@@ -65,14 +67,25 @@ _libelf_load_extended(Elf *e, int ec, uint64_t shoff, uint16_t phnum,
 		return (0);
 	}
 
-	if ((scn = _libelf_allocate_scn(e, (size_t) 0)) == NULL)
+	if ((src = _libelf_rawbytes(e, shoff, fsz, &buf)) == NULL)
 		return (0);
 
+	if ((scn = _libelf_allocate_scn(e, (size_t) 0)) == NULL) {
+		free(buf);
+		return (0);
+	}
+
 	xlator = _libelf_get_translator(ELF_T_SHDR, ELF_TOMEMORY, ec,
 	    _libelf_elfmachine(e));
+	t0 = _libelf_stats_clock();
 	(*xlator)((unsigned char *) &scn->s_shdr, sizeof(scn->s_shdr),
-	    (unsigned char *) e->e_rawfile + shoff, (size_t) 1,
-	    e->e_byteorder != LIBELF_PRIVATE(byteorder));
+	    src, (size_t) 1, e->e_byteorder != LIBELF_PRIVATE(byteorder));
+	free(buf);
+
+	LIBELF_STATS_ADD(e, es_xlate_nsec, _libelf_stats_clock() - t0);
+	LIBELF_STATS_ADD(e, es_xlate_calls, 1);
+	LIBELF_STATS_ADD(e, es_xlate_bytes, fsz);
+	LIBELF_STATS_ADD(e, es_sections, 1);
 
 #define	GET_SHDR_MEMBER(M) ((ec == ELFCLASS32) ? scn->s_shdr.s_shdr32.M : \
 		scn->s_shdr.s_shdr64.M)
@@ -100,19 +113,20 @@ _libelf_load_extended(Elf *e, int ec, uint64_t shoff, uint16_t phnum,
 		eh->e_ident[EI_MAG3] = ELFMAG3;				\
 		eh->e_ident[EI_CLASS] = ELFCLASS##SZ;			\
 		eh->e_ident[EI_DATA]  = ELFDATANONE;			\
-		eh->e_ident[EI_VERSION] = LIBELF_PRIVATE(version) & 0xFFU; \
+		eh->e_version = LIBELF_GET_PRIVATE(version);		\
+		eh->e_ident[EI_VERSION] = eh->e_version & 0xFFU;	\
 		eh->e_machine = EM_NONE;				\
 		eh->e_type    = ELF_K_NONE;				\
-		eh->e_version = LIBELF_PRIVATE(version);		\
 	} while (/* CONSTCOND */ 0)
 
 void *
 _libelf_ehdr(Elf *e, int ec, int allocate)
 {
 	void *ehdr;
+	unsigned char *buf, *src;
 	size_t fsz, msz;
 	uint16_t phnum, shnum, strndx;
-	uint64_t shoff;
+	uint64_t shoff, t0;
 	int (*xlator)(unsigned char *_d, size_t _dsz, unsigned char *_s,
 	    size_t _c, int _swap);
 
@@ -155,11 +169,19 @@ _libelf_ehdr(Elf *e, int ec, int allocate)
 	if ((msz = _libelf_msize(ELF_T_EHDR, ec, EV_CURRENT)) == 0)
 		return (NULL);
 
+	src = buf = NULL;
+	if (e->e_cmd != ELF_C_WRITE &&
+	    (src = _libelf_rawbytes(e, 0, fsz, &buf)) == NULL)
+		return (NULL);
+
 	if ((ehdr = calloc((size_t) 1, msz)) == NULL) {
+		free(buf);
 		LIBELF_SET_ERROR(RESOURCE, 0);
 		return (NULL);
 	}
 
+	LIBELF_STATS_ADD(e, es_allocated[ELF_T_EHDR], msz);
+
 	if (ec == ELFCLASS32) {
 		e->e_u.e_elf.e_ehdr.e_ehdr32 = ehdr;
 		EHDR_INIT(ehdr,32);
@@ -176,8 +198,14 @@ _libelf_ehdr(Elf *e, int ec, int allocate)
 
 	xlator = _libelf_get_translator(ELF_T_EHDR, ELF_TOMEMORY, ec,
 	    _libelf_elfmachine(e));
-	(*xlator)((unsigned char*) ehdr, msz, e->e_rawfile, (size_t) 1,
+	t0 = _libelf_stats_clock();
+	(*xlator)((unsigned char*) ehdr, msz, src, (size_t) 1,
 	    e->e_byteorder != LIBELF_PRIVATE(byteorder));
+	free(buf);
+
+	LIBELF_STATS_ADD(e, es_xlate_nsec, _libelf_stats_clock() - t0);
+	LIBELF_STATS_ADD(e, es_xlate_calls, 1);
+	LIBELF_STATS_ADD(e, es_xlate_bytes, fsz);
 
 	if (ec == ELFCLASS32) {
 		phnum = ((Elf32_Ehdr *) ehdr)->e_phnum;
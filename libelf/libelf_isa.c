@@ -0,0 +1,70 @@
+/*-
+ * Copyright (c) 2026, Elftoolchain Project Contributors.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE AUTHOR AND CONTRIBUTORS ``AS IS'' AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED.  IN NO EVENT SHALL THE AUTHOR OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS
+ * OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY
+ * OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+ * SUCH DAMAGE.
+ */
+
+#include <sys/cdefs.h>
+
+#include <libelf.h>
+#include <stdlib.h>
+
+#include "_libelf.h"
+
+ELFTC_VCSID("$Id$");
+
+/*@ELFTC-DOWNSTREAM-VCSID@*/
+
+/*
+ * Return the set of vector instruction sets that the library may use,
+ * as a mask of LIBELF_ISA_* flags.  The set is determined on first use.
+ * Setting the environment variable LIBELF_NOSIMD disables the vector
+ * code throughout the library.
+ */
+unsigned int
+_libelf_isa(void)
+{
+	unsigned int isa;
+
+	if ((isa = LIBELF_GET_PRIVATE(isa)) != LIBELF_ISA_UNKNOWN)
+		return (isa);
+
+	isa = 0;
+
+#if	defined(LIBELF_HAVE_X86_VECTOR)
+	if (getenv("LIBELF_NOSIMD") == NULL) {
+		__builtin_cpu_init();
+		if (__builtin_cpu_supports("sse2"))
+			isa |= LIBELF_ISA_SSE2;
+		if (__builtin_cpu_supports("ssse3"))
+			isa |= LIBELF_ISA_SSSE3;
+		if (__builtin_cpu_supports("avx2"))
+			isa |= LIBELF_ISA_AVX2;
+	}
+#endif
+
+	/* Concurrent callers compute the same value. */
+	LIBELF_SET_PRIVATE(isa, isa);
+
+	return (isa);
+}
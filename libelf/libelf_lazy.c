@@ -0,0 +1,349 @@
+/*-
+ * Copyright (c) 2026, Elftoolchain Project Contributors.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE AUTHOR AND CONTRIBUTORS ``AS IS'' AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED.  IN NO EVENT SHALL THE AUTHOR OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS
+ * OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY
+ * OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+ * SUCH DAMAGE.
+ */
+
+#include <sys/cdefs.h>
+#include <sys/types.h>
+
+#include <assert.h>
+#include <errno.h>
+#include <libelf.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+#include "_libelf.h"
+
+ELFTC_VCSID("$Id$");
+
+/*@ELFTC-DOWNSTREAM-VCSID@*/
+
+/*
+ * On-demand access to the contents of ELF objects.
+ *
+ * When a file cannot be mapped in, reading all of it into memory at
+ * elf_begin() time is both slow and wasteful for applications that
+ * only look at a few sections of a large object.  Such objects are
+ * instead read piecemeal using pread(2):
+ *
+ * - The ELF header, program header table and section header table
+ *   are read when first needed, through a small cache of file blocks
+ *   with least-recently-used replacement.
+ * - The contents of a section are read directly into the buffer of
+ *   its data descriptor when elf_getdata(3) or elf_rawdata(3) first
+ *   asks for them.  These reads bypass the block cache, so that they
+ *   may proceed concurrently for distinct sections.
+ * - Operations that need the whole file image, such as elf_rawfile(3),
+ *   read the file in completely and switch the descriptor over to the
+ *   usual in-memory representation.
+ */
+
+/*
+ * Read `sz' bytes at offset `off' of the file underlying descriptor
+ * `e' into `dst', bypassing the block cache.
+ */
+static int
+_libelf_lazy_pread(Elf *e, unsigned char *dst, uint64_t off, size_t sz)
+{
+	ssize_t n;
+
+	while (sz > 0) {
+		if ((n = pread(e->e_fd, dst, sz, (off_t) off)) < 0) {
+			if (errno == EINTR)
+				continue;
+			LIBELF_SET_ERROR(IO, errno);
+			return (0);
+		}
+
+		if (n == 0) {	/* The file shrank underneath us. */
+			LIBELF_SET_ERROR(IO, 0);
+			return (0);
+		}
+
+		LIBELF_STATS_ADD(e, es_read, n);
+
+		dst += n;
+		off += (uint64_t) n;
+		sz -= (size_t) n;
+	}
+
+	return (1);
+}
+
+/*
+ * Return the cache block holding file offset `boff', reading it in
+ * if necessary.
+ */
+static struct _Libelf_Lazy_Block *
+_libelf_lazy_getblock(Elf *e, off_t boff)
+{
+	struct _Libelf_Lazy *lz;
+	struct _Libelf_Lazy_Block *b, *victim;
+	size_t n, sz;
+
+	lz = e->e_lazy;
+	victim = NULL;
+
+	for (n = 0; n < LIBELF_LAZY_NBLOCKS; n++) {
+		b = &lz->lz_blocks[n];
+		if (b->lb_buf != NULL && b->lb_off == boff)
+			goto done;
+		if (victim == NULL || b->lb_buf == NULL ||
+		    (victim->lb_buf != NULL && b->lb_stamp < victim->lb_stamp))
+			victim = b;
+	}
+
+	b = victim;
+	if (b->lb_buf == NULL &&
+	    (b->lb_buf = malloc(LIBELF_LAZY_BLOCKSIZE)) == NULL) {
+		LIBELF_SET_ERROR(RESOURCE, 0);
+		return (NULL);
+	}
+
+	sz = (size_t) (e->e_rawsize - boff);
+	if (sz > LIBELF_LAZY_BLOCKSIZE)
+		sz = LIBELF_LAZY_BLOCKSIZE;
+
+	if (_libelf_lazy_pread(e, b->lb_buf, (uint64_t) boff, sz) == 0) {
+		free(b->lb_buf);
+		b->lb_buf = NULL;
+		return (NULL);
+	}
+
+	b->lb_off = boff;
+	b->lb_size = sz;
+
+ done:
+	b->lb_stamp = ++lz->lz_clock;
+	return (b);
+}
+
+/*
+ * Read `sz' bytes at offset `off' of the file underlying descriptor
+ * `e' into `dst'.  Small reads are satisfied from the block cache if
+ * `cached' is non-zero.  The caller is expected to have checked that
+ * the requested range lies within the file.
+ */
+int
+_libelf_lazy_read(Elf *e, void *dst, uint64_t off, size_t sz, int cached)
+{
+	size_t n;
+	off_t boff;
+	unsigned char *p;
+	struct _Libelf_Lazy_Block *b;
+
+	assert(e->e_flags & LIBELF_F_RAWFILE_LAZY);
+	assert(off + sz <= (uint64_t) e->e_rawsize);
+
+	p = dst;
+
+	if (!cached || sz > LIBELF_LAZY_BLOCKSIZE)
+		return (_libelf_lazy_pread(e, p, off, sz));
+
+	while (sz > 0) {
+		boff = (off_t) (off - off % LIBELF_LAZY_BLOCKSIZE);
+		if ((b = _libelf_lazy_getblock(e, boff)) == NULL)
+			return (0);
+
+		n = b->lb_size - (size_t) (off - (uint64_t) boff);
+		if (n > sz)
+			n = sz;
+
+		(void) memcpy(p, b->lb_buf + (off - (uint64_t) boff), n);
+
+		p += n;
+		off += n;
+		sz -= n;
+	}
+
+	return (1);
+}
+
+/*
+ * Return a pointer to `sz' bytes of the file representation of
+ * descriptor `e' starting at offset `off'.
+ *
+ * If the bytes had to be read in, the buffer holding them is returned
+ * in `*buf' and needs to be freed by the caller; `*buf' is set to
+ * NULL otherwise.
+ */
+unsigned char *
+_libelf_rawbytes(Elf *e, uint64_t off, size_t sz, unsigned char **buf)
+{
+	*buf = NULL;
+
+	if ((e->e_flags & LIBELF_F_RAWFILE_LAZY) == 0)
+		return (e->e_rawfile + off);
+
+	if ((*buf = malloc(sz > 0 ? sz : 1)) == NULL) {
+		LIBELF_SET_ERROR(RESOURCE, 0);
+		return (NULL);
+	}
+
+	if (_libelf_lazy_read(e, *buf, off, sz, 1) == 0) {
+		free(*buf);
+		*buf = NULL;
+		return (NULL);
+	}
+
+	return (*buf);
+}
+
+/*
+ * Open the ELF object in file `fd' of size `fsize' for on-demand
+ * access.
+ *
+ * Returns zero if the file does not hold an ELF object, in which case
+ * the caller needs to read it in as usual.  Otherwise, returns
+ * non-zero and sets `*ep' to the new descriptor, or to NULL if an
+ * error was encountered.
+ */
+int
+_libelf_lazy_open(int fd, size_t fsize, int reporterror, Elf **ep)
+{
+	Elf *e;
+	struct _Libelf_Lazy *lz;
+	struct _Libelf_Lazy_Block *b;
+
+	*ep = NULL;
+
+	if (fsize <= EI_NIDENT)
+		return (0);
+
+	if ((lz = calloc((size_t) 1, sizeof(*lz))) == NULL) {
+		LIBELF_SET_ERROR(RESOURCE, 0);
+		return (1);
+	}
+
+	/*
+	 * Read in the first block of the file.  This holds the ELF
+	 * header and usually the program header table.
+	 */
+	b = &lz->lz_blocks[0];
+	b->lb_off = 0;
+	b->lb_size = fsize < LIBELF_LAZY_BLOCKSIZE ? fsize :
+	    LIBELF_LAZY_BLOCKSIZE;
+	b->lb_stamp = ++lz->lz_clock;
+
+	if ((b->lb_buf = malloc(LIBELF_LAZY_BLOCKSIZE)) == NULL) {
+		LIBELF_SET_ERROR(RESOURCE, 0);
+		free(lz);
+		return (1);
+	}
+
+	e = NULL;
+	if (pread(fd, b->lb_buf, b->lb_size, (off_t) 0) !=
+	    (ssize_t) b->lb_size) {
+		LIBELF_SET_ERROR(IO, errno);
+		goto error;
+	}
+
+	if (b->lb_buf[EI_MAG0] != ELFMAG0 || b->lb_buf[EI_MAG1] != ELFMAG1 ||
+	    b->lb_buf[EI_MAG2] != ELFMAG2 || b->lb_buf[EI_MAG3] != ELFMAG3) {
+		free(b->lb_buf);
+		free(lz);
+		return (0);
+	}
+
+	/*
+	 * Let the first block stand in for the file image while the
+	 * ELF identification bytes are checked.
+	 */
+	if ((e = _libelf_memory(b->lb_buf, b->lb_size, reporterror)) ==
+	    NULL)
+		goto error;
+
+	if (e->e_kind != ELF_K_ELF) {
+		(void) elf_end(e);
+		free(b->lb_buf);
+		free(lz);
+		return (0);
+	}
+
+	(void) memcpy(lz->lz_ident, b->lb_buf, EI_NIDENT);
+
+	e->e_rawfile = NULL;
+	e->e_rawsize = (off_t) fsize;
+	e->e_fd = fd;
+	e->e_lazy = lz;
+	e->e_flags |= LIBELF_F_RAWFILE_LAZY;
+
+	*ep = e;
+	return (1);
+
+ error:
+	free(b->lb_buf);
+	free(lz);
+	return (1);
+}
+
+/*
+ * Read in the complete file underlying a lazily accessed descriptor,
+ * for operations that need access to the whole file image.
+ */
+int
+_libelf_lazy_load(Elf *e)
+{
+	unsigned char *m;
+
+	if ((e->e_flags & LIBELF_F_RAWFILE_LAZY) == 0)
+		return (1);
+
+	if ((m = malloc((size_t) e->e_rawsize)) == NULL) {
+		LIBELF_SET_ERROR(RESOURCE, 0);
+		return (0);
+	}
+
+	if (_libelf_lazy_read(e, m, 0, (size_t) e->e_rawsize, 0) == 0) {
+		free(m);
+		return (0);
+	}
+
+	_libelf_lazy_release(e);
+
+	e->e_rawfile = m;
+	e->e_flags &= ~LIBELF_F_RAWFILE_LAZY;
+	e->e_flags |= LIBELF_F_RAWFILE_MALLOC;
+
+	return (1);
+}
+
+/*
+ * Release the block cache of a lazily accessed descriptor.
+ */
+void
+_libelf_lazy_release(Elf *e)
+{
+	size_t n;
+
+	if (e->e_lazy == NULL)
+		return;
+
+	for (n = 0; n < LIBELF_LAZY_NBLOCKS; n++)
+		free(e->e_lazy->lz_blocks[n].lb_buf);
+
+	free(e->e_lazy);
+	e->e_lazy = NULL;
+}
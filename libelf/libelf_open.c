@@ -132,8 +132,12 @@ _libelf_open_object(int fd, Elf_Cmd c, int reporterror)
 	size_t fsize;
 	struct stat sb;
 	unsigned int flags;
+#if	ELFTC_HAVE_MMAP
+	int mapflags, mapprot;
+#endif
 
-	assert(c == ELF_C_READ || c == ELF_C_RDWR || c == ELF_C_WRITE);
+	assert(c == ELF_C_READ || c == ELF_C_RDWR || c == ELF_C_WRITE ||
+	    c == ELF_C_READ_MMAP || c == ELF_C_RDWR_MMAP);
 
 	if (fstat(fd, &sb) < 0) {
 		LIBELF_SET_ERROR(IO, errno);
@@ -186,25 +190,69 @@ _libelf_open_object(int fd, Elf_Cmd c, int reporterror)
 
 #if	ELFTC_HAVE_MMAP
 		/*
-		 * Always map regular files in with 'PROT_READ'
-		 * permissions.
+		 * Map regular files in privately.
+		 *
+		 * Objects opened with ELF_C_READ are mapped read-only,
+		 * so that the mapping does not count against the
+		 * system's commit limit.  Section data is then copied
+		 * out of the mapping, since the application may modify
+		 * the buffers returned by elf_getdata(3).
+		 *
+		 * Objects opened with ELF_C_RDWR are mapped with write
+		 * permission, which lets elf_getdata(3) hand out data
+		 * that needs no translation without copying it; if the
+		 * application modifies such data, the kernel copies
+		 * the affected pages and the underlying file is left
+		 * untouched.  When elf_update(3) is called, we remove
+		 * this mapping, write file data out using write(2),
+		 * and map the new contents back.
 		 *
-		 * For objects opened in ELF_C_RDWR mode, when
-		 * elf_update(3) is called, we remove this mapping,
-		 * write file data out using write(2), and map the new
-		 * contents back.
+		 * The ELF_C_READ_MMAP command asks for a read-only
+		 * mapping whose contents are handed out in place.  The
+		 * ELF_C_RDWR_MMAP command asks for a shared mapping,
+		 * through which elf_update(3) can modify the file in
+		 * place.
+		 *
+		 * Files are not mapped in if the LIBELF_NOMMAP
+		 * environment variable is set.
 		 */
-		m = mmap(NULL, fsize, PROT_READ, MAP_PRIVATE, fd, (off_t) 0);
-
-		if (m == MAP_FAILED)
+		mapprot = PROT_READ | PROT_WRITE;
+		mapflags = MAP_PRIVATE;
+		if (LIBELF_BASE_CMD(c) == ELF_C_READ)
+			mapprot = PROT_READ;
+		else if (c == ELF_C_RDWR_MMAP)
+			mapflags = MAP_SHARED;
+
+		if (getenv("LIBELF_NOMMAP") == NULL &&
+		    (m = mmap(NULL, fsize, mapprot, mapflags, fd,
+			(off_t) 0)) == MAP_FAILED)
 			m = NULL;
-		else
+
+		if (m != NULL) {
 			flags = LIBELF_F_RAWFILE_MMAP;
+			if (mapflags == MAP_SHARED)
+				flags |= LIBELF_F_RAWFILE_SHARED;
+			if ((mapprot & PROT_WRITE) == 0)
+				flags |= LIBELF_F_RAWFILE_RDONLY;
+			if (c == ELF_C_READ)
+				flags |= LIBELF_F_RAWFILE_COPY;
+		}
 #endif
 
 		/*
-		 * Fallback to a read() if the call to mmap() failed,
-		 * or if mmap() is not available.
+		 * If the file could not be mapped in, ELF objects
+		 * opened for reading are read in on demand.
+		 */
+		if (m == NULL && LIBELF_BASE_CMD(c) == ELF_C_READ &&
+		    _libelf_lazy_open(fd, fsize, reporterror, &e)) {
+			if (e != NULL)
+				e->e_cmd = ELF_C_READ;
+			return (e);
+		}
+
+		/*
+		 * Otherwise, fallback to a read() if the call to mmap()
+		 * failed, or if mmap() is not available.
 		 */
 		if (m == NULL) {
 			if ((m = malloc(fsize)) == NULL) {
@@ -237,6 +285,8 @@ _libelf_open_object(int fd, Elf_Cmd c, int reporterror)
 		return (NULL);
 	}
 
+	c = LIBELF_BASE_CMD(c);
+
 	/* ar(1) archives aren't supported in RDWR mode. */
 	if (c == ELF_C_RDWR && e->e_kind == ELF_K_AR) {
 		(void) elf_end(e);
@@ -248,5 +298,10 @@ _libelf_open_object(int fd, Elf_Cmd c, int reporterror)
 	e->e_fd = fd;
 	e->e_cmd = c;
 
+	if (flags & LIBELF_F_RAWFILE_MMAP)
+		LIBELF_STATS_ADD(e, es_mapped, fsize);
+	else
+		LIBELF_STATS_ADD(e, es_read, fsize);
+
 	return (e);
 }
@@ -0,0 +1,154 @@
+/*-
+ * Copyright (c) 2026, Elftoolchain Project Contributors.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE AUTHOR AND CONTRIBUTORS ``AS IS'' AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED.  IN NO EVENT SHALL THE AUTHOR OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS
+ * OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY
+ * OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+ * SUCH DAMAGE.
+ */
+
+#include <sys/cdefs.h>
+
+#include <libelf.h>
+#include <pthread.h>
+#include <stdlib.h>
+#include <unistd.h>
+
+#include "_libelf.h"
+
+ELFTC_VCSID("$Id$");
+
+/*@ELFTC-DOWNSTREAM-VCSID@*/
+
+/*
+ * The maximum number of threads used to run a set of jobs.
+ */
+#define	LIBELF_PARALLEL_MAXTHREADS	16
+
+struct _Libelf_Parallel {
+	pthread_mutex_t	p_mutex;
+	size_t		p_next;		/* next job to be run */
+	size_t		p_njobs;
+	int		p_failed;	/* set once a job fails */
+	int		p_error;	/* the error reported by that job */
+	int		(*p_fn)(void *_arg, size_t _i);
+	void		*p_arg;
+};
+
+/*
+ * Run jobs until none are left, or until one of them fails.  The error
+ * state of the library is private to each thread, so the error set by
+ * a failing job is recorded for the thread that started the jobs.
+ */
+static void *
+_libelf_parallel_worker(void *arg)
+{
+	size_t i;
+	struct _Libelf_Parallel *p;
+
+	p = arg;
+
+	for (;;) {
+		(void) pthread_mutex_lock(&p->p_mutex);
+		if (p->p_failed || p->p_next >= p->p_njobs) {
+			(void) pthread_mutex_unlock(&p->p_mutex);
+			break;
+		}
+		i = p->p_next++;
+		(void) pthread_mutex_unlock(&p->p_mutex);
+
+		if ((*p->p_fn)(p->p_arg, i))
+			continue;
+
+		(void) pthread_mutex_lock(&p->p_mutex);
+		if (!p->p_failed) {
+			p->p_failed = 1;
+			p->p_error = LIBELF_THREAD_PRIVATE(error);
+		}
+		(void) pthread_mutex_unlock(&p->p_mutex);
+	}
+
+	return (NULL);
+}
+
+/*
+ * Run `njobs' independent jobs by invoking `fn' with `arg' and the
+ * indices 0 to `njobs' - 1, spreading the jobs over the available
+ * processors.  The calling thread takes part in running the jobs.  If
+ * threads cannot be created, the remaining jobs are run by the calling
+ * thread.
+ *
+ * Returns 1 if all the jobs succeeded, or 0 with the error set by the
+ * first failing job.
+ */
+int
+_libelf_parallel(size_t njobs, int (*fn)(void *arg, size_t i), void *arg)
+{
+	long ncpu;
+	size_t i, nthreads;
+	pthread_t tids[LIBELF_PARALLEL_MAXTHREADS - 1];
+	struct _Libelf_Parallel p;
+
+	if (njobs == 0)
+		return (1);
+
+	if (njobs == 1)
+		return ((*fn)(arg, 0));
+
+	nthreads = njobs;
+	if ((ncpu = sysconf(_SC_NPROCESSORS_ONLN)) > 0 &&
+	    (size_t) ncpu < nthreads)
+		nthreads = (size_t) ncpu;
+	if (nthreads > LIBELF_PARALLEL_MAXTHREADS)
+		nthreads = LIBELF_PARALLEL_MAXTHREADS;
+
+	p.p_next = 0;
+	p.p_njobs = njobs;
+	p.p_failed = 0;
+	p.p_error = 0;
+	p.p_fn = fn;
+	p.p_arg = arg;
+
+	if (nthreads <= 1 || pthread_mutex_init(&p.p_mutex, NULL) != 0) {
+		for (i = 0; i < njobs; i++)
+			if (!(*fn)(arg, i))
+				return (0);
+		return (1);
+	}
+
+	for (i = 0; i < nthreads - 1; i++)
+		if (pthread_create(&tids[i], NULL, _libelf_parallel_worker,
+		    &p) != 0)
+			break;
+
+	(void) _libelf_parallel_worker(&p);
+
+	while (i > 0)
+		(void) pthread_join(tids[--i], NULL);
+
+	(void) pthread_mutex_destroy(&p.p_mutex);
+
+	if (p.p_failed) {
+		LIBELF_THREAD_PRIVATE(error) = p.p_error;
+		return (0);
+	}
+
+	return (1);
+}
@@ -42,10 +42,11 @@ _libelf_getphdr(Elf *e, int ec)
 {
 	size_t phnum;
 	size_t fsz, msz;
-	uint64_t phoff;
+	uint64_t phoff, t0;
 	Elf32_Ehdr *eh32;
 	Elf64_Ehdr *eh64;
 	void *ehdr, *phdr;
+	unsigned char *buf, *src;
 	_libelf_translator_function *xlator;
 
 	assert(ec == ELFCLASS32 || ec == ELFCLASS64);
@@ -94,7 +95,11 @@ _libelf_getphdr(Elf *e, int ec)
 	if ((msz = _libelf_msize(ELF_T_PHDR, ec, EV_CURRENT)) == 0)
 		return (NULL);
 
+	if ((src = _libelf_rawbytes(e, phoff, fsz, &buf)) == NULL)
+		return (NULL);
+
 	if ((phdr = calloc(phnum, msz)) == NULL) {
+		free(buf);
 		LIBELF_SET_ERROR(RESOURCE, 0);
 		return (NULL);
 	}
@@ -104,11 +109,18 @@ _libelf_getphdr(Elf *e, int ec)
 	else
 		e->e_u.e_elf.e_phdr.e_phdr64 = phdr;
 
+	LIBELF_STATS_ADD(e, es_allocated[ELF_T_PHDR], phnum * msz);
 
 	xlator = _libelf_get_translator(ELF_T_PHDR, ELF_TOMEMORY, ec,
 	    _libelf_elfmachine(e));
-	(*xlator)(phdr, phnum * msz, e->e_rawfile + phoff, phnum,
+	t0 = _libelf_stats_clock();
+	(*xlator)(phdr, phnum * msz, src, phnum,
 	    e->e_byteorder != LIBELF_PRIVATE(byteorder));
+	free(buf);
+
+	LIBELF_STATS_ADD(e, es_xlate_nsec, _libelf_stats_clock() - t0);
+	LIBELF_STATS_ADD(e, es_xlate_calls, 1);
+	LIBELF_STATS_ADD(e, es_xlate_bytes, fsz);
 
 	return (phdr);
 }
@@ -142,6 +154,8 @@ _libelf_newphdr(Elf *e, int ec, size_t count)
 		return (NULL);
 	}
 
+	LIBELF_STATS_ADD(e, es_allocated[ELF_T_PHDR], count * msz);
+
 	if (ec == ELFCLASS32) {
 		if ((oldphdr = (void *) e->e_u.e_elf.e_phdr.e_phdr32) != NULL)
 			free(oldphdr);
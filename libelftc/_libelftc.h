@@ -45,6 +45,16 @@ struct _Elftc_Bfd_Target {
 
 extern struct _Elftc_Bfd_Target _libelftc_targets[];
 
+/** @brief Memory arena for short-lived strings. */
+struct vector_str_arena {
+	/** Chunks of memory, most recent first */
+	struct vector_str_chunk	*chunks;
+	/** Next free byte in the current chunk */
+	char		*cur;
+	/** Free bytes in the current chunk */
+	size_t		avail;
+};
+
 /** @brief Dynamic vector data for string. */
 struct vector_str {
 	/** Current size */
@@ -53,6 +63,13 @@ struct vector_str {
 	size_t		capacity;
 	/** String array */
 	char		**container;
+	/** Arena to allocate from, or NULL to use malloc(3) */
+	struct vector_str_arena *arena;
+};
+
+/** @brief Reusable state for elftc_demangle_r(). */
+struct _Elftc_Demangle_Ctx {
+	struct vector_str_arena	dc_arena;
 };
 
 #define BUFFER_GROWFACTOR	1.618
@@ -71,15 +88,27 @@ extern "C" {
 char	*cpp_demangle_ARM(const char *_org);
 char	*cpp_demangle_gnu2(const char *_org);
 char	*cpp_demangle_gnu3(const char *_org);
+int	cpp_demangle_gnu3_r(const char *_org, char *_buf, size_t _bufsize,
+    struct vector_str_arena *_arena);
 bool	is_cpp_mangled_ARM(const char *_org);
 bool	is_cpp_mangled_gnu2(const char *_org);
 bool	is_cpp_mangled_gnu3(const char *_org);
 unsigned int	libelftc_hash_string(const char *);
+void	*vector_str_arena_alloc(struct vector_str_arena *_arena,
+    size_t _size);
+void	vector_str_arena_dest(struct vector_str_arena *_arena);
+void	vector_str_arena_free(struct vector_str_arena *_arena, void *_ptr);
+void	vector_str_arena_init(struct vector_str_arena *_arena);
+void	vector_str_arena_reset(struct vector_str_arena *_arena);
+size_t	vector_str_copy_flat(const struct vector_str *_vs, char *_buf,
+    size_t _bufsize);
 void	vector_str_dest(struct vector_str *_vec);
 int	vector_str_find(const struct vector_str *_vs, const char *_str,
     size_t _len);
 char	*vector_str_get_flat(const struct vector_str *_vs, size_t *_len);
 bool	vector_str_init(struct vector_str *_vs);
+bool	vector_str_init_arena(struct vector_str *_vs,
+    struct vector_str_arena *_arena);
 bool	vector_str_pop(struct vector_str *_vs);
 bool	vector_str_push(struct vector_str *_vs, const char *_str,
     size_t _len);
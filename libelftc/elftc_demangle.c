@@ -75,25 +75,80 @@ demangle(const char *s, unsigned int style, unsigned int rc)
 int
 elftc_demangle(const char *mangledname, char *buffer, size_t bufsize,
     unsigned int flags)
+{
+	struct _Elftc_Demangle_Ctx ctx;
+	int error;
+
+	vector_str_arena_init(&ctx.dc_arena);
+
+	error = elftc_demangle_r(&ctx, mangledname, buffer, bufsize, flags);
+
+	vector_str_arena_dest(&ctx.dc_arena);
+
+	return (error);
+}
+
+Elftc_Demangle_Ctx *
+elftc_demangle_ctx_create(void)
+{
+	Elftc_Demangle_Ctx *ctx;
+
+	if ((ctx = malloc(sizeof(*ctx))) == NULL)
+		return (NULL);
+
+	vector_str_arena_init(&ctx->dc_arena);
+
+	return (ctx);
+}
+
+void
+elftc_demangle_ctx_destroy(Elftc_Demangle_Ctx *ctx)
+{
+
+	if (ctx == NULL)
+		return;
+
+	vector_str_arena_dest(&ctx->dc_arena);
+	free(ctx);
+}
+
+int
+elftc_demangle_r(Elftc_Demangle_Ctx *ctx, const char *mangledname,
+    char *buffer, size_t bufsize, unsigned int flags)
 {
 	unsigned int style, rc;
 	char *rlt;
+	int error;
 
 	style = flags & 0xFFFF;
 	rc = flags >> 16;
 
-	if (mangledname == NULL ||
+	if (ctx == NULL || mangledname == NULL ||
 	    ((style = is_mangled(mangledname, style)) == 0)) {
 		errno = EINVAL;
 		return (-1);
 	}
 
+	if (buffer == NULL)
+		bufsize = 0;
+
+	/*
+	 * GNU v3 names are decoded directly into the caller's buffer,
+	 * using the memory retained in the context.
+	 */
+	if (style == ELFTC_DEM_GNU3) {
+		error = cpp_demangle_gnu3_r(mangledname, buffer, bufsize,
+		    &ctx->dc_arena);
+		vector_str_arena_reset(&ctx->dc_arena);
+		return (error);
+	}
+
 	if ((rlt = demangle(mangledname, style, rc)) == NULL) {
 		errno = EINVAL;
 		return (-1);
 	}
 
-	if (buffer == NULL || bufsize < strlen(rlt) + 1) {
+	if (bufsize < strlen(rlt) + 1) {
 		free(rlt);
 		errno = ENAMETOOLONG;
 		return (-1);
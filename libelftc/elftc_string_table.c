@@ -24,12 +24,12 @@
  * THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
  */
 
-#include <sys/param.h>
-#include <sys/queue.h>
+#include <sys/types.h>
 
 #include <assert.h>
 #include <errno.h>
 #include <gelf.h>
+#include <stdint.h>
 #include <stdlib.h>
 #include <string.h>
 
@@ -40,12 +40,18 @@ ELFTC_VCSID("$Id$");
 
 #define	ELFTC_STRING_TABLE_DEFAULT_SIZE			(4*1024)
 #define ELFTC_STRING_TABLE_EXPECTED_STRING_SIZE		16
-#define ELFTC_STRING_TABLE_EXPECTED_CHAIN_LENGTH	8
-#define	ELFTC_STRING_TABLE_POOL_SIZE_INCREMENT		(4*1024)
-
+#define	ELFTC_STRING_TABLE_MINIMUM_SLOTS		16
+
+/*
+ * The strings in the table are indexed by an open-addressed hash
+ * table using linear probing.  Each slot records the full hash value
+ * of its string, so that most mismatches are detected without
+ * looking at the string pool.  An index of zero marks an unused slot,
+ * and a negative index marks a deleted string.
+ */
 struct _Elftc_String_Table_Entry {
 	ssize_t		ste_idx;
-	SLIST_ENTRY(_Elftc_String_Table_Entry) ste_next;
+	unsigned int	ste_hash;
 };
 
 #define	ELFTC_STRING_TABLE_COMPACTION_FLAG	0x1
@@ -63,29 +69,76 @@ struct _Elftc_String_Table_Entry {
 		    ((len) << 1);				\
 	} while (0)
 
+/* Keep the load factor of the hash table at or below 3/4. */
+#define	ELFTC_STRING_TABLE_NEEDS_RESIZE(st)			\
+	(((st)->st_nentries + 1) * 4 > (st)->st_nslots * 3)
+
 struct _Elftc_String_Table {
 	size_t		st_len; /* length and flags */
-	int		st_nbuckets;
+	size_t		st_nentries;
+	size_t		st_nslots;	/* a power of two */
 	size_t		st_string_pool_size;
 	char		*st_string_pool;
-	SLIST_HEAD(_Elftc_String_Table_Bucket,
-	    _Elftc_String_Table_Entry) st_buckets[];
+	struct _Elftc_String_Table_Entry *st_slots;
+	int		st_merged;	/* strings may share tails */
 };
 
+/*
+ * A string being placed by elftc_string_table_merge().
+ */
+struct _Elftc_String_Table_Key {
+	const char	*stk_string;
+	size_t		stk_len;
+	size_t		stk_idx;
+	unsigned int	stk_hash;
+};
+
+/*
+ * Return the character of key `k' at distance `depth' from its end,
+ * or -1 if the string is shorter than that.
+ */
+#define	ELFTC_STRING_TABLE_KEY_CHAR(k, depth)				\
+	((depth) < (k)->stk_len ?					\
+	    (int) (unsigned char) (k)->stk_string[(k)->stk_len - 1 -	\
+		(depth)] : -1)
+
+/*
+ * Map a hash value to its home slot.  The low bits of FNV hashes
+ * depend only on the low bits of the characters hashed, so the value
+ * is mixed first.
+ */
+static size_t
+elftc_string_table_slot(const Elftc_String_Table *st, unsigned int hash)
+{
+	uint32_t m;
+
+	m = (uint32_t) hash * 0x9E3779B1U;
+	m ^= m >> 15;
+
+	return (m & (st->st_nslots - 1));
+}
+
+/*
+ * Return the slot holding `string', or if it is not present, the
+ * unused slot where it would be entered.
+ */
 static struct _Elftc_String_Table_Entry *
 elftc_string_table_find_hash_entry(Elftc_String_Table *st, const char *string,
-    int *rhashindex)
+    unsigned int hash)
 {
 	struct _Elftc_String_Table_Entry *ste;
-	int hashindex;
+	size_t i, mask;
 	char *s;
 
-	hashindex = libelftc_hash_string(string) % st->st_nbuckets;
+	mask = st->st_nslots - 1;
 
-	if (rhashindex)
-		*rhashindex = hashindex;
+	for (i = elftc_string_table_slot(st, hash);; i = (i + 1) & mask) {
+		ste = &st->st_slots[i];
+		if (ste->ste_idx == 0)
+			return (ste);
+		if (ste->ste_hash != hash)
+			continue;
 
-	SLIST_FOREACH(ste, &st->st_buckets[hashindex], ste_next) {
 		s = st->st_string_pool + labs(ste->ste_idx);
 
 		assert(s > st->st_string_pool &&
@@ -94,11 +147,75 @@ elftc_string_table_find_hash_entry(Elftc_String_Table *st, const char *string,
 		if (strcmp(s, string) == 0)
 			return (ste);
 	}
-
-	return (NULL);
 }
 
+/*
+ * Move the entries of the table into a new array of `nslots' slots.
+ */
 static int
+elftc_string_table_rehash(Elftc_String_Table *st, size_t nslots)
+{
+	struct _Elftc_String_Table_Entry *old, *ste;
+	size_t i, j, mask, oldnslots;
+
+	if ((ste = calloc(nslots, sizeof(*ste))) == NULL)
+		return (0);
+
+	old = st->st_slots;
+	oldnslots = st->st_nslots;
+
+	st->st_slots = ste;
+	st->st_nslots = nslots;
+	mask = nslots - 1;
+
+	for (i = 0; i < oldnslots; i++) {
+		if (old[i].ste_idx == 0)
+			continue;
+		for (j = elftc_string_table_slot(st, old[i].ste_hash);
+		     st->st_slots[j].ste_idx != 0; j = (j + 1) & mask)
+			;
+		st->st_slots[j] = old[i];
+	}
+
+	free(old);
+
+	return (1);
+}
+
+/*
+ * Release the slot `ste', moving later entries in its probe sequence
+ * back so that they remain reachable.
+ */
+static void
+elftc_string_table_free_entry(Elftc_String_Table *st,
+    struct _Elftc_String_Table_Entry *ste)
+{
+	size_t i, j, k, mask;
+
+	mask = st->st_nslots - 1;
+	i = (size_t) (ste - st->st_slots);
+
+	for (;;) {
+		st->st_slots[i].ste_idx = 0;
+		for (j = i;;) {
+			j = (j + 1) & mask;
+			if (st->st_slots[j].ste_idx == 0) {
+				st->st_nentries--;
+				return;
+			}
+			k = elftc_string_table_slot(st,
+			    st->st_slots[j].ste_hash);
+			/* Entries whose home lies in (i, j] stay put. */
+			if (i <= j ? (i < k && k <= j) : (i < k || k <= j))
+				continue;
+			break;
+		}
+		st->st_slots[i] = st->st_slots[j];
+		i = j;
+	}
+}
+
+static size_t
 elftc_string_table_add_to_pool(Elftc_String_Table *st, const char *string)
 {
 	char *newpool;
@@ -107,11 +224,14 @@ elftc_string_table_add_to_pool(Elftc_String_Table *st, const char *string)
 	len = strlen(string) + 1; /* length, including the trailing NUL */
 	stlen = ELFTC_STRING_TABLE_LENGTH(st);
 
-	/* Resize the pool, if needed. */
+	/*
+	 * Resize the pool, if needed.  The pool grows geometrically,
+	 * so that building large tables takes linear time.
+	 */
 	if (stlen + len >= st->st_string_pool_size) {
-		newsize = roundup(st->st_string_pool_size +
-		    ELFTC_STRING_TABLE_POOL_SIZE_INCREMENT,
-		    ELFTC_STRING_TABLE_POOL_SIZE_INCREMENT);
+		newsize = st->st_string_pool_size * 2;
+		if (newsize <= stlen + len)
+			newsize = stlen + len + 1;
 		if ((newpool = realloc(st->st_string_pool, newsize)) ==
 		    NULL)
 			return (0);
@@ -125,33 +245,195 @@ elftc_string_table_add_to_pool(Elftc_String_Table *st, const char *string)
 	return (stlen);
 }
 
+/*
+ * Sort keys by their reversed strings, in descending order, using a
+ * multikey quicksort.  Keys that differ only in the characters
+ * before the last `depth' ones are already known to be in the same
+ * partition.
+ *
+ * After sorting, every string is immediately preceded by the strings
+ * that end with it.
+ */
+static void
+elftc_string_table_sort(struct _Elftc_String_Table_Key *k, size_t n,
+    size_t depth)
+{
+	struct _Elftc_String_Table_Key tmp;
+	size_t i, lt, gt, neq, ngt, nlt;
+	int c, pivot;
+
+#define	ELFTC_STRING_TABLE_SWAP_KEYS(a, b) do {	\
+		tmp = k[(a)];				\
+		k[(a)] = k[(b)];			\
+		k[(b)] = tmp;				\
+	} while (0)
+
+	while (n > 1) {
+		pivot = ELFTC_STRING_TABLE_KEY_CHAR(&k[n / 2], depth);
+
+		/*
+		 * Partition the keys into those with a greater character
+		 * at this depth, [0, lt), those with an equal character,
+		 * [lt, gt), and those with a lesser one, [gt, n).
+		 */
+		for (i = lt = 0, gt = n; i < gt;) {
+			c = ELFTC_STRING_TABLE_KEY_CHAR(&k[i], depth);
+			if (c > pivot) {
+				ELFTC_STRING_TABLE_SWAP_KEYS(lt, i);
+				lt++;
+				i++;
+			} else if (c < pivot) {
+				gt--;
+				ELFTC_STRING_TABLE_SWAP_KEYS(i, gt);
+			} else
+				i++;
+		}
+
+		ngt = lt;
+		nlt = n - gt;
+		/* Strings are distinct, so at most one can end here. */
+		neq = pivot < 0 ? 0 : gt - lt;
+
+		/*
+		 * Recurse into the two smaller partitions and iterate on
+		 * the largest one, bounding the depth of the recursion.
+		 */
+		if (neq >= ngt && neq >= nlt) {
+			elftc_string_table_sort(k, ngt, depth);
+			elftc_string_table_sort(k + gt, nlt, depth);
+			k += lt;
+			n = neq;
+			depth++;
+		} else if (ngt >= nlt) {
+			elftc_string_table_sort(k + lt, neq, depth + 1);
+			elftc_string_table_sort(k + gt, nlt, depth);
+			n = ngt;
+		} else {
+			elftc_string_table_sort(k, ngt, depth);
+			elftc_string_table_sort(k + lt, neq, depth + 1);
+			k += gt;
+			n = nlt;
+		}
+	}
+
+#undef	ELFTC_STRING_TABLE_SWAP_KEYS
+}
+
+/*
+ * Rebuild the string pool so that a string which is a suffix of
+ * another shares the storage of the longer string.  Deleted strings
+ * are dropped.  Returns zero, leaving the table unchanged, if memory
+ * could not be allocated.
+ */
+static int
+elftc_string_table_merge(Elftc_String_Table *st)
+{
+	struct _Elftc_String_Table_Entry *slots, *ste;
+	struct _Elftc_String_Table_Key *k, *keys, *prev;
+	size_t i, j, mask, n, newsize;
+	char *pool;
+
+	if ((keys = malloc((st->st_nentries + 1) * sizeof(*keys))) == NULL)
+		return (0);
+
+	for (i = n = 0; i < st->st_nslots; i++) {
+		ste = &st->st_slots[i];
+		if (ste->ste_idx <= 0)
+			continue;
+		k = &keys[n++];
+		k->stk_string = st->st_string_pool + ste->ste_idx;
+		k->stk_len = strlen(k->stk_string);
+		k->stk_hash = ste->ste_hash;
+	}
+
+	elftc_string_table_sort(keys, n, 0);
+
+	/* Assign offsets, placing suffixes inside their predecessors. */
+	newsize = 1;
+	for (i = 0, prev = NULL; i < n; i++) {
+		k = &keys[i];
+		if (prev != NULL && prev->stk_len >= k->stk_len &&
+		    memcmp(prev->stk_string + prev->stk_len - k->stk_len,
+		    k->stk_string, k->stk_len) == 0) {
+			k->stk_idx = prev->stk_idx + prev->stk_len -
+			    k->stk_len;
+			continue;
+		}
+		k->stk_idx = newsize;
+		newsize += k->stk_len + 1;
+		prev = k;
+	}
+
+	if ((pool = malloc(newsize)) == NULL) {
+		free(keys);
+		return (0);
+	}
+	if ((slots = calloc(st->st_nslots, sizeof(*slots))) == NULL) {
+		free(pool);
+		free(keys);
+		return (0);
+	}
+
+	*pool = '\0';
+	mask = st->st_nslots - 1;
+	for (i = 0; i < n; i++) {
+		k = &keys[i];
+		/* Suffixes rewrite the same bytes as their container. */
+		memcpy(pool + k->stk_idx, k->stk_string, k->stk_len + 1);
+		for (j = elftc_string_table_slot(st, k->stk_hash);
+		     slots[j].ste_idx != 0; j = (j + 1) & mask)
+			;
+		slots[j].ste_idx = (ssize_t) k->stk_idx;
+		slots[j].ste_hash = k->stk_hash;
+	}
+
+	free(keys);
+	free(st->st_slots);
+	free(st->st_string_pool);
+
+	st->st_slots = slots;
+	st->st_nentries = n;
+	st->st_string_pool = pool;
+	st->st_string_pool_size = newsize;
+	st->st_merged = 1;
+
+	ELFTC_STRING_TABLE_CLEAR_COMPACTION_FLAG(st);
+	ELFTC_STRING_TABLE_UPDATE_LENGTH(st, newsize);
+
+	return (1);
+}
+
 Elftc_String_Table *
 elftc_string_table_create(size_t sizehint)
 {
 	struct _Elftc_String_Table *st;
-	int n, nbuckets, tablesize;
+	size_t nslots;
 
 	if (sizehint < ELFTC_STRING_TABLE_DEFAULT_SIZE)
 		sizehint = ELFTC_STRING_TABLE_DEFAULT_SIZE;
 
-	nbuckets = sizehint / (ELFTC_STRING_TABLE_EXPECTED_CHAIN_LENGTH *
-	    ELFTC_STRING_TABLE_EXPECTED_STRING_SIZE);
+	for (nslots = ELFTC_STRING_TABLE_MINIMUM_SLOTS;
+	     nslots * 3 < (sizehint / ELFTC_STRING_TABLE_EXPECTED_STRING_SIZE) *
+		 4;
+	     nslots *= 2)
+		;
 
-	tablesize = sizeof(struct _Elftc_String_Table) +
-	    nbuckets * sizeof(struct _Elftc_String_Table_Bucket);
-
-	if ((st = malloc(tablesize)) == NULL)
+	if ((st = malloc(sizeof(*st))) == NULL)
 		return (NULL);
 	if ((st->st_string_pool = malloc(sizehint)) == NULL) {
 		free(st);
 		return (NULL);
 	}
-
-	for (n = 0; n < nbuckets; n++)
-		SLIST_INIT(&st->st_buckets[n]);
+	if ((st->st_slots = calloc(nslots, sizeof(*st->st_slots))) == NULL) {
+		free(st->st_string_pool);
+		free(st);
+		return (NULL);
+	}
 
 	st->st_len = 0;
-	st->st_nbuckets = nbuckets;
+	st->st_nentries = 0;
+	st->st_nslots = nslots;
+	st->st_merged = 0;
 	st->st_string_pool_size = sizehint;
 	*st->st_string_pool = '\0';
 	ELFTC_STRING_TABLE_UPDATE_LENGTH(st, 1);
@@ -162,12 +444,7 @@ elftc_string_table_create(size_t sizehint)
 void
 elftc_string_table_destroy(Elftc_String_Table *st)
 {
-	int n;
-	struct _Elftc_String_Table_Entry *s, *t;
-
-	for (n = 0; n < st->st_nbuckets; n++)
-		SLIST_FOREACH_SAFE(s, &st->st_buckets[n], ste_next, t)
-			free(s);
+	free(st->st_slots);
 	free(st->st_string_pool);
 	free(st);
 }
@@ -234,9 +511,7 @@ elftc_string_table_image(Elftc_String_Table *st, size_t *size)
 {
 	char *r, *s, *end;
 	struct _Elftc_String_Table_Entry *ste;
-	struct _Elftc_String_Table_Bucket *head;
 	size_t copied, offset, length, newsize;
-	int hashindex;
 
 	/*
 	 * For the common case of a string table has not seen
@@ -249,6 +524,18 @@ elftc_string_table_image(Elftc_String_Table *st, size_t *size)
 		return (st->st_string_pool);
 	}
 
+	/*
+	 * Strings in a merged pool cannot be walked in sequence, so
+	 * such a table is compacted by merging it again.
+	 */
+	if (st->st_merged) {
+		if (!elftc_string_table_merge(st))
+			return (NULL);
+		if (size)
+			*size = ELFTC_STRING_TABLE_LENGTH(st);
+		return (st->st_string_pool);
+	}
+
 	/*
 	 * Otherwise, compact the string table in-place.
 	 */
@@ -265,16 +552,13 @@ elftc_string_table_image(Elftc_String_Table *st, size_t *size)
 		length = strlen(s) + 1;
 
 		ste = elftc_string_table_find_hash_entry(st, s,
-		    &hashindex);
-		head = &st->st_buckets[hashindex];
+		    libelftc_hash_string(s));
 
-		assert(ste != NULL);
+		assert(ste->ste_idx != 0);
 
 		/* Ignore deleted strings. */
 		if (ste->ste_idx < 0) {
-			SLIST_REMOVE(head, ste, _Elftc_String_Table_Entry,
-			    ste_next);
-			free(ste);
+			elftc_string_table_free_entry(st, ste);
 			continue;
 		}
 
@@ -301,29 +585,43 @@ elftc_string_table_image(Elftc_String_Table *st, size_t *size)
 	return (st->st_string_pool);
 }
 
+const char *
+elftc_string_table_image_merged(Elftc_String_Table *st, size_t *size)
+{
+	if (!elftc_string_table_merge(st))
+		return (NULL);
+
+	if (size)
+		*size = ELFTC_STRING_TABLE_LENGTH(st);
+
+	return (st->st_string_pool);
+}
+
 size_t
 elftc_string_table_insert(Elftc_String_Table *st, const char *string)
 {
 	struct _Elftc_String_Table_Entry *ste;
+	unsigned int hash;
 	ssize_t idx;
-	int hashindex;
-
-	hashindex = 0;
 
-	ste = elftc_string_table_find_hash_entry(st, string, &hashindex);
+	hash = libelftc_hash_string(string);
 
-	assert(hashindex >= 0 && hashindex < st->st_nbuckets);
+	ste = elftc_string_table_find_hash_entry(st, string, hash);
 
-	if (ste == NULL) {
-		if ((ste = malloc(sizeof(*ste))) == NULL)
-			return (0);
-		if ((ste->ste_idx = elftc_string_table_add_to_pool(st,
-		    string)) == 0) {
-			free(ste);
-			return (0);
+	if (ste->ste_idx == 0) {
+		if (ELFTC_STRING_TABLE_NEEDS_RESIZE(st)) {
+			if (!elftc_string_table_rehash(st, st->st_nslots * 2))
+				return (0);
+			ste = elftc_string_table_find_hash_entry(st, string,
+			    hash);
 		}
+		if ((idx = (ssize_t) elftc_string_table_add_to_pool(st,
+		    string)) == 0)
+			return (0);
 
-		SLIST_INSERT_HEAD(&st->st_buckets[hashindex], ste, ste_next);
+		ste->ste_idx = idx;
+		ste->ste_hash = hash;
+		st->st_nentries++;
 	}
 
 	idx = ste->ste_idx;
@@ -338,13 +636,11 @@ elftc_string_table_lookup(Elftc_String_Table *st, const char *string)
 {
 	struct _Elftc_String_Table_Entry *ste;
 	ssize_t idx;
-	int hashindex;
-
-	ste = elftc_string_table_find_hash_entry(st, string, &hashindex);
 
-	assert(hashindex >= 0 && hashindex < st->st_nbuckets);
+	ste = elftc_string_table_find_hash_entry(st, string,
+	    libelftc_hash_string(string));
 
-	if (ste == NULL || (idx = ste->ste_idx) < 0)
+	if ((idx = ste->ste_idx) <= 0)
 		return (0);
 
 	return (idx);
@@ -356,9 +652,10 @@ elftc_string_table_remove(Elftc_String_Table *st, const char *string)
 	struct _Elftc_String_Table_Entry *ste;
 	ssize_t idx;
 
-	ste = elftc_string_table_find_hash_entry(st, string, NULL);
+	ste = elftc_string_table_find_hash_entry(st, string,
+	    libelftc_hash_string(string));
 
-	if (ste == NULL || (idx = ste->ste_idx) < 0)
+	if ((idx = ste->ste_idx) <= 0)
 		return (ELFTC_FAILURE);
 
 	assert(idx > 0 && (size_t)idx < ELFTC_STRING_TABLE_LENGTH(st));
@@ -381,10 +678,11 @@ elftc_string_table_to_string(Elftc_String_Table *st, size_t offset)
 	 * Check for:
 	 * - An offset value within pool bounds.
 	 * - A non-NUL byte at the specified offset.
-	 * - The end of the prior string at offset - 1.
+	 * - The end of the prior string at offset - 1, unless strings
+	 *   may start inside other strings.
 	 */
 	if (offset == 0 || offset >= ELFTC_STRING_TABLE_LENGTH(st) ||
-	    *s == '\0' || *(s - 1) != '\0') {
+	    *s == '\0' || (!st->st_merged && *(s - 1) != '\0')) {
 		errno = EINVAL;
 		return (NULL);
 	}
@@ -38,6 +38,7 @@
  * Types meant to be opaque to the consumers of these APIs.
  */
 typedef struct _Elftc_Bfd_Target Elftc_Bfd_Target;
+typedef struct _Elftc_Demangle_Ctx Elftc_Demangle_Ctx;
 typedef struct _Elftc_String_Table Elftc_String_Table;
 
 /* Target types. */
@@ -76,6 +77,11 @@ unsigned int	elftc_bfd_target_osabi(Elftc_Bfd_Target *_tgt);
 int		elftc_copyfile(int _srcfd,  int _dstfd);
 int		elftc_demangle(const char *_mangledname, char *_buffer,
     size_t _bufsize, unsigned int _flags);
+Elftc_Demangle_Ctx	*elftc_demangle_ctx_create(void);
+void		elftc_demangle_ctx_destroy(Elftc_Demangle_Ctx *_ctx);
+int		elftc_demangle_r(Elftc_Demangle_Ctx *_ctx,
+    const char *_mangledname, char *_buffer, size_t _bufsize,
+    unsigned int _flags);
 const char	*elftc_reloc_type_str(unsigned int mach, unsigned int type);
 int		elftc_set_timestamps(const char *_filename, struct stat *_sb);
 Elftc_String_Table	*elftc_string_table_create(size_t _sizehint);
@@ -84,6 +90,8 @@ Elftc_String_Table	*elftc_string_table_from_section(Elf_Scn *_scn,
     size_t _sizehint);
 const char	*elftc_string_table_image(Elftc_String_Table *_table,
     size_t *_sz);
+const char	*elftc_string_table_image_merged(Elftc_String_Table *_table,
+    size_t *_sz);
 size_t		elftc_string_table_insert(Elftc_String_Table *_table,
     const char *_string);
 size_t		elftc_string_table_lookup(Elftc_String_Table *_table,
@@ -57,7 +57,7 @@ enum type_qualifier {
 struct vector_type_qualifier {
 	size_t size, capacity;
 	enum type_qualifier *q_container;
-	struct vector_str ext_name;
+	struct vector_str ext_name;	/* also holds the arena */
 };
 
 enum read_cmd {
@@ -73,6 +73,7 @@ struct read_cmd_item {
 struct vector_read_cmd {
 	size_t size, capacity;
 	struct read_cmd_item *r_container;
+	struct vector_str_arena *arena;
 };
 
 enum push_qualifier {
@@ -101,6 +102,7 @@ struct cpp_demangle_data {
 	int			 func_type;
 	const char		*cur;		/* current mangled name ptr */
 	const char		*last_sname;	/* last source name */
+	struct vector_str_arena	*arena;		/* arena or NULL for malloc */
 };
 
 struct type_delimit {
@@ -124,10 +126,12 @@ struct type_delimit {
 #define SIMPLE_HASH(x,y)	(64 * x + y)
 #define DEM_PUSH_STR(d,s)	cpp_demangle_push_str((d), (s), strlen((s)))
 #define VEC_PUSH_STR(d,s)	vector_str_push((d), (s), strlen((s)))
+#define DEM_ALLOC(d,n)		vector_str_arena_alloc((d)->arena, (n))
+#define DEM_FREE(d,p)		vector_str_arena_free((d)->arena, (p))
 
 static void	cpp_demangle_data_dest(struct cpp_demangle_data *);
 static int	cpp_demangle_data_init(struct cpp_demangle_data *,
-		    const char *);
+		    const char *, struct vector_str_arena *);
 static int	cpp_demangle_get_subst(struct cpp_demangle_data *, size_t);
 static int	cpp_demangle_get_tmpl_param(struct cpp_demangle_data *, size_t);
 static int	cpp_demangle_push_fp(struct cpp_demangle_data *,
@@ -157,6 +161,7 @@ static int	cpp_demangle_read_function(struct cpp_demangle_data *, int *,
 		    struct vector_type_qualifier *);
 static int	cpp_demangle_local_source_name(struct cpp_demangle_data *ddata);
 static int	cpp_demangle_read_local_name(struct cpp_demangle_data *);
+static int	cpp_demangle_read_mangled_name(struct cpp_demangle_data *);
 static int	cpp_demangle_read_name(struct cpp_demangle_data *);
 static int	cpp_demangle_read_name_flat(struct cpp_demangle_data *,
 		    char**);
@@ -194,12 +199,14 @@ static int	hex_to_dec(char);
 static void	vector_read_cmd_dest(struct vector_read_cmd *);
 static struct read_cmd_item *vector_read_cmd_find(struct vector_read_cmd *,
 		    enum read_cmd);
-static int	vector_read_cmd_init(struct vector_read_cmd *);
+static int	vector_read_cmd_init(struct vector_read_cmd *,
+		    struct vector_str_arena *);
 static int	vector_read_cmd_pop(struct vector_read_cmd *);
 static int	vector_read_cmd_push(struct vector_read_cmd *, enum read_cmd,
 		    void *);
 static void	vector_type_qualifier_dest(struct vector_type_qualifier *);
-static int	vector_type_qualifier_init(struct vector_type_qualifier *);
+static int	vector_type_qualifier_init(struct vector_type_qualifier *,
+		    struct vector_str_arena *);
 static int	vector_type_qualifier_push(struct vector_type_qualifier *,
 		    enum type_qualifier);
 
@@ -214,12 +221,8 @@ char *
 cpp_demangle_gnu3(const char *org)
 {
 	struct cpp_demangle_data ddata;
-	struct vector_str ret_type;
-	struct type_delimit td;
 	ssize_t org_len;
-	unsigned int limit;
 	char *rtn;
-	bool has_ret, more_type;
 
 	if (org == NULL || (org_len = strlen(org)) < 2)
 		return (NULL);
@@ -235,20 +238,98 @@ cpp_demangle_gnu3(const char *org)
 	if (org[0] != '_' || org[1] != 'Z')
 		return (NULL);
 
-	if (!cpp_demangle_data_init(&ddata, org + 2))
+	if (!cpp_demangle_data_init(&ddata, org + 2, NULL))
 		return (NULL);
 
 	rtn = NULL;
+	if (cpp_demangle_read_mangled_name(&ddata))
+		rtn = vector_str_get_flat(&ddata.output, (size_t *) NULL);
+
+	cpp_demangle_data_dest(&ddata);
+
+	return (rtn);
+}
+
+/**
+ * @brief Decode the input string by IA-64 C++ ABI style into buffer.
+ *
+ * Temporary strings are allocated from arena, which the caller
+ * resets between names.  No memory is allocated once the arena has
+ * grown large enough.
+ * @return 0 at success, or -1 with errno set to EINVAL if the string
+ * could not be decoded, or to ENAMETOOLONG if the result did not fit.
+ */
+int
+cpp_demangle_gnu3_r(const char *org, char *buf, size_t bufsize,
+    struct vector_str_arena *arena)
+{
+	struct cpp_demangle_data ddata;
+	size_t len, org_len;
+	int n;
+
+	if (org == NULL || (org_len = strlen(org)) < 2)
+		goto einval;
+
+	if (org_len > 11 && !strncmp(org, "_GLOBAL__I_", 11)) {
+		if ((n = snprintf(buf, bufsize,
+		    "global constructors keyed to %s", org + 11)) < 0)
+			goto einval;
+		len = (size_t) n;
+		goto done;
+	}
+
+	if (org[0] != '_' || org[1] != 'Z')
+		goto einval;
+
+	if (!cpp_demangle_data_init(&ddata, org + 2, arena))
+		goto einval;
+
+	len = 0;
+	if (cpp_demangle_read_mangled_name(&ddata))
+		len = vector_str_copy_flat(&ddata.output, buf, bufsize);
+
+	cpp_demangle_data_dest(&ddata);
+
+	if (len == 0)
+		goto einval;
+
+done:
+	if (len >= bufsize) {
+		errno = ENAMETOOLONG;
+		return (-1);
+	}
+
+	return (0);
+
+einval:
+	errno = EINVAL;
+	return (-1);
+}
+
+/*
+ * Read the mangled name following the "_Z" prefix into the output
+ * vector.
+ */
+static int
+cpp_demangle_read_mangled_name(struct cpp_demangle_data *ddata)
+{
+	struct vector_str ret_type;
+	struct type_delimit td;
+	unsigned int limit;
+	int rtn;
+	bool has_ret, more_type;
+
+	rtn = 0;
 	has_ret = more_type = false;
 
-	if (!cpp_demangle_read_encoding(&ddata))
+	if (!cpp_demangle_read_encoding(ddata))
 		goto clean;
 
 	/*
 	 * Pop function name from substitution candidate list.
 	 */
-	if (*ddata.cur != 0 && ddata.subst.size >= 1) {
-		if (!vector_str_pop(&ddata.subst))
+	if (*ddata->cur != 0 && ddata->subst.size >= 1) {
+		if (!vector_str_pop(&ddata->subst))
 			goto clean;
 	}
 
@@ -261,28 +342,28 @@ cpp_demangle_gnu3(const char *org)
 	 * args. (the template args is right next to the function name,
 	 * which means it's a template function)
 	 */
-	if (ddata.is_tmpl) {
-		ddata.is_tmpl = false;
-		if (!vector_str_init(&ret_type))
+	if (ddata->is_tmpl) {
+		ddata->is_tmpl = false;
+		if (!vector_str_init_arena(&ret_type, ddata->arena))
 			goto clean;
-		ddata.cur_output = &ret_type;
+		ddata->cur_output = &ret_type;
 		has_ret = true;
 	}
 
-	while (*ddata.cur != '\0') {
+	while (*ddata->cur != '\0') {
 		/*
 		 * Breaking at some gcc info at tail. e.g) @@GLIBCXX_3.4
 		 */
-		if (*ddata.cur == '@' && *(ddata.cur + 1) == '@')
+		if (*ddata->cur == '@' && *(ddata->cur + 1) == '@')
 			break;
 
 		if (has_ret) {
 			/* Read return type */
-			if (!cpp_demangle_read_type(&ddata, NULL))
+			if (!cpp_demangle_read_type(ddata, NULL))
 				goto clean;
 		} else {
 			/* Read function arg type */
-			if (!cpp_demangle_read_type(&ddata, &td))
+			if (!cpp_demangle_read_type(ddata, &td))
 				goto clean;
 		}
 
@@ -290,10 +371,10 @@ cpp_demangle_gnu3(const char *org)
 			/* Push return type to the beginning */
 			if (!VEC_PUSH_STR(&ret_type, " "))
 				goto clean;
-			if (!vector_str_push_vector_head(&ddata.output,
+			if (!vector_str_push_vector_head(&ddata->output,
 			    &ret_type))
 				goto clean;
-			ddata.cur_output = &ddata.output;
+			ddata->cur_output = &ddata->output;
 			vector_str_dest(&ret_type);
 			has_ret = false;
 			more_type = true;
@@ -305,29 +386,27 @@ cpp_demangle_gnu3(const char *org)
 	if (more_type)
 		goto clean;
 
-	if (ddata.output.size == 0)
+	if (ddata->output.size == 0)
 		goto clean;
-	if (td.paren && !VEC_PUSH_STR(&ddata.output, ")"))
+	if (td.paren && !VEC_PUSH_STR(&ddata->output, ")"))
 		goto clean;
-	if (ddata.mem_vat && !VEC_PUSH_STR(&ddata.output, " volatile"))
+	if (ddata->mem_vat && !VEC_PUSH_STR(&ddata->output, " volatile"))
 		goto clean;
-	if (ddata.mem_cst && !VEC_PUSH_STR(&ddata.output, " const"))
+	if (ddata->mem_cst && !VEC_PUSH_STR(&ddata->output, " const"))
 		goto clean;
-	if (ddata.mem_rst && !VEC_PUSH_STR(&ddata.output, " restrict"))
+	if (ddata->mem_rst && !VEC_PUSH_STR(&ddata->output, " restrict"))
 		goto clean;
-	if (ddata.mem_ref && !VEC_PUSH_STR(&ddata.output, " &"))
+	if (ddata->mem_ref && !VEC_PUSH_STR(&ddata->output, " &"))
 		goto clean;
-	if (ddata.mem_rref && !VEC_PUSH_STR(&ddata.output, " &&"))
+	if (ddata->mem_rref && !VEC_PUSH_STR(&ddata->output, " &&"))
 		goto clean;
 
-	rtn = vector_str_get_flat(&ddata.output, (size_t *) NULL);
+	rtn = 1;
 
 clean:
 	if (has_ret)
 		vector_str_dest(&ret_type);
 
-	cpp_demangle_data_dest(&ddata);
-
 	return (rtn);
 }
 
@@ -346,21 +425,22 @@ cpp_demangle_data_dest(struct cpp_demangle_data *d)
 }
 
 static int
-cpp_demangle_data_init(struct cpp_demangle_data *d, const char *cur)
+cpp_demangle_data_init(struct cpp_demangle_data *d, const char *cur,
+    struct vector_str_arena *arena)
 {
 
 	if (d == NULL || cur == NULL)
 		return (0);
 
-	if (!vector_str_init(&d->output))
+	if (!vector_str_init_arena(&d->output, arena))
 		return (0);
-	if (!vector_str_init(&d->subst))
+	if (!vector_str_init_arena(&d->subst, arena))
 		goto clean1;
-	if (!vector_str_init(&d->tmpl))
+	if (!vector_str_init_arena(&d->tmpl, arena))
 		goto clean2;
-	if (!vector_str_init(&d->class_type))
+	if (!vector_str_init_arena(&d->class_type, arena))
 		goto clean3;
-	if (!vector_read_cmd_init(&d->cmd))
+	if (!vector_read_cmd_init(&d->cmd, arena))
 		goto clean4;
 
 	assert(d->output.container != NULL);
@@ -381,6 +461,7 @@ cpp_demangle_data_init(struct cpp_demangle_data *d, const char *cur)
 	d->cur = cur;
 	d->cur_output = &d->output;
 	d->last_sname = NULL;
+	d->arena = arena;
 
 	return (1);
 
@@ -483,7 +564,7 @@ cpp_demangle_push_subst_v(struct cpp_demangle_data *ddata, struct vector_str *v)
 
 	rtn = cpp_demangle_push_subst(ddata, str, str_len);
 
-	free(str);
+	DEM_FREE(ddata, str);
 
 	return (rtn);
 }
@@ -507,7 +588,7 @@ cpp_demangle_push_type_qualifier(struct cpp_demangle_data *ddata,
 
 	rtn = 0;
 	if (type_str != NULL) {
-		if (!vector_str_init(&subst_v))
+		if (!vector_str_init_arena(&subst_v, ddata->arena))
 			return (0);
 		if (!VEC_PUSH_STR(&subst_v, type_str))
 			goto clean;
@@ -602,28 +683,28 @@ cpp_demangle_push_type_qualifier(struct cpp_demangle_data *ddata,
 			if ((e_len = strlen(v->ext_name.container[e_idx])) ==
 			    0)
 				goto clean;
-			if ((buf = malloc(e_len + 2)) == NULL)
+			if ((buf = DEM_ALLOC(ddata, e_len + 2)) == NULL)
 				goto clean;
 			snprintf(buf, e_len + 2, " %s",
 			    v->ext_name.container[e_idx]);
 
 			if (!DEM_PUSH_STR(ddata, buf)) {
-				free(buf);
+				DEM_FREE(ddata, buf);
 				goto clean;
 			}
 
 			if (type_str != NULL) {
 				if (!VEC_PUSH_STR(&subst_v, buf)) {
-					free(buf);
+					DEM_FREE(ddata, buf);
 					goto clean;
 				}
 				if (!cpp_demangle_push_subst_v(ddata,
 				    &subst_v)) {
-					free(buf);
+					DEM_FREE(ddata, buf);
 					goto clean;
 				}
 			}
-			free(buf);
+			DEM_FREE(ddata, buf);
 			++e_idx;
 			break;
 
@@ -706,26 +787,26 @@ cpp_demangle_push_type_qualifier(struct cpp_demangle_data *ddata,
 			if ((e_len = strlen(v->ext_name.container[e_idx])) ==
 			    0)
 				goto clean;
-			if ((buf = malloc(e_len + 12)) == NULL)
+			if ((buf = DEM_ALLOC(ddata, e_len + 12)) == NULL)
 				goto clean;
 			snprintf(buf, e_len + 12, " __vector(%s)",
 			    v->ext_name.container[e_idx]);
 			if (!DEM_PUSH_STR(ddata, buf)) {
-				free(buf);
+				DEM_FREE(ddata, buf);
 				goto clean;
 			}
 			if (type_str != NULL) {
 				if (!VEC_PUSH_STR(&subst_v, buf)) {
-					free(buf);
+					DEM_FREE(ddata, buf);
 					goto clean;
 				}
 				if (!cpp_demangle_push_subst_v(ddata,
 				    &subst_v)) {
-					free(buf);
+					DEM_FREE(ddata, buf);
 					goto clean;
 				}
 			}
-			free(buf);
+			DEM_FREE(ddata, buf);
 			++e_idx;
 			break;
 		}
@@ -823,35 +904,35 @@ cpp_demangle_read_array(struct cpp_demangle_data *ddata)
 			idx = ddata->output.size;
 			for (i = p_idx; i < idx; ++i)
 				if (!vector_str_pop(&ddata->output)) {
-					free(exp);
+					DEM_FREE(ddata, exp);
 					return (0);
 				}
 			if (*ddata->cur != '_') {
-				free(exp);
+				DEM_FREE(ddata, exp);
 				return (0);
 			}
 			++ddata->cur;
 			if (*ddata->cur == '\0') {
-				free(exp);
+				DEM_FREE(ddata, exp);
 				return (0);
 			}
 			if (!cpp_demangle_read_type(ddata, NULL)) {
-				free(exp);
+				DEM_FREE(ddata, exp);
 				return (0);
 			}
 			if (!DEM_PUSH_STR(ddata, " [")) {
-				free(exp);
+				DEM_FREE(ddata, exp);
 				return (0);
 			}
 			if (!cpp_demangle_push_str(ddata, exp, exp_len)) {
-				free(exp);
+				DEM_FREE(ddata, exp);
 				return (0);
 			}
 			if (!DEM_PUSH_STR(ddata, "]")) {
-				free(exp);
+				DEM_FREE(ddata, exp);
 				return (0);
 			}
-			free(exp);
+			DEM_FREE(ddata, exp);
 		}
 	}
 
@@ -1247,7 +1328,7 @@ cpp_demangle_read_expression_flat(struct cpp_demangle_data *ddata, char **str)
 	idx = output->size;
 	for (i = p_idx; i < idx; ++i) {
 		if (!vector_str_pop(output)) {
-			free(exp);
+			DEM_FREE(ddata, exp);
 			return (0);
 		}
 	}
@@ -1418,7 +1499,7 @@ cpp_demangle_read_function(struct cpp_demangle_data *ddata, int *ext_c,
 
 		/* Release type qualifier vector. */
 		vector_type_qualifier_dest(v);
-		if (!vector_type_qualifier_init(v))
+		if (!vector_type_qualifier_init(v, ddata->arena))
 			return (0);
 
 		/* Push ref-qualifiers. */
@@ -1484,9 +1565,9 @@ cpp_demangle_read_encoding(struct cpp_demangle_data *ddata)
 			goto clean2;
 		rtn = 1;
 	clean2:
-		free(num_str);
+		DEM_FREE(ddata, num_str);
 	clean1:
-		free(name);
+		DEM_FREE(ddata, name);
 		return (rtn);
 
 	case SIMPLE_HASH('G', 'T'):
@@ -1550,7 +1631,7 @@ cpp_demangle_read_encoding(struct cpp_demangle_data *ddata)
 			goto clean3;
 		rtn = 1;
 	clean3:
-		free(type);
+		DEM_FREE(ddata, type);
 		return (rtn);
 
 	case SIMPLE_HASH('T', 'D'):
@@ -1669,7 +1750,7 @@ cpp_demangle_read_local_name(struct cpp_demangle_data *ddata)
 	if (*(++ddata->cur) == '\0')
 		return (0);
 
-	if (!vector_str_init(&local_name))
+	if (!vector_str_init_arena(&local_name, ddata->arena))
 		return (0);
 	ddata->cur_output = &local_name;
 
@@ -1770,7 +1851,7 @@ cpp_demangle_read_name(struct cpp_demangle_data *ddata)
 		return (cpp_demangle_read_local_name(ddata));
 	}
 
-	if (!vector_str_init(&v))
+	if (!vector_str_init_arena(&v, ddata->arena))
 		return (0);
 
 	p_idx = output->size;
@@ -1793,7 +1874,7 @@ cpp_demangle_read_name(struct cpp_demangle_data *ddata)
 		p_idx = output->size;
 		if (!cpp_demangle_read_tmpl_args(ddata))
 			goto clean;
-		free(subst_str);
+		DEM_FREE(ddata, subst_str);
 		if ((subst_str = vector_str_substr(output, p_idx,
 		    output->size - 1, &subst_str_len)) == NULL)
 			goto clean;
@@ -1806,7 +1887,7 @@ cpp_demangle_read_name(struct cpp_demangle_data *ddata)
 	rtn = 1;
 
 clean:
-	free(subst_str);
+	DEM_FREE(ddata, subst_str);
 	vector_str_dest(&v);
 
 	return (rtn);
@@ -1833,7 +1914,7 @@ cpp_demangle_read_name_flat(struct cpp_demangle_data *ddata, char **str)
 	idx = output->size;
 	for (i = p_idx; i < idx; ++i) {
 		if (!vector_str_pop(output)) {
-			free(name);
+			DEM_FREE(ddata, name);
 			return (0);
 		}
 	}
@@ -1880,7 +1961,7 @@ cpp_demangle_read_nested_name(struct cpp_demangle_data *ddata)
 
 next:
 	output = ddata->cur_output;
-	if (!vector_str_init(&v))
+	if (!vector_str_init_arena(&v, ddata->arena))
 		return (0);
 
 	rtn = 0;
@@ -1911,10 +1992,10 @@ next:
 		    output->size - 1, &subst_str_len)) == NULL)
 			goto clean;
 		if (!vector_str_push(&v, subst_str, subst_str_len)) {
-			free(subst_str);
+			DEM_FREE(ddata, subst_str);
 			goto clean;
 		}
-		free(subst_str);
+		DEM_FREE(ddata, subst_str);
 
 		if (!cpp_demangle_push_subst_v(ddata, &v))
 			goto clean;
@@ -1982,6 +2063,8 @@ cpp_demangle_read_number(struct cpp_demangle_data *ddata, long *rtn)
 static int
 cpp_demangle_read_number_as_string(struct cpp_demangle_data *ddata, char **str)
 {
+	char buf[sizeof(long) * CHAR_BIT / 3 + 3];
+	size_t len;
 	long n;
 
 	if (!cpp_demangle_read_number(ddata, &n)) {
@@ -1989,10 +2072,12 @@ cpp_demangle_read_number_as_string(struct cpp_demangle_data *ddata, char **str)
 		return (0);
 	}
 
-	if (asprintf(str, "%ld", n) < 0) {
-		*str = NULL;
+	len = (size_t) snprintf(buf, sizeof(buf), "%ld", n) + 1;
+
+	if ((*str = DEM_ALLOC(ddata, len)) == NULL)
 		return (0);
-	}
+
+	memcpy(*str, buf, len);
 
 	return (1);
 }
@@ -2117,10 +2202,10 @@ clean2:
 	if (!vector_read_cmd_pop(&ddata->cmd))
 		rtn = 0;
 clean1:
-	free(class_type);
+	DEM_FREE(ddata, class_type);
 
 	vector_type_qualifier_dest(v);
-	if (!vector_type_qualifier_init(v))
+	if (!vector_type_qualifier_init(v, ddata->arena))
 		return (0);
 
 	return (rtn);
@@ -2148,7 +2233,7 @@ cpp_demangle_read_sname(struct cpp_demangle_data *ddata)
 	assert(ddata->cur_output->size > 0);
 	if (vector_read_cmd_find(&ddata->cmd, READ_TMPL) == NULL)
 		ddata->last_sname =
-		    ddata->cur_output->container[ddata->output.size - 1];
+		    ddata->cur_output->container[ddata->cur_output->size - 1];
 
 	ddata->cur += len;
 
@@ -2294,7 +2379,7 @@ cpp_demangle_read_subst_std(struct cpp_demangle_data *ddata)
 	if (ddata == NULL)
 		return (0);
 
-	if (!vector_str_init(&v))
+	if (!vector_str_init_arena(&v, ddata->arena))
 		return (0);
 
 	subst_str = NULL;
@@ -2327,7 +2412,7 @@ cpp_demangle_read_subst_std(struct cpp_demangle_data *ddata)
 		p_idx = output->size;
 		if (!cpp_demangle_read_tmpl_args(ddata))
 			goto clean;
-		free(subst_str);
+		DEM_FREE(ddata, subst_str);
 		if ((subst_str = vector_str_substr(output, p_idx,
 		    output->size - 1, &subst_str_len)) == NULL)
 			goto clean;
@@ -2339,7 +2424,7 @@ cpp_demangle_read_subst_std(struct cpp_demangle_data *ddata)
 
 	rtn = 1;
 clean:
-	free(subst_str);
+	DEM_FREE(ddata, subst_str);
 	vector_str_dest(&v);
 
 	return (rtn);
@@ -2373,8 +2458,8 @@ cpp_demangle_read_subst_stdtmpl(struct cpp_demangle_data *ddata,
 		return (0);
 
 	rtn = 0;
-	if ((subst_str = malloc(sizeof(char) * (substr_len + len + 1))) ==
-	    NULL)
+	if ((subst_str = DEM_ALLOC(ddata,
+	    sizeof(char) * (substr_len + len + 1))) == NULL)
 		goto clean;
 
 	memcpy(subst_str, str, len);
@@ -2386,8 +2471,8 @@ cpp_demangle_read_subst_stdtmpl(struct cpp_demangle_data *ddata,
 
 	rtn = 1;
 clean:
-	free(subst_str);
-	free(substr);
+	DEM_FREE(ddata, subst_str);
+	DEM_FREE(ddata, substr);
 
 	return (rtn);
 }
@@ -2441,11 +2526,11 @@ cpp_demangle_read_tmpl_args(struct cpp_demangle_data *ddata)
 			return (0);
 		if (!vector_str_find(&ddata->tmpl, arg, arg_len) &&
 		    !vector_str_push(&ddata->tmpl, arg, arg_len)) {
-			free(arg);
+			DEM_FREE(ddata, arg);
 			return (0);
 		}
 
-		free(arg);
+		DEM_FREE(ddata, arg);
 
 		if (*ddata->cur == 'E') {
 			++ddata->cur;
@@ -2547,7 +2632,7 @@ cpp_demangle_read_type(struct cpp_demangle_data *ddata,
 	 * pointer-to-member, template-param, template-template-param, subst
 	 */
 
-	if (!vector_type_qualifier_init(&v))
+	if (!vector_type_qualifier_init(&v, ddata->arena))
 		return (0);
 
 	extern_c = 0;
@@ -2765,16 +2850,16 @@ again:
 		if ((subst_str = vector_str_substr(output, p_idx,
 		    output->size - 1, &subst_str_len)) == NULL)
 			goto clean;
-		if (!vector_str_init(&sv)) {
-			free(subst_str);
+		if (!vector_str_init_arena(&sv, ddata->arena)) {
+			DEM_FREE(ddata, subst_str);
 			goto clean;
 		}
 		if (!vector_str_push(&sv, subst_str, subst_str_len)) {
-			free(subst_str);
+			DEM_FREE(ddata, subst_str);
 			vector_str_dest(&sv);
 			goto clean;
 		}
-		free(subst_str);
+		DEM_FREE(ddata, subst_str);
 		if (!cpp_demangle_push_subst_v(ddata, &sv)) {
 			vector_str_dest(&sv);
 			goto clean;
@@ -3013,16 +3098,16 @@ rtn:
 	if (td)
 		td->firstp = false;
 
-	free(type_str);
-	free(exp_str);
-	free(num_str);
+	DEM_FREE(ddata, type_str);
+	DEM_FREE(ddata, exp_str);
+	DEM_FREE(ddata, num_str);
 	vector_type_qualifier_dest(&v);
 
 	return (1);
 clean:
-	free(type_str);
-	free(exp_str);
-	free(num_str);
+	DEM_FREE(ddata, type_str);
+	DEM_FREE(ddata, exp_str);
+	DEM_FREE(ddata, num_str);
 	vector_type_qualifier_dest(&v);
 
 	return (0);
@@ -3049,7 +3134,7 @@ cpp_demangle_read_type_flat(struct cpp_demangle_data *ddata, char **str)
 	idx = output->size;
 	for (i = p_idx; i < idx; ++i) {
 		if (!vector_str_pop(output)) {
-			free(type);
+			DEM_FREE(ddata, type);
 			return (0);
 		}
 	}
@@ -3861,7 +3946,7 @@ vector_read_cmd_dest(struct vector_read_cmd *v)
 	if (v == NULL)
 		return;
 
-	free(v->r_container);
+	vector_str_arena_free(v->arena, v->r_container);
 }
 
 static struct read_cmd_item *
@@ -3880,7 +3965,7 @@ vector_read_cmd_find(struct vector_read_cmd *v, enum read_cmd dst)
 }
 
 static int
-vector_read_cmd_init(struct vector_read_cmd *v)
+vector_read_cmd_init(struct vector_read_cmd *v, struct vector_str_arena *a)
 {
 
 	if (v == NULL)
@@ -3888,9 +3973,10 @@ vector_read_cmd_init(struct vector_read_cmd *v)
 
 	v->size = 0;
 	v->capacity = VECTOR_DEF_CAPACITY;
+	v->arena = a;
 
-	if ((v->r_container = malloc(sizeof(*v->r_container) * v->capacity))
-	    == NULL)
+	if ((v->r_container = vector_str_arena_alloc(a,
+	    sizeof(*v->r_container) * v->capacity)) == NULL)
 		return (0);
 
 	return (1);
@@ -3922,11 +4008,12 @@ vector_read_cmd_push(struct vector_read_cmd *v, enum read_cmd cmd, void *data)
 
 	if (v->size == v->capacity) {
 		tmp_cap = BUFFER_GROW(v->capacity);
-		if ((tmp_r_ctn = malloc(sizeof(*tmp_r_ctn) * tmp_cap)) == NULL)
+		if ((tmp_r_ctn = vector_str_arena_alloc(v->arena,
+		    sizeof(*tmp_r_ctn) * tmp_cap)) == NULL)
 			return (0);
 		for (i = 0; i < v->size; ++i)
 			tmp_r_ctn[i] = v->r_container[i];
-		free(v->r_container);
+		vector_str_arena_free(v->arena, v->r_container);
 		v->r_container = tmp_r_ctn;
 		v->capacity = tmp_cap;
 	}
@@ -3945,13 +4032,14 @@ vector_type_qualifier_dest(struct vector_type_qualifier *v)
 	if (v == NULL)
 		return;
 
-	free(v->q_container);
+	vector_str_arena_free(v->ext_name.arena, v->q_container);
 	vector_str_dest(&v->ext_name);
 }
 
 /* size, capacity, ext_name */
 static int
-vector_type_qualifier_init(struct vector_type_qualifier *v)
+vector_type_qualifier_init(struct vector_type_qualifier *v,
+    struct vector_str_arena *a)
 {
 
 	if (v == NULL)
@@ -3960,14 +4048,14 @@ vector_type_qualifier_init(struct vector_type_qualifier *v)
 	v->size = 0;
 	v->capacity = VECTOR_DEF_CAPACITY;
 
-	if ((v->q_container = malloc(sizeof(enum type_qualifier) * v->capacity))
-	    == NULL)
+	if ((v->q_container = vector_str_arena_alloc(a,
+	    sizeof(enum type_qualifier) * v->capacity)) == NULL)
 		return (0);
 
 	assert(v->q_container != NULL);
 
-	if (!vector_str_init(&v->ext_name)) {
-		free(v->q_container);
+	if (!vector_str_init_arena(&v->ext_name, a)) {
+		vector_str_arena_free(a, v->q_container);
 		return (0);
 	}
 
@@ -3987,12 +4075,12 @@ vector_type_qualifier_push(struct vector_type_qualifier *v,
 
 	if (v->size == v->capacity) {
 		tmp_cap = BUFFER_GROW(v->capacity);
-		if ((tmp_ctn = malloc(sizeof(enum type_qualifier) * tmp_cap))
-		    == NULL)
+		if ((tmp_ctn = vector_str_arena_alloc(v->ext_name.arena,
+		    sizeof(enum type_qualifier) * tmp_cap)) == NULL)
 			return (0);
 		for (i = 0; i < v->size; ++i)
 			tmp_ctn[i] = v->q_container[i];
-		free(v->q_container);
+		vector_str_arena_free(v->ext_name.arena, v->q_container);
 		v->q_container = tmp_ctn;
 		v->capacity = tmp_cap;
 	}
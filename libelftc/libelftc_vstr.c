@@ -27,7 +27,6 @@
 #include <sys/types.h>
 #include <assert.h>
 #include <libelftc.h>
-#include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
 
@@ -42,7 +41,24 @@ ELFTC_VCSID("$Id$");
  * Resemble to std::vector<std::string> in C++.
  */
 
+/** @brief Chunk of memory owned by a vector_str_arena. */
+struct vector_str_chunk {
+	/** Next older chunk */
+	struct vector_str_chunk	*next;
+	/** Usable size */
+	size_t			 size;
+};
+
+#define	VECTOR_STR_ALIGN	(2 * sizeof(void *))
+#define	VECTOR_STR_ROUNDUP(n)	\
+	(((n) + VECTOR_STR_ALIGN - 1) & ~(VECTOR_STR_ALIGN - 1))
+#define	VECTOR_STR_CHUNK_HDR_SIZE	\
+	VECTOR_STR_ROUNDUP(sizeof(struct vector_str_chunk))
+#define	VECTOR_STR_CHUNK_DATA(c)	((char *) (c) + VECTOR_STR_CHUNK_HDR_SIZE)
+#define	VECTOR_STR_CHUNK_DEF_SIZE	4096
+
 static size_t	get_strlen_sum(const struct vector_str *v);
+static char	*vector_str_dup(struct vector_str_arena *a, const char *str);
 static bool	vector_str_grow(struct vector_str *v);
 
 static size_t
@@ -61,6 +77,175 @@ get_strlen_sum(const struct vector_str *v)
 	return (len);
 }
 
+static char *
+vector_str_dup(struct vector_str_arena *a, const char *str)
+{
+	size_t len;
+	char *rtn;
+
+	len = strlen(str) + 1;
+
+	if ((rtn = vector_str_arena_alloc(a, len)) == NULL)
+		return (NULL);
+
+	memcpy(rtn, str, len);
+
+	return (rtn);
+}
+
+/**
+ * @brief Allocate memory from arena.
+ *
+ * If arena is NULL, the memory is allocated with malloc(3).
+ * @return NULL at failed or pointer to size bytes.
+ */
+void *
+vector_str_arena_alloc(struct vector_str_arena *a, size_t size)
+{
+	struct vector_str_chunk *c;
+	size_t csize;
+	char *p;
+
+	if (a == NULL)
+		return (malloc(size));
+
+	size = VECTOR_STR_ROUNDUP(size);
+
+	if (size > a->avail) {
+		csize = a->chunks != NULL ? a->chunks->size * 2 :
+		    VECTOR_STR_CHUNK_DEF_SIZE;
+		if (csize < size)
+			csize = size;
+		if ((c = malloc(VECTOR_STR_CHUNK_HDR_SIZE + csize)) == NULL)
+			return (NULL);
+		c->next = a->chunks;
+		c->size = csize;
+		a->chunks = c;
+		a->cur = VECTOR_STR_CHUNK_DATA(c);
+		a->avail = csize;
+	}
+
+	p = a->cur;
+	a->cur += size;
+	a->avail -= size;
+
+	return (p);
+}
+
+/**
+ * @brief Deallocate all memory owned by arena.
+ */
+void
+vector_str_arena_dest(struct vector_str_arena *a)
+{
+	struct vector_str_chunk *c;
+
+	if (a == NULL)
+		return;
+
+	while ((c = a->chunks) != NULL) {
+		a->chunks = c->next;
+		free(c);
+	}
+
+	a->cur = NULL;
+	a->avail = 0;
+}
+
+/**
+ * @brief Release memory allocated by vector_str_arena_alloc().
+ *
+ * Memory allocated from an arena is only reclaimed when the arena is
+ * reset.
+ */
+void
+vector_str_arena_free(struct vector_str_arena *a, void *p)
+{
+
+	if (a == NULL)
+		free(p);
+}
+
+/**
+ * @brief Initialize arena.
+ */
+void
+vector_str_arena_init(struct vector_str_arena *a)
+{
+
+	if (a == NULL)
+		return;
+
+	a->chunks = NULL;
+	a->cur = NULL;
+	a->avail = 0;
+}
+
+/**
+ * @brief Reclaim all memory allocated from arena, for reuse.
+ *
+ * If the last use of the arena needed more than one chunk, the chunks
+ * are replaced by a single one large enough to hold their contents.
+ */
+void
+vector_str_arena_reset(struct vector_str_arena *a)
+{
+	struct vector_str_chunk *c;
+	size_t total;
+
+	if (a == NULL || a->chunks == NULL)
+		return;
+
+	if (a->chunks->next != NULL) {
+		total = 0;
+		while ((c = a->chunks) != NULL) {
+			a->chunks = c->next;
+			total += c->size;
+			free(c);
+		}
+		if ((c = malloc(VECTOR_STR_CHUNK_HDR_SIZE + total)) == NULL) {
+			a->cur = NULL;
+			a->avail = 0;
+			return;
+		}
+		c->next = NULL;
+		c->size = total;
+		a->chunks = c;
+	}
+
+	a->cur = VECTOR_STR_CHUNK_DATA(a->chunks);
+	a->avail = a->chunks->size;
+}
+
+/**
+ * @brief Copy flat string from vector to buffer.
+ *
+ * The string is copied only if it fits in the buffer, including the
+ * trailing NUL.
+ * @return Length of the flat string.
+ */
+size_t
+vector_str_copy_flat(const struct vector_str *v, char *buf, size_t bufsize)
+{
+	size_t elem_size, i, len;
+
+	if (v == NULL)
+		return (0);
+
+	len = 0;
+	for (i = 0; i < v->size; ++i) {
+		elem_size = strlen(v->container[i]);
+		if (len + elem_size < bufsize)
+			memcpy(buf + len, v->container[i], elem_size);
+		len += elem_size;
+	}
+
+	if (len < bufsize)
+		buf[len] = '\0';
+
+	return (len);
+}
+
 /**
  * @brief Deallocate resource in vector_str.
  */
@@ -72,10 +257,11 @@ vector_str_dest(struct vector_str *v)
 	if (v == NULL)
 		return;
 
-	for (i = 0; i < v->size; ++i)
-		free(v->container[i]);
+	if (v->arena == NULL)
+		for (i = 0; i < v->size; ++i)
+			free(v->container[i]);
 
-	free(v->container);
+	vector_str_arena_free(v->arena, v->container);
 }
 
 /**
@@ -121,7 +307,8 @@ vector_str_get_flat(const struct vector_str *v, size_t *l)
 	if ((rtn_size = get_strlen_sum(v)) == 0)
 		return (NULL);
 
-	if ((rtn = malloc(sizeof(char) * (rtn_size + 1))) == NULL)
+	if ((rtn = vector_str_arena_alloc(v->arena,
+	    sizeof(char) * (rtn_size + 1))) == NULL)
 		return (NULL);
 
 	elem_pos = 0;
@@ -156,13 +343,14 @@ vector_str_grow(struct vector_str *v)
 
 	assert(tmp_cap > v->capacity);
 
-	if ((tmp_ctn = malloc(sizeof(char *) * tmp_cap)) == NULL)
+	if ((tmp_ctn = vector_str_arena_alloc(v->arena,
+	    sizeof(char *) * tmp_cap)) == NULL)
 		return (false);
 
 	for (i = 0; i < v->size; ++i)
 		tmp_ctn[i] = v->container[i];
 
-	free(v->container);
+	vector_str_arena_free(v->arena, v->container);
 
 	v->container = tmp_ctn;
 	v->capacity = tmp_cap;
@@ -176,6 +364,19 @@ vector_str_grow(struct vector_str *v)
  */
 bool
 vector_str_init(struct vector_str *v)
+{
+
+	return (vector_str_init_arena(v, NULL));
+}
+
+/**
+ * @brief Initialize vector_str allocating from arena.
+ *
+ * Strings in the vector remain valid until the arena is reset.
+ * @return false at failed, true at success.
+ */
+bool
+vector_str_init_arena(struct vector_str *v, struct vector_str_arena *a)
 {
 
 	if (v == NULL)
@@ -183,10 +384,12 @@ vector_str_init(struct vector_str *v)
 
 	v->size = 0;
 	v->capacity = VECTOR_DEF_CAPACITY;
+	v->arena = a;
 
 	assert(v->capacity > 0);
 
-	if ((v->container = malloc(sizeof(char *) * v->capacity)) == NULL)
+	if ((v->container = vector_str_arena_alloc(a,
+	    sizeof(char *) * v->capacity)) == NULL)
 		return (false);
 
 	assert(v->container != NULL);
@@ -210,7 +413,7 @@ vector_str_pop(struct vector_str *v)
 
 	--v->size;
 
-	free(v->container[v->size]);
+	vector_str_arena_free(v->arena, v->container[v->size]);
 	v->container[v->size] = NULL;
 
 	return (true);
@@ -230,10 +433,13 @@ vector_str_push(struct vector_str *v, const char *str, size_t len)
 	if (v->size == v->capacity && vector_str_grow(v) == false)
 		return (false);
 
-	if ((v->container[v->size] = malloc(sizeof(char) * (len + 1))) == NULL)
+	if ((v->container[v->size] = vector_str_arena_alloc(v->arena,
+	    sizeof(char) * (len + 1))) == NULL)
 		return (false);
 
-	snprintf(v->container[v->size], len + 1, "%s", str);
+	len = strnlen(str, len);
+	memcpy(v->container[v->size], str, len);
+	v->container[v->size][len] = '\0';
 
 	++v->size;
 
@@ -255,15 +461,17 @@ vector_str_push_vector_head(struct vector_str *dst, struct vector_str *org)
 
 	tmp_cap = BUFFER_GROW(dst->size + org->size);
 
-	if ((tmp_ctn = malloc(sizeof(char *) * tmp_cap)) == NULL)
+	if ((tmp_ctn = vector_str_arena_alloc(dst->arena,
+	    sizeof(char *) * tmp_cap)) == NULL)
 		return (false);
 
 	for (i = 0; i < org->size; ++i)
-		if ((tmp_ctn[i] = strdup(org->container[i])) == NULL) {
+		if ((tmp_ctn[i] = vector_str_dup(dst->arena,
+		    org->container[i])) == NULL) {
 			for (j = 0; j < i; ++j)
-				free(tmp_ctn[j]);
+				vector_str_arena_free(dst->arena, tmp_ctn[j]);
 
-			free(tmp_ctn);
+			vector_str_arena_free(dst->arena, tmp_ctn);
 
 			return (false);
 		}
@@ -271,7 +479,7 @@ vector_str_push_vector_head(struct vector_str *dst, struct vector_str *org)
 	for (i = 0; i < dst->size; ++i)
 		tmp_ctn[i + org->size] = dst->container[i];
 
-	free(dst->container);
+	vector_str_arena_free(dst->arena, dst->container);
 
 	dst->container = tmp_ctn;
 	dst->capacity = tmp_cap;
@@ -295,24 +503,26 @@ vector_str_push_vector(struct vector_str *dst, struct vector_str *org)
 
 	tmp_cap = BUFFER_GROW(dst->size + org->size);
 
-	if ((tmp_ctn = malloc(sizeof(char *) * tmp_cap)) == NULL)
+	if ((tmp_ctn = vector_str_arena_alloc(dst->arena,
+	    sizeof(char *) * tmp_cap)) == NULL)
 		return (false);
 
 	for (i = 0; i < dst->size; ++i)
 		tmp_ctn[i] = dst->container[i];
 
 	for (i = 0; i < org->size; ++i)
-		if ((tmp_ctn[i + dst->size] = strdup(org->container[i])) ==
-		    NULL) {
-			for (j = 0; j < i + dst->size; ++j)
-				free(tmp_ctn[j]);
+		if ((tmp_ctn[i + dst->size] = vector_str_dup(dst->arena,
+		    org->container[i])) == NULL) {
+			for (j = 0; j < i; ++j)
+				vector_str_arena_free(dst->arena,
+				    tmp_ctn[j + dst->size]);
 
-			free(tmp_ctn);
+			vector_str_arena_free(dst->arena, tmp_ctn);
 
 			return (false);
 		}
 
-	free(dst->container);
+	vector_str_arena_free(dst->arena, dst->container);
 
 	dst->container = tmp_ctn;
 	dst->capacity = tmp_cap;
@@ -341,7 +551,8 @@ vector_str_substr(const struct vector_str *v, size_t begin, size_t end,
 	for (i = begin; i < end + 1; ++i)
 		len += strlen(v->container[i]);
 
-	if ((rtn = malloc(sizeof(char) * (len + 1))) == NULL)
+	if ((rtn = vector_str_arena_alloc(v->arena,
+	    sizeof(char) * (len + 1))) == NULL)
 		return (NULL);
 
 	if (r_len != NULL)
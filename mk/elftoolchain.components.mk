@@ -19,6 +19,12 @@ WITH_ISA?=	no
 # Build PE support.
 WITH_PE?=	yes
 
+# Support zlib compressed ELF sections in libelf (needs libz).
+WITH_ZLIB?=	yes
+
+# Support zstd compressed ELF sections in libelf (needs libzstd).
+WITH_ZSTD?=	no
+
 # Build test suites.
 .if defined(MAKEOBJDIR) || defined(MAKEOBJDIRPREFIX)
 .if defined(WITH_TESTS) && ${WITH_TESTS} == "yes"
@@ -48,3 +54,9 @@ WITH_TESTS?=	yes
 .if ${WITH_TESTS} != "yes" && ${WITH_TESTS} != "no"
 .error Unrecognized value for WITH_TESTS: "${WITH_TESTS}".
 .endif
+.if ${WITH_ZLIB} != "yes" && ${WITH_ZLIB} != "no"
+.error Unrecognized value for WITH_ZLIB: "${WITH_ZLIB}".
+.endif
+.if ${WITH_ZSTD} != "yes" && ${WITH_ZSTD} != "no"
+.error Unrecognized value for WITH_ZSTD: "${WITH_ZSTD}".
+.endif
@@ -8,6 +8,7 @@
 .endif
 
 .include "${TOP}/mk/elftoolchain.os.mk"
+.include "${TOP}/mk/elftoolchain.components.mk"
 
 LIBDWARF?=	${TOP}/libdwarf
 LIBELF?=	${TOP}/libelf
@@ -37,6 +38,14 @@ LDFLAGS+= -L${.CURDIR}/${TOP}/libdwarf/${.OBJDIR:S,${.CURDIR}/,,}
 _LDADD_LIBELF=${LDADD:M-lelf}
 .if !empty(_LDADD_LIBELF)
 _INCDIRS+= -I${.CURDIR}/${TOP}/libelf
+# Libraries needed by libelf.
+LDADD+= -lpthread
+.if ${WITH_ZLIB} == "yes"
+LDADD+= -lz
+.endif
+.if ${WITH_ZSTD} == "yes"
+LDADD+= -lzstd
+.endif
 .if exists(${.OBJDIR}/${TOP}/libelf)
 LDFLAGS+= -L${.OBJDIR}/${TOP}/libelf
 .elif exists(${TOP}/libelf/${.OBJDIR:S,${.CURDIR}/,,})
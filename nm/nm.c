@@ -82,6 +82,7 @@ struct sym_print_data {
 struct nm_prog_info {
 	const char	*name;
 	const char	*def_filename;
+	Elftc_Demangle_Ctx *demangle_ctx;
 };
 
 /* List for line number information. */
@@ -737,6 +738,7 @@ global_dest(void)
 {
 
 	filter_dest();
+	elftc_demangle_ctx_destroy(nm_info.demangle_ctx);
 }
 
 static void
@@ -748,6 +750,7 @@ global_init(void)
 
 	nm_info.name = ELFTC_GETPROGNAME();
 	nm_info.def_filename = "a.out";
+	nm_info.demangle_ctx = NULL;
 	nm_opts.print_symbol = PRINT_SYM_SYM;
 	nm_opts.print_name = PRINT_NAME_NONE;
 	nm_opts.demangle_type = -1;
@@ -868,8 +871,8 @@ print_ar_index(int fd, Elf *arf)
 #define	PRINT_DEMANGLED_NAME(FORMAT, NAME) do {				\
 	char _demangled[DEMANGLED_BUFFER_SIZE];				\
 	if (nm_opts.demangle_type < 0 ||				\
-	    elftc_demangle((NAME), _demangled, sizeof(_demangled),	\
-		nm_opts.demangle_type) < 0)				\
+	    elftc_demangle_r(nm_info.demangle_ctx, (NAME), _demangled,	\
+		sizeof(_demangled), nm_opts.demangle_type) < 0)		\
 		printf((FORMAT), (NAME));				\
 	else								\
 		printf((FORMAT), _demangled);				\
@@ -2112,6 +2115,9 @@ main(int argc, char **argv)
 
 	global_init();
 	get_opt(argc, argv);
+	if (nm_opts.demangle_type >= 0 &&
+	    (nm_info.demangle_ctx = elftc_demangle_ctx_create()) == NULL)
+		err(EXIT_FAILURE, "elftc_demangle_ctx_create");
 	rtn = read_files(argc - optind, argv + optind);
 	global_dest();
 
@@ -73,6 +73,7 @@ ELFTC_VCSID("$Id$");
 #define	RE_WW	0x00040000
 #define	RE_W	0x00080000
 #define	RE_X	0x00100000
+#define	RE_Z	0x00200000
 
 /*
  * dwarf dump options.
@@ -175,6 +176,7 @@ static struct option longopts[] = {
 	{"arch-specific", no_argument, NULL, 'A'},
 	{"archive-index", no_argument, NULL, 'c'},
 	{"debug-dump", optional_argument, NULL, OPTION_DEBUG_DUMP},
+	{"decompress", no_argument, NULL, 'z'},
 	{"dynamic", no_argument, NULL, 'd'},
 	{"file-header", no_argument, NULL, 'h'},
 	{"full-section-name", no_argument, NULL, 'N'},
@@ -6958,6 +6960,10 @@ dump_elf(struct readelf *re)
 		warnx("gelf_getclass failed: %s", elf_errmsg(-1));
 		return;
 	}
+	/* Show the contents of compressed sections decompressed. */
+	if (re->options & RE_Z)
+		(void) elf_flagelf(re->elf, ELF_C_SET, ELF_F_DECOMPRESS);
+
 	if (re->ehdr.e_ident[EI_DATA] == ELFDATA2MSB) {
 		re->dw_read = _read_msb;
 		re->dw_decode = _decode_msb;
@@ -7476,6 +7482,8 @@ Usage: %s [options] file...\n\
                            Display DWARF information.\n\
   -x INDEX | --hex-dump=INDEX\n\
                            Display contents of a section as hexadecimal.\n\
+  -z | --decompress        Decompress the contents of compressed sections\n\
+                           before displaying them.\n\
   -A | --arch-specific     (accepted, but ignored)\n\
   -D | --use-dynamic       Print the symbol table specified by the DT_SYMTAB\n\
                            entry in the \".dynamic\" section.\n\
@@ -7508,7 +7516,7 @@ main(int argc, char **argv)
 	memset(re, 0, sizeof(*re));
 	STAILQ_INIT(&re->v_dumpop);
 
-	while ((opt = getopt_long(argc, argv, "AacDdegHhIi:lNnp:rSstuVvWw::x:",
+	while ((opt = getopt_long(argc, argv, "AacDdegHhIi:lNnp:rSstuVvWw::x:z",
 	    longopts, NULL)) != -1) {
 		switch(opt) {
 		case '?':
@@ -7605,6 +7613,9 @@ main(int argc, char **argv)
 				add_dumpop(re, 0, optarg, HEX_DUMP,
 				    DUMP_BY_NAME);
 			break;
+		case 'z':
+			re->options |= RE_Z;
+			break;
 		case OPTION_DEBUG_DUMP:
 			re->options |= RE_W;
 			parse_dwarf_op_long(re, optarg);
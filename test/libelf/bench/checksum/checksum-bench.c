@@ -0,0 +1,264 @@
+/*-
+ * Copyright (c) 2026, Elftoolchain Project Contributors.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE AUTHOR AND CONTRIBUTORS ``AS IS'' AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED.  IN NO EVENT SHALL THE AUTHOR OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS
+ * OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY
+ * OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+ * SUCH DAMAGE.
+ *
+ * $Id$
+ */
+
+/*
+ * Measure the throughput of gelf_checksum(3).
+ *
+ * A temporary ELF object is created holding a large allocatable text
+ * section, optionally split into many sections.  Its checksum is then
+ * computed repeatedly in child processes, once with the LIBELF_NOSIMD
+ * environment variable set, and the two results are compared.
+ */
+
+#include <sys/types.h>
+#include <sys/wait.h>
+
+#include <err.h>
+#include <fcntl.h>
+#include <gelf.h>
+#include <libelf.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+#include <unistd.h>
+
+#define	DEFAULT_SIZE	(64 * 1024 * 1024)
+#define	DEFAULT_REPS	20
+
+static size_t	textsize = DEFAULT_SIZE;
+static size_t	nsections = 1;
+static int	reps = DEFAULT_REPS;
+static char	objfile[] = "/tmp/checksum-bench.XXXXXX";
+
+struct result {
+	double		r_mbs;		/* throughput in MB/s */
+	long		r_checksum;	/* checksum computed */
+};
+
+static double
+now(void)
+{
+	struct timespec ts;
+
+	if (clock_gettime(CLOCK_MONOTONIC, &ts) < 0)
+		err(1, "clock_gettime");
+
+	return ((double) ts.tv_sec + (double) ts.tv_nsec / 1e9);
+}
+
+/*
+ * Create an ELF object whose text is split over `nsections' sections.
+ */
+static void
+make_object(void)
+{
+	Elf *e;
+	Elf_Data *d;
+	Elf_Scn *scn;
+	GElf_Ehdr eh;
+	GElf_Shdr sh;
+	unsigned char *text;
+	size_t i, off, sz;
+	int fd;
+
+	if ((fd = mkstemp(objfile)) < 0)
+		err(1, "mkstemp");
+
+	if ((text = malloc(textsize)) == NULL)
+		err(1, "malloc");
+	for (i = 0; i < textsize; i++)
+		text[i] = (unsigned char) (i * 131 + (i >> 12) + 7);
+
+	if ((e = elf_begin(fd, ELF_C_WRITE, NULL)) == NULL)
+		errx(1, "elf_begin: %s", elf_errmsg(-1));
+	if (gelf_newehdr(e, ELFCLASS64) == NULL || gelf_getehdr(e, &eh) == NULL)
+		errx(1, "gelf_newehdr: %s", elf_errmsg(-1));
+	eh.e_ident[EI_DATA] = ELFDATA2LSB;
+	eh.e_type = ET_EXEC;
+	if (gelf_update_ehdr(e, &eh) == 0)
+		errx(1, "gelf_update_ehdr: %s", elf_errmsg(-1));
+
+	for (i = 0, off = 0; i < nsections; i++, off += sz) {
+		sz = textsize / nsections;
+		if (i == nsections - 1)
+			sz = textsize - off;
+
+		if ((scn = elf_newscn(e)) == NULL ||
+		    gelf_getshdr(scn, &sh) == NULL)
+			errx(1, "elf_newscn: %s", elf_errmsg(-1));
+		sh.sh_type = SHT_PROGBITS;
+		sh.sh_flags = SHF_ALLOC | SHF_EXECINSTR;
+		sh.sh_addralign = 1;
+		if (gelf_update_shdr(scn, &sh) == 0)
+			errx(1, "gelf_update_shdr: %s", elf_errmsg(-1));
+
+		if ((d = elf_newdata(scn)) == NULL)
+			errx(1, "elf_newdata: %s", elf_errmsg(-1));
+		d->d_buf = text + off;
+		d->d_size = sz;
+		d->d_type = ELF_T_BYTE;
+		d->d_align = 1;
+	}
+
+	if (elf_update(e, ELF_C_WRITE) < 0)
+		errx(1, "elf_update: %s", elf_errmsg(-1));
+
+	(void) elf_end(e);
+	(void) close(fd);
+	free(text);
+}
+
+/*
+ * Run the measurements, writing the results to file descriptor `fd'.
+ */
+static void
+run(int fd, int scalar)
+{
+	struct result r;
+	double t0, t1;
+	Elf *e;
+	int i, tfd;
+
+	if (scalar && setenv("LIBELF_NOSIMD", "1", 1) < 0)
+		err(1, "setenv");
+
+	if ((tfd = open(objfile, O_RDONLY)) < 0)
+		err(1, "%s", objfile);
+	if ((e = elf_begin(tfd, ELF_C_READ, NULL)) == NULL)
+		errx(1, "elf_begin: %s", elf_errmsg(-1));
+
+	/* Fault the file in before timing. */
+	r.r_checksum = gelf_checksum(e);
+
+	t0 = now();
+	for (i = 0; i < reps; i++)
+		r.r_checksum = gelf_checksum(e);
+	t1 = now();
+
+	r.r_mbs = (double) textsize * reps / (t1 - t0) / 1e6;
+
+	(void) elf_end(e);
+	(void) close(tfd);
+
+	if (write(fd, &r, sizeof(r)) != (ssize_t) sizeof(r))
+		err(1, "write");
+}
+
+/*
+ * Run the measurements in a child process and collect its results.
+ */
+static void
+collect(struct result *r, int scalar)
+{
+	pid_t pid;
+	int fds[2], status;
+
+	if (pipe(fds) < 0)
+		err(1, "pipe");
+
+	if ((pid = fork()) < 0)
+		err(1, "fork");
+
+	if (pid == 0) {
+		(void) close(fds[0]);
+		run(fds[1], scalar);
+		_exit(0);
+	}
+
+	(void) close(fds[1]);
+	if (read(fds[0], r, sizeof(*r)) != (ssize_t) sizeof(*r))
+		errx(1, "short read from child");
+	(void) close(fds[0]);
+
+	if (waitpid(pid, &status, 0) < 0)
+		err(1, "waitpid");
+	if (!WIFEXITED(status) || WEXITSTATUS(status) != 0)
+		errx(1, "child failed");
+}
+
+static void
+usage(void)
+{
+	(void) fprintf(stderr,
+	    "usage: checksum-bench [-c nsections] [-n reps] [-s size]\n");
+	exit(1);
+}
+
+int
+main(int argc, char **argv)
+{
+	struct result scalar, vector;
+	int c;
+
+	while ((c = getopt(argc, argv, "c:n:s:")) != -1) {
+		switch (c) {
+		case 'c':
+			if ((nsections = (size_t) strtoul(optarg, NULL, 0)) ==
+			    0 || nsections >= SHN_LORESERVE)
+				usage();
+			break;
+		case 'n':
+			if ((reps = atoi(optarg)) <= 0)
+				usage();
+			break;
+		case 's':
+			if ((textsize = (size_t) strtoul(optarg, NULL, 0)) == 0)
+				usage();
+			break;
+		default:
+			usage();
+		}
+	}
+
+	if (nsections > textsize)
+		usage();
+
+	if (elf_version(EV_CURRENT) == EV_NONE)
+		errx(1, "elf_version: %s", elf_errmsg(-1));
+
+	make_object();
+
+	collect(&scalar, 1);
+	collect(&vector, 0);
+
+	(void) unlink(objfile);
+
+	(void) printf("%-10s %10s %10s %7s %10s\n", "sections", "scalar",
+	    "simd", "ratio", "checksum");
+	(void) printf("%-10zu %10.0f %10.0f %7.2f %#10lx\n", nsections,
+	    scalar.r_mbs, vector.r_mbs, vector.r_mbs / scalar.r_mbs,
+	    (unsigned long) vector.r_checksum);
+
+	if (scalar.r_checksum != vector.r_checksum)
+		errx(1, "checksum mismatch: %#lx != %#lx",
+		    (unsigned long) scalar.r_checksum,
+		    (unsigned long) vector.r_checksum);
+
+	exit(0);
+}
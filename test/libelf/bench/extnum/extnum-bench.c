@@ -0,0 +1,290 @@
+/*-
+ * Copyright (c) 2026, Elftoolchain Project Contributors.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE AUTHOR AND CONTRIBUTORS ``AS IS'' AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED.  IN NO EVENT SHALL THE AUTHOR OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS
+ * OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY
+ * OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+ * SUCH DAMAGE.
+ *
+ * $Id$
+ */
+
+/*
+ * Measure the cost of opening objects with a large number of sections,
+ * which use extended section numbering.
+ *
+ * An object with the requested number of empty sections, followed by a
+ * symbol table, is created.  Each measurement runs in a child process
+ * so that its peak memory use can be reported.
+ */
+
+#include <sys/types.h>
+#include <sys/resource.h>
+#include <sys/time.h>
+#include <sys/wait.h>
+
+#include <err.h>
+#include <fcntl.h>
+#include <gelf.h>
+#include <libelf.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+
+#define	DEFAULT_NSCN	1000000
+#define	DEFAULT_REPS	5
+#define	NSYMS		1000
+
+static size_t	nscn = DEFAULT_NSCN;
+static int	reps = DEFAULT_REPS;
+static size_t	symndx;
+
+static double
+now(void)
+{
+	struct timespec ts;
+
+	if (clock_gettime(CLOCK_MONOTONIC, &ts) < 0)
+		err(1, "clock_gettime");
+
+	return ((double) ts.tv_sec + (double) ts.tv_nsec / 1e9);
+}
+
+/*
+ * Create the test object in file `fn'.  Section names are not needed,
+ * so all sections share the name of the section name string table.
+ */
+static void
+create(const char *fn)
+{
+	static char shstrtab[] = "\0.shstrtab";
+	GElf_Ehdr eh;
+	GElf_Shdr sh;
+	GElf_Sym sym;
+	Elf_Data *d;
+	Elf_Scn *scn;
+	Elf *e;
+	void *symbuf;
+	size_t i;
+	int fd;
+
+	if ((fd = open(fn, O_RDWR | O_CREAT | O_TRUNC, 0644)) < 0)
+		err(1, "open \"%s\"", fn);
+
+	if ((e = elf_begin(fd, ELF_C_WRITE, NULL)) == NULL ||
+	    gelf_newehdr(e, ELFCLASS64) == NULL ||
+	    gelf_getehdr(e, &eh) == NULL)
+		errx(1, "elf_begin: %s", elf_errmsg(-1));
+
+	eh.e_ident[EI_DATA] = ELFDATA2LSB;
+	eh.e_type = ET_REL;
+	eh.e_machine = EM_X86_64;
+	if (gelf_update_ehdr(e, &eh) == 0)
+		errx(1, "gelf_update_ehdr: %s", elf_errmsg(-1));
+
+	/* The section name string table and the empty sections. */
+	for (i = 1; i < nscn - 1; i++) {
+		if ((scn = elf_newscn(e)) == NULL ||
+		    gelf_getshdr(scn, &sh) == NULL)
+			errx(1, "elf_newscn: %s", elf_errmsg(-1));
+		sh.sh_name = 1;
+		sh.sh_type = SHT_PROGBITS;
+		if (i == 1) {
+			if ((d = elf_newdata(scn)) == NULL)
+				errx(1, "elf_newdata: %s", elf_errmsg(-1));
+			d->d_buf = shstrtab;
+			d->d_size = sizeof(shstrtab);
+			sh.sh_type = SHT_STRTAB;
+		}
+		if (gelf_update_shdr(scn, &sh) == 0)
+			errx(1, "gelf_update_shdr: %s", elf_errmsg(-1));
+	}
+
+	if (elf_setshstrndx(e, 1) == 0)
+		errx(1, "elf_setshstrndx: %s", elf_errmsg(-1));
+
+	/* The symbol table, which uses the name string table. */
+	if ((scn = elf_newscn(e)) == NULL || (d = elf_newdata(scn)) == NULL ||
+	    gelf_getshdr(scn, &sh) == NULL)
+		errx(1, "elf_newscn: %s", elf_errmsg(-1));
+
+	sh.sh_type = SHT_SYMTAB;
+	sh.sh_link = 1;
+	sh.sh_entsize = gelf_fsize(e, ELF_T_SYM, 1, EV_CURRENT);
+	if (gelf_update_shdr(scn, &sh) == 0)
+		errx(1, "gelf_update_shdr: %s", elf_errmsg(-1));
+
+	d->d_type = ELF_T_SYM;
+	d->d_size = gelf_fsize(e, ELF_T_SYM, NSYMS, EV_CURRENT);
+	if ((symbuf = d->d_buf = calloc(1, d->d_size)) == NULL)
+		err(1, "calloc");
+	for (i = 1; i < NSYMS; i++) {
+		(void) memset(&sym, 0, sizeof(sym));
+		sym.st_value = i;
+		sym.st_shndx = (uint16_t) (i % SHN_LORESERVE);
+		if (gelf_update_sym(d, (int) i, &sym) == 0)
+			errx(1, "gelf_update_sym: %s", elf_errmsg(-1));
+	}
+
+	symndx = elf_ndxscn(scn);
+
+	if (elf_update(e, ELF_C_WRITE) < 0)
+		errx(1, "elf_update: %s", elf_errmsg(-1));
+
+	(void) elf_end(e);
+	free(symbuf);
+	(void) close(fd);
+}
+
+/*
+ * Open the object and read its symbol table, or with `all' set, visit
+ * the headers of all its sections.
+ */
+static void
+scan(const char *fn, int all)
+{
+	GElf_Shdr sh;
+	Elf_Data *d;
+	Elf_Scn *scn;
+	Elf *e;
+	size_t n;
+	int fd;
+
+	if ((fd = open(fn, O_RDONLY)) < 0)
+		err(1, "open \"%s\"", fn);
+	if ((e = elf_begin(fd, ELF_C_READ, NULL)) == NULL)
+		errx(1, "elf_begin: %s", elf_errmsg(-1));
+
+	if (elf_getshdrnum(e, &n) < 0 || n != nscn)
+		errx(1, "unexpected section count %zu", n);
+
+	if (all) {
+		for (scn = NULL, n = 0; (scn = elf_nextscn(e, scn)) != NULL;
+		     n++)
+			if (gelf_getshdr(scn, &sh) == NULL)
+				errx(1, "gelf_getshdr: %s", elf_errmsg(-1));
+		if (n != nscn - 1)
+			errx(1, "visited %zu sections", n);
+	} else {
+		if ((scn = elf_getscn(e, symndx)) == NULL ||
+		    gelf_getshdr(scn, &sh) == NULL ||
+		    sh.sh_type != SHT_SYMTAB ||
+		    (d = elf_getdata(scn, NULL)) == NULL)
+			errx(1, "symtab: %s", elf_errmsg(-1));
+	}
+
+	(void) elf_end(e);
+	(void) close(fd);
+}
+
+/*
+ * Run `reps' scans in a child process, returning the time per scan in
+ * milliseconds and the peak memory use of the child in KB.
+ */
+static void
+measure(const char *fn, int all, double *ms, long *kb)
+{
+	struct rusage ru;
+	double t;
+	pid_t pid;
+	int fds[2], r, status;
+
+	if (pipe(fds) < 0)
+		err(1, "pipe");
+
+	if ((pid = fork()) < 0)
+		err(1, "fork");
+
+	if (pid == 0) {
+		(void) close(fds[0]);
+		t = now();
+		for (r = 0; r < reps; r++)
+			scan(fn, all);
+		t = (now() - t) * 1e3 / reps;
+		if (write(fds[1], &t, sizeof(t)) != (ssize_t) sizeof(t))
+			err(1, "write");
+		_exit(0);
+	}
+
+	(void) close(fds[1]);
+	if (read(fds[0], ms, sizeof(*ms)) != (ssize_t) sizeof(*ms))
+		errx(1, "short read from child");
+	(void) close(fds[0]);
+
+	if (wait4(pid, &status, 0, &ru) < 0)
+		err(1, "wait4");
+	if (!WIFEXITED(status) || WEXITSTATUS(status) != 0)
+		errx(1, "child failed");
+
+	*kb = ru.ru_maxrss;
+}
+
+static void
+usage(void)
+{
+	(void) fprintf(stderr, "usage: extnum-bench [-n reps] [-s nsections]"
+	    "\n");
+	exit(1);
+}
+
+int
+main(int argc, char **argv)
+{
+	char fn[] = "/tmp/extnum-bench.XXXXXX";
+	double ms;
+	long kb;
+	int c, fd;
+
+	while ((c = getopt(argc, argv, "n:s:")) != -1) {
+		switch (c) {
+		case 'n':
+			if ((reps = atoi(optarg)) <= 0)
+				usage();
+			break;
+		case 's':
+			if ((nscn = (size_t) strtoul(optarg, NULL, 0)) < 3)
+				usage();
+			break;
+		default:
+			usage();
+		}
+	}
+
+	if (elf_version(EV_CURRENT) == EV_NONE)
+		errx(1, "elf_version: %s", elf_errmsg(-1));
+
+	if ((fd = mkstemp(fn)) < 0)
+		err(1, "mkstemp");
+	(void) close(fd);
+
+	create(fn);
+
+	(void) printf("%-16s %12s %12s\n", "operation", "ms", "maxrss-kb");
+	measure(fn, 0, &ms, &kb);
+	(void) printf("%-16s %12.3f %12ld\n", "read-symtab", ms, kb);
+	measure(fn, 1, &ms, &kb);
+	(void) printf("%-16s %12.3f %12ld\n", "visit-all", ms, kb);
+
+	(void) unlink(fn);
+	exit(0);
+}
@@ -0,0 +1,238 @@
+/*-
+ * Copyright (c) 2026, Elftoolchain Project Contributors.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE AUTHOR AND CONTRIBUTORS ``AS IS'' AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED.  IN NO EVENT SHALL THE AUTHOR OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS
+ * OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY
+ * OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+ * SUCH DAMAGE.
+ *
+ * $Id$
+ */
+
+/*
+ * Measure random access to the sections of an object with a large
+ * number of sections.
+ *
+ * An object with the requested number of small sections is created in
+ * a temporary file.  It is then opened, every section is fetched with
+ * elf_getscn(), and the checksum of the object is computed.
+ */
+
+#include <sys/types.h>
+
+#include <err.h>
+#include <fcntl.h>
+#include <gelf.h>
+#include <libelf.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+
+#define	DEFAULT_NSCN	500000
+#define	DEFAULT_REPS	5
+
+static size_t	nscn = DEFAULT_NSCN;
+static int	reps = DEFAULT_REPS;
+
+static double
+now(void)
+{
+	struct timespec ts;
+
+	if (clock_gettime(CLOCK_MONOTONIC, &ts) < 0)
+		err(1, "clock_gettime");
+
+	return ((double) ts.tv_sec + (double) ts.tv_nsec / 1e9);
+}
+
+/*
+ * Create the test object in file `fn'.  Each section holds a few bytes
+ * of data and has a name of its own.
+ *
+ * The object is written out directly rather than with elf_update(3),
+ * whose layout checks take time quadratic in the number of sections.
+ */
+static void
+create(const char *fn)
+{
+	static char payload[] = "0123456789abcdef";
+	Elf64_Ehdr eh;
+	Elf64_Shdr *sh;
+	char *strtab;
+	size_t i, len;
+	uint64_t off;
+	uint16_t one;
+	FILE *f;
+
+	if ((sh = calloc(nscn, sizeof(*sh))) == NULL ||
+	    (strtab = malloc(nscn * 24 + sizeof(".shstrtab") + 1)) == NULL)
+		err(1, "malloc");
+
+	/* Lay out the section contents after the ELF header. */
+	strtab[0] = '\0';
+	len = 1;
+	off = sizeof(eh);
+	for (i = 1; i < nscn - 1; i++) {
+		sh[i].sh_name = (Elf64_Word) len;
+		len += (size_t) sprintf(strtab + len, ".text.f%zu", i) + 1;
+		sh[i].sh_type = SHT_PROGBITS;
+		sh[i].sh_offset = off;
+		sh[i].sh_size = sizeof(payload);
+		sh[i].sh_addralign = 1;
+		off += sizeof(payload);
+	}
+	sh[i].sh_name = (Elf64_Word) len;
+	len += (size_t) sprintf(strtab + len, ".shstrtab") + 1;
+	sh[i].sh_type = SHT_STRTAB;
+	sh[i].sh_offset = off;
+	sh[i].sh_size = len;
+	sh[i].sh_addralign = 1;
+	off = (off + len + 7) & ~(uint64_t) 7;
+
+	(void) memset(&eh, 0, sizeof(eh));
+	one = 1;
+	eh.e_ident[EI_MAG0] = ELFMAG0;
+	eh.e_ident[EI_MAG1] = ELFMAG1;
+	eh.e_ident[EI_MAG2] = ELFMAG2;
+	eh.e_ident[EI_MAG3] = ELFMAG3;
+	eh.e_ident[EI_CLASS] = ELFCLASS64;
+	eh.e_ident[EI_DATA] = *(uint8_t *) &one ? ELFDATA2LSB : ELFDATA2MSB;
+	eh.e_ident[EI_VERSION] = EV_CURRENT;
+	eh.e_type = ET_REL;
+	eh.e_machine = EM_X86_64;
+	eh.e_version = EV_CURRENT;
+	eh.e_shoff = off;
+	eh.e_ehsize = sizeof(eh);
+	eh.e_shentsize = sizeof(*sh);
+
+	/* Use extended section numbering when needed. */
+	if (nscn >= SHN_LORESERVE) {
+		sh[0].sh_size = nscn;
+		sh[0].sh_link = (Elf64_Word) (nscn - 1);
+		eh.e_shstrndx = SHN_XINDEX;
+	} else {
+		eh.e_shnum = (Elf64_Half) nscn;
+		eh.e_shstrndx = (Elf64_Half) (nscn - 1);
+	}
+
+	if ((f = fopen(fn, "w")) == NULL)
+		err(1, "fopen \"%s\"", fn);
+	if (fwrite(&eh, sizeof(eh), 1, f) != 1)
+		err(1, "fwrite");
+	for (i = 1; i < nscn - 1; i++)
+		if (fwrite(payload, sizeof(payload), 1, f) != 1)
+			err(1, "fwrite");
+	if (fwrite(strtab, len, 1, f) != 1 ||
+	    fseeko(f, (off_t) off, SEEK_SET) < 0 ||
+	    fwrite(sh, sizeof(*sh), nscn, f) != nscn ||
+	    fclose(f) != 0)
+		err(1, "fwrite");
+
+	free(strtab);
+	free(sh);
+}
+
+/*
+ * Return the time in milliseconds taken by `reps' passes of `op' over
+ * the object in file `fn'.
+ */
+static double
+measure(const char *fn, int op)
+{
+	Elf_Scn *scn;
+	Elf *e;
+	double t;
+	size_t i;
+	int fd, r;
+
+	if ((fd = open(fn, O_RDONLY)) < 0)
+		err(1, "open \"%s\"", fn);
+	if ((e = elf_begin(fd, ELF_C_READ, NULL)) == NULL)
+		errx(1, "elf_begin: %s", elf_errmsg(-1));
+
+	(void) elf_errno();
+
+	t = now();
+	for (r = 0; r < reps; r++) {
+		if (op == 0) {
+			for (i = 1; i < nscn; i++)
+				if ((scn = elf_getscn(e, i)) == NULL ||
+				    elf_ndxscn(scn) != i)
+					errx(1, "elf_getscn: %s",
+					    elf_errmsg(-1));
+		} else if (gelf_checksum(e) == 0 && elf_errno() != 0)
+			errx(1, "gelf_checksum: %s", elf_errmsg(-1));
+	}
+	t = (now() - t) * 1e3 / reps;
+
+	(void) elf_end(e);
+	(void) close(fd);
+
+	return (t);
+}
+
+static void
+usage(void)
+{
+	(void) fprintf(stderr, "usage: getscn-bench [-n reps] [-s nsections]"
+	    "\n");
+	exit(1);
+}
+
+int
+main(int argc, char **argv)
+{
+	char fn[] = "/tmp/getscn-bench.XXXXXX";
+	int c, fd;
+
+	while ((c = getopt(argc, argv, "n:s:")) != -1) {
+		switch (c) {
+		case 'n':
+			if ((reps = atoi(optarg)) <= 0)
+				usage();
+			break;
+		case 's':
+			if ((nscn = (size_t) strtoul(optarg, NULL, 0)) < 2)
+				usage();
+			break;
+		default:
+			usage();
+		}
+	}
+
+	if (elf_version(EV_CURRENT) == EV_NONE)
+		errx(1, "elf_version: %s", elf_errmsg(-1));
+
+	if ((fd = mkstemp(fn)) < 0)
+		err(1, "mkstemp");
+	(void) close(fd);
+
+	create(fn);
+
+	(void) printf("%-16s %12s\n", "operation", "ms");
+	(void) printf("%-16s %12.3f\n", "getscn-all", measure(fn, 0));
+	(void) printf("%-16s %12.3f\n", "checksum", measure(fn, 1));
+
+	(void) unlink(fn);
+	exit(0);
+}
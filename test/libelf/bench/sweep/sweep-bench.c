@@ -0,0 +1,742 @@
+/*-
+ * Copyright (c) 2026, Elftoolchain Project Contributors.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE AUTHOR AND CONTRIBUTORS ``AS IS'' AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED.  IN NO EVENT SHALL THE AUTHOR OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS
+ * OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY
+ * OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+ * SUCH DAMAGE.
+ *
+ * $Id$
+ */
+
+/*
+ * Measure the read and write paths of the library over a sweep of
+ * synthetic inputs.
+ *
+ * For every combination of ELF class, byte order, section count and
+ * symbol count, an object is created and then opened, read and
+ * rewritten.  Archives with varying numbers of members are created
+ * and iterated over in the same way.  Each measurement runs in a child
+ * process, so that its peak memory use can be reported along with its
+ * throughput.  The results are written out as CSV or JSON.
+ *
+ * Only APIs common to the libelf implementations are used, so that
+ * the results may be compared against another libelf linked in its
+ * place.  With the -d option the generated inputs are kept, for use
+ * by other tools.
+ */
+
+#include <sys/types.h>
+#include <sys/resource.h>
+#include <sys/stat.h>
+#include <sys/time.h>
+#include <sys/wait.h>
+
+#include <err.h>
+#include <fcntl.h>
+#include <gelf.h>
+#include <libelf.h>
+#include <limits.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+
+#define	DEFAULT_REPS	5
+#define	MAXLIST		16
+#define	SECSIZE		256	/* Size of each payload section. */
+#define	MEMBER_NSCN	8	/* Sections in each archive member. */
+#define	MEMBER_NSYMS	64	/* Symbols in each archive member. */
+
+struct config {
+	int		c_class;
+	int		c_order;
+	size_t		c_nscn;		/* Payload sections. */
+	size_t		c_nsyms;
+	size_t		c_nmembers;	/* Archive members, or 0. */
+	char		c_path[PATH_MAX];
+};
+
+struct result {
+	double		r_secs;
+	uint64_t	r_ops;
+	uint64_t	r_bytes;
+	long		r_maxrss;	/* In KB. */
+};
+
+struct bench {
+	const char	*b_name;
+	void		(*b_fn)(const struct config *, struct result *);
+	int		b_archive;
+};
+
+static int	reps = DEFAULT_REPS;
+static int	json;
+static FILE	*out;
+static int	nresults;
+
+static size_t	sections[MAXLIST] = { 16, 1024, 16384 };
+static size_t	nsections = 3;
+static size_t	symbols[MAXLIST] = { 1000, 100000 };
+static size_t	nsymbols = 2;
+static size_t	members[MAXLIST] = { 16, 256, 4096 };
+static size_t	nmembers = 3;
+
+static double
+now(void)
+{
+	struct timespec ts;
+
+	if (clock_gettime(CLOCK_MONOTONIC, &ts) < 0)
+		err(1, "clock_gettime");
+
+	return ((double) ts.tv_sec + (double) ts.tv_nsec / 1e9);
+}
+
+static off_t
+filesize(const char *fn)
+{
+	struct stat sb;
+
+	if (stat(fn, &sb) < 0)
+		err(1, "stat \"%s\"", fn);
+
+	return (sb.st_size);
+}
+
+static Elf_Scn *
+newscn(Elf *e, GElf_Shdr *sh, uint32_t name, uint32_t type)
+{
+	Elf_Scn *scn;
+
+	if ((scn = elf_newscn(e)) == NULL || gelf_getshdr(scn, sh) == NULL)
+		errx(1, "elf_newscn: %s", elf_errmsg(-1));
+
+	sh->sh_name = name;
+	sh->sh_type = type;
+
+	return (scn);
+}
+
+static Elf_Data *
+newdata(Elf_Scn *scn, void *buf, size_t sz, Elf_Type type)
+{
+	Elf_Data *d;
+
+	if ((d = elf_newdata(scn)) == NULL)
+		errx(1, "elf_newdata: %s", elf_errmsg(-1));
+
+	d->d_buf = buf;
+	d->d_size = sz;
+	d->d_type = type;
+
+	return (d);
+}
+
+/*
+ * Create a relocatable object in file `fn' with `nscn' payload
+ * sections, alternately of type SHT_PROGBITS and SHT_RELA, followed
+ * by a string table, a symbol table with `nsyms' entries and the
+ * section name string table.  The symbol table is thus at index
+ * `nscn' + 2.
+ */
+static void
+create(const char *fn, int ec, int ed, size_t nscn, size_t nsyms)
+{
+	GElf_Ehdr eh;
+	GElf_Shdr sh;
+	GElf_Sym sym;
+	Elf_Data *d;
+	Elf_Scn *scn;
+	Elf *e;
+	char *shstrtab, *strtab;
+	void *payload, *symbuf;
+	size_t i, relsz, shoff, shstrndx, stoff, strndx;
+	int fd;
+
+	if ((fd = open(fn, O_RDWR | O_CREAT | O_TRUNC, 0644)) < 0)
+		err(1, "open \"%s\"", fn);
+
+	if ((e = elf_begin(fd, ELF_C_WRITE, NULL)) == NULL ||
+	    gelf_newehdr(e, ec) == NULL ||
+	    gelf_getehdr(e, &eh) == NULL)
+		errx(1, "elf_begin: %s", elf_errmsg(-1));
+
+	eh.e_ident[EI_DATA] = (unsigned char) ed;
+	eh.e_type = ET_REL;
+	eh.e_machine = ec == ELFCLASS32 ? EM_386 : EM_X86_64;
+
+	if ((shstrtab = malloc(nscn * 16 + 32)) == NULL ||
+	    (strtab = malloc(nsyms * 16 + 1)) == NULL ||
+	    (payload = calloc(1, SECSIZE)) == NULL)
+		err(1, "malloc");
+
+	shoff = 0;
+	shstrtab[shoff++] = '\0';
+
+	/* The payload sections share a single buffer. */
+	relsz = gelf_fsize(e, ELF_T_RELA, SECSIZE / gelf_fsize(e, ELF_T_RELA,
+	    1, EV_CURRENT), EV_CURRENT);
+	for (i = 0; i < nscn; i++) {
+		scn = newscn(e, &sh, (uint32_t) shoff,
+		    i % 2 ? SHT_RELA : SHT_PROGBITS);
+		shoff += (size_t) sprintf(shstrtab + shoff, ".p%zu", i) + 1;
+		if (sh.sh_type == SHT_RELA) {
+			sh.sh_link = (uint32_t) (nscn + 2);
+			sh.sh_info = (uint32_t) i;
+			sh.sh_entsize = gelf_fsize(e, ELF_T_RELA, 1,
+			    EV_CURRENT);
+			(void) newdata(scn, payload, relsz, ELF_T_RELA);
+		} else
+			(void) newdata(scn, payload, SECSIZE, ELF_T_BYTE);
+		if (gelf_update_shdr(scn, &sh) == 0)
+			errx(1, "gelf_update_shdr: %s", elf_errmsg(-1));
+	}
+
+	/* The string table and the symbol table. */
+	scn = newscn(e, &sh, (uint32_t) shoff, SHT_STRTAB);
+	shoff += (size_t) sprintf(shstrtab + shoff, ".strtab") + 1;
+	strndx = elf_ndxscn(scn);
+	d = newdata(scn, strtab, 0, ELF_T_BYTE);
+	if (gelf_update_shdr(scn, &sh) == 0)
+		errx(1, "gelf_update_shdr: %s", elf_errmsg(-1));
+
+	stoff = 0;
+	strtab[stoff++] = '\0';
+
+	scn = newscn(e, &sh, (uint32_t) shoff, SHT_SYMTAB);
+	shoff += (size_t) sprintf(shstrtab + shoff, ".symtab") + 1;
+	sh.sh_link = (uint32_t) strndx;
+	sh.sh_info = 1;
+	sh.sh_entsize = gelf_fsize(e, ELF_T_SYM, 1, EV_CURRENT);
+	if (gelf_update_shdr(scn, &sh) == 0)
+		errx(1, "gelf_update_shdr: %s", elf_errmsg(-1));
+
+	if ((symbuf = calloc(nsyms, sh.sh_entsize)) == NULL)
+		err(1, "calloc");
+	d = newdata(scn, symbuf, nsyms * sh.sh_entsize, ELF_T_SYM);
+	for (i = 1; i < nsyms; i++) {
+		(void) memset(&sym, 0, sizeof(sym));
+		sym.st_name = (uint32_t) stoff;
+		sym.st_info = GELF_ST_INFO(STB_GLOBAL, STT_FUNC);
+		sym.st_shndx = (uint16_t) (1 + i % (nscn < SHN_LORESERVE - 1 ?
+		    nscn : SHN_LORESERVE - 1));
+		sym.st_value = i * 16;
+		sym.st_size = 16;
+		if (gelf_update_sym(d, (int) i, &sym) == 0)
+			errx(1, "gelf_update_sym: %s", elf_errmsg(-1));
+		stoff += (size_t) sprintf(strtab + stoff, "sym%zu", i) + 1;
+	}
+	d = elf_getdata(elf_getscn(e, strndx), NULL);
+	d->d_size = stoff;
+
+	/* The section name string table. */
+	scn = newscn(e, &sh, (uint32_t) shoff, SHT_STRTAB);
+	shoff += (size_t) sprintf(shstrtab + shoff, ".shstrtab") + 1;
+	(void) newdata(scn, shstrtab, shoff, ELF_T_BYTE);
+	if (gelf_update_shdr(scn, &sh) == 0)
+		errx(1, "gelf_update_shdr: %s", elf_errmsg(-1));
+
+	/*
+	 * Record the index of the section name string table, using
+	 * extended section numbering if needed.
+	 */
+	shstrndx = elf_ndxscn(scn);
+	if (shstrndx >= SHN_LORESERVE) {
+		if ((scn = elf_getscn(e, 0)) == NULL ||
+		    gelf_getshdr(scn, &sh) == NULL)
+			errx(1, "elf_getscn: %s", elf_errmsg(-1));
+		sh.sh_link = (uint32_t) shstrndx;
+		if (gelf_update_shdr(scn, &sh) == 0)
+			errx(1, "gelf_update_shdr: %s", elf_errmsg(-1));
+		shstrndx = SHN_XINDEX;
+	}
+	eh.e_shstrndx = (uint16_t) shstrndx;
+	if (gelf_update_ehdr(e, &eh) == 0)
+		errx(1, "gelf_update_ehdr: %s", elf_errmsg(-1));
+
+	if (elf_update(e, ELF_C_WRITE) < 0)
+		errx(1, "elf_update: %s", elf_errmsg(-1));
+
+	(void) elf_end(e);
+	(void) close(fd);
+
+	free(payload);
+	free(shstrtab);
+	free(strtab);
+	free(symbuf);
+}
+
+/*
+ * Create an ar(1) archive in file `fn' holding `n' copies of a small
+ * object.
+ */
+static void
+create_archive(const char *fn, int ec, int ed, size_t n)
+{
+	char hdr[61], name[32], tmp[PATH_MAX];
+	size_t i, sz;
+	char *buf;
+	FILE *f;
+	int fd;
+
+	(void) snprintf(tmp, sizeof(tmp), "%s.member", fn);
+	create(tmp, ec, ed, MEMBER_NSCN, MEMBER_NSYMS);
+
+	sz = (size_t) filesize(tmp);
+	if ((buf = malloc(sz + 1)) == NULL)
+		err(1, "malloc");
+	if ((fd = open(tmp, O_RDONLY)) < 0 ||
+	    read(fd, buf, sz) != (ssize_t) sz)
+		err(1, "read \"%s\"", tmp);
+	(void) close(fd);
+	(void) unlink(tmp);
+	buf[sz] = '\n';		/* Padding to an even offset. */
+
+	if ((f = fopen(fn, "w")) == NULL)
+		err(1, "fopen \"%s\"", fn);
+
+	(void) fputs("!<arch>\n", f);
+	for (i = 0; i < n; i++) {
+		(void) snprintf(name, sizeof(name), "m%zu.o/", i);
+		(void) snprintf(hdr, sizeof(hdr),
+		    "%-16.16s%-12d%-6d%-6d%-8o%-10zu`\n", name, 0, 0, 0, 0644,
+		    sz);
+		if (fwrite(hdr, 60, 1, f) != 1 ||
+		    fwrite(buf, sz + (sz & 1), 1, f) != 1)
+			err(1, "fwrite \"%s\"", fn);
+	}
+
+	if (fclose(f) != 0)
+		err(1, "fclose \"%s\"", fn);
+	free(buf);
+}
+
+static Elf *
+open_elf(const char *fn, Elf_Cmd cmd, int *fd)
+{
+	Elf *e;
+
+	if ((*fd = open(fn, cmd == ELF_C_READ ? O_RDONLY : O_RDWR)) < 0)
+		err(1, "open \"%s\"", fn);
+	if ((e = elf_begin(*fd, cmd, NULL)) == NULL)
+		errx(1, "elf_begin: %s", elf_errmsg(-1));
+
+	return (e);
+}
+
+static void
+close_elf(Elf *e, int fd)
+{
+	(void) elf_end(e);
+	(void) close(fd);
+}
+
+/*
+ * The benchmarks.  Each runs `reps' iterations and records the number
+ * of operations performed and the number of bytes processed.
+ */
+
+/* Create the object from scratch with elf_update(ELF_C_WRITE). */
+static void
+bench_write(const struct config *c, struct result *r)
+{
+	int i;
+
+	for (i = 0; i < reps; i++) {
+		create(c->c_path, c->c_class, c->c_order, c->c_nscn,
+		    c->c_nsyms);
+		r->r_bytes += (uint64_t) filesize(c->c_path);
+		r->r_ops++;
+	}
+}
+
+/* Open the object and visit all section headers. */
+static void
+bench_begin(const struct config *c, struct result *r)
+{
+	GElf_Shdr sh;
+	Elf_Scn *scn;
+	Elf *e;
+	size_t n;
+	int fd, i;
+
+	for (i = 0; i < reps; i++) {
+		e = open_elf(c->c_path, ELF_C_READ, &fd);
+		if (elf_getshdrnum(e, &n) < 0 || n != c->c_nscn + 4)
+			errx(1, "unexpected section count %zu", n);
+		for (scn = NULL; (scn = elf_nextscn(e, scn)) != NULL; )
+			if (gelf_getshdr(scn, &sh) == NULL)
+				errx(1, "gelf_getshdr: %s", elf_errmsg(-1));
+		close_elf(e, fd);
+		r->r_bytes += (uint64_t) filesize(c->c_path);
+		r->r_ops++;
+	}
+}
+
+/* Retrieve the data for every section. */
+static void
+bench_getdata(const struct config *c, struct result *r)
+{
+	Elf_Data *d;
+	Elf_Scn *scn;
+	Elf *e;
+	int fd, i;
+
+	for (i = 0; i < reps; i++) {
+		e = open_elf(c->c_path, ELF_C_READ, &fd);
+		for (scn = NULL; (scn = elf_nextscn(e, scn)) != NULL; ) {
+			if ((d = elf_getdata(scn, NULL)) == NULL)
+				errx(1, "elf_getdata: %s", elf_errmsg(-1));
+			r->r_bytes += d->d_size;
+			r->r_ops++;
+		}
+		close_elf(e, fd);
+	}
+}
+
+/* Retrieve every entry of the symbol table. */
+static void
+bench_getsym(const struct config *c, struct result *r)
+{
+	GElf_Sym sym;
+	Elf_Data *d;
+	Elf_Scn *scn;
+	Elf *e;
+	size_t n;
+	int fd, i;
+
+	for (i = 0; i < reps; i++) {
+		e = open_elf(c->c_path, ELF_C_READ, &fd);
+		if ((scn = elf_getscn(e, c->c_nscn + 2)) == NULL ||
+		    (d = elf_getdata(scn, NULL)) == NULL)
+			errx(1, "symtab: %s", elf_errmsg(-1));
+		for (n = 0; n < c->c_nsyms; n++)
+			if (gelf_getsym(d, (int) n, &sym) == NULL)
+				errx(1, "gelf_getsym: %s", elf_errmsg(-1));
+		r->r_bytes += d->d_size;
+		r->r_ops += c->c_nsyms;
+		close_elf(e, fd);
+	}
+}
+
+/* Open the object for update and write it back out. */
+static void
+bench_update(const struct config *c, struct result *r)
+{
+	Elf *e;
+	int fd, i;
+
+	for (i = 0; i < reps; i++) {
+		e = open_elf(c->c_path, ELF_C_RDWR, &fd);
+		(void) elf_flagelf(e, ELF_C_SET, ELF_F_DIRTY);
+		if (elf_update(e, ELF_C_WRITE) < 0)
+			errx(1, "elf_update: %s", elf_errmsg(-1));
+		close_elf(e, fd);
+		r->r_bytes += (uint64_t) filesize(c->c_path);
+		r->r_ops++;
+	}
+}
+
+/* Iterate over the members of an archive. */
+static void
+bench_archive(const struct config *c, struct result *r)
+{
+	Elf_Arhdr *arh;
+	Elf_Cmd cmd;
+	Elf *ar, *e;
+	size_t n;
+	int fd, i;
+
+	for (i = 0; i < reps; i++) {
+		ar = open_elf(c->c_path, ELF_C_READ, &fd);
+		cmd = ELF_C_READ;
+		for (n = 0; (e = elf_begin(fd, cmd, ar)) != NULL; n++) {
+			if ((arh = elf_getarhdr(e)) == NULL ||
+			    elf_kind(e) != ELF_K_ELF ||
+			    gelf_getclass(e) != c->c_class)
+				errx(1, "member %zu: %s", n, elf_errmsg(-1));
+			cmd = elf_next(e);
+			(void) elf_end(e);
+		}
+		if (n != c->c_nmembers)
+			errx(1, "unexpected member count %zu", n);
+		close_elf(ar, fd);
+		r->r_bytes += (uint64_t) filesize(c->c_path);
+		r->r_ops += n;
+	}
+}
+
+static struct bench benches[] = {
+	{ "write",	bench_write,	0 },
+	{ "begin",	bench_begin,	0 },
+	{ "getdata",	bench_getdata,	0 },
+	{ "getsym",	bench_getsym,	0 },
+	{ "update",	bench_update,	0 },
+	{ "archive",	bench_archive,	1 }
+};
+
+#define	NBENCHES	(sizeof(benches) / sizeof(benches[0]))
+
+/*
+ * Run `fn' in a child process, collecting its results and peak memory
+ * use.
+ */
+static void
+measure(void (*fn)(const struct config *, struct result *),
+    const struct config *c, struct result *r)
+{
+	struct rusage ru;
+	pid_t pid;
+	double t;
+	int fds[2], status;
+
+	if (pipe(fds) < 0)
+		err(1, "pipe");
+
+	if ((pid = fork()) < 0)
+		err(1, "fork");
+
+	if (pid == 0) {
+		(void) close(fds[0]);
+		(void) memset(r, 0, sizeof(*r));
+		t = now();
+		(*fn)(c, r);
+		r->r_secs = now() - t;
+		if (write(fds[1], r, sizeof(*r)) != (ssize_t) sizeof(*r))
+			err(1, "write");
+		_exit(0);
+	}
+
+	(void) close(fds[1]);
+	if (read(fds[0], r, sizeof(*r)) != (ssize_t) sizeof(*r))
+		errx(1, "short read from child");
+	(void) close(fds[0]);
+
+	if (wait4(pid, &status, 0, &ru) < 0)
+		err(1, "wait4");
+	if (!WIFEXITED(status) || WEXITSTATUS(status) != 0)
+		errx(1, "child failed");
+
+	r->r_maxrss = ru.ru_maxrss;
+}
+
+static void
+report(const struct bench *b, const struct config *c,
+    const struct result *r)
+{
+	const char *fmt;
+
+	if (json)
+		fmt = "%s  {\"bench\": \"%s\", \"class\": %d, "
+		    "\"order\": \"%s\", \"sections\": %zu, \"symbols\": %zu, "
+		    "\"members\": %zu, \"reps\": %d, \"seconds\": %.6f, "
+		    "\"ops_per_sec\": %.1f, \"mb_per_sec\": %.2f, "
+		    "\"maxrss_kb\": %ld}";
+	else
+		fmt = "%s%s,%d,%s,%zu,%zu,%zu,%d,%.6f,%.1f,%.2f,%ld\n";
+
+	(void) fprintf(out, fmt, json ? (nresults ? ",\n" : "") : "",
+	    b->b_name, c->c_class == ELFCLASS32 ? 32 : 64,
+	    c->c_order == ELFDATA2LSB ? "lsb" : "msb",
+	    b->b_archive ? (size_t) MEMBER_NSCN : c->c_nscn,
+	    b->b_archive ? (size_t) MEMBER_NSYMS : c->c_nsyms,
+	    c->c_nmembers, reps, r->r_secs, (double) r->r_ops / r->r_secs,
+	    (double) r->r_bytes / r->r_secs / 1e6, r->r_maxrss);
+	(void) fflush(out);
+
+	nresults++;
+}
+
+static void
+generate_archive(const struct config *c, struct result *r)
+{
+	(void) r;
+
+	create_archive(c->c_path, c->c_class, c->c_order, c->c_nmembers);
+}
+
+/*
+ * Run the benchmarks on the input described by `c'.  Objects are
+ * created by the first benchmark, archives in a separate child process,
+ * so that the memory used to generate the input is not counted
+ * against the later measurements.
+ */
+static void
+sweep(struct config *c, const char *dir, int keep)
+{
+	struct result r;
+	size_t i;
+
+	if (c->c_nmembers > 0)
+		(void) snprintf(c->c_path, sizeof(c->c_path),
+		    "%s/ar-%d%s-%zu.a", dir, c->c_class == ELFCLASS32 ? 32 : 64,
+		    c->c_order == ELFDATA2LSB ? "lsb" : "msb", c->c_nmembers);
+	else
+		(void) snprintf(c->c_path, sizeof(c->c_path),
+		    "%s/obj-%d%s-%zu-%zu.o", dir,
+		    c->c_class == ELFCLASS32 ? 32 : 64,
+		    c->c_order == ELFDATA2LSB ? "lsb" : "msb", c->c_nscn,
+		    c->c_nsyms);
+
+	if (c->c_nmembers > 0)
+		measure(generate_archive, c, &r);
+
+	for (i = 0; i < NBENCHES; i++) {
+		if (benches[i].b_archive != (c->c_nmembers > 0))
+			continue;
+		measure(benches[i].b_fn, c, &r);
+		report(&benches[i], c, &r);
+	}
+
+	if (!keep)
+		(void) unlink(c->c_path);
+}
+
+/*
+ * Parse a comma-separated list of counts.
+ */
+static size_t
+parse_list(const char *s, size_t *list, size_t min)
+{
+	char *end;
+	size_t n;
+
+	for (n = 0; n < MAXLIST; n++) {
+		list[n] = (size_t) strtoul(s, &end, 0);
+		if (end == s || list[n] < min)
+			return (0);
+		if (*end == '\0')
+			return (n + 1);
+		if (*end != ',')
+			return (0);
+		s = end + 1;
+	}
+
+	return (0);
+}
+
+static void
+usage(void)
+{
+	(void) fprintf(stderr, "usage: sweep-bench [-a members] [-d dir] "
+	    "[-f csv|json] [-n reps] [-o file]\n"
+	    "\t[-s sections] [-y symbols]\n");
+	exit(1);
+}
+
+int
+main(int argc, char **argv)
+{
+	static const int classes[] = { ELFCLASS32, ELFCLASS64 };
+	static const int orders[] = { ELFDATA2LSB, ELFDATA2MSB };
+	struct config c;
+	char tmpdir[PATH_MAX];
+	const char *dir;
+	size_t i, j, k, l;
+	int ch;
+
+	dir = NULL;
+	out = stdout;
+
+	while ((ch = getopt(argc, argv, "a:d:f:n:o:s:y:")) != -1) {
+		switch (ch) {
+		case 'a':
+			if ((nmembers = parse_list(optarg, members, 0)) == 0)
+				usage();
+			break;
+		case 'd':
+			dir = optarg;
+			break;
+		case 'f':
+			if (strcmp(optarg, "json") == 0)
+				json = 1;
+			else if (strcmp(optarg, "csv") != 0)
+				usage();
+			break;
+		case 'n':
+			if ((reps = atoi(optarg)) <= 0)
+				usage();
+			break;
+		case 'o':
+			if ((out = fopen(optarg, "w")) == NULL)
+				err(1, "fopen \"%s\"", optarg);
+			break;
+		case 's':
+			if ((nsections = parse_list(optarg, sections, 1)) == 0)
+				usage();
+			break;
+		case 'y':
+			if ((nsymbols = parse_list(optarg, symbols, 1)) == 0)
+				usage();
+			break;
+		default:
+			usage();
+		}
+	}
+
+	if (elf_version(EV_CURRENT) == EV_NONE)
+		errx(1, "elf_version: %s", elf_errmsg(-1));
+
+	if (dir == NULL) {
+		(void) snprintf(tmpdir, sizeof(tmpdir), "%s/sweep-bench.XXXXXX",
+		    getenv("TMPDIR") ? getenv("TMPDIR") : "/tmp");
+		if (mkdtemp(tmpdir) == NULL)
+			err(1, "mkdtemp");
+	}
+
+	if (json)
+		(void) fprintf(out, "[\n");
+	else
+		(void) fprintf(out, "bench,class,order,sections,symbols,"
+		    "members,reps,seconds,ops_per_sec,mb_per_sec,maxrss_kb\n");
+
+	(void) memset(&c, 0, sizeof(c));
+	for (i = 0; i < 2; i++) {
+		c.c_class = classes[i];
+		for (j = 0; j < 2; j++) {
+			c.c_order = orders[j];
+			c.c_nmembers = 0;
+			for (k = 0; k < nsections; k++) {
+				c.c_nscn = sections[k];
+				for (l = 0; l < nsymbols; l++) {
+					c.c_nsyms = symbols[l];
+					sweep(&c, dir ? dir : tmpdir,
+					    dir != NULL);
+				}
+			}
+			for (k = 0; k < nmembers; k++) {
+				if ((c.c_nmembers = members[k]) > 0)
+					sweep(&c, dir ? dir : tmpdir,
+					    dir != NULL);
+			}
+		}
+	}
+
+	if (json)
+		(void) fprintf(out, "\n]\n");
+
+	if (dir == NULL)
+		(void) rmdir(tmpdir);
+
+	exit(0);
+}
@@ -0,0 +1,267 @@
+/*-
+ * Copyright (c) 2026, Elftoolchain Project Contributors.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE AUTHOR AND CONTRIBUTORS ``AS IS'' AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED.  IN NO EVENT SHALL THE AUTHOR OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS
+ * OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY
+ * OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+ * SUCH DAMAGE.
+ *
+ * $Id$
+ */
+
+/*
+ * Measure the throughput of the byte swapping translators.
+ *
+ * Each ELF type is translated to and from the non-native byte order.
+ * The scalar and vector converters are compared by running the
+ * measurements twice in child processes, once with the LIBELF_NOSIMD
+ * environment variable set.
+ */
+
+#include <sys/types.h>
+#include <sys/wait.h>
+
+#include <err.h>
+#include <libelf.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+#include <unistd.h>
+
+static struct xlate_type {
+	const char	*xt_name;
+	Elf_Type	xt_type;
+	int		xt_class;
+} xlate_types[] = {
+	{ "HALF",	ELF_T_HALF,	ELFCLASS64 },
+	{ "WORD",	ELF_T_WORD,	ELFCLASS64 },
+	{ "XWORD",	ELF_T_XWORD,	ELFCLASS64 },
+	{ "ADDR32",	ELF_T_ADDR,	ELFCLASS32 },
+	{ "ADDR64",	ELF_T_ADDR,	ELFCLASS64 },
+	{ "DYN32",	ELF_T_DYN,	ELFCLASS32 },
+	{ "DYN64",	ELF_T_DYN,	ELFCLASS64 },
+	{ "PHDR32",	ELF_T_PHDR,	ELFCLASS32 },
+	{ "PHDR64",	ELF_T_PHDR,	ELFCLASS64 },
+	{ "REL32",	ELF_T_REL,	ELFCLASS32 },
+	{ "REL64",	ELF_T_REL,	ELFCLASS64 },
+	{ "RELA32",	ELF_T_RELA,	ELFCLASS32 },
+	{ "RELA64",	ELF_T_RELA,	ELFCLASS64 },
+	{ "SHDR32",	ELF_T_SHDR,	ELFCLASS32 },
+	{ "SHDR64",	ELF_T_SHDR,	ELFCLASS64 },
+	{ "SYM32",	ELF_T_SYM,	ELFCLASS32 },
+	{ "SYM64",	ELF_T_SYM,	ELFCLASS64 }
+};
+
+#define	NTYPES		(sizeof(xlate_types) / sizeof(xlate_types[0]))
+
+#define	DEFAULT_SIZE	(16 * 1024 * 1024)
+#define	DEFAULT_REPS	20
+
+static size_t	bufsize = DEFAULT_SIZE;
+static int	reps = DEFAULT_REPS;
+static unsigned int swapped_order;
+
+static double
+now(void)
+{
+	struct timespec ts;
+
+	if (clock_gettime(CLOCK_MONOTONIC, &ts) < 0)
+		err(1, "clock_gettime");
+
+	return ((double) ts.tv_sec + (double) ts.tv_nsec / 1e9);
+}
+
+static Elf_Data *
+xlate(const struct xlate_type *xt, Elf_Data *dst, Elf_Data *src,
+    int tofile)
+{
+	if (xt->xt_class == ELFCLASS32)
+		return (tofile ? elf32_xlatetof(dst, src, swapped_order) :
+		    elf32_xlatetom(dst, src, swapped_order));
+	else
+		return (tofile ? elf64_xlatetof(dst, src, swapped_order) :
+		    elf64_xlatetom(dst, src, swapped_order));
+}
+
+/*
+ * Return the throughput in MB/s of translating a buffer of type `xt'
+ * in the direction specified by `tofile'.
+ */
+static double
+measure(const struct xlate_type *xt, unsigned char *mem,
+    unsigned char *file, int tofile)
+{
+	Elf_Data dst, src;
+	double t0, t1;
+	size_t fsz, msz;
+	int r;
+
+	fsz = xt->xt_class == ELFCLASS32 ?
+	    elf32_fsize(xt->xt_type, 1, EV_CURRENT) :
+	    elf64_fsize(xt->xt_type, 1, EV_CURRENT);
+	fsz = (bufsize / fsz) * fsz;
+
+	/* Prepare the memory representation of the file data. */
+	src.d_buf = file;
+	src.d_size = fsz;
+	src.d_type = xt->xt_type;
+	src.d_version = EV_CURRENT;
+	dst.d_buf = mem;
+	dst.d_size = bufsize;
+	dst.d_version = EV_CURRENT;
+	if (xlate(xt, &dst, &src, 0) == NULL)
+		errx(1, "%s: elf_xlatetom: %s", xt->xt_name, elf_errmsg(-1));
+	msz = dst.d_size;
+
+	t0 = now();
+	for (r = 0; r < reps; r++) {
+		src.d_buf = tofile ? mem : file;
+		src.d_size = tofile ? msz : fsz;
+		src.d_type = xt->xt_type;
+		dst.d_buf = tofile ? file : mem;
+		dst.d_size = bufsize;
+		if (xlate(xt, &dst, &src, tofile) == NULL)
+			errx(1, "%s: %s: %s", xt->xt_name,
+			    tofile ? "elf_xlatetof" : "elf_xlatetom",
+			    elf_errmsg(-1));
+	}
+	t1 = now();
+
+	return ((double) fsz * reps / (t1 - t0) / 1e6);
+}
+
+/*
+ * Run the measurements, writing the results to file descriptor `fd'.
+ */
+static void
+run(int fd, int scalar)
+{
+	unsigned char *file, *mem;
+	double mbs[2];
+	size_t i;
+
+	if (scalar && setenv("LIBELF_NOSIMD", "1", 1) < 0)
+		err(1, "setenv");
+
+	if ((file = malloc(bufsize)) == NULL ||
+	    (mem = malloc(bufsize)) == NULL)
+		err(1, "malloc");
+
+	for (i = 0; i < bufsize; i++)
+		file[i] = (unsigned char) (i * 131 + 7);
+
+	for (i = 0; i < NTYPES; i++) {
+		mbs[0] = measure(&xlate_types[i], mem, file, 0);
+		mbs[1] = measure(&xlate_types[i], mem, file, 1);
+		if (write(fd, mbs, sizeof(mbs)) != (ssize_t) sizeof(mbs))
+			err(1, "write");
+	}
+
+	free(file);
+	free(mem);
+}
+
+/*
+ * Run the measurements in a child process and collect its results.
+ */
+static void
+collect(double (*mbs)[2], int scalar)
+{
+	pid_t pid;
+	int fds[2], status;
+	size_t i;
+
+	if (pipe(fds) < 0)
+		err(1, "pipe");
+
+	if ((pid = fork()) < 0)
+		err(1, "fork");
+
+	if (pid == 0) {
+		(void) close(fds[0]);
+		run(fds[1], scalar);
+		_exit(0);
+	}
+
+	(void) close(fds[1]);
+	for (i = 0; i < NTYPES; i++)
+		if (read(fds[0], mbs[i], sizeof(mbs[i])) !=
+		    (ssize_t) sizeof(mbs[i]))
+			errx(1, "short read from child");
+	(void) close(fds[0]);
+
+	if (waitpid(pid, &status, 0) < 0)
+		err(1, "waitpid");
+	if (!WIFEXITED(status) || WEXITSTATUS(status) != 0)
+		errx(1, "child failed");
+}
+
+static void
+usage(void)
+{
+	(void) fprintf(stderr, "usage: xlate-bench [-n reps] [-s size]\n");
+	exit(1);
+}
+
+int
+main(int argc, char **argv)
+{
+	double scalar[NTYPES][2], vector[NTYPES][2];
+	uint16_t one;
+	size_t i;
+	int c;
+
+	while ((c = getopt(argc, argv, "n:s:")) != -1) {
+		switch (c) {
+		case 'n':
+			if ((reps = atoi(optarg)) <= 0)
+				usage();
+			break;
+		case 's':
+			if ((bufsize = (size_t) strtoul(optarg, NULL, 0)) < 64)
+				usage();
+			break;
+		default:
+			usage();
+		}
+	}
+
+	if (elf_version(EV_CURRENT) == EV_NONE)
+		errx(1, "elf_version: %s", elf_errmsg(-1));
+
+	one = 1;
+	swapped_order = *(uint8_t *) &one ? ELFDATA2MSB : ELFDATA2LSB;
+
+	collect(scalar, 1);
+	collect(vector, 0);
+
+	(void) printf("%-8s %10s %10s %7s %10s %10s %7s\n", "type",
+	    "tom-scalar", "tom-simd", "ratio", "tof-scalar", "tof-simd",
+	    "ratio");
+	for (i = 0; i < NTYPES; i++)
+		(void) printf("%-8s %10.0f %10.0f %7.2f %10.0f %10.0f %7.2f\n",
+		    xlate_types[i].xt_name, scalar[i][0], vector[i][0],
+		    vector[i][0] / scalar[i][0], scalar[i][1], vector[i][1],
+		    vector[i][1] / scalar[i][1]);
+
+	exit(0);
+}
@@ -0,0 +1,69 @@
+/*-
+ * Copyright (c) 2026, Elftoolchain Project Contributors.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE AUTHOR AND CONTRIBUTORS ``AS IS'' AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED.  IN NO EVENT SHALL THE AUTHOR OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS
+ * OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY
+ * OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+ * SUCH DAMAGE.
+ *
+ * $Id$
+ */
+
+#include <libelf.h>
+#include <unistd.h>
+
+#include "tet_api.h"
+
+#include "elfts.h"
+
+/*
+ * Write out a new ELF object to file "fn".  The object has the
+ * class, byte order and type given; its sections are added by the
+ * "addscns" callback.  Returns 0 on success and -1 on failure.
+ */
+
+int
+elfts_make_file(const char *fn, int ec, int ed, int type,
+    int (*addscns)(Elf *_e, void *_arg), void *arg)
+{
+	Elf *e;
+	int fd, result;
+
+	if ((e = elfts_new_file(fn, ec, ed, type, &fd)) == NULL)
+		return (-1);
+
+	result = -1;
+
+	if (addscns != NULL && (*addscns)(e, arg) < 0)
+		goto done;
+
+	if (elf_update(e, ELF_C_WRITE) < 0) {
+		tet_printf("U: cannot create file: \"%s\".", elf_errmsg(-1));
+		goto done;
+	}
+
+	result = 0;
+
+ done:
+	(void) elf_end(e);
+	(void) close(fd);
+
+	return (result);
+}
@@ -0,0 +1,68 @@
+/*-
+ * Copyright (c) 2026, Elftoolchain Project Contributors.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE AUTHOR AND CONTRIBUTORS ``AS IS'' AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED.  IN NO EVENT SHALL THE AUTHOR OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS
+ * OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY
+ * OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+ * SUCH DAMAGE.
+ *
+ * $Id$
+ */
+
+#include <gelf.h>
+#include <libelf.h>
+#include <unistd.h>
+
+#include "tet_api.h"
+
+#include "elfts.h"
+
+/*
+ * Create file "fn" for writing and give it an ELF header of class
+ * "ec", byte order "ed" and object type "type".
+ */
+
+Elf *
+elfts_new_file(const char *fn, int ec, int ed, int type, int *fdp)
+{
+	Elf *e;
+	GElf_Ehdr eh;
+
+	if ((e = elfts_open_file(fn, ELF_C_WRITE, fdp)) == NULL)
+		return (NULL);
+
+	if (gelf_newehdr(e, ec) == NULL ||
+	    gelf_getehdr(e, &eh) == NULL)
+		goto error;
+
+	eh.e_ident[EI_DATA] = ed;
+	eh.e_type = type;
+
+	if (gelf_update_ehdr(e, &eh) == 0)
+		goto error;
+
+	return (e);
+
+ error:
+	tet_printf("U: cannot create file: \"%s\".", elf_errmsg(-1));
+	(void) elf_end(e);
+	(void) close(*fdp);
+	return (NULL);
+}
@@ -0,0 +1,76 @@
+/*-
+ * Copyright (c) 2026, Elftoolchain Project Contributors.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE AUTHOR AND CONTRIBUTORS ``AS IS'' AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED.  IN NO EVENT SHALL THE AUTHOR OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS
+ * OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY
+ * OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+ * SUCH DAMAGE.
+ *
+ * $Id$
+ */
+
+#include <gelf.h>
+#include <libelf.h>
+
+#include "tet_api.h"
+
+#include "elfts.h"
+
+/*
+ * Append a section described by "sh" to descriptor "e".  If "buf" is
+ * not NULL, the section is given a data descriptor of type "dtype"
+ * covering "size" bytes at "buf", aligned to the "sh_addralign" of
+ * "sh" if that is set.  The buffer remains owned by the caller and
+ * must stay valid until the descriptor is written out.
+ */
+
+Elf_Scn *
+elfts_new_section(Elf *e, const GElf_Shdr *sh, Elf_Type dtype, void *buf,
+    size_t size)
+{
+	Elf_Scn *scn;
+	Elf_Data *d;
+	GElf_Shdr shdr;
+
+	if ((scn = elf_newscn(e)) == NULL)
+		goto error;
+
+	shdr = *sh;
+	if (gelf_update_shdr(scn, &shdr) == 0)
+		goto error;
+
+	if (buf == NULL)
+		return (scn);
+
+	if ((d = elf_newdata(scn)) == NULL)
+		goto error;
+
+	d->d_buf = buf;
+	d->d_size = size;
+	d->d_type = dtype;
+	if (sh->sh_addralign != 0)
+		d->d_align = sh->sh_addralign;
+
+	return (scn);
+
+ error:
+	tet_printf("U: cannot create section: \"%s\".", elf_errmsg(-1));
+	return (NULL);
+}
@@ -51,9 +51,11 @@ elfts_open_file(const char *fn, Elf_Cmd cmd, int *fdp)
 		mode = O_WRONLY | O_CREAT;
 		break;
 	case ELF_C_READ:
+	case ELF_C_READ_MMAP:
 		mode = O_RDONLY;
 		break;
 	case ELF_C_RDWR:
+	case ELF_C_RDWR_MMAP:
 		mode = O_RDWR;
 		break;
 	default:
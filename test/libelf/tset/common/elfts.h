@@ -29,6 +29,8 @@
 #ifndef	_ELF_TS_H_
 #define	_ELF_TS_H_ 	1
 
+#include <gelf.h>
+
 /*
  * Common definitions used by test cases.
  */
@@ -114,5 +116,11 @@ void	elfts_init_version(void);
 Elf	*elfts_open_file(const char *_fn, Elf_Cmd _cmd, int *_fdp);
 int	elfts_compare_files(const char *_reffn, const char *fn);
 char	*elfts_copy_file(const char *_fn, int *_error);
+int	elfts_make_file(const char *_fn, int _ec, int _ed, int _type,
+    int (*_addscns)(Elf *_e, void *_arg), void *_arg);
+Elf	*elfts_new_file(const char *_fn, int _ec, int _ed, int _type,
+    int *_fdp);
+Elf_Scn	*elfts_new_section(Elf *_e, const GElf_Shdr *_sh, Elf_Type _dtype,
+    void *_buf, size_t _size);
 
 #endif	/* _LIBELF_TS_H_ */
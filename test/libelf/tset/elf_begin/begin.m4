@@ -91,6 +91,7 @@ tcCmdInvalid(void)
 	result = TET_PASS;
 	for (c = ELF_C_NULL-1; c <= ELF_C_NUM; c++) {
 		if (c == ELF_C_READ || c == ELF_C_WRITE || c == ELF_C_RDWR ||
+		    c == ELF_C_READ_MMAP || c == ELF_C_RDWR_MMAP ||
 		    c == ELF_C_NULL)
 			continue;
 		if ((e = elf_begin(-1, c, NULL)) != NULL ||
@@ -383,18 +384,20 @@ tcCmdWriteParamIgnored(void)
 
 /*
  * Check that opening various classes/endianness of ELF files
- * passes.
+ * passes, including when the files are read in on demand instead of
+ * being mapped in.
  */
 undefine(`FN')
 define(`FN',`
 void
-tcElfOpen$1$2(void)
+tcElfOpen$3$1$2(void)
 {
 	Elf *e;
 	int fd, result;
 	char *p;
 
-	TP_ANNOUNCE("open(ELFCLASS$1,ELFDATA2`'TOUPPER($2)) succeeds.");
+	TP_ANNOUNCE("open(ELFCLASS$1,ELFDATA2`'TOUPPER($2)) succeeds"ifelse($3,`NoMmap',
+	    `" when not mapped in"')".");
 
 	TP_SET_VERSION();
 
@@ -407,7 +410,12 @@ tcElfOpen$1$2(void)
 		goto done;
 	}
 
-	if ((e = elf_begin(fd, ELF_C_READ, NULL)) == NULL) {
+ifelse($3,`NoMmap',`	(void) setenv("LIBELF_NOMMAP", "1", 1);
+')dnl
+	e = elf_begin(fd, ELF_C_READ, NULL);
+ifelse($3,`NoMmap',`	(void) unsetenv("LIBELF_NOMMAP");
+')dnl
+	if (e == NULL) {
 		TP_FAIL("elf_begin() failed: %s.", elf_errmsg(-1));
 		goto done;
 	}
@@ -436,6 +444,144 @@ FN(32,`lsb')
 FN(32,`msb')
 FN(64,`lsb')
 FN(64,`msb')
+FN(32,`lsb',`NoMmap')
+FN(32,`msb',`NoMmap')
+FN(64,`lsb',`NoMmap')
+FN(64,`msb',`NoMmap')
+
+/*
+ * Check that a file too short to hold an ELF header is rejected by
+ * elf_getehdr() when read in on demand, as it is when mapped in.
+ */
+undefine(`FN')
+define(`FN',`
+void
+tcElfShortHeader$2$1(void)
+{
+	Elf *e;
+	int error, fd, result;
+	char buf[EI_NIDENT + 4];
+
+	TP_ANNOUNCE("ELFCLASS$1: a truncated ELF header is rejected"ifelse($2,
+	    `NoMmap',`" when not mapped in"')".");
+
+	TP_SET_VERSION();
+
+	fd = -1;
+	e = NULL;
+	result = TET_UNRESOLVED;
+
+	if ((fd = open("check_elf.lsb$1", O_RDONLY)) < 0 ||
+	    read(fd, buf, sizeof(buf)) != (ssize_t) sizeof(buf)) {
+		TP_UNRESOLVED("read() failed: %s.", strerror(errno));
+		goto done;
+	}
+	(void) close(fd);
+	fd = -1;
+
+	if (setup_tempfile() == 0 ||
+	    (fd = open(filename, O_RDWR|O_TRUNC, 0)) < 0 ||
+	    write(fd, buf, sizeof(buf)) != (ssize_t) sizeof(buf)) {
+		TP_UNRESOLVED("setup failed: %s.", strerror(errno));
+		goto done;
+	}
+
+ifelse($2,`NoMmap',`	(void) setenv("LIBELF_NOMMAP", "1", 1);
+')dnl
+	e = elf_begin(fd, ELF_C_READ, NULL);
+ifelse($2,`NoMmap',`	(void) unsetenv("LIBELF_NOMMAP");
+')dnl
+	if (e == NULL) {
+		TP_FAIL("elf_begin() failed: %s.", elf_errmsg(-1));
+		goto done;
+	}
+
+	if (elf_kind(e) != ELF_K_ELF) {
+		TP_FAIL("kind %d, expected %d.", elf_kind(e), ELF_K_ELF);
+		goto done;
+	}
+
+	if (elf$1_getehdr(e) != NULL ||
+	    (error = elf_errno()) != ELF_E_HEADER) {
+		TP_FAIL("elf$1_getehdr() error %d \"%s\".", error,
+		    elf_errmsg(error));
+		goto done;
+	}
+
+	result = TET_PASS;
+
+ done:
+	if (e)
+		(void) elf_end(e);
+	if (fd != -1)
+		(void) close(fd);
+	cleanup_tempfile();
+	tet_result(result);
+}')
+
+FN(32)
+FN(64)
+FN(32,`NoMmap')
+FN(64,`NoMmap')
+
+/*
+ * Check that ELF_C_READ_MMAP and ELF_C_RDWR_MMAP behave like their
+ * non-mmap counterparts.
+ */
+undefine(`FN')
+define(`FN',`
+void
+tcCmd$1Mmap(void)
+{
+	Elf *e;
+	Elf_Kind k;
+	int fd, result;
+	char *p;
+
+	TP_ANNOUNCE("cmd == ELF_C_$1_MMAP opens an ELF object.");
+
+	TP_SET_VERSION();
+
+	fd = -1;
+	e = NULL;
+	result = TET_UNRESOLVED;
+
+	if ((fd = open ("check_elf.lsb64", $2)) < 0) {
+		TP_UNRESOLVED("open() failed: %s.", strerror(errno));
+		goto done;
+	}
+
+	if ((e = elf_begin(fd, ELF_C_$1_MMAP, NULL)) == NULL) {
+		TP_FAIL("elf_begin() failed: %s.", elf_errmsg(-1));
+		goto done;
+	}
+
+	if ((k = elf_kind(e)) != ELF_K_ELF) {
+		TP_FAIL("kind %d, expected %d.", k, ELF_K_ELF);
+		goto done;
+	}
+
+	if ((p = elf_getident(e, NULL)) == NULL) {
+		TP_FAIL("elf_getident() failed: \"%s\".", elf_errmsg(-1));
+		goto done;
+	}
+
+	if (p[EI_CLASS] != ELFCLASS64 || p[EI_DATA] != ELFDATA2LSB)
+		TP_FAIL("class %d expected %d, data %d expected %d.",
+		    p[EI_CLASS], ELFCLASS64, p[EI_DATA], ELFDATA2LSB);
+	else
+		result = TET_PASS;
+
+ done:
+	if (e)
+		(void) elf_end(e);
+	if (fd != -1)
+		(void) close(fd);
+	tet_result(result);
+}')
+
+FN(`READ',`O_RDONLY')
+FN(`RDWR',`O_RDWR')
 
 /*
  * Check an `fd' mismatch is detected.
@@ -551,6 +697,67 @@ tcArRetrieval_$1(void)
 	tet_result(result);
 }
 
+/*
+ * Check that the members of $1-style archives are correctly retrieved
+ * when the archive is read in on demand.
+ */
+void
+tcArRetrievalNoMmap_$1(void)
+{
+	Elf *e, *e1;
+	int fd, n, result;
+	char *id;
+	Elf_Cmd c;
+	Elf_Kind k;
+
+	TP_ANNOUNCE("($1): archive members are retrieved when the archive "
+	    "is not mapped in.");
+
+	TP_SET_VERSION();
+
+	e = e1 = NULL;
+	fd = -1;
+	result = TET_UNRESOLVED;
+
+	(void) setenv("LIBELF_NOMMAP", "1", 1);
+	_TS_OPEN_FILE(e, TS_ARFILE_$1, ELF_C_READ, fd, goto done;);
+
+	result = TET_PASS;
+	n = 0;
+	c = ELF_C_READ;
+	while ((e1 = elf_begin(fd, c, e)) != NULL) {
+		n++;
+		if ((k = elf_kind(e1)) != ELF_K_ELF) {
+			TP_FAIL("member %d: kind %d, expected %d.", n, k,
+			    ELF_K_ELF);
+			goto done;
+		}
+		if ((id = elf_getident(e1, NULL)) == NULL ||
+		    id[EI_MAG0] != ELFMAG0 || id[EI_MAG1] != ELFMAG1 ||
+		    id[EI_MAG2] != ELFMAG2 || id[EI_MAG3] != ELFMAG3) {
+			TP_FAIL("member %d: elf_getident() failed: \"%s\".",
+			    n, elf_errmsg(-1));
+			goto done;
+		}
+		c = elf_next(e1);
+		(void) elf_end(e1);
+		e1 = NULL;
+	}
+
+	if (n == 0)
+		TP_FAIL("elf_begin() failed: \"%s\".", elf_errmsg(-1));
+
+ done:
+	(void) unsetenv("LIBELF_NOMMAP");
+	if (e1)
+		(void) elf_end(e1);
+	if (e)
+		(void) elf_end(e);
+	if (fd != -1)
+		(void) close(fd);
+	tet_result(result);
+}
+
 /*
  * Check opening of ar(1) archives opened with elf_memory().
  */
@@ -89,7 +89,10 @@ tcInvalidInvalid(void)
 	ret = error = 0;
 	result = TET_PASS;
 	for (c = ELF_C_FIRST-1; c <= ELF_C_LAST; c++) {
-		if (c == ELF_C_FDDONE || c == ELF_C_FDREAD)
+		if (c == ELF_C_FDDONE || c == ELF_C_FDREAD ||
+		    c == ELF_C_ACCESS_NORMAL || c == ELF_C_ACCESS_SEQUENTIAL ||
+		    c == ELF_C_ACCESS_RANDOM || c == ELF_C_HUGEPAGES ||
+		    c == ELF_C_PARALLEL)
 			continue;
 		if ((ret = elf_cntl(e, c)) != -1 ||
 		    (error = elf_errno()) != ELF_E_ARGUMENT) {
@@ -126,6 +129,86 @@ tcReadFDREAD(void)
 	tet_result(result);
 }
 
+static Elf_Cmd access_cmds[] = {
+	ELF_C_ACCESS_SEQUENTIAL,
+	ELF_C_ACCESS_RANDOM,
+	ELF_C_HUGEPAGES,
+	ELF_C_ACCESS_NORMAL
+};
+
+#define	NACCESS_CMDS	(sizeof(access_cmds) / sizeof(access_cmds[0]))
+
+/*
+ * Access hints are accepted for descriptors for in-memory images.
+ */
+void
+tcReadAccessMemory(void)
+{
+	Elf *e;
+	size_t n;
+	int result;
+
+	TP_ANNOUNCE("elf_cntl(e,ACCESS_*) for an in-memory image succeeds.");
+
+	TP_CHECK_INITIALIZATION();
+
+	TS_OPEN_MEMORY(e, elf_file);
+
+	result = TET_PASS;
+	for (n = 0; n < NACCESS_CMDS; n++)
+		if (elf_cntl(e, access_cmds[n]) != 0) {
+			TP_FAIL("cmd=%d elf_errmsg=\"%s\".", access_cmds[n],
+			    elf_errmsg(-1));
+			break;
+		}
+
+	(void) elf_end(e);
+	tet_result(result);
+}
+
+/*
+ * Access hints are accepted for archive members, unlike the
+ * commands that control the use of the file descriptor.
+ */
+void
+tcReadAccessArMember(void)
+{
+	Elf *ar, *e;
+	size_t n;
+	int err, fd, result, ret;
+
+	TP_ANNOUNCE("elf_cntl(member,ACCESS_*) succeeds.");
+
+	TP_CHECK_INITIALIZATION();
+
+	e = NULL;
+	TS_OPEN_FILE(ar, "a.ar", ELF_C_READ, fd);
+
+	if ((e = elf_begin(fd, ELF_C_READ, ar)) == NULL) {
+		TP_UNRESOLVED("elf_begin(member) failed: \"%s\".",
+		    elf_errmsg(-1));
+		goto done;
+	}
+
+	result = TET_PASS;
+	for (n = 0; n < NACCESS_CMDS; n++)
+		if (elf_cntl(e, access_cmds[n]) != 0) {
+			TP_FAIL("cmd=%d elf_errmsg=\"%s\".", access_cmds[n],
+			    elf_errmsg(-1));
+			goto done;
+		}
+
+	if ((ret = elf_cntl(e, ELF_C_FDREAD)) != -1 ||
+	    (err = elf_errno()) != ELF_E_ARCHIVE)
+		TP_FAIL("FDREAD: ret (%d) error (%d).", ret, err);
+
+ done:
+	(void) elf_end(e);
+	(void) elf_end(ar);
+	(void) close(fd);
+	tet_result(result);
+}
+
 static char pathname[PATH_MAX];
 
 /*
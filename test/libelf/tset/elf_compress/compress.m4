@@ -0,0 +1,693 @@
+/*-
+ * Copyright (c) 2026, Elftoolchain Project Contributors.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE AUTHOR AND CONTRIBUTORS ``AS IS'' AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED.  IN NO EVENT SHALL THE AUTHOR OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS
+ * OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY
+ * OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+ * SUCH DAMAGE.
+ *
+ * $Id$
+ */
+
+#include <sys/types.h>
+
+#include <fcntl.h>
+#include <gelf.h>
+#include <libelf.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+#include "elfts.h"
+#include "tet_api.h"
+
+IC_REQUIRES_VERSION_INIT();
+
+include(`elfts.m4')
+
+/*
+ * Tests for the `elf_compress' and `gelf_getchdr' APIs, and for the
+ * handling of compressed sections by `elf_getdata' and `elf_update'.
+ */
+
+#define	TS_NWORDS	1024		/* #words in the test section */
+#define	TS_SMALLSZ	16		/* a section too small to compress */
+
+static uint32_t words[TS_NWORDS];
+
+static void
+init_words(void)
+{
+	size_t i;
+
+	for (i = 0; i < TS_NWORDS; i++)
+		words[i] = (uint32_t) (i % 13) * 0x01020304U;
+}
+
+struct scnspec {
+	int		ctype;
+	unsigned int	cflags;
+	size_t		nbytes;
+};
+
+/*
+ * Add a section of type SHT_HASH holding the words in `words[]', or
+ * an SHT_PROGBITS section with `nbytes' bytes of them if `nbytes' is
+ * non-zero.  The section is compressed with `ctype' if that is
+ * non-zero.
+ */
+static int
+add_sections(Elf *e, void *arg)
+{
+	Elf_Scn *scn;
+	GElf_Shdr sh;
+	struct scnspec *ss;
+
+	ss = arg;
+
+	(void) memset(&sh, 0, sizeof(sh));
+	sh.sh_type = ss->nbytes ? SHT_PROGBITS : SHT_HASH;
+	sh.sh_addralign = 4;
+
+	if ((scn = elfts_new_section(e, &sh, ss->nbytes ? ELF_T_BYTE :
+	    ELF_T_WORD, words, ss->nbytes ? ss->nbytes : sizeof(words))) ==
+	    NULL)
+		return (-1);
+
+	if (ss->ctype && elf_compress(scn, ss->ctype, ss->cflags) != 1) {
+		tet_printf("U: cannot create file: \"%s\".", elf_errmsg(-1));
+		return (-1);
+	}
+
+	return (0);
+}
+
+static int
+make_file(int ec, int ed, int ctype, unsigned int cflags, size_t nbytes)
+{
+	struct scnspec ss;
+
+	init_words();
+
+	ss.ctype = ctype;
+	ss.cflags = cflags;
+	ss.nbytes = nbytes;
+
+	return (elfts_make_file(TS_NEWFILE, ec, ed, ET_REL, add_sections,
+	    &ss));
+}
+
+/*
+ * A NULL section is rejected.
+ */
+void
+tcArgsNull(void)
+{
+	int error, result, ret;
+
+	TP_CHECK_INITIALIZATION();
+
+	TP_ANNOUNCE("elf_compress(NULL,...) fails with ELF_E_ARGUMENT.");
+
+	result = TET_PASS;
+	if ((ret = elf_compress(NULL, ELFCOMPRESS_ZLIB, 0)) != -1 ||
+	    (error = elf_errno()) != ELF_E_ARGUMENT)
+		TP_FAIL("ret=%d, error=%d \"%s\".", ret, error,
+		    elf_errmsg(error));
+
+	tet_result(result);
+}
+
+/*
+ * Unknown compression types and flags are rejected.
+ */
+void
+tcArgsIllegal(void)
+{
+	int error, fd, result, ret;
+	Elf *e;
+	Elf_Scn *scn;
+
+	TP_CHECK_INITIALIZATION();
+
+	TP_ANNOUNCE("Illegal types and flags are rejected.");
+
+	result = TET_UNRESOLVED;
+	e = NULL;
+	fd = -1;
+
+	if (make_file(ELFCLASS64, ELFDATA2LSB, 0, 0, 0) < 0)
+		goto done;
+
+	_TS_OPEN_FILE(e, TS_NEWFILE, ELF_C_RDWR, fd, goto done;);
+
+	if ((scn = elf_getscn(e, 1)) == NULL) {
+		TP_UNRESOLVED("elf_getscn() failed: \"%s\".", elf_errmsg(-1));
+		goto done;
+	}
+
+	result = TET_PASS;
+	if ((ret = elf_compress(scn, -1, 0)) != -1 ||
+	    (error = elf_errno()) != ELF_E_ARGUMENT)
+		TP_FAIL("type: ret=%d, error=%d \"%s\".", ret, error,
+		    elf_errmsg(error));
+	else if ((ret = elf_compress(scn, ELFCOMPRESS_ZLIB,
+	    ~ELF_CHF_FORCE)) != -1 || (error = elf_errno()) !=
+	    ELF_E_ARGUMENT)
+		TP_FAIL("flags: ret=%d, error=%d \"%s\".", ret, error,
+		    elf_errmsg(error));
+	else if ((ret = elf_compress(elf_getscn(e, 0), ELFCOMPRESS_ZLIB,
+	    0)) != -1 || (error = elf_errno()) != ELF_E_ARGUMENT)
+		TP_FAIL("SHT_NULL: ret=%d, error=%d \"%s\".", ret, error,
+		    elf_errmsg(error));
+
+ done:
+	if (e)
+		(void) elf_end(e);
+	if (fd != -1)
+		(void) close(fd);
+	(void) unlink(TS_NEWFILE);
+
+	tet_result(result);
+}
+
+/*
+ * gelf_getchdr() rejects uncompressed sections, and sections whose
+ * compression is still pending.
+ */
+void
+tcGetchdrSequence(void)
+{
+	int error, fd, result;
+	Elf *e;
+	Elf_Scn *scn;
+	GElf_Chdr ch;
+
+	TP_CHECK_INITIALIZATION();
+
+	TP_ANNOUNCE("gelf_getchdr() needs a compressed section.");
+
+	result = TET_UNRESOLVED;
+	e = NULL;
+	fd = -1;
+
+	if (make_file(ELFCLASS32, ELFDATA2MSB, 0, 0, 0) < 0)
+		goto done;
+
+	_TS_OPEN_FILE(e, TS_NEWFILE, ELF_C_RDWR, fd, goto done;);
+
+	if ((scn = elf_getscn(e, 1)) == NULL) {
+		TP_UNRESOLVED("elf_getscn() failed: \"%s\".", elf_errmsg(-1));
+		goto done;
+	}
+
+	result = TET_PASS;
+	if (gelf_getchdr(scn, &ch) != NULL ||
+	    (error = elf_errno()) != ELF_E_ARGUMENT) {
+		TP_FAIL("uncompressed: error=%d \"%s\".", error,
+		    elf_errmsg(error));
+		goto done;
+	}
+
+	if (elf_compress(scn, ELFCOMPRESS_ZLIB, 0) != 1) {
+		TP_UNRESOLVED("elf_compress() failed: \"%s\".",
+		    elf_errmsg(-1));
+		goto done;
+	}
+
+	if (gelf_getchdr(scn, &ch) != NULL ||
+	    (error = elf_errno()) != ELF_E_SEQUENCE) {
+		TP_FAIL("pending: error=%d \"%s\".", error,
+		    elf_errmsg(error));
+		goto done;
+	}
+
+	if (elf_update(e, ELF_C_NULL) < 0) {
+		TP_UNRESOLVED("elf_update() failed: \"%s\".",
+		    elf_errmsg(-1));
+		goto done;
+	}
+
+	if (gelf_getchdr(scn, &ch) == NULL)
+		TP_FAIL("gelf_getchdr() failed: \"%s\".", elf_errmsg(-1));
+	else if (ch.ch_type != ELFCOMPRESS_ZLIB ||
+	    ch.ch_size != sizeof(words))
+		TP_FAIL("type=%u size=%ju.", ch.ch_type,
+		    (uintmax_t) ch.ch_size);
+
+ done:
+	if (e)
+		(void) elf_end(e);
+	if (fd != -1)
+		(void) close(fd);
+	(void) unlink(TS_NEWFILE);
+
+	tet_result(result);
+}
+
+/*
+ * Sections compressed by elf_update() can be read back, both in
+ * their compressed form and transparently decompressed.
+ */
+undefine(`FN')
+define(`FN',`
+void
+tcRoundTrip$1$2(void)
+{
+	int fd, result;
+	Elf *e;
+	Elf_Scn *scn;
+	Elf_Data *d;
+	GElf_Chdr ch;
+	GElf_Shdr sh;
+
+	TP_CHECK_INITIALIZATION();
+
+	TP_ANNOUNCE("TOUPPER($2)$1: compressed sections round trip.");
+
+	result = TET_UNRESOLVED;
+	e = NULL;
+	fd = -1;
+
+	if (make_file(ELFCLASS$1, ELFDATA2`'TOUPPER($2), ELFCOMPRESS_ZLIB,
+	    0, 0) < 0)
+		goto done;
+
+	_TS_OPEN_FILE(e, TS_NEWFILE, ELF_C_READ, fd, goto done;);
+
+	if ((scn = elf_getscn(e, 1)) == NULL ||
+	    gelf_getshdr(scn, &sh) == NULL) {
+		TP_UNRESOLVED("elf_getscn() failed: \"%s\".", elf_errmsg(-1));
+		goto done;
+	}
+
+	result = TET_PASS;
+
+	if ((sh.sh_flags & SHF_COMPRESSED) == 0 ||
+	    sh.sh_size >= sizeof(words) ||
+	    sh.sh_addralign != ($1 / 8)) {
+		TP_FAIL("flags=0x%jx size=%ju align=%ju.",
+		    (uintmax_t) sh.sh_flags, (uintmax_t) sh.sh_size,
+		    (uintmax_t) sh.sh_addralign);
+		goto done;
+	}
+
+	if (gelf_getchdr(scn, &ch) == NULL) {
+		TP_FAIL("gelf_getchdr() failed: \"%s\".", elf_errmsg(-1));
+		goto done;
+	}
+
+	if (ch.ch_type != ELFCOMPRESS_ZLIB || ch.ch_size != sizeof(words) ||
+	    ch.ch_addralign != 4) {
+		TP_FAIL("type=%u size=%ju align=%ju.", ch.ch_type,
+		    (uintmax_t) ch.ch_size, (uintmax_t) ch.ch_addralign);
+		goto done;
+	}
+
+	/* Compressed contents are returned as is by default. */
+	if ((d = elf_getdata(scn, NULL)) == NULL ||
+	    d->d_type != ELF_T_BYTE || d->d_size != sh.sh_size) {
+		TP_FAIL("elf_getdata() failed: \"%s\".", elf_errmsg(-1));
+		goto done;
+	}
+
+	(void) elf_end(e);
+	(void) close(fd);
+
+	_TS_OPEN_FILE(e, TS_NEWFILE, ELF_C_READ, fd, goto done;);
+
+	if (elf_flagelf(e, ELF_C_SET, ELF_F_DECOMPRESS) == 0 ||
+	    (scn = elf_getscn(e, 1)) == NULL) {
+		TP_UNRESOLVED("elf_flagelf() failed: \"%s\".",
+		    elf_errmsg(-1));
+		goto done;
+	}
+
+	if ((d = elf_getdata(scn, NULL)) == NULL) {
+		TP_FAIL("elf_getdata() failed: \"%s\".", elf_errmsg(-1));
+		goto done;
+	}
+
+	if (d->d_type != ELF_T_WORD || d->d_size != sizeof(words) ||
+	    d->d_align != 4 || memcmp(d->d_buf, words, sizeof(words)))
+		TP_FAIL("type=%d size=%ju align=%ju.", d->d_type,
+		    (uintmax_t) d->d_size, (uintmax_t) d->d_align);
+	else if (elf_getdata(scn, NULL) != d)
+		TP_FAIL("decompressed data is not cached.");
+
+ done:
+	if (e)
+		(void) elf_end(e);
+	if (fd != -1)
+		(void) close(fd);
+	(void) unlink(TS_NEWFILE);
+
+	tet_result(result);
+}')
+
+FN(32,`lsb')
+FN(32,`msb')
+FN(64,`lsb')
+FN(64,`msb')
+
+/*
+ * Sections that do not shrink are only compressed if requested.
+ */
+undefine(`FN')
+define(`FN',`
+void
+tcSmall$1(void)
+{
+	int fd, result;
+	Elf *e;
+	Elf_Scn *scn;
+	GElf_Shdr sh;
+
+	TP_CHECK_INITIALIZATION();
+
+	TP_ANNOUNCE("$1: small sections are compressed only if forced.");
+
+	result = TET_UNRESOLVED;
+	e = NULL;
+	fd = -1;
+
+	if (make_file(ELFCLASS64, ELFDATA2LSB, ELFCOMPRESS_ZLIB, $2,
+	    TS_SMALLSZ) < 0)
+		goto done;
+
+	_TS_OPEN_FILE(e, TS_NEWFILE, ELF_C_READ, fd, goto done;);
+
+	if ((scn = elf_getscn(e, 1)) == NULL ||
+	    gelf_getshdr(scn, &sh) == NULL) {
+		TP_UNRESOLVED("elf_getscn() failed: \"%s\".", elf_errmsg(-1));
+		goto done;
+	}
+
+	result = TET_PASS;
+	if (((sh.sh_flags & SHF_COMPRESSED) != 0) != $3)
+		TP_FAIL("flags=0x%jx size=%ju.", (uintmax_t) sh.sh_flags,
+		    (uintmax_t) sh.sh_size);
+
+ done:
+	if (e)
+		(void) elf_end(e);
+	if (fd != -1)
+		(void) close(fd);
+	(void) unlink(TS_NEWFILE);
+
+	tet_result(result);
+}')
+
+FN(`Default',0,0)
+FN(`Forced',ELF_CHF_FORCE,1)
+
+/*
+ * elf_compress() with a type of zero decompresses a section.
+ */
+undefine(`FN')
+define(`FN',`
+void
+tcDecompress$1$2(void)
+{
+	int fd, result, ret;
+	Elf *e;
+	Elf_Scn *scn;
+	Elf_Data *d;
+	GElf_Shdr sh;
+
+	TP_CHECK_INITIALIZATION();
+
+	TP_ANNOUNCE("TOUPPER($2)$1: sections can be decompressed.");
+
+	result = TET_UNRESOLVED;
+	e = NULL;
+	fd = -1;
+
+	if (make_file(ELFCLASS$1, ELFDATA2`'TOUPPER($2), ELFCOMPRESS_ZLIB,
+	    0, 0) < 0)
+		goto done;
+
+	_TS_OPEN_FILE(e, TS_NEWFILE, ELF_C_RDWR, fd, goto done;);
+
+	if ((scn = elf_getscn(e, 1)) == NULL) {
+		TP_UNRESOLVED("elf_getscn() failed: \"%s\".", elf_errmsg(-1));
+		goto done;
+	}
+
+	result = TET_PASS;
+	if ((ret = elf_compress(scn, 0, 0)) != 1) {
+		TP_FAIL("elf_compress() returned %d: \"%s\".", ret,
+		    elf_errmsg(-1));
+		goto done;
+	}
+
+	if ((ret = elf_compress(scn, 0, 0)) != 0) {
+		TP_FAIL("elf_compress() returned %d.", ret);
+		goto done;
+	}
+
+	if (elf_update(e, ELF_C_WRITE) < 0) {
+		TP_FAIL("elf_update() failed: \"%s\".", elf_errmsg(-1));
+		goto done;
+	}
+
+	(void) elf_end(e);
+	(void) close(fd);
+
+	_TS_OPEN_FILE(e, TS_NEWFILE, ELF_C_READ, fd, goto done;);
+
+	if ((scn = elf_getscn(e, 1)) == NULL ||
+	    gelf_getshdr(scn, &sh) == NULL ||
+	    (d = elf_getdata(scn, NULL)) == NULL) {
+		TP_FAIL("cannot read section: \"%s\".", elf_errmsg(-1));
+		goto done;
+	}
+
+	if ((sh.sh_flags & SHF_COMPRESSED) || sh.sh_addralign != 4 ||
+	    d->d_size != sizeof(words) ||
+	    memcmp(d->d_buf, words, sizeof(words)))
+		TP_FAIL("flags=0x%jx size=%ju.", (uintmax_t) sh.sh_flags,
+		    (uintmax_t) d->d_size);
+
+ done:
+	if (e)
+		(void) elf_end(e);
+	if (fd != -1)
+		(void) close(fd);
+	(void) unlink(TS_NEWFILE);
+
+	tet_result(result);
+}')
+
+FN(32,`lsb')
+FN(32,`msb')
+FN(64,`lsb')
+FN(64,`msb')
+
+/*
+ * Compressed contents computed by elf_update(ELF_C_NULL) are reused
+ * until the section's data is flagged dirty.
+ */
+undefine(`FN')
+define(`FN',`
+void
+tcNullUpdate$1$2(void)
+{
+	int fd, result;
+	Elf *e;
+	Elf_Scn *scn;
+	Elf_Data *d;
+	GElf_Shdr sh;
+	uint64_t size;
+	uint32_t buf[TS_NWORDS];
+
+	TP_CHECK_INITIALIZATION();
+
+	TP_ANNOUNCE("TOUPPER($2)$1: flagged changes are compressed after "
+	    "ELF_C_NULL.");
+
+	result = TET_UNRESOLVED;
+	e = NULL;
+	fd = -1;
+
+	init_words();
+	(void) memcpy(buf, words, sizeof(buf));
+
+	if ((e = elfts_new_file(TS_NEWFILE, ELFCLASS$1,
+	    ELFDATA2`'TOUPPER($2), ET_REL, &fd)) == NULL)
+		goto done;
+
+	(void) memset(&sh, 0, sizeof(sh));
+	sh.sh_type = SHT_HASH;
+	sh.sh_addralign = 4;
+
+	if ((scn = elfts_new_section(e, &sh, ELF_T_WORD, buf,
+	    sizeof(buf))) == NULL)
+		goto done;
+
+	d = elf_getdata(scn, NULL);
+
+	if (elf_compress(scn, ELFCOMPRESS_ZLIB, 0) != 1 ||
+	    elf_update(e, ELF_C_NULL) < 0 ||
+	    gelf_getshdr(scn, &sh) == NULL) {
+		TP_UNRESOLVED("elf_update() failed: \"%s\".", elf_errmsg(-1));
+		goto done;
+	}
+
+	size = sh.sh_size;
+
+	result = TET_PASS;
+
+	if (elf_update(e, ELF_C_NULL) < 0 || gelf_getshdr(scn, &sh) == NULL ||
+	    sh.sh_size != size) {
+		TP_FAIL("size %ju, expected %ju.", (uintmax_t) sh.sh_size,
+		    (uintmax_t) size);
+		goto done;
+	}
+
+	/* A change to the data compresses to a different size. */
+	(void) memset(buf, 0, sizeof(buf));
+	if (elf_flagdata(d, ELF_C_SET, ELF_F_DIRTY) == 0 ||
+	    elf_update(e, ELF_C_NULL) < 0 || gelf_getshdr(scn, &sh) == NULL ||
+	    sh.sh_size >= size) {
+		TP_FAIL("size %ju, expected less than %ju.",
+		    (uintmax_t) sh.sh_size, (uintmax_t) size);
+		goto done;
+	}
+
+	if (elf_update(e, ELF_C_WRITE) < 0) {
+		TP_FAIL("elf_update() failed: \"%s\".", elf_errmsg(-1));
+		goto done;
+	}
+
+	(void) elf_end(e);
+	(void) close(fd);
+	e = NULL;
+	fd = -1;
+
+	_TS_OPEN_FILE(e, TS_NEWFILE, ELF_C_READ, fd, goto done;);
+
+	if (elf_flagelf(e, ELF_C_SET, ELF_F_DECOMPRESS) == 0 ||
+	    (scn = elf_getscn(e, 1)) == NULL ||
+	    (d = elf_getdata(scn, NULL)) == NULL) {
+		TP_FAIL("elf_getdata() failed: \"%s\".", elf_errmsg(-1));
+		goto done;
+	}
+
+	if (d->d_size != sizeof(buf) || memcmp(d->d_buf, buf, sizeof(buf)))
+		TP_FAIL("size=%ju, contents differ.", (uintmax_t) d->d_size);
+
+ done:
+	if (e)
+		(void) elf_end(e);
+	if (fd != -1)
+		(void) close(fd);
+	(void) unlink(TS_NEWFILE);
+
+	tet_result(result);
+}')
+
+FN(32,`lsb')
+FN(32,`msb')
+FN(64,`lsb')
+FN(64,`msb')
+
+/*
+ * Sections decompressed by elf_getdata() are written out with their
+ * original compressed contents if they were not modified.  The test
+ * section is too small to benefit from compression, and would be
+ * written out uncompressed if it were compressed again.
+ */
+undefine(`FN')
+define(`FN',`
+void
+tcDecompressUnchanged$1$2(void)
+{
+	int error, fd, result;
+	Elf *e;
+	Elf_Scn *scn;
+	Elf_Data *d;
+	char *tfn;
+
+	TP_CHECK_INITIALIZATION();
+
+	TP_ANNOUNCE("TOUPPER($2)$1: unmodified sections keep their "
+	    "compressed contents.");
+
+	result = TET_UNRESOLVED;
+	e = NULL;
+	fd = -1;
+	tfn = NULL;
+
+	if (make_file(ELFCLASS$1, ELFDATA2`'TOUPPER($2), ELFCOMPRESS_ZLIB,
+	    ELF_CHF_FORCE, TS_SMALLSZ) < 0)
+		goto done;
+
+	if ((tfn = elfts_copy_file(TS_NEWFILE, &error)) == NULL) {
+		TP_UNRESOLVED("elfts_copy_file() failed: \"%s\".",
+		    strerror(error));
+		goto done;
+	}
+
+	_TS_OPEN_FILE(e, tfn, ELF_C_RDWR, fd, goto done;);
+
+	if (elf_flagelf(e, ELF_C_SET, ELF_F_DECOMPRESS) == 0 ||
+	    (scn = elf_getscn(e, 1)) == NULL ||
+	    (d = elf_getdata(scn, NULL)) == NULL) {
+		TP_UNRESOLVED("elf_getdata() failed: \"%s\".",
+		    elf_errmsg(-1));
+		goto done;
+	}
+
+	if (d->d_size != TS_SMALLSZ || memcmp(d->d_buf, words, TS_SMALLSZ)) {
+		TP_UNRESOLVED("size=%ju, contents differ.",
+		    (uintmax_t) d->d_size);
+		goto done;
+	}
+
+	if (elf_update(e, ELF_C_WRITE) < 0) {
+		TP_FAIL("elf_update() failed: \"%s\".", elf_errmsg(-1));
+		goto done;
+	}
+
+	(void) elf_end(e);
+	e = NULL;
+	(void) close(fd);
+	fd = -1;
+
+	result = elfts_compare_files(TS_NEWFILE, tfn);
+
+ done:
+	if (e)
+		(void) elf_end(e);
+	if (fd != -1)
+		(void) close(fd);
+	if (tfn != NULL)
+		(void) unlink(tfn);
+	(void) unlink(TS_NEWFILE);
+
+	tet_result(result);
+}')
+
+FN(32,`lsb')
+FN(32,`msb')
+FN(64,`lsb')
+FN(64,`msb')
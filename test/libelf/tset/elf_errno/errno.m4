@@ -31,6 +31,7 @@ include(`elfts.m4')
 #include <errno.h>
 #include <fcntl.h>
 #include <libelf.h>
+#include <pthread.h>
 #include <string.h>
 #include <unistd.h>
 
@@ -183,3 +184,69 @@ tcExpectedErrorIsReturned(void)
 
 	tet_result(result);
 }
+
+/*
+ * Assertion: the error number is maintained separately for each thread.
+ */
+
+static void *
+thread_error(void *arg)
+{
+	int *perror;
+
+	perror = arg;
+
+	/* A new thread starts with no pending error. */
+	if ((*perror = elf_errno()) != ELF_E_NONE)
+		return (NULL);
+
+	/* Force an error different from the one in the main thread. */
+	(void) elf_getdata(NULL, NULL);
+	*perror = elf_errno();
+
+	return (NULL);
+}
+
+void
+tcThreadLocal(void)
+{
+	int error, result, thread_err;
+	pthread_t tid;
+
+	result = TET_UNRESOLVED;
+
+	TP_ANNOUNCE("Error numbers are maintained per thread.");
+
+	TP_SET_VERSION();
+
+	(void) elf_errno();	/* discard stored error */
+
+	/* Force an error in this thread. */
+	if (elf_version(EV_CURRENT + 1) != EV_NONE) {
+		TP_UNRESOLVED("elf_version() succeeded unexpectedly.");
+		goto done;
+	}
+
+	thread_err = -1;
+	if (pthread_create(&tid, NULL, thread_error, &thread_err) != 0 ||
+	    pthread_join(tid, NULL) != 0) {
+		TP_UNRESOLVED("pthread_create() failed.");
+		goto done;
+	}
+
+	if (thread_err != ELF_E_ARGUMENT) {
+		TP_FAIL("unexpected error %d in thread.", thread_err);
+		goto done;
+	}
+
+	if ((error = elf_errno()) != ELF_E_VERSION) {
+		TP_FAIL("unexpected error %d \"%s\"", error,
+			elf_errmsg(error));
+		goto done;
+	}
+
+	result = TET_PASS;
+
+ done:
+	tet_result(result);
+}
@@ -154,6 +154,7 @@ static size_t sizes32[ELF_T_NUM] = {
 	DEFINE_SIZE(ADDR,	4),
 	DEFINE_SIZE(BYTE,	1),
 	DEFINE_SIZE(CAP,	8),
+	DEFINE_SIZE(CHDR,	4+4+4),
 	DEFINE_SIZE(DYN,	4+4),
 	DEFINE_SIZE(EHDR,	16+2+2+4+4+4+4+4+2+2+2+2+2+2),
 	DEFINE_SIZE(HALF,	2),
@@ -215,6 +216,7 @@ static size_t sizes64[ELF_T_NUM] = {
 	DEFINE_SIZE(ADDR,	8),
 	DEFINE_SIZE(BYTE,	1),
 	DEFINE_SIZE(CAP,	16),
+	DEFINE_SIZE(CHDR,	4+4+8+8),
 	DEFINE_SIZE(DYN,	8+8),
 	DEFINE_SIZE(EHDR,	16+2+2+4+8+8+8+4+2+2+2+2+2+2),
 	DEFINE_SIZE(HALF,	2),
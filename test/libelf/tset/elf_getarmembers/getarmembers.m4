@@ -0,0 +1,432 @@
+/*-
+ * Copyright (c) 2026, Elftoolchain Project Contributors.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE AUTHOR AND CONTRIBUTORS ``AS IS'' AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED.  IN NO EVENT SHALL THE AUTHOR OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS
+ * OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY
+ * OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+ * SUCH DAMAGE.
+ *
+ * $Id$
+ */
+
+#include <sys/types.h>
+
+#include <libelf.h>
+#include <pthread.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+#include "elfts.h"
+#include "tet_api.h"
+
+IC_REQUIRES_VERSION_INIT();
+
+include(`elfts.m4')
+/*
+ * The following defines should match that in `./Makefile'.
+ */
+define(`TP_ARFILE_SVR4', `"a.ar"')
+define(`TP_ARFILE_BSD', `"a-bsd.ar"')
+
+/* This list of files must match the order of the files in test archive. */
+static char *rfn[] = {
+	"s1",
+	"a1.o",
+	"s------------------------2", /* long file name */
+	"a2.o",
+	"s 3"	/* file name with blanks */
+};
+
+#define	NMEMBERS	(sizeof(rfn) / sizeof(rfn[0]))
+
+/*
+ * A NULL `Elf' argument fails.
+ */
+void
+tcArgsNull(void)
+{
+	int error, result;
+	size_t n;
+
+	TP_CHECK_INITIALIZATION();
+
+	TP_ANNOUNCE("elf_getarmembers(NULL) and elf_openarmember(NULL) "
+	    "fail.");
+
+	result = TET_PASS;
+	n = ~(size_t) 0;
+	if (elf_getarmembers(NULL, &n) != NULL || n != 0 ||
+	    (error = elf_errno()) != ELF_E_ARGUMENT)
+		TP_FAIL("elf_getarmembers: n=%d error=%d \"%s\".", n, error,
+		    elf_errmsg(error));
+	else if (elf_openarmember(NULL, 0) != NULL ||
+	    (error = elf_errno()) != ELF_E_ARGUMENT)
+		TP_FAIL("elf_openarmember: error=%d \"%s\".", error,
+		    elf_errmsg(error));
+
+	tet_result(result);
+}
+
+/*
+ * Both functions fail on descriptors for non-archives.
+ */
+static char *nonar = "This is not an AR file.";
+
+void
+tcArgsNonAr(void)
+{
+	Elf *e;
+	int error, result;
+	size_t n;
+
+	TP_CHECK_INITIALIZATION();
+
+	TP_ANNOUNCE("elf_getarmembers(non-ar) and elf_openarmember(non-ar) "
+	    "fail.");
+
+	TS_OPEN_MEMORY(e, nonar);
+
+	result = TET_PASS;
+	n = ~(size_t) 0;
+	if (elf_getarmembers(e, &n) != NULL || n != 0 ||
+	    (error = elf_errno()) != ELF_E_ARGUMENT)
+		TP_FAIL("elf_getarmembers: n=%d error=%d \"%s\".", n, error,
+		    elf_errmsg(error));
+	else if (elf_openarmember(e, 0) != NULL ||
+	    (error = elf_errno()) != ELF_E_ARGUMENT)
+		TP_FAIL("elf_openarmember: error=%d \"%s\".", error,
+		    elf_errmsg(error));
+
+	(void) elf_end(e);
+
+	tet_result(result);
+}
+
+struct member_worker {
+	Elf		*mw_ar;
+	size_t		mw_ndx;
+	char		*mw_name;	/* name seen by the thread */
+	int		mw_error;
+};
+
+static void *
+member_worker(void *arg)
+{
+	Elf *e;
+	Elf_Arhdr *arh;
+	struct member_worker *mw;
+
+	mw = arg;
+	if ((e = elf_openarmember(mw->mw_ar, mw->mw_ndx)) == NULL ||
+	    (arh = elf_getarhdr(e)) == NULL)
+		mw->mw_error = elf_errno();
+	else
+		mw->mw_name = strdup(arh->ar_name);
+
+	(void) elf_end(e);
+
+	return (NULL);
+}
+
+#define	NCLOSE_ITERATIONS	256
+
+static void *
+end_worker(void *arg)
+{
+	(void) elf_end(arg);
+
+	return (NULL);
+}
+
+define(`ARCHIVE_TESTS',`
+/*
+ * The member table matches a traversal using elf_next().
+ */
+
+void
+tcArMembers$1(void)
+{
+	Elf *ar_e, *e;
+	Elf_Arhdr *arh;
+	Elf_Armember *am;
+	Elf_Cmd c;
+	int fd, result;
+	size_t n, nmembers, sz;
+
+	TP_CHECK_INITIALIZATION();
+
+	TP_ANNOUNCE("elf_getarmembers()/$1 describes all members.");
+
+	ar_e = e = NULL;
+	fd = -1;
+
+	TS_OPEN_FILE(ar_e, TP_ARFILE_$1, ELF_C_READ, fd);
+
+	result = TET_PASS;
+
+	if ((am = elf_getarmembers(ar_e, &nmembers)) == NULL ||
+	    nmembers != NMEMBERS) {
+		TP_FAIL("elf_getarmembers() failed: n=%d error=\"%s\".",
+		    nmembers, elf_errmsg(-1));
+		goto done;
+	}
+
+	c = ELF_C_READ;
+	for (n = 0; (e = elf_begin(fd, c, ar_e)) != NULL; n++) {
+		if (n >= nmembers) {
+			TP_FAIL("too few members in the table.");
+			goto done;
+		}
+
+		if ((arh = elf_getarhdr(e)) == NULL) {
+			TP_UNRESOLVED("elf_getarhdr() failed: \"%s\".",
+			    elf_errmsg(-1));
+			goto done;
+		}
+
+		if (strcmp(am[n].am_arhdr->ar_name, rfn[n]) != 0 ||
+		    strcmp(arh->ar_name, rfn[n]) != 0) {
+			TP_FAIL("member %d: name \"%s\" != \"%s\".", n,
+			    am[n].am_arhdr->ar_name, rfn[n]);
+			goto done;
+		}
+
+		if (elf_getbase(e) != am[n].am_dataoff ||
+		    elf_rawfile(e, &sz) == NULL || sz != am[n].am_size ||
+		    am[n].am_arhdr->ar_size != am[n].am_size) {
+			TP_FAIL("member %d: offset %jd size %d mismatch.", n,
+			    (intmax_t) am[n].am_dataoff, am[n].am_size);
+			goto done;
+		}
+
+		if (elf_rand(ar_e, am[n].am_off) != am[n].am_off) {
+			TP_FAIL("member %d: elf_rand(%jd) failed: \"%s\".",
+			    n, (intmax_t) am[n].am_off, elf_errmsg(-1));
+			goto done;
+		}
+
+		/* Continue the traversal from this member. */
+		c = elf_next(e);
+		(void) elf_end(e);
+		e = NULL;
+	}
+
+	if (n != nmembers)
+		TP_FAIL("n=%d != %d.", n, nmembers);
+
+ done:
+	if (e)
+		(void) elf_end(e);
+	if (ar_e)
+		(void) elf_end(ar_e);
+	if (fd != -1)
+		(void) close(fd);
+
+	tet_result(result);
+}
+
+/*
+ * elf_openarmember() opens members by index.
+ */
+
+void
+tcArOpenMember$1(void)
+{
+	Elf *ar_e, *e;
+	Elf_Arhdr *arh;
+	Elf_Armember *am;
+	int error, fd, result;
+	size_t n, nmembers;
+
+	TP_CHECK_INITIALIZATION();
+
+	TP_ANNOUNCE("elf_openarmember()/$1 opens the indexed member.");
+
+	ar_e = e = NULL;
+	fd = -1;
+
+	TS_OPEN_FILE(ar_e, TP_ARFILE_$1, ELF_C_READ, fd);
+
+	result = TET_PASS;
+
+	if ((am = elf_getarmembers(ar_e, &nmembers)) == NULL) {
+		TP_UNRESOLVED("elf_getarmembers() failed: \"%s\".",
+		    elf_errmsg(-1));
+		goto done;
+	}
+
+	/* Open the members in reverse order. */
+	for (n = nmembers; n > 0; n--) {
+		if ((e = elf_openarmember(ar_e, n - 1)) == NULL) {
+			TP_FAIL("elf_openarmember(%d) failed: \"%s\".", n - 1,
+			    elf_errmsg(-1));
+			goto done;
+		}
+
+		if ((arh = elf_getarhdr(e)) == NULL ||
+		    strcmp(arh->ar_name, rfn[n - 1]) != 0 ||
+		    elf_getbase(e) != am[n - 1].am_dataoff) {
+			TP_FAIL("member %d: mismatched descriptor.", n - 1);
+			goto done;
+		}
+
+		(void) elf_end(e);
+		e = NULL;
+	}
+
+	if ((e = elf_openarmember(ar_e, nmembers)) != NULL ||
+	    (error = elf_errno()) != ELF_E_ARGUMENT)
+		TP_FAIL("out of range index: error=%d \"%s\".", error,
+		    elf_errmsg(error));
+
+ done:
+	if (e)
+		(void) elf_end(e);
+	if (ar_e)
+		(void) elf_end(ar_e);
+	if (fd != -1)
+		(void) close(fd);
+
+	tet_result(result);
+}
+
+/*
+ * Distinct members may be opened concurrently.
+ */
+
+void
+tcArConcurrentMembers$1(void)
+{
+	Elf *ar_e;
+	pthread_t tid[NMEMBERS];
+	struct member_worker mw[NMEMBERS];
+	int fd, result;
+	size_t n, nthreads;
+
+	TP_CHECK_INITIALIZATION();
+
+	TP_ANNOUNCE("elf_openarmember()/$1 can be invoked concurrently "
+	    "on distinct members.");
+
+	nthreads = 0;
+	result = TET_UNRESOLVED;
+
+	TS_OPEN_FILE(ar_e, TP_ARFILE_$1, ELF_C_READ, fd);
+
+	(void) memset(mw, 0, sizeof(mw));
+	for (nthreads = 0; nthreads < NMEMBERS; nthreads++) {
+		mw[nthreads].mw_ar = ar_e;
+		mw[nthreads].mw_ndx = nthreads;
+		if (pthread_create(&tid[nthreads], NULL, member_worker,
+		    &mw[nthreads]) != 0) {
+			TP_UNRESOLVED("pthread_create() failed.");
+			goto done;
+		}
+	}
+
+	result = TET_PASS;
+
+done:
+	for (n = 0; n < nthreads; n++)
+		(void) pthread_join(tid[n], NULL);
+
+	for (n = 0; result == TET_PASS && n < nthreads; n++) {
+		if (mw[n].mw_error != ELF_E_NONE) {
+			TP_FAIL("member %d: error %d \"%s\".", n,
+			    mw[n].mw_error, elf_errmsg(mw[n].mw_error));
+			break;
+		}
+
+		if (strcmp(mw[n].mw_name, rfn[n]) != 0) {
+			TP_FAIL("member %d: name \"%s\" != \"%s\".", n,
+			    mw[n].mw_name, rfn[n]);
+			break;
+		}
+	}
+
+	for (n = 0; n < nthreads; n++)
+		free(mw[n].mw_name);
+
+	(void) elf_end(ar_e);
+	(void) close(fd);
+
+	tet_result(result);
+}
+
+/*
+ * An archive and its last open member may be closed concurrently.
+ */
+
+void
+tcArConcurrentEnd$1(void)
+{
+	Elf *ar_e, *e;
+	pthread_t tid;
+	int fd, result;
+	size_t n;
+
+	TP_CHECK_INITIALIZATION();
+
+	TP_ANNOUNCE("elf_end()/$1 on an archive and its last member "
+	    "can be invoked concurrently.");
+
+	ar_e = NULL;
+	fd = -1;
+	result = TET_UNRESOLVED;
+
+	_TS_OPEN_FILE(ar_e, TP_ARFILE_$1, ELF_C_READ, fd, goto done;);
+	(void) elf_end(ar_e);
+	ar_e = NULL;
+
+	for (n = 0; n < NCLOSE_ITERATIONS; n++) {
+		if ((ar_e = elf_begin(fd, ELF_C_READ, NULL)) == NULL ||
+		    (e = elf_openarmember(ar_e, n % NMEMBERS)) == NULL) {
+			TP_UNRESOLVED("iteration %d: \"%s\".", n,
+			    elf_errmsg(-1));
+			goto done;
+		}
+
+		if (pthread_create(&tid, NULL, end_worker, e) != 0) {
+			TP_UNRESOLVED("pthread_create() failed.");
+			(void) elf_end(e);
+			goto done;
+		}
+
+		(void) elf_end(ar_e);
+		ar_e = NULL;
+		(void) pthread_join(tid, NULL);
+	}
+
+	result = TET_PASS;
+
+ done:
+	if (ar_e)
+		(void) elf_end(ar_e);
+	if (fd != -1)
+		(void) close(fd);
+
+	tet_result(result);
+}
+')
+
+ARCHIVE_TESTS(`SVR4')
+ARCHIVE_TESTS(`BSD')
@@ -74,10 +74,46 @@ tcArgsNull(void)
 	tet_result(result);
 }
 
+static char *nonar = "This is not an AR file.";
+
+/*
+ * elf_arsym_lookup() with a NULL `Elf' or name argument fails.
+ */
+void
+tcArgsLookupNull(void)
+{
+	Elf *e;
+	int error, result;
+	size_t n;
+
+	TP_CHECK_INITIALIZATION();
+
+	TP_ANNOUNCE("elf_arsym_lookup(NULL) fails.");
+
+	result = TET_PASS;
+	n = ~(size_t) 0;
+	if (elf_arsym_lookup(NULL, "a1", &n) != NULL ||
+	    (n != (size_t) 0) || (error = elf_errno()) != ELF_E_ARGUMENT) {
+		TP_FAIL("n=%d error=%d \"%s\".", n, error, elf_errmsg(error));
+		goto done;
+	}
+
+	TS_OPEN_MEMORY(e, nonar);
+
+	n = ~(size_t) 0;
+	if (elf_arsym_lookup(e, "a1", &n) != NULL ||
+	    (n != (size_t) 0) || (error = elf_errno()) != ELF_E_ARGUMENT)
+		TP_FAIL("n=%d error=%d \"%s\".", n, error, elf_errmsg(error));
+
+	(void) elf_end(e);
+
+ done:
+	tet_result(result);
+}
+
 /*
  * elf_getarsym() on a non-Ar file fails.
  */
-static char *nonar = "This is not an AR file.";
 
 void
 tcArgsNonAr(void)
@@ -357,6 +393,114 @@ tcArArSym$1(void)
 	tet_result(result);
 
 }
+
+/*
+ * elf_arsym_lookup() finds the archive member defining a symbol.
+ */
+
+void
+tcArLookup$1(void)
+{
+	Elf_Arhdr *arh;
+	Elf *ar_e, *e;
+	off_t *off;
+	int fd, result;
+	struct refsym *r;
+	size_t n;
+
+	TP_CHECK_INITIALIZATION();
+
+	TP_ANNOUNCE("elf_arsym_lookup()/$1 returns the defining members.");
+
+	ar_e = e = NULL;
+	fd = -1;
+
+	TS_OPEN_FILE(ar_e, TP_ARFILE_$1, ELF_C_READ, fd);
+
+	result = TET_PASS;
+
+	for (r = refsym; r->as_name; r++) {
+		n = ~ (size_t) 0;
+		if ((off = elf_arsym_lookup(ar_e, r->as_name, &n)) == NULL ||
+		    n != 1) {
+			TP_FAIL("\"%s\": n=%d error=\"%s\".", r->as_name,
+			    n, elf_errmsg(-1));
+			goto done;
+		}
+
+		if (elf_rand(ar_e, *off) != *off) {
+			TP_FAIL("elf_rand(%jd) failed: \"%s\".",
+			    (intmax_t) *off, elf_errmsg(-1));
+			goto done;
+		}
+
+		if ((e = elf_begin(fd, ELF_C_READ, ar_e)) == NULL) {
+			TP_UNRESOLVED("elf_begin() failed: \"%s\".",
+			    elf_errmsg(-1));
+			goto done;
+		}
+
+		if ((arh = elf_getarhdr(e)) == NULL) {
+			TP_UNRESOLVED("elf_getarhdr() failed: \"%s\".",
+			    elf_errmsg(-1));
+			goto done;
+		}
+
+		if (strcmp(arh->ar_name, r->as_object) != 0) {
+			TP_FAIL("object-name \"%s\" != ref \"%s\".",
+			    arh->ar_name, r->as_object);
+			goto done;
+		}
+
+		(void) elf_end(e);
+		e = NULL;
+	}
+
+	/* Names absent from the symbol table are not found. */
+	n = ~ (size_t) 0;
+	if ((off = elf_arsym_lookup(ar_e, "a3", &n)) != NULL || n != 0)
+		TP_FAIL("\"a3\": off=%p n=%d.", (void *) off, n);
+
+ done:
+	if (e)
+		(void) elf_end(e);
+	if (ar_e)
+		(void) elf_end(ar_e);
+	if (fd != -1)
+		(void) close(fd);
+
+	tet_result(result);
+}
+
+/*
+ * elf_arsym_lookup() on an ar archive without a symbol table fails.
+ */
+
+void
+tcArLookupNoSymtab$1(void)
+{
+	Elf *e;
+	off_t *off;
+	int error, fd, result;
+	size_t n;
+
+	TP_CHECK_INITIALIZATION();
+
+	TP_ANNOUNCE("elf_arsym_lookup(ar-with-no-symtab)/$1 fails.");
+
+	TS_OPEN_FILE(e, TP_ARFILE_NOSYMTAB_$1, ELF_C_READ, fd);
+
+	result = TET_PASS;
+	n = ~ (size_t) 0;
+	if ((off = elf_arsym_lookup(e, "a1", &n)) != NULL || n != 0 ||
+	    (error = elf_errno()) != ELF_E_ARCHIVE)
+		TP_FAIL("off=%p n=%d error=%d.", (void *) off, n, error);
+
+	(void) elf_end(e);
+	(void) close(fd);
+
+	tet_result(result);
+}
 ')
 
 ARCHIVE_TESTS(`SVR4')
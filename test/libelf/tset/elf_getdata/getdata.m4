@@ -26,8 +26,11 @@
  * $Id$
  */
 
+#include <errno.h>
 #include <libelf.h>
 #include <gelf.h>
+#include <pthread.h>
+#include <stdlib.h>
 #include <string.h>
 #include <unistd.h>
 
@@ -241,6 +244,85 @@ _FN(lsb,64)
 _FN(msb,32)
 _FN(msb,64)
 
+/*
+ * Verify where the data for a section that needs no translation is
+ * placed, and that modifying it leaves the underlying file alone.
+ *
+ * Objects opened with ELF_C_READ are mapped read-only, so their data
+ * is copied out of the file image.  With ELF_C_RDWR and
+ * ELF_C_READ_MMAP, the data is handed out in place.
+ */
+undefine(`_FN')
+define(`_FN',`
+void
+tcDataPlacement$1(void)
+{
+	int error, fd, result;
+	size_t rawsz, shstrndx;
+	const char *srcfile = "zerosection.lsb64";
+	char *p, *raw, *tfn;
+	Elf_Scn *scn;
+	Elf_Data *ed;
+	Elf *e;
+
+	fd = -1;
+	e = NULL;
+	tfn = NULL;
+	result = TET_UNRESOLVED;
+
+	TP_ANNOUNCE("data for a section is placed correctly with "
+	    "ELF_C_$1.");
+
+	if ((tfn = elfts_copy_file(srcfile, &error)) == NULL) {
+		TP_UNRESOLVED("elfts_copy_file(%s) failed: \"%s\".",
+		    srcfile, strerror(error));
+		goto done;
+	}
+
+	_TS_OPEN_FILE(e, tfn, ELF_C_$1, fd, goto done;);
+
+	if ((raw = elf_rawfile(e, &rawsz)) == NULL ||
+	    elf_getshdrstrndx(e, &shstrndx) != 0 ||
+	    (scn = elf_getscn(e, shstrndx)) == NULL ||
+	    (ed = elf_getdata(scn, NULL)) == NULL) {
+		TP_UNRESOLVED("Cannot retrieve the string table: \"%s\".",
+		    elf_errmsg(-1));
+		goto done;
+	}
+
+	p = ed->d_buf;
+	if ((p >= raw && p < raw + rawsz) != $2) {
+		TP_FAIL("d_buf %p is ifelse($2,1,`not ')in the file image "
+		    "at %p, size %zu.", p, raw, rawsz);
+		goto done;
+	}
+
+ifelse($1,`READ_MMAP',`',`
+	/* The application may write to the returned data. */
+	(void) memset(ed->d_buf, 0xFF, ed->d_size);
+')
+	(void) elf_end(e);
+	e = NULL;
+	(void) close(fd);
+	fd = -1;
+
+	result = elfts_compare_files(srcfile, tfn);
+
+done:
+	if (e)
+		(void) elf_end(e);
+	if (fd != -1)
+		(void) close(fd);
+	if (tfn != NULL)
+		(void) unlink(tfn);
+	tet_result(result);
+}
+')
+
+_FN(`READ',0)
+_FN(`READ_MMAP',1)
+_FN(`RDWR',1)
+
 static const char new_content[] = {
 changequote({,})
 	'n', 'e', 'w', ' ', 'c', 'o', 'n', 't', 'e', 'n', 't', '\0'
@@ -349,3 +431,450 @@ _FN(lsb,32)
 _FN(lsb,64)
 _FN(msb,32)
 _FN(msb,64)
+
+/*
+ * Verify that elf_getdata() and elf_rawdata() may be invoked
+ * concurrently on distinct sections of a descriptor opened for
+ * reading.
+ */
+
+#define	NSCN_MAX	16
+
+struct scn_worker {
+	Elf_Scn		*sw_scn;
+	Elf_Data	*sw_data;
+	Elf_Data	*sw_rawdata;
+	int		sw_error;
+};
+
+static void *
+scn_worker(void *arg)
+{
+	struct scn_worker *sw;
+
+	sw = arg;
+	if ((sw->sw_data = elf_getdata(sw->sw_scn, NULL)) == NULL ||
+	    (sw->sw_rawdata = elf_rawdata(sw->sw_scn, NULL)) == NULL)
+		sw->sw_error = elf_errno();
+
+	return (NULL);
+}
+
+undefine(`_FN')
+define(`_FN',`
+void
+tcConcurrentSections$1$2(void)
+{
+	Elf *e, *e2;
+	Elf_Data *ed;
+	Elf_Scn *scn;
+	pthread_t tid[NSCN_MAX];
+	struct scn_worker sw[NSCN_MAX];
+	size_t i, nscn, nthreads;
+	int fd, fd2, result;
+
+	e = e2 = NULL;
+	fd = fd2 = -1;
+	nthreads = 0;
+	result = TET_UNRESOLVED;
+
+	TP_ANNOUNCE("elf_getdata() and elf_rawdata() can be invoked "
+	    "concurrently on distinct sections.");
+
+	_TS_OPEN_FILE(e, "multiscn.$1$2", ELF_C_READ, fd, goto done;);
+	_TS_OPEN_FILE(e2, "multiscn.$1$2", ELF_C_READ, fd2, goto done;);
+
+	if (elf_getshdrnum(e, &nscn) != 0 || nscn > NSCN_MAX) {
+		TP_UNRESOLVED("elf_getshdrnum() failed: \"%s\".",
+		    elf_errmsg(-1));
+		goto done;
+	}
+
+	(void) memset(sw, 0, sizeof(sw));
+	for (i = 1; i < nscn; i++)
+		if ((sw[i].sw_scn = elf_getscn(e, i)) == NULL) {
+			TP_UNRESOLVED("elf_getscn(%d) failed: \"%s\".",
+			    (int) i, elf_errmsg(-1));
+			goto done;
+		}
+
+	for (nthreads = 1; nthreads < nscn; nthreads++)
+		if (pthread_create(&tid[nthreads], NULL, scn_worker,
+		    &sw[nthreads]) != 0) {
+			TP_UNRESOLVED("pthread_create() failed.");
+			goto done;
+		}
+
+	result = TET_PASS;
+
+done:
+	for (i = 1; i < nthreads; i++)
+		(void) pthread_join(tid[i], NULL);
+
+	for (i = 1; result == TET_PASS && i < nthreads; i++) {
+		if (sw[i].sw_error != ELF_E_NONE) {
+			TP_FAIL("section %d: error %d \"%s\".", (int) i,
+			    sw[i].sw_error, elf_errmsg(sw[i].sw_error));
+			break;
+		}
+
+		/* Compare against a serially retrieved descriptor. */
+		if ((scn = elf_getscn(e2, i)) == NULL ||
+		    (ed = elf_getdata(scn, NULL)) == NULL) {
+			TP_UNRESOLVED("section %d: elf_getdata() failed: "
+			    "\"%s\".", (int) i, elf_errmsg(-1));
+			break;
+		}
+
+		if (ed->d_type != sw[i].sw_data->d_type ||
+		    ed->d_size != sw[i].sw_data->d_size ||
+		    (ed->d_buf == NULL) != (sw[i].sw_data->d_buf == NULL) ||
+		    (ed->d_buf != NULL && memcmp(ed->d_buf,
+		    sw[i].sw_data->d_buf, ed->d_size) != 0)) {
+			TP_FAIL("section %d: data mismatch.", (int) i);
+			break;
+		}
+
+		if (sw[i].sw_rawdata->d_type != ELF_T_BYTE) {
+			TP_FAIL("section %d: illegal raw data type %d.",
+			    (int) i, (int) sw[i].sw_rawdata->d_type);
+			break;
+		}
+	}
+
+	if (e)
+		elf_end(e);
+	if (e2)
+		elf_end(e2);
+	if (fd != -1)
+		(void) close(fd);
+	if (fd2 != -1)
+		(void) close(fd2);
+	tet_result(result);
+}')
+
+_FN(lsb,32)
+_FN(lsb,64)
+_FN(msb,32)
+_FN(msb,64)
+
+/*
+ * Verify that objects that are read in on demand, because the
+ * LIBELF_NOMMAP environment variable prevents them from being mapped
+ * in, return the same section data as mapped objects.
+ */
+
+undefine(`_FN')
+define(`_FN',`
+void
+tcLazyData$1$2(void)
+{
+	Elf *e, *e2;
+	Elf_Data *d, *d2;
+	Elf_Scn *scn, *scn2;
+	size_t i, nscn;
+	int fd, fd2, raw, result;
+
+	e = e2 = NULL;
+	fd = fd2 = -1;
+	result = TET_UNRESOLVED;
+
+	TP_ANNOUNCE("elf_getdata() and elf_rawdata() return the same "
+	    "data for objects read in on demand.");
+
+	_TS_OPEN_FILE(e, "multiscn.$1$2", ELF_C_READ, fd, goto done;);
+
+	(void) setenv("LIBELF_NOMMAP", "1", 1);
+	e2 = elfts_open_file("multiscn.$1$2", ELF_C_READ, &fd2);
+	(void) unsetenv("LIBELF_NOMMAP");
+	if (e2 == NULL)
+		goto done;
+
+	if (elf_getshdrnum(e, &nscn) != 0) {
+		TP_UNRESOLVED("elf_getshdrnum() failed: \"%s\".",
+		    elf_errmsg(-1));
+		goto done;
+	}
+
+	result = TET_PASS;
+
+	for (i = 1; i < nscn; i++) {
+		if ((scn = elf_getscn(e, i)) == NULL ||
+		    (scn2 = elf_getscn(e2, i)) == NULL) {
+			TP_FAIL("section %d: elf_getscn() failed: \"%s\".",
+			    (int) i, elf_errmsg(-1));
+			break;
+		}
+
+		for (raw = 0; raw < 2; raw++) {
+			d = raw ? elf_rawdata(scn, NULL) :
+			    elf_getdata(scn, NULL);
+			d2 = raw ? elf_rawdata(scn2, NULL) :
+			    elf_getdata(scn2, NULL);
+			if (d == NULL || d2 == NULL) {
+				TP_FAIL("section %d raw %d: \"%s\".", (int) i,
+				    raw, elf_errmsg(-1));
+				goto done;
+			}
+
+			if (d->d_type != d2->d_type ||
+			    d->d_size != d2->d_size ||
+			    (d->d_buf == NULL) != (d2->d_buf == NULL) ||
+			    (d->d_buf != NULL && memcmp(d->d_buf, d2->d_buf,
+			    d->d_size) != 0)) {
+				TP_FAIL("section %d raw %d: data mismatch.",
+				    (int) i, raw);
+				goto done;
+			}
+		}
+	}
+
+ done:
+	if (e)
+		elf_end(e);
+	if (e2)
+		elf_end(e2);
+	if (fd != -1)
+		(void) close(fd);
+	if (fd2 != -1)
+		(void) close(fd2);
+	tet_result(result);
+}')
+
+_FN(lsb,32)
+_FN(lsb,64)
+_FN(msb,32)
+_FN(msb,64)
+
+/*
+ * Verify that a short read of section contents for an object read in
+ * on demand is reported as ELF_E_IO.
+ */
+
+undefine(`_FN')
+define(`_FN',`
+void
+tcLazyShortRead$1$2(void)
+{
+	Elf *e;
+	Elf_Data *d;
+	Elf_Scn *scn;
+	GElf_Shdr sh;
+	size_t i, nscn;
+	int error, fd, result;
+	char *fn;
+
+	e = NULL;
+	fd = -1;
+	fn = NULL;
+	result = TET_UNRESOLVED;
+
+	TP_ANNOUNCE("a truncated object read in on demand is "
+	    "reported as ELF_E_IO.");
+
+	if ((fn = elfts_copy_file("multiscn.$1$2", &error)) == NULL) {
+		TP_UNRESOLVED("elfts_copy_file() failed: \"%s\".",
+		    strerror(error));
+		goto done;
+	}
+
+	(void) setenv("LIBELF_NOMMAP", "1", 1);
+	e = elfts_open_file(fn, ELF_C_READ, &fd);
+	(void) unsetenv("LIBELF_NOMMAP");
+	if (e == NULL)
+		goto done;
+
+	/* Read in the section headers before truncating the file. */
+	if (elf_getshdrnum(e, &nscn) != 0 || nscn < 3) {
+		TP_UNRESOLVED("elf_getshdrnum() failed: \"%s\".",
+		    elf_errmsg(-1));
+		goto done;
+	}
+
+	for (i = 1; i < nscn; i++)
+		if ((scn = elf_getscn(e, i)) == NULL ||
+		    gelf_getshdr(scn, &sh) == NULL) {
+			TP_UNRESOLVED("section %d: \"%s\".", (int) i,
+			    elf_errmsg(-1));
+			goto done;
+		}
+
+	if (truncate(fn, (off_t) EI_NIDENT) < 0) {
+		TP_UNRESOLVED("truncate() failed: \"%s\".", strerror(errno));
+		goto done;
+	}
+
+	result = TET_PASS;
+
+	if ((scn = elf_getscn(e, 1)) == NULL ||
+	    (d = elf_getdata(scn, NULL)) != NULL ||
+	    (error = elf_errno()) != ELF_E_IO) {
+		TP_FAIL("elf_getdata() error %d \"%s\".", error,
+		    elf_errmsg(error));
+		goto done;
+	}
+
+	if ((scn = elf_getscn(e, 2)) == NULL ||
+	    (d = elf_rawdata(scn, NULL)) != NULL ||
+	    (error = elf_errno()) != ELF_E_IO)
+		TP_FAIL("elf_rawdata() error %d \"%s\".", error,
+		    elf_errmsg(error));
+
+ done:
+	if (e)
+		elf_end(e);
+	if (fd != -1)
+		(void) close(fd);
+	if (fn != NULL) {
+		(void) unlink(fn);
+		free(fn);
+	}
+	tet_result(result);
+}')
+
+_FN(lsb,32)
+_FN(lsb,64)
+_FN(msb,32)
+_FN(msb,64)
+
+/*
+ * Verify that the data descriptors handed out to threads retrieving
+ * distinct sections concurrently are distinct, over many rounds.
+ */
+
+#define	NROUNDS		256
+
+static pthread_mutex_t gate_mutex = PTHREAD_MUTEX_INITIALIZER;
+static pthread_cond_t gate_cond = PTHREAD_COND_INITIALIZER;
+static int gate_open;
+
+static void *
+gated_scn_worker(void *arg)
+{
+	(void) pthread_mutex_lock(&gate_mutex);
+	while (!gate_open)
+		(void) pthread_cond_wait(&gate_cond, &gate_mutex);
+	(void) pthread_mutex_unlock(&gate_mutex);
+
+	return (scn_worker(arg));
+}
+
+undefine(`_FN')
+define(`_FN',`
+void
+tcConcurrentDescriptors$1$2(void)
+{
+	Elf *e;
+	Elf_Data *d;
+	pthread_t tid[NSCN_MAX];
+	struct scn_worker sw[NSCN_MAX];
+	size_t i, j, nscn, nthreads;
+	int fd, result, round;
+
+	e = NULL;
+	fd = -1;
+	nthreads = 0;
+	result = TET_UNRESOLVED;
+
+	TP_ANNOUNCE("concurrent calls to elf_getdata() and elf_rawdata() "
+	    "return distinct descriptors.");
+
+	for (round = 0; round < NROUNDS; round++) {
+		_TS_OPEN_FILE(e, "multiscn.$1$2", ELF_C_READ, fd, goto done;);
+
+		if (elf_getshdrnum(e, &nscn) != 0 || nscn > NSCN_MAX) {
+			TP_UNRESOLVED("elf_getshdrnum() failed: \"%s\".",
+			    elf_errmsg(-1));
+			goto done;
+		}
+
+		(void) memset(sw, 0, sizeof(sw));
+		for (i = 1; i < nscn; i++)
+			if ((sw[i].sw_scn = elf_getscn(e, i)) == NULL) {
+				TP_UNRESOLVED("elf_getscn(%d) failed: "
+				    "\"%s\".", (int) i, elf_errmsg(-1));
+				goto done;
+			}
+
+		gate_open = 0;
+		for (nthreads = 1; nthreads < nscn; nthreads++)
+			if (pthread_create(&tid[nthreads], NULL,
+			    gated_scn_worker, &sw[nthreads]) != 0) {
+				TP_UNRESOLVED("pthread_create() failed.");
+				goto done;
+			}
+
+		(void) pthread_mutex_lock(&gate_mutex);
+		gate_open = 1;
+		(void) pthread_cond_broadcast(&gate_cond);
+		(void) pthread_mutex_unlock(&gate_mutex);
+
+		for (i = 1; i < nthreads; i++)
+			(void) pthread_join(tid[i], NULL);
+		nthreads = 0;
+
+		for (i = 1; i < nscn; i++) {
+			if (sw[i].sw_error != ELF_E_NONE) {
+				TP_FAIL("round %d section %d: error %d "
+				    "\"%s\".", round, (int) i,
+				    sw[i].sw_error,
+				    elf_errmsg(sw[i].sw_error));
+				goto done;
+			}
+
+			if (sw[i].sw_data == sw[i].sw_rawdata ||
+			    sw[i].sw_rawdata->d_type != ELF_T_BYTE) {
+				TP_FAIL("round %d section %d: descriptors "
+				    "overlap.", round, (int) i);
+				goto done;
+			}
+
+			for (j = 1; j < i; j++)
+				if (sw[j].sw_data == sw[i].sw_data ||
+				    sw[j].sw_data == sw[i].sw_rawdata ||
+				    sw[j].sw_rawdata == sw[i].sw_data ||
+				    sw[j].sw_rawdata == sw[i].sw_rawdata) {
+					TP_FAIL("round %d: sections %d and "
+					    "%d share a descriptor.", round,
+					    (int) j, (int) i);
+					goto done;
+				}
+
+			/* The descriptors are those cached by the section. */
+			if ((d = elf_getdata(sw[i].sw_scn, NULL)) !=
+			    sw[i].sw_data ||
+			    elf_getdata(sw[i].sw_scn, d) != NULL ||
+			    (d = elf_rawdata(sw[i].sw_scn, NULL)) !=
+			    sw[i].sw_rawdata) {
+				TP_FAIL("round %d section %d: descriptor "
+				    "mismatch.", round, (int) i);
+				goto done;
+			}
+		}
+
+		(void) elf_end(e);
+		(void) close(fd);
+		e = NULL;
+		fd = -1;
+	}
+
+	result = TET_PASS;
+
+done:
+	(void) pthread_mutex_lock(&gate_mutex);
+	gate_open = 1;
+	(void) pthread_cond_broadcast(&gate_cond);
+	(void) pthread_mutex_unlock(&gate_mutex);
+	for (i = 1; i < nthreads; i++)
+		(void) pthread_join(tid[i], NULL);
+	if (e)
+		elf_end(e);
+	if (fd != -1)
+		(void) close(fd);
+	tet_result(result);
+}')
+
+_FN(lsb,32)
+_FN(lsb,64)
+_FN(msb,32)
+_FN(msb,64)
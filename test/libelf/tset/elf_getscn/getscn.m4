@@ -311,3 +311,70 @@ FN(32,`lsb')
 FN(32,`msb')
 FN(64,`lsb')
 FN(64,`msb')
+
+/*
+ * elf_getscn() retrieves sections added by elf_newscn().
+ */
+
+#define	NEWSCN_COUNT	100
+
+undefine(`FN')
+define(`FN',`
+void
+tcNewScn$1$2(void)
+{
+	Elf *e;
+	int fd, result;
+	Elf_Scn *scn[NEWSCN_COUNT], *s;
+	size_t i, n, r;
+
+	TP_CHECK_INITIALIZATION();
+
+	TP_ANNOUNCE("TOUPPER($2)$1: elf_getscn() retrieves sections "
+	    "added by elf_newscn().");
+
+	e = NULL;
+	fd = -1;
+	result = TET_UNRESOLVED;
+
+	_TS_OPEN_FILE(e, "newscn.$2$1", ELF_C_READ, fd, goto done;);
+
+	if (elf_getshnum(e, &n) == 0) {
+		TP_UNRESOLVED("elf_getshnum() failed.");
+		goto done;
+	}
+
+	for (i = 0; i < NEWSCN_COUNT; i++)
+		if ((scn[i] = elf_newscn(e)) == NULL) {
+			TP_UNRESOLVED("elf_newscn() failed: \"%s\".",
+			    elf_errmsg(-1));
+			goto done;
+		}
+
+	result = TET_PASS;
+
+	for (i = 0; i < NEWSCN_COUNT; i++) {
+		if ((s = elf_getscn(e, n + i)) != scn[i]) {
+			TP_FAIL("scn[%d]=%p != %p \"%s\".", i, (void *) s,
+			    (void *) scn[i], elf_errmsg(-1));
+			break;
+		}
+		if ((r = elf_ndxscn(s)) != n + i) {
+			TP_FAIL("scn=%p ndx %d != %d.", (void *) s, r, n + i);
+			break;
+		}
+	}
+
+ done:
+	if (e)
+		(void) elf_end(e);
+	if (fd != -1)
+		(void) close(fd);
+
+	tet_result(result);
+}')
+
+FN(32,`lsb')
+FN(32,`msb')
+FN(64,`lsb')
+FN(64,`msb')
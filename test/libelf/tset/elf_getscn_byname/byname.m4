@@ -0,0 +1,372 @@
+/*-
+ * Copyright (c) 2026, Elftoolchain Project Contributors.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE AUTHOR AND CONTRIBUTORS ``AS IS'' AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED.  IN NO EVENT SHALL THE AUTHOR OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS
+ * OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY
+ * OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+ * SUCH DAMAGE.
+ *
+ * $Id$
+ */
+
+
+#include <sys/types.h>
+
+#include <gelf.h>
+#include <libelf.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+#include <unistd.h>
+
+#include "elfts.h"
+#include "tet_api.h"
+
+IC_REQUIRES_VERSION_INIT();
+
+include(`elfts.m4')
+
+/*
+ * Tests for the `elf_getscn_byname' and `elf_nextscn_byname' APIs.
+ *
+ * The test objects have TS_NSCN sections.  Every TS_DUPSTEP'th section
+ * is named TS_DUPNAME, the others are named "secN" where N is the
+ * section index.  The last section is the section name string table,
+ * which also holds the unused name TS_EXTRANAME.
+ */
+
+#define	TS_NSCN		100
+#define	TS_DUPSTEP	7
+#define	TS_DUPNAME	".dup"
+#define	TS_EXTRANAME	".extra"
+#define	TS_NAMESZ	16
+
+static char names[TS_NSCN][TS_NAMESZ];
+static char strtab[TS_NSCN * TS_NAMESZ];
+static size_t nameoff[TS_NSCN];
+static size_t extra;		/* offset of TS_EXTRANAME */
+static size_t strtabsz;
+
+/*
+ * Lay out the section names and the string table holding them.
+ */
+static void
+make_names(void)
+{
+	size_t i, off;
+
+	for (i = 1; i < TS_NSCN - 1; i++) {
+		if (i % TS_DUPSTEP == 0)
+			(void) strcpy(names[i], TS_DUPNAME);
+		else
+			(void) snprintf(names[i], TS_NAMESZ, "sec%zu", i);
+	}
+	(void) strcpy(names[TS_NSCN - 1], ".shstrtab");
+
+	(void) memset(strtab, 0, sizeof(strtab));
+	for (i = 1, off = 1; i < TS_NSCN; i++) {
+		nameoff[i] = off;
+		(void) strcpy(strtab + off, names[i]);
+		off += strlen(names[i]) + 1;
+	}
+
+	extra = off;
+	(void) strcpy(strtab + off, TS_EXTRANAME);
+	strtabsz = off + sizeof(TS_EXTRANAME);
+}
+
+/*
+ * Add the sections of the test object to descriptor `e', and make the
+ * last one the section name string table if `*(int *) arg' is set.
+ */
+static int
+add_sections(Elf *e, void *arg)
+{
+	size_t i;
+	GElf_Shdr sh;
+
+	make_names();
+
+	for (i = 1; i < TS_NSCN; i++) {
+		(void) memset(&sh, 0, sizeof(sh));
+		sh.sh_name = (uint32_t) nameoff[i];
+		sh.sh_type = i == TS_NSCN - 1 ? SHT_STRTAB : SHT_PROGBITS;
+		if (elfts_new_section(e, &sh, ELF_T_BYTE,
+		    i == TS_NSCN - 1 ? strtab : NULL, strtabsz) == NULL)
+			return (-1);
+	}
+
+	if (*(int *) arg && elf_setshstrndx(e, TS_NSCN - 1) == 0) {
+		tet_printf("U: cannot create file: \"%s\".", elf_errmsg(-1));
+		return (-1);
+	}
+
+	return (0);
+}
+
+/*
+ * Create TS_NEWFILE with the test sections.
+ */
+static int
+make_file(int ec, int ed, int setstrndx)
+{
+	return (elfts_make_file(TS_NEWFILE, ec, ed, ET_NONE, add_sections,
+	    &setstrndx));
+}
+
+/*
+ * Invalid arguments are rejected.
+ */
+void
+tcArgsInvalid(void)
+{
+	int error, fd, result;
+	Elf *e, *e2;
+	Elf_Scn *scn;
+	char image[16];
+
+	TP_CHECK_INITIALIZATION();
+
+	TP_ANNOUNCE("invalid arguments are rejected.");
+
+	result = TET_PASS;
+
+	(void) memset(image, 0, sizeof(image));
+	if ((e = elf_memory(image, sizeof(image))) == NULL) {
+		TP_UNRESOLVED("elf_memory() failed: \"%s\".", elf_errmsg(-1));
+		goto done;
+	}
+
+	if (elf_getscn_byname(NULL, "sec1") != NULL ||
+	    (error = elf_errno()) != ELF_E_ARGUMENT)
+		TP_FAIL("elf=NULL: error=%d.", error);
+	else if (elf_getscn_byname(e, "sec1") != NULL ||
+	    (error = elf_errno()) != ELF_E_ARGUMENT)
+		TP_FAIL("non-ELF descriptor: error=%d.", error);
+
+	(void) elf_end(e);
+
+	if (result != TET_PASS ||
+	    make_file(ELFCLASS64, ELFDATA2LSB, 1) < 0)
+		goto done;
+
+	if ((e = elfts_open_file(TS_NEWFILE, ELF_C_READ, &fd)) == NULL) {
+		result = TET_UNRESOLVED;
+		goto done;
+	}
+	if ((e2 = elf_begin(fd, ELF_C_READ, NULL)) == NULL) {
+		TP_UNRESOLVED("elf_begin() failed: \"%s\".", elf_errmsg(-1));
+		(void) elf_end(e);
+		(void) close(fd);
+		goto done;
+	}
+
+	if (elf_getscn_byname(e, NULL) != NULL ||
+	    (error = elf_errno()) != ELF_E_ARGUMENT)
+		TP_FAIL("name=NULL: error=%d.", error);
+	else if (elf_nextscn_byname(e, NULL) != NULL ||
+	    (error = elf_errno()) != ELF_E_ARGUMENT)
+		TP_FAIL("scn=NULL: error=%d.", error);
+	else if ((scn = elf_getscn_byname(e2, TS_DUPNAME)) == NULL)
+		TP_UNRESOLVED("lookup failed: \"%s\".", elf_errmsg(-1));
+	else if (elf_nextscn_byname(e, scn) != NULL ||
+	    (error = elf_errno()) != ELF_E_ARGUMENT)
+		TP_FAIL("foreign scn: error=%d.", error);
+
+	(void) elf_end(e2);
+	(void) elf_end(e);
+	(void) close(fd);
+
+ done:
+	(void) unlink(TS_NEWFILE);
+	tet_result(result);
+}
+
+/*
+ * Lookups in an object without a section name string table fail
+ * without setting an error.
+ */
+void
+tcNoShstrtab(void)
+{
+	int error, fd, result;
+	Elf *e;
+
+	TP_CHECK_INITIALIZATION();
+
+	TP_ANNOUNCE("objects without a section name string table are "
+	    "handled.");
+
+	if (make_file(ELFCLASS64, ELFDATA2LSB, 0) < 0 ||
+	    (e = elfts_open_file(TS_NEWFILE, ELF_C_READ, &fd)) == NULL) {
+		tet_result(TET_UNRESOLVED);
+		return;
+	}
+
+	result = TET_PASS;
+	(void) elf_errno();
+	if (elf_getscn_byname(e, "sec1") != NULL ||
+	    (error = elf_errno()) != ELF_E_NONE)
+		TP_FAIL("error=%d.", error);
+
+	(void) elf_end(e);
+	(void) close(fd);
+	(void) unlink(TS_NEWFILE);
+	tet_result(result);
+}
+
+/*
+ * Every section is found by name, duplicates are returned in
+ * ascending order, and unknown names are not found.
+ *
+ * Arguments: class, byte order.
+ */
+define(`FN',`
+void
+tcLookup$1`'TOUPPER($2)(void)
+{
+	int error, fd, result;
+	size_t i, ndx;
+	Elf *e;
+	Elf_Scn *scn;
+
+	TP_CHECK_INITIALIZATION();
+
+	TP_ANNOUNCE("TOUPPER($2)$1: lookups succeed.");
+
+	if (make_file(ELFCLASS$1, ELFDATA2`'TOUPPER($2), 1) < 0 ||
+	    (e = elfts_open_file(TS_NEWFILE, ELF_C_READ, &fd)) == NULL) {
+		tet_result(TET_UNRESOLVED);
+		return;
+	}
+
+	result = TET_PASS;
+	(void) elf_errno();
+
+	for (i = 1; i < TS_NSCN; i++) {
+		if (i % TS_DUPSTEP == 0)
+			continue;
+		if ((scn = elf_getscn_byname(e, names[i])) == NULL) {
+			TP_FAIL("\"%s\" not found: \"%s\".", names[i],
+			    elf_errmsg(-1));
+			break;
+		}
+		if ((ndx = elf_ndxscn(scn)) != i) {
+			TP_FAIL("\"%s\": unexpected index %zu.", names[i],
+			    ndx);
+			break;
+		}
+		if (elf_nextscn_byname(e, scn) != NULL) {
+			TP_FAIL("\"%s\": unexpected duplicate.", names[i]);
+			break;
+		}
+	}
+
+	if (result == TET_PASS) {
+		for (i = TS_DUPSTEP, scn = elf_getscn_byname(e, TS_DUPNAME);
+		     scn != NULL; i += TS_DUPSTEP,
+		     scn = elf_nextscn_byname(e, scn))
+			if ((ndx = elf_ndxscn(scn)) != i) {
+				TP_FAIL("duplicate: index %zu, expected %zu.",
+				    ndx, i);
+				break;
+			}
+		if (result == TET_PASS && i < TS_NSCN - 1)
+			TP_FAIL("duplicate: missing index %zu.", i);
+	}
+
+	if (result == TET_PASS &&
+	    (elf_getscn_byname(e, TS_EXTRANAME) != NULL ||
+	    (error = elf_errno()) != ELF_E_NONE))
+		TP_FAIL("unknown name: error=%d.", error);
+
+	(void) elf_end(e);
+	(void) close(fd);
+	(void) unlink(TS_NEWFILE);
+	tet_result(result);
+}')
+
+FN(32,`lsb')
+FN(32,`msb')
+FN(64,`lsb')
+FN(64,`msb')
+
+/*
+ * Sections added with elf_newscn() are seen by later lookups.
+ */
+void
+tcNewscn(void)
+{
+	int fd, result, setstrndx;
+	Elf *e;
+	Elf_Scn *scn;
+	GElf_Shdr sh;
+
+	TP_CHECK_INITIALIZATION();
+
+	TP_ANNOUNCE("sections added by elf_newscn() are found.");
+
+	result = TET_UNRESOLVED;
+	setstrndx = 1;
+
+	if ((e = elfts_new_file(TS_NEWFILE, ELFCLASS64, ELFDATA2LSB, ET_NONE,
+	    &fd)) == NULL || add_sections(e, &setstrndx) < 0)
+		goto done;
+
+	/* Section sizes are only known after a layout pass. */
+	if (elf_update(e, ELF_C_NULL) < 0) {
+		TP_UNRESOLVED("cannot create sections: \"%s\".",
+		    elf_errmsg(-1));
+		goto done;
+	}
+
+	result = TET_PASS;
+
+	if (elf_getscn_byname(e, "sec1") == NULL) {
+		TP_FAIL("\"sec1\" not found: \"%s\".", elf_errmsg(-1));
+		goto done;
+	}
+	if (elf_getscn_byname(e, TS_EXTRANAME) != NULL) {
+		TP_FAIL("\"" TS_EXTRANAME "\" found.");
+		goto done;
+	}
+
+	if ((scn = elf_newscn(e)) == NULL || gelf_getshdr(scn, &sh) == NULL) {
+		TP_UNRESOLVED("elf_newscn() failed: \"%s\".", elf_errmsg(-1));
+		goto done;
+	}
+	sh.sh_name = (uint32_t) extra;
+	if (gelf_update_shdr(scn, &sh) == 0) {
+		TP_UNRESOLVED("gelf_update_shdr() failed: \"%s\".",
+		    elf_errmsg(-1));
+		goto done;
+	}
+
+	if (elf_getscn_byname(e, TS_EXTRANAME) != scn)
+		TP_FAIL("new section not found: \"%s\".", elf_errmsg(-1));
+
+ done:
+	if (e) {
+		(void) elf_end(e);
+		(void) close(fd);
+	}
+	(void) unlink(TS_NEWFILE);
+	tet_result(result);
+}
@@ -0,0 +1,357 @@
+/*-
+ * Copyright (c) 2026, Elftoolchain Project Contributors.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE AUTHOR AND CONTRIBUTORS ``AS IS'' AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED.  IN NO EVENT SHALL THE AUTHOR OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS
+ * OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY
+ * OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+ * SUCH DAMAGE.
+ *
+ * $Id$
+ */
+
+#include <sys/types.h>
+
+#include <gelf.h>
+#include <libelf.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+#include <unistd.h>
+
+#include "elfts.h"
+#include "tet_api.h"
+
+IC_REQUIRES_VERSION_INIT();
+
+include(`elfts.m4')
+
+/*
+ * Tests for the `elf_getstats' API.
+ */
+
+#define	TS_NWORDS	1024
+
+static int
+is_native(int ed)
+{
+	uint16_t one;
+
+	one = 1;
+	return (ed == (*(uint8_t *) &one ? ELFDATA2LSB : ELFDATA2MSB));
+}
+
+/*
+ * A NULL destination is rejected.
+ */
+void
+tcArgsNull(void)
+{
+	int error, result;
+	Elf *e;
+	char image[16];
+
+	TP_CHECK_INITIALIZATION();
+
+	TP_ANNOUNCE("a NULL destination is rejected.");
+
+	result = TET_PASS;
+
+	(void) memset(image, 0, sizeof(image));
+	if ((e = elf_memory(image, sizeof(image))) == NULL) {
+		TP_UNRESOLVED("elf_memory() failed: \"%s\".", elf_errmsg(-1));
+		goto done;
+	}
+
+	if (elf_getstats(NULL, NULL) != -1 ||
+	    (error = elf_errno()) != ELF_E_ARGUMENT)
+		TP_FAIL("elf=NULL: error=%d.", error);
+	else if (elf_getstats(e, NULL) != -1 ||
+	    (error = elf_errno()) != ELF_E_ARGUMENT)
+		TP_FAIL("elf=%p: error=%d.", (void *) e, error);
+
+	(void) elf_end(e);
+
+ done:
+	tet_result(result);
+}
+
+/*
+ * A destination too small to hold its size is rejected.
+ */
+void
+tcArgsSize(void)
+{
+	int error, result;
+	Elf_Stats st;
+
+	TP_CHECK_INITIALIZATION();
+
+	TP_ANNOUNCE("a destination with a zero size is rejected.");
+
+	result = TET_PASS;
+
+	st.es_size = 0;
+	if (elf_getstats(NULL, &st) != -1 ||
+	    (error = elf_errno()) != ELF_E_ARGUMENT)
+		TP_FAIL("error=%d.", error);
+
+	tet_result(result);
+}
+
+/*
+ * Only the members that fit in `es_size' bytes are returned.
+ */
+void
+tcShortSize(void)
+{
+	int result;
+	Elf_Stats st;
+	size_t sz;
+
+	TP_CHECK_INITIALIZATION();
+
+	TP_ANNOUNCE("a short structure is partially filled in.");
+
+	result = TET_PASS;
+
+	sz = offsetof(Elf_Stats, es_read);
+
+	(void) memset(&st, 0xFF, sizeof(st));
+	st.es_size = sz;
+	if (elf_getstats(NULL, &st) != 0)
+		TP_FAIL("elf_getstats() failed: \"%s\".", elf_errmsg(-1));
+	else if (st.es_size != sz || st.es_read != UINT64_MAX)
+		TP_FAIL("es_size=%ju es_read=0x%jx.", (uintmax_t) st.es_size,
+		    (uintmax_t) st.es_read);
+
+	tet_result(result);
+}
+
+/*
+ * The counters of a new descriptor are zero.
+ */
+void
+tcNewDescriptor(void)
+{
+	int result;
+	size_t i;
+	Elf *e;
+	Elf_Stats st;
+	uint64_t *c;
+	char image[16];
+
+	TP_CHECK_INITIALIZATION();
+
+	TP_ANNOUNCE("the counters of a new descriptor are zero.");
+
+	result = TET_PASS;
+
+	(void) memset(image, 0, sizeof(image));
+	if ((e = elf_memory(image, sizeof(image))) == NULL) {
+		TP_UNRESOLVED("elf_memory() failed: \"%s\".", elf_errmsg(-1));
+		goto done;
+	}
+
+	(void) memset(&st, 0xFF, sizeof(st));
+	st.es_size = sizeof(st);
+	if (elf_getstats(e, &st) != 0) {
+		TP_FAIL("elf_getstats() failed: \"%s\".", elf_errmsg(-1));
+		goto done;
+	}
+
+	if (st.es_size != sizeof(st)) {
+		TP_FAIL("es_size is %ju.", (uintmax_t) st.es_size);
+		goto done;
+	}
+
+	c = &st.es_mapped;
+	for (i = 0; &c[i] < (uint64_t *) (&st + 1); i++)
+		if (c[i] != 0) {
+			TP_FAIL("counter %d is %ju.", (int) i,
+			    (uintmax_t) c[i]);
+			break;
+		}
+
+ done:
+	if (e)
+		(void) elf_end(e);
+	tet_result(result);
+}
+
+/*
+ * Create TS_NEWFILE, holding a section with TS_NWORDS words, and
+ * check the counters for the write.  Returns the size of the file,
+ * and the test result in `*res'.
+ */
+static off_t
+write_file(int ec, int ed, int *res)
+{
+	int fd, result;
+	off_t rc;
+	Elf *e;
+	Elf_Stats before, after, st;
+	GElf_Shdr sh;
+	size_t i;
+	static uint32_t words[TS_NWORDS];
+
+	result = TET_PASS;
+
+	for (i = 0; i < TS_NWORDS; i++)
+		words[i] = (uint32_t) i;
+
+	if ((e = elfts_new_file(TS_NEWFILE, ec, ed, ET_NONE, &fd)) == NULL) {
+		*res = TET_UNRESOLVED;
+		return ((off_t) -1);
+	}
+
+	(void) memset(&sh, 0, sizeof(sh));
+	sh.sh_type = SHT_SYMTAB_SHNDX;
+	sh.sh_entsize = sizeof(words[0]);
+	if (elfts_new_section(e, &sh, ELF_T_WORD, words, sizeof(words)) ==
+	    NULL) {
+		result = TET_UNRESOLVED;
+		goto fail;
+	}
+
+	before.es_size = after.es_size = st.es_size = sizeof(Elf_Stats);
+	if (elf_getstats(NULL, &before) != 0)
+		goto error;
+
+	if ((rc = elf_update(e, ELF_C_WRITE)) < 0)
+		goto error;
+
+	if (elf_getstats(e, &st) != 0 || elf_getstats(NULL, &after) != 0)
+		goto error;
+
+	/* The ELF header, the section and the section header table. */
+	if (st.es_updates != 1 || st.es_update_extents != 3 ||
+	    st.es_update_bytes != (uint64_t) rc)
+		TP_FAIL("updates=%ju extents=%ju bytes=%ju, size=%jd.",
+		    (uintmax_t) st.es_updates,
+		    (uintmax_t) st.es_update_extents,
+		    (uintmax_t) st.es_update_bytes, (intmax_t) rc);
+	else if (!is_native(ed) && st.es_xlate_bytes < sizeof(words))
+		TP_FAIL("xlate_bytes=%ju.", (uintmax_t) st.es_xlate_bytes);
+	else if (after.es_updates - before.es_updates != 1 ||
+	    after.es_update_bytes - before.es_update_bytes != (uint64_t) rc)
+		TP_FAIL("aggregate: updates=%ju bytes=%ju.",
+		    (uintmax_t) (after.es_updates - before.es_updates),
+		    (uintmax_t) (after.es_update_bytes -
+			before.es_update_bytes));
+
+	(void) elf_end(e);
+	(void) close(fd);
+
+	/* The counters of a released descriptor remain in the totals. */
+	if (result == TET_PASS && (elf_getstats(NULL, &after) != 0 ||
+	    after.es_updates - before.es_updates != 1 ||
+	    after.es_update_bytes - before.es_update_bytes != (uint64_t) rc))
+		TP_FAIL("released: updates=%ju bytes=%ju.",
+		    (uintmax_t) (after.es_updates - before.es_updates),
+		    (uintmax_t) (after.es_update_bytes -
+			before.es_update_bytes));
+
+	*res = result;
+	return (rc);
+
+ error:
+	TP_UNRESOLVED("cannot create file: \"%s\".", elf_errmsg(-1));
+ fail:
+	*res = result;
+	(void) elf_end(e);
+	(void) close(fd);
+	return ((off_t) -1);
+}
+
+/*
+ * The counters account for the work done by elf_update() and for
+ * reading the object back in.
+ *
+ * Arguments: class, byte order.
+ */
+define(`FN',`
+void
+tcUpdate$1`'TOUPPER($2)(void)
+{
+	int fd, result;
+	off_t size;
+	Elf *e;
+	Elf_Scn *scn;
+	Elf_Stats st;
+
+	TP_CHECK_INITIALIZATION();
+
+	TP_ANNOUNCE("TOUPPER($2)$1: counters track writing and reading "
+	    "an object.");
+
+	result = TET_PASS;
+	e = NULL;
+
+	if ((size = write_file(ELFCLASS$1, ELFDATA2`'TOUPPER($2),
+	    &result)) < 0 || result != TET_PASS)
+		goto done;
+
+	if ((e = elfts_open_file(TS_NEWFILE, ELF_C_READ, &fd)) == NULL) {
+		result = TET_UNRESOLVED;
+		goto done;
+	}
+
+	if ((scn = elf_getscn(e, 1)) == NULL || elf_getdata(scn, NULL) == NULL) {
+		TP_UNRESOLVED("cannot read section: \"%s\".", elf_errmsg(-1));
+		goto done;
+	}
+
+	st.es_size = sizeof(st);
+	if (elf_getstats(e, &st) != 0) {
+		TP_FAIL("elf_getstats() failed: \"%s\".", elf_errmsg(-1));
+		goto done;
+	}
+
+	if (st.es_mapped == 0 && st.es_read == 0)
+		TP_FAIL("mapped=0 read=0.");
+	else if (st.es_mapped != 0 && st.es_mapped != (uint64_t) size)
+		TP_FAIL("mapped=%ju size=%jd.", (uintmax_t) st.es_mapped,
+		    (intmax_t) size);
+	else if (st.es_sections != 2)
+		TP_FAIL("sections=%ju.", (uintmax_t) st.es_sections);
+	else if (st.es_allocated[ELF_T_EHDR] != sizeof(Elf$1_Ehdr))
+		TP_FAIL("allocated[EHDR]=%ju.",
+		    (uintmax_t) st.es_allocated[ELF_T_EHDR]);
+	else if (!is_native(ELFDATA2`'TOUPPER($2)) &&
+	    st.es_allocated[ELF_T_WORD] != TS_NWORDS * sizeof(uint32_t))
+		TP_FAIL("allocated[WORD]=%ju.",
+		    (uintmax_t) st.es_allocated[ELF_T_WORD]);
+	else if (st.es_updates != 0 || st.es_update_bytes != 0)
+		TP_FAIL("updates=%ju bytes=%ju.", (uintmax_t) st.es_updates,
+		    (uintmax_t) st.es_update_bytes);
+
+ done:
+	if (e) {
+		(void) elf_end(e);
+		(void) close(fd);
+	}
+	(void) unlink(TS_NEWFILE);
+	tet_result(result);
+}')
+
+FN(32,lsb)
+FN(32,msb)
+FN(64,lsb)
+FN(64,msb)
@@ -38,7 +38,7 @@
 #include "tet_api.h"
 
 /*
- * Test the `elf_hash' API.
+ * Test the `elf_hash' and `elf_gnu_hash' APIs.
  */
 
 /*
@@ -58,6 +58,16 @@ static struct htab {
 	H(NULL,			0)
 };
 
+static struct htab gnu_htab[] = {
+	H("",			0x1505),
+	H("\377\377\377\377",	0x7ced42c1),
+	H("\030\2265Q\023_;\312\214\212#f\001\220\224|",
+				0xf3d99b10),
+	H("elf-hash",		0x1c951a4d),
+	H("printf",		0x156b2bb8),
+	H(NULL,			0)
+};
+
 static void
 to_printable_string(char *dst, const char *src)
 {
@@ -99,3 +109,29 @@ tpCheckHash(void)
 	}
 	tet_result(result);
 }
+
+void
+tpCheckGnuHash(void)
+{
+	unsigned long h;
+	struct htab *ht;
+	int result;
+	char *tmp;
+
+	tet_infoline("assertion: check elf_gnu_hash() against several "
+	    "constant strings.");
+
+	result = TET_PASS;
+	for (ht = gnu_htab; ht->s; ht++) {
+		if ((h = elf_gnu_hash(ht->s)) != ht->h) {
+			if ((tmp = malloc(4 * strlen(ht->s) + 1)) != NULL) {
+				to_printable_string(tmp, ht->s);
+				tet_printf("fail: elf_gnu_hash(\"%s\") = "
+				    "0x%x != expected 0x%x.", tmp, h, ht->h);
+				free(tmp);
+			}
+			result = TET_FAIL;
+		}
+	}
+	tet_result(result);
+}
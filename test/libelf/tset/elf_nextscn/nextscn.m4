@@ -27,6 +27,7 @@
  */
 
 #include <ar.h>
+#include <gelf.h>
 #include <libelf.h>
 #include <string.h>
 #include <unistd.h>
@@ -376,3 +377,107 @@ FN(32,`lsb')
 FN(32,`msb')
 FN(64,`lsb')
 FN(64,`msb')
+
+/*
+ * elf_nextscn() iterates through sections in ascending order after
+ * sections of an object with many sections were looked up out of
+ * order.
+ */
+
+#define	TS_MANY_SCN	3000
+
+undefine(`FN')
+define(`FN',`
+void
+tcElfOutOfOrder$1(void)
+{
+	Elf *e;
+	Elf_Scn *scn;
+	GElf_Ehdr eh;
+	GElf_Shdr sh;
+	int fd, result;
+	size_t n;
+	static const size_t lookups[] = { 2500, 100, 1500, TS_MANY_SCN - 1 };
+
+	TP_CHECK_INITIALIZATION();
+
+	TP_ANNOUNCE("elf_nextscn() visits sections in ascending order "
+	    "after out-of-order lookups.");
+
+	e = NULL;
+	fd = -1;
+	result = TET_UNRESOLVED;
+
+	_TS_OPEN_FILE(e, TS_NEWFILE, ELF_C_WRITE, fd, goto done;);
+
+	if (gelf_newehdr(e, ELFCLASS$1) == NULL ||
+	    gelf_getehdr(e, &eh) == NULL) {
+		TP_UNRESOLVED("gelf_newehdr() failed: \"%s\".",
+		    elf_errmsg(-1));
+		goto done;
+	}
+
+	eh.e_ident[EI_DATA] = ELFDATA2LSB;
+	if (gelf_update_ehdr(e, &eh) == 0) {
+		TP_UNRESOLVED("gelf_update_ehdr() failed: \"%s\".",
+		    elf_errmsg(-1));
+		goto done;
+	}
+
+	for (n = 1; n < TS_MANY_SCN; n++) {
+		if ((scn = elf_newscn(e)) == NULL ||
+		    gelf_getshdr(scn, &sh) == NULL) {
+			TP_UNRESOLVED("elf_newscn() failed: \"%s\".",
+			    elf_errmsg(-1));
+			goto done;
+		}
+		sh.sh_type = SHT_PROGBITS;
+		sh.sh_info = (uint32_t) n;
+		(void) gelf_update_shdr(scn, &sh);
+	}
+
+	if (elf_update(e, ELF_C_WRITE) < 0) {
+		TP_UNRESOLVED("elf_update() failed: \"%s\".",
+		    elf_errmsg(-1));
+		goto done;
+	}
+
+	(void) elf_end(e);
+	(void) close(fd);
+	e = NULL;
+
+	_TS_OPEN_FILE(e, TS_NEWFILE, ELF_C_READ, fd, goto done;);
+
+	for (n = 0; n < sizeof(lookups) / sizeof(lookups[0]); n++)
+		if ((scn = elf_getscn(e, lookups[n])) == NULL ||
+		    elf_ndxscn(scn) != lookups[n]) {
+			TP_UNRESOLVED("elf_getscn(%d) failed: \"%s\".",
+			    (int) lookups[n], elf_errmsg(-1));
+			goto done;
+		}
+
+	result = TET_PASS;
+
+	for (scn = NULL, n = 1; (scn = elf_nextscn(e, scn)) != NULL; n++)
+		if (elf_ndxscn(scn) != n || gelf_getshdr(scn, &sh) == NULL ||
+		    sh.sh_info != n) {
+			TP_FAIL("section %d: ndx=%d.", (int) n,
+			    (int) elf_ndxscn(scn));
+			goto done;
+		}
+
+	if (n != TS_MANY_SCN)
+		TP_FAIL("%d sections visited.", (int) n - 1);
+
+ done:
+	if (e)
+		(void) elf_end(e);
+	if (fd != -1)
+		(void) close(fd);
+	(void) unlink(TS_NEWFILE);
+
+	tet_result(result);
+}')
+
+FN(32)
+FN(64)
@@ -353,6 +353,258 @@ FN(32,`msb',`newscn')
 FN(64,`lsb',`newscn')
 FN(64,`msb',`newscn')
 
+/*
+ * Lookups remain correct after a section whose strings have already
+ * been looked up gains a data descriptor.
+ */
+
+undefine(`FN')
+define(`FN',`
+void
+tcCacheNewData$1`'TOUPPER($2)(void)
+{
+	int fd, result;
+	Elf *e;
+	size_t sz;
+	Elf_Scn *scn;
+	Elf_Data *d;
+	Elf$1_Shdr *sh;
+	Elf$1_Ehdr *eh;
+	char *r;
+
+	TP_CHECK_INITIALIZATION();
+
+	TP_ANNOUNCE("TOUPPER($2)$1: lookups see data added by elf_newdata().");
+
+	result = TET_UNRESOLVED;
+
+	_TS_OPEN_FILE(e, "$3.$2$1", ELF_C_READ, fd, goto done;);
+
+	if ((eh = elf$1_getehdr(e)) == NULL ||
+	    (scn = elf_getscn(e, eh->e_shstrndx)) == NULL ||
+	    (sh = elf$1_getshdr(scn)) == NULL) {
+		TP_UNRESOLVED("cannot retrieve the string table: \"%s\".",
+		    elf_errmsg(-1));
+		goto done;
+	}
+
+	sz = sh->sh_size;
+
+	if ((r = elf_strptr(e, eh->e_shstrndx, refstr[1].offset)) == NULL ||
+	    strcmp(r, refstr[1].string) != 0) {
+		TP_UNRESOLVED("elf_strptr() failed: \"%s\".", elf_errmsg(-1));
+		goto done;
+	}
+
+	if ((d = elf_newdata(scn)) == NULL) {
+		TP_UNRESOLVED("elf_newdata() failed: \"%s\".",
+		    elf_errmsg(-1));
+		goto done;
+	}
+
+	d->d_buf  = teststring;
+	d->d_size = sizeof(teststring);
+
+	if (elf_update(e, ELF_C_NULL) < 0) {
+		TP_UNRESOLVED("elf_update() failed: \"%s\".",
+		    elf_errmsg(-1));
+		goto done;
+	}
+
+	result = TET_PASS;
+
+	if ((r = elf_strptr(e, eh->e_shstrndx, sz)) == NULL ||
+	    strcmp(r, teststring) != 0) {
+		TP_FAIL("offset %d: r=\"%s\" error=\"%s\".", (int) sz, r,
+		    elf_errmsg(-1));
+		goto done;
+	}
+
+	if ((r = elf_strptr(e, eh->e_shstrndx, refstr[1].offset)) == NULL ||
+	    strcmp(r, refstr[1].string) != 0)
+		TP_FAIL("offset %d: r=\"%s\" error=\"%s\".",
+		    (int) refstr[1].offset, r, elf_errmsg(-1));
+
+ done:
+	(void) elf_end(e);
+	tet_result(result);
+}')
+
+FN(32,`lsb',`newscn')
+FN(32,`msb',`newscn')
+FN(64,`lsb',`newscn')
+FN(64,`msb',`newscn')
+
+/*
+ * Lookups see changes to the contents and type of a string table's
+ * data descriptor that were flagged using elf_flagdata().
+ */
+
+undefine(`FN')
+define(`FN',`
+void
+tcCacheFlagData$1`'TOUPPER($2)(void)
+{
+	int error, fd, result;
+	Elf *e;
+	Elf_Scn *scn;
+	Elf_Data *d;
+	Elf$1_Ehdr *eh;
+	char *r;
+	const char *name = ".SHSTRTAB";
+
+	TP_CHECK_INITIALIZATION();
+
+	TP_ANNOUNCE("TOUPPER($2)$1: lookups see data flagged as dirty.");
+
+	result = TET_UNRESOLVED;
+
+	_TS_OPEN_FILE(e, "$3.$2$1", ELF_C_READ, fd, goto done;);
+
+	if ((eh = elf$1_getehdr(e)) == NULL ||
+	    (scn = elf_getscn(e, eh->e_shstrndx)) == NULL ||
+	    (d = elf_getdata(scn, NULL)) == NULL) {
+		TP_UNRESOLVED("cannot retrieve the string table: \"%s\".",
+		    elf_errmsg(-1));
+		goto done;
+	}
+
+	if ((r = elf_strptr(e, eh->e_shstrndx, refstr[1].offset)) == NULL ||
+	    strcmp(r, refstr[1].string) != 0) {
+		TP_UNRESOLVED("elf_strptr() failed: \"%s\".", elf_errmsg(-1));
+		goto done;
+	}
+
+	(void) memcpy((char *) d->d_buf + refstr[1].offset, name,
+	    strlen(name));
+
+	if (elf_flagdata(d, ELF_C_SET, ELF_F_DIRTY) != ELF_F_DIRTY) {
+		TP_UNRESOLVED("elf_flagdata() failed: \"%s\".",
+		    elf_errmsg(-1));
+		goto done;
+	}
+
+	result = TET_PASS;
+
+	if ((r = elf_strptr(e, eh->e_shstrndx, refstr[1].offset)) !=
+	    (char *) d->d_buf + refstr[1].offset || strcmp(r, name) != 0) {
+		TP_FAIL("r=\"%s\" error=\"%s\".", r, elf_errmsg(-1));
+		goto done;
+	}
+
+	/* A descriptor that no longer holds bytes is rejected. */
+	d->d_type = ELF_T_WORD;
+	if (elf_flagdata(d, ELF_C_SET, ELF_F_DIRTY) != ELF_F_DIRTY) {
+		TP_UNRESOLVED("elf_flagdata() failed: \"%s\".",
+		    elf_errmsg(-1));
+		result = TET_UNRESOLVED;
+		goto done;
+	}
+
+	if ((r = elf_strptr(e, eh->e_shstrndx, refstr[1].offset)) != NULL ||
+	    (error = elf_errno()) != ELF_E_DATA)
+		TP_FAIL("r=%p error=%d.", (void *) r, error);
+
+ done:
+	(void) elf_end(e);
+	tet_result(result);
+}')
+
+FN(32,`lsb',`newscn')
+FN(32,`msb',`newscn')
+FN(64,`lsb',`newscn')
+FN(64,`msb',`newscn')
+
+/*
+ * Lookups use the new buffer after the application replaces the data
+ * buffer of a string table with a smaller one.
+ */
+
+static char shortstrtab[] = {
+	'\0', '.', 'x', '\0'
+};
+
+undefine(`FN')
+define(`FN',`
+void
+tcCacheReplaceBuffer$1`'TOUPPER($2)(void)
+{
+	int error, fd, result;
+	Elf *e;
+	Elf_Scn *scn;
+	Elf_Data *d;
+	Elf$1_Ehdr *eh;
+	char *r;
+	void *buf;
+	size_t sz;
+
+	TP_CHECK_INITIALIZATION();
+
+	TP_ANNOUNCE("TOUPPER($2)$1: lookups use a replaced data buffer.");
+
+	result = TET_UNRESOLVED;
+	d = NULL;
+	buf = NULL;
+	sz = 0;
+
+	_TS_OPEN_FILE(e, "$3.$2$1", ELF_C_READ, fd, goto done;);
+
+	if ((eh = elf$1_getehdr(e)) == NULL ||
+	    (scn = elf_getscn(e, eh->e_shstrndx)) == NULL ||
+	    (d = elf_getdata(scn, NULL)) == NULL) {
+		TP_UNRESOLVED("cannot retrieve the string table: \"%s\".",
+		    elf_errmsg(-1));
+		goto done;
+	}
+
+	if ((r = elf_strptr(e, eh->e_shstrndx, refstr[2].offset)) == NULL ||
+	    strcmp(r, refstr[2].string) != 0) {
+		TP_UNRESOLVED("elf_strptr() failed: \"%s\".", elf_errmsg(-1));
+		goto done;
+	}
+
+	/* The original buffer belongs to the library. */
+	buf = d->d_buf;
+	sz = d->d_size;
+
+	d->d_buf  = shortstrtab;
+	d->d_size = sizeof(shortstrtab);
+
+	if (elf_flagdata(d, ELF_C_SET, ELF_F_DIRTY) != ELF_F_DIRTY ||
+	    elf_update(e, ELF_C_NULL) < 0) {
+		TP_UNRESOLVED("elf_flagdata()/elf_update() failed: \"%s\".",
+		    elf_errmsg(-1));
+		goto done;
+	}
+
+	result = TET_PASS;
+
+	if ((r = elf_strptr(e, eh->e_shstrndx, 1)) != &shortstrtab[1]) {
+		TP_FAIL("offset 1: r=%p error=\"%s\".", (void *) r,
+		    elf_errmsg(-1));
+		goto done;
+	}
+
+	/* Offsets past the end of the new buffer are rejected. */
+	if ((r = elf_strptr(e, eh->e_shstrndx, refstr[2].offset)) != NULL ||
+	    (error = elf_errno()) != ELF_E_ARGUMENT)
+		TP_FAIL("offset %d: r=%p error=%d.", (int) refstr[2].offset,
+		    (void *) r, error);
+
+ done:
+	if (buf != NULL) {
+		d->d_buf = buf;
+		d->d_size = sz;
+	}
+	(void) elf_end(e);
+	tet_result(result);
+}')
+
+FN(32,`lsb',`newscn')
+FN(32,`msb',`newscn')
+FN(64,`lsb',`newscn')
+FN(64,`msb',`newscn')
+
 /*
  * TODO: With the layout bit set, an out of bounds offset is detected.
  */
@@ -33,6 +33,7 @@
 #include <fcntl.h>
 #include <libelf.h>
 #include <gelf.h>
+#include <pthread.h>
 #include <stdint.h>
 #include <string.h>
 #include <unistd.h>
@@ -224,6 +225,67 @@ FN(`32', `msb')
 FN(`64', `lsb')
 FN(`64', `msb')
 
+/*
+ * Objects opened for reading, with or without ELF_C_READ_MMAP, are
+ * rejected for ELF_C_WRITE with error ELF_E_MODE.
+ */
+
+undefine(`FN')
+define(`FN',`
+void
+tcReadMode$3Write$1$2(void)
+{
+	Elf *e;
+	off_t offset;
+	int error, fd, result;
+
+	TP_CHECK_INITIALIZATION();
+
+	TP_ANNOUNCE("TOUPPER($2)$1: ELF_C_WRITE with objects opened "
+	    "with $4 returns ELF_E_MODE.");
+
+	result = TET_UNRESOLVED;
+	e = NULL;
+	fd = -1;
+
+	_TS_OPEN_FILE(e, "newehdr.$2$1", $4, fd, goto done;);
+
+	if ((offset = elf_update(e, ELF_C_WRITE)) != (off_t) -1) {
+		TP_FAIL("elf_update() succeeded unexpectedly; offset=%jd.",
+		    (intmax_t) offset);
+		goto done;
+	}
+
+	if ((error = elf_errno()) != ELF_E_MODE) {
+		TP_FAIL("elf_update() did not fail with ELF_E_MODE; "
+		    "error=%d \"%s\".", error, elf_errmsg(error));
+		goto done;
+	}
+
+	if ((offset = elf_update(e, ELF_C_NULL)) < 0) {
+		TP_FAIL("elf_update(NULL) failed: \"%s\".",
+		    elf_errmsg(-1));
+		goto done;
+	}
+
+	result = TET_PASS;
+
+ done:
+	(void) elf_end(e);
+	if (fd != -1)
+		(void) close(fd);
+	tet_result(result);
+}')
+
+FN(`32', `lsb', `', `ELF_C_READ')
+FN(`32', `msb', `', `ELF_C_READ')
+FN(`64', `lsb', `', `ELF_C_READ')
+FN(`64', `msb', `', `ELF_C_READ')
+FN(`32', `lsb', `Mmap', `ELF_C_READ_MMAP')
+FN(`32', `msb', `Mmap', `ELF_C_READ_MMAP')
+FN(`64', `lsb', `Mmap', `ELF_C_READ_MMAP')
+FN(`64', `msb', `Mmap', `ELF_C_READ_MMAP')
+
 /*
  * In-memory ELF objects are updateable with command ELF_C_NULL.
  */
@@ -1479,6 +1541,84 @@ FN(32,msb)
 FN(64,lsb)
 FN(64,msb)
 
+/*
+ * Test that repeated calls to elf_update() without any changes
+ * flagged leave the ELF object unchanged.
+ */
+
+undefine(`FN')
+define(`FN',`
+void
+tcRdWrModeRepeatedNoOp_$1$2(void)
+{
+	int error, fd, i, result;
+	Elf *e;
+	const char *srcfile = "rdwr.$2$1";
+	char *tfn;
+
+	TP_CHECK_INITIALIZATION();
+
+	TP_ANNOUNCE("TOUPPER($2)$1: repeated calls to elf_update() without "
+	    "flagged changes are a no-op");
+
+	result = TET_UNRESOLVED;
+	e = NULL;
+	fd = -1;
+	tfn = NULL;
+
+	/* Make a copy of the reference object. */
+	if ((tfn = elfts_copy_file(srcfile, &error)) < 0) {
+		TP_UNRESOLVED("elfts_copyfile(%s) failed: \"%s\".",
+		    srcfile, strerror(error));
+		goto done;
+	}
+
+	/* Open the copied object in RDWR mode. */
+	_TS_OPEN_FILE(e, tfn, ELF_C_RDWR, fd, goto done;);
+
+	if (elf$1_getehdr(e) == NULL) {
+		TP_UNRESOLVED("elf$1_getehdr() failed: \"%s\".",
+		    elf_errmsg(-1));
+		goto done;
+	}
+
+	for (i = 0; i < 3; i++) {
+		if (elf_update(e, ELF_C_WRITE) < 0) {
+			TP_FAIL("elf_update(WRITE) #%d failed: \"%s\".",
+			    i, elf_errmsg(-1));
+			goto done;
+		}
+	}
+
+	/* Close the temporary file. */
+	if ((error = elf_end(e)) != 0) {
+		TP_UNRESOLVED("elf_end() failed: \"%s\".",
+		    elf_errmsg(-1));
+		goto done;
+	}
+
+	e = NULL;
+	(void) close(fd);
+
+	/* compare against the original */
+	result = elfts_compare_files(srcfile, tfn);
+
+ done:
+	if (e)
+		(void) elf_end(e);
+	if (fd != -1)
+		(void) close(fd);
+	if (tfn != NULL)
+		(void) unlink(tfn);
+
+	tet_result(result);
+}')
+
+FN(32,lsb)
+FN(32,msb)
+FN(64,lsb)
+FN(64,msb)
+
 /*
  * Test that a call to elf_update() without a change to underlying
  * data for the object is a no-op.
@@ -1487,7 +1627,7 @@ FN(64,msb)
 undefine(`FN')
 define(`FN',`
 void
-tcRdWrModeNoDataChange_$1$2(void)
+tcRdWrModeNoDataChange$3_$1$2(void)
 {
 	int error, fd, result;
 	Elf *e;
@@ -1500,7 +1640,7 @@ tcRdWrModeNoDataChange_$1$2(void)
 	TP_CHECK_INITIALIZATION();
 
 	TP_ANNOUNCE("TOUPPER($2)$1: elf_update() with no data changes "
-	    "is a no-op");
+	    "is a no-op"ifelse($3,`Mmap',` " with ELF_C_RDWR_MMAP"'));
 
 	result = TET_UNRESOLVED;
 	e = NULL;
@@ -1515,7 +1655,7 @@ tcRdWrModeNoDataChange_$1$2(void)
 	}
 
 	/* Open the copied object in RDWR mode. */
-	_TS_OPEN_FILE(e, tfn, ELF_C_RDWR, fd, goto done;);
+	_TS_OPEN_FILE(e, tfn, ELF_C_RDWR`'ifelse($3,`Mmap',`_MMAP'), fd, goto done;);
 
 	if (fstat(fd, &sb) < 0) {
 		TP_UNRESOLVED("fstat() failed: \"%s\".",
@@ -1582,6 +1722,119 @@ tcRdWrModeNoDataChange_$1$2(void)
 	tet_result(result);
 }')
 
+FN(32,lsb)
+FN(32,msb)
+FN(64,lsb)
+FN(64,msb)
+FN(32,lsb,`Mmap')
+FN(32,msb,`Mmap')
+FN(64,lsb,`Mmap')
+FN(64,msb,`Mmap')
+
+/*
+ * Test that changes made to section data returned by elf_getdata()
+ * are written out, whether or not they have been flagged, and whether
+ * or not the data was translated.
+ */
+
+undefine(`FN')
+define(`FN',`
+void
+tcRdWrModeInPlaceData_$1$2(void)
+{
+	int error, fd, flagged, result;
+	Elf *e;
+	Elf_Data *d;
+	Elf_Scn *scn;
+	GElf_Shdr sh;
+	const char *srcfile = "rdwr.$2$1";
+	const char *new_data[2] = { "HELLO", "WORLD" };
+	char buf[8];
+	char *tfn;
+
+	TP_CHECK_INITIALIZATION();
+
+	TP_ANNOUNCE("TOUPPER($2)$1: data changes are written out "
+	    "with or without ELF_F_DIRTY");
+
+	result = TET_UNRESOLVED;
+	e = NULL;
+	fd = -1;
+	tfn = NULL;
+
+	if ((tfn = elfts_copy_file(srcfile, &error)) < 0) {
+		TP_UNRESOLVED("elfts_copyfile(%s) failed: \"%s\".",
+		    srcfile, strerror(error));
+		goto done;
+	}
+
+	_TS_OPEN_FILE(e, tfn, ELF_C_RDWR, fd, goto done;);
+
+	for (flagged = 0; flagged < 2; flagged++) {
+		/*
+		 * An update releases the section descriptors, so
+		 * retrieve the data again on each iteration.
+		 */
+		if ((scn = elf_getscn(e, 1)) == NULL ||
+		    gelf_getshdr(scn, &sh) == NULL ||
+		    (d = elf_getdata(scn, NULL)) == NULL) {
+			TP_UNRESOLVED("elf_getdata() failed: \"%s\".",
+			    elf_errmsg(-1));
+			goto done;
+		}
+
+		if (d->d_size < strlen(new_data[flagged])) {
+			TP_UNRESOLVED("section too small: %d.",
+			    (int) d->d_size);
+			goto done;
+		}
+
+		(void) memcpy(d->d_buf, new_data[flagged],
+		    strlen(new_data[flagged]));
+
+		if (flagged && elf_flagdata(d, ELF_C_SET, ELF_F_DIRTY) !=
+		    ELF_F_DIRTY) {
+			TP_UNRESOLVED("elf_flagdata() failed: \"%s\".",
+			    elf_errmsg(-1));
+			goto done;
+		}
+
+		if (elf_update(e, ELF_C_WRITE) < 0) {
+			TP_FAIL("elf_update(WRITE) failed: \"%s\".",
+			    elf_errmsg(-1));
+			goto done;
+		}
+
+		if (pread(fd, buf, strlen(new_data[flagged]),
+		    (off_t) sh.sh_offset) !=
+		    (ssize_t) strlen(new_data[flagged])) {
+			TP_UNRESOLVED("pread() failed: \"%s\".",
+			    strerror(errno));
+			goto done;
+		}
+
+		if (memcmp(buf, new_data[flagged],
+		    strlen(new_data[flagged])) != 0) {
+			TP_FAIL("%s change was not written out.",
+			    flagged ? "flagged" : "unflagged");
+			result = TET_FAIL;
+			goto done;
+		}
+	}
+
+	result = TET_PASS;
+
+ done:
+	if (e)
+		(void) elf_end(e);
+	if (fd != -1)
+		(void) close(fd);
+	if (tfn != NULL)
+		(void) unlink(tfn);
+
+	tet_result(result);
+}')
+
 FN(32,lsb)
 FN(32,msb)
 FN(64,lsb)
@@ -1595,7 +1848,7 @@ FN(64,msb)
 undefine(`FN')
 define(`FN',`
 void
-tcRdWrModeEhdrChange_$1$2(void)
+tcRdWrModeEhdrChange$3_$1$2(void)
 {
 	int error, fd, result;
 	unsigned int flag;
@@ -1610,7 +1863,7 @@ tcRdWrModeEhdrChange_$1$2(void)
 	TP_CHECK_INITIALIZATION();
 
 	TP_ANNOUNCE("TOUPPER($2)$1: elf_update() updates a changed "
-	    "header correctly");
+	    "header correctly"ifelse($3,`Mmap',` " with ELF_C_RDWR_MMAP"'));
 
 	result = TET_UNRESOLVED;
 	e = NULL;
@@ -1625,7 +1878,7 @@ tcRdWrModeEhdrChange_$1$2(void)
 	}
 
 	/* Open the copied object in RDWR mode. */
-	_TS_OPEN_FILE(e, tfn, ELF_C_RDWR, fd, goto done;);
+	_TS_OPEN_FILE(e, tfn, ELF_C_RDWR`'ifelse($3,`Mmap',`_MMAP'), fd, goto done;);
 
 	if (fstat(fd, &sb) < 0) {
 		TP_UNRESOLVED("fstat() failed: \"%s\".",
@@ -1701,6 +1954,10 @@ FN(32,lsb)
 FN(32,msb)
 FN(64,lsb)
 FN(64,msb)
+FN(32,lsb,`Mmap')
+FN(32,msb,`Mmap')
+FN(64,lsb,`Mmap')
+FN(64,msb,`Mmap')
 
 /*
  * Test extending a section.
@@ -1712,7 +1969,7 @@ static char *extra_data = "goodbye world";
 undefine(`FN')
 define(`FN',`
 void
-tcRdWrExtendSection_$1$2(void)
+tcRdWrExtendSection$3_$1$2(void)
 {
 	int error, fd, result;
 	unsigned int flag;
@@ -1728,7 +1985,7 @@ tcRdWrExtendSection_$1$2(void)
 	TP_CHECK_INITIALIZATION();
 
 	TP_ANNOUNCE("TOUPPER($2)$1: elf_update() deals with an "
-	    "extended section correctly");
+	    "extended section correctly"ifelse($3,`Mmap',` " with ELF_C_RDWR_MMAP"'));
 
 	result = TET_UNRESOLVED;
 	e = NULL;
@@ -1743,7 +2000,7 @@ tcRdWrExtendSection_$1$2(void)
 	}
 
 	/* Open the copied object in RDWR mode. */
-	_TS_OPEN_FILE(e, tfn, ELF_C_RDWR, fd, goto done;);
+	_TS_OPEN_FILE(e, tfn, ELF_C_RDWR`'ifelse($3,`Mmap',`_MMAP'), fd, goto done;);
 
 	if (stat(reffile, &sb) < 0) {
 		TP_UNRESOLVED("stat() failed: \"%s\".", strerror(errno));
@@ -1825,15 +2082,20 @@ FN(32,lsb)
 FN(32,msb)
 FN(64,lsb)
 FN(64,msb)
+FN(32,lsb,`Mmap')
+FN(32,msb,`Mmap')
+FN(64,lsb,`Mmap')
+FN(64,msb,`Mmap')
 
 /*
- * Test shrinking a section.
+ * Test shrinking a section, optionally writing out sections in
+ * parallel.
  */
 
 undefine(`FN')
 define(`FN',`
 void
-tcRdWrShrinkSection_$1$2(void)
+tcRdWrShrinkSection$3_$1$2(void)
 {
 	int error, fd, result;
 	unsigned int flag;
@@ -1865,6 +2127,13 @@ tcRdWrShrinkSection_$1$2(void)
 
 	/* Open the copied object in RDWR mode. */
 	_TS_OPEN_FILE(e, tfn, ELF_C_RDWR, fd, goto done;);
+ifelse($3,`Parallel',`
+	if (elf_cntl(e, ELF_C_PARALLEL) != 0) {
+		TP_FAIL("elf_cntl(PARALLEL) failed: \"%s\".",
+		    elf_errmsg(-1));
+		goto done;
+	}
+')
 
 	if (stat(reffile, &sb) < 0) {
 		TP_UNRESOLVED("stat() failed: \"%s\".", strerror(errno));
@@ -1951,6 +2220,257 @@ FN(32,lsb)
 FN(32,msb)
 FN(64,lsb)
 FN(64,msb)
+FN(32,lsb,`Parallel')
+FN(32,msb,`Parallel')
+FN(64,lsb,`Parallel')
+FN(64,msb,`Parallel')
+
+/*
+ * Objects opened with ELF_C_WRITE on a regular file are streamed out
+ * an extent at a time, while those on pipes are assembled in memory
+ * and written out in one go.  Check that both paths produce the same
+ * bytes for an object with gaps between its extents and with a section
+ * larger than the library's staging buffer.
+ */
+
+#define	STREAM_FILL		0x5A
+#define	STREAM_NWORDS		(48 * 1024)
+#define	STREAM_DATA_OFFSET	0x1000
+#define	STREAM_GAP		0x100
+
+static const char stream_strtab[] = "\0.data\0.shstrtab";
+static uint32_t stream_words[STREAM_NWORDS];
+
+struct stream_reader {
+	int	sr_rfd;		/* Read end of the pipe. */
+	int	sr_wfd;		/* File to copy the pipe's contents to. */
+	int	sr_error;	/* errno on failure. */
+};
+
+static void *
+stream_reader(void *arg)
+{
+	char buf[4096];
+	ssize_t n;
+	struct stream_reader *sr;
+
+	sr = arg;
+	while ((n = read(sr->sr_rfd, buf, sizeof(buf))) != 0) {
+		if (n < 0) {
+			if (errno == EINTR)
+				continue;
+			sr->sr_error = errno;
+			break;
+		}
+		if (write(sr->sr_wfd, buf, (size_t) n) != n) {
+			sr->sr_error = errno;
+			break;
+		}
+	}
+
+	return (NULL);
+}
+
+undefine(`FN')
+define(`FN',`
+static int
+stream_build$1$2(int fd)
+{
+	int result;
+	off_t fsz;
+	size_t esz, psz, ssz, off;
+	Elf *e;
+	Elf_Data *d;
+	Elf_Scn *scn;
+	Elf$1_Ehdr *eh;
+	Elf$1_Phdr *ph;
+	Elf$1_Shdr *sh;
+
+	result = TET_UNRESOLVED;
+
+	if ((e = elf_begin(fd, ELF_C_WRITE, NULL)) == NULL) {
+		TP_UNRESOLVED("elf_begin() failed: \"%s\".", elf_errmsg(-1));
+		return (result);
+	}
+
+	if ((eh = elf$1_newehdr(e)) == NULL ||
+	    (ph = elf$1_newphdr(e, 1)) == NULL) {
+		TP_UNRESOLVED("elf$1_new[ep]hdr() failed: \"%s\".",
+		    elf_errmsg(-1));
+		goto done;
+	}
+
+	eh->e_ident[EI_DATA] = ELFDATA2`'TOUPPER($2);
+	eh->e_machine = MAKE_EM($1,$2);
+	eh->e_type = ET_REL;
+	eh->e_shstrndx = 2;
+
+	esz = elf$1_fsize(ELF_T_EHDR, 1, EV_CURRENT);
+	psz = elf$1_fsize(ELF_T_PHDR, 1, EV_CURRENT);
+	ssz = elf$1_fsize(ELF_T_SHDR, 1, EV_CURRENT);
+
+	INIT_PHDR(ph);
+	eh->e_phoff = esz;
+
+	/* A word-sized section that needs translation for one byte order. */
+	if ((scn = elf_newscn(e)) == NULL || (d = elf_newdata(scn)) == NULL ||
+	    (sh = elf$1_getshdr(scn)) == NULL) {
+		TP_UNRESOLVED("section 1: \"%s\".", elf_errmsg(-1));
+		goto done;
+	}
+
+	d->d_buf = stream_words;
+	d->d_size = sizeof(stream_words);
+	d->d_off = (off_t) 0;
+	d->d_type = ELF_T_WORD;
+	d->d_align = 4;
+
+	off = STREAM_DATA_OFFSET;
+	sh->sh_name = 1;
+	sh->sh_type = SHT_PROGBITS;
+	sh->sh_offset = off;
+	sh->sh_size = sizeof(stream_words);
+	sh->sh_addralign = 4;
+	off += sizeof(stream_words) + STREAM_GAP;
+
+	/* The section name string table. */
+	if ((scn = elf_newscn(e)) == NULL || (d = elf_newdata(scn)) == NULL ||
+	    (sh = elf$1_getshdr(scn)) == NULL) {
+		TP_UNRESOLVED("section 2: \"%s\".", elf_errmsg(-1));
+		goto done;
+	}
+
+	d->d_buf = (char *) stream_strtab;
+	d->d_size = sizeof(stream_strtab);
+	d->d_off = (off_t) 0;
+
+	sh->sh_name = 7;
+	sh->sh_type = SHT_STRTAB;
+	sh->sh_offset = off;
+	sh->sh_size = sizeof(stream_strtab);
+	sh->sh_addralign = 1;
+	off += sizeof(stream_strtab) + STREAM_GAP;
+
+	off = (off + 7) & ~(size_t) 7;
+	eh->e_shoff = off;
+
+	(void) elf_flagelf(e, ELF_C_SET, ELF_F_LAYOUT);
+
+	if ((fsz = elf_update(e, ELF_C_WRITE)) != (off_t) (off + 3 * ssz)) {
+		TP_FAIL("elf_update() returned %jd, expected %jd: \"%s\".",
+		    (intmax_t) fsz, (intmax_t) (off + 3 * ssz),
+		    elf_errmsg(-1));
+		result = TET_FAIL;
+		goto done;
+	}
+
+	result = TET_PASS;
+
+ done:
+	(void) elf_end(e);
+	return (result);
+}
+
+void
+tcStreamedWrite$1$2(void)
+{
+	int fd, pfd[2], result, started;
+	size_t i;
+	pthread_t tid;
+	struct stream_reader sr;
+	const char *buffered = "buffered.$2$1";
+
+	TP_CHECK_INITIALIZATION();
+
+	TP_ANNOUNCE("TOUPPER($2)$1: a streamed ELF_C_WRITE object matches "
+	    "one assembled in memory.");
+
+	result = TET_UNRESOLVED;
+	fd = pfd[0] = pfd[1] = -1;
+	started = 0;
+	sr.sr_wfd = -1;
+
+	for (i = 0; i < STREAM_NWORDS; i++)
+		stream_words[i] = (uint32_t) (i * 0x01020304U);
+
+	(void) elf_fill(STREAM_FILL);
+
+	/* Stream the object out to a regular file. */
+	if ((fd = open(TS_NEWFILE, O_RDWR|O_CREAT|O_TRUNC, 0666)) < 0) {
+		TP_UNRESOLVED("open(%s) failed: \"%s\".", TS_NEWFILE,
+		    strerror(errno));
+		goto done;
+	}
+
+	if ((result = stream_build$1$2(fd)) != TET_PASS)
+		goto done;
+
+	(void) close(fd);
+	fd = -1;
+
+	/* Write it out again through a pipe. */
+	result = TET_UNRESOLVED;
+	if ((sr.sr_wfd = open(buffered, O_WRONLY|O_CREAT|O_TRUNC,
+	    0666)) < 0 || pipe(pfd) < 0) {
+		TP_UNRESOLVED("open/pipe failed: \"%s\".", strerror(errno));
+		goto done;
+	}
+
+	sr.sr_rfd = pfd[0];
+	sr.sr_error = 0;
+	if (pthread_create(&tid, NULL, stream_reader, &sr) != 0) {
+		TP_UNRESOLVED("pthread_create() failed.");
+		goto done;
+	}
+	started = 1;
+
+	result = stream_build$1$2(pfd[1]);
+
+	(void) close(pfd[1]);
+	pfd[1] = -1;
+	(void) pthread_join(tid, NULL);
+	started = 0;
+
+	if (result != TET_PASS)
+		goto done;
+
+	if (sr.sr_error != 0) {
+		TP_UNRESOLVED("reading the pipe failed: \"%s\".",
+		    strerror(sr.sr_error));
+		result = TET_UNRESOLVED;
+		goto done;
+	}
+
+	(void) close(sr.sr_wfd);
+	sr.sr_wfd = -1;
+
+	result = elfts_compare_files(buffered, TS_NEWFILE);
+
+ done:
+	if (started) {
+		(void) close(pfd[1]);
+		pfd[1] = -1;
+		(void) pthread_join(tid, NULL);
+	}
+	(void) elf_fill(0);
+	if (fd != -1)
+		(void) close(fd);
+	if (pfd[0] != -1)
+		(void) close(pfd[0]);
+	if (pfd[1] != -1)
+		(void) close(pfd[1]);
+	if (sr.sr_wfd != -1)
+		(void) close(sr.sr_wfd);
+	(void) unlink(TS_NEWFILE);
+	(void) unlink(buffered);
+
+	tet_result(result);
+}')
+
+FN(32,`lsb')
+FN(32,`msb')
+FN(64,`lsb')
+FN(64,`msb')
 
 /*
  * Test cases rejecting malformed ELF files created with the
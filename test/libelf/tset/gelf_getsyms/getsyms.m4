@@ -0,0 +1,364 @@
+/*-
+ * Copyright (c) 2026, Elftoolchain Project Contributors.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE AUTHOR AND CONTRIBUTORS ``AS IS'' AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED.  IN NO EVENT SHALL THE AUTHOR OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS
+ * OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY
+ * OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+ * SUCH DAMAGE.
+ *
+ * $Id$
+ */
+
+#include <sys/types.h>
+
+#include <gelf.h>
+#include <libelf.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+#include "elfts.h"
+#include "tet_api.h"
+
+IC_REQUIRES_VERSION_INIT();
+
+include(`elfts.m4')
+
+/*
+ * Tests for the `gelf_getsyms', `gelf_getrels' and `gelf_getrelas'
+ * APIs.  The entries they return are compared against those returned
+ * by the single entry APIs.
+ */
+
+#define	TS_NENTRIES	100		/* #entries in each section */
+#define	TS_BATCH	7		/* #entries retrieved per call */
+
+/*
+ * Section indices in the test file.
+ */
+#define	TS_SYMNDX	1
+#define	TS_RELNDX	2
+#define	TS_RELANDX	3
+
+/*
+ * Add a symbol table, and sections holding relocation entries with
+ * and without addends.
+ */
+static int
+add_sections(Elf *e, void *arg)
+{
+	int ec;
+	size_t i;
+	GElf_Shdr sh;
+	GElf_Sym sym;
+	GElf_Rel rel;
+	GElf_Rela rela;
+	static char buf[3][TS_NENTRIES * sizeof(Elf64_Rela)];
+	static const struct {
+		uint32_t	type;
+		Elf_Type	dtype;
+	} scns[] = {
+		{ SHT_SYMTAB,	ELF_T_SYM },
+		{ SHT_REL,	ELF_T_REL },
+		{ SHT_RELA,	ELF_T_RELA }
+	};
+
+	(void) arg;
+
+	ec = gelf_getclass(e);
+
+	for (i = 0; i < sizeof(scns) / sizeof(scns[0]); i++) {
+		(void) memset(&sh, 0, sizeof(sh));
+		sh.sh_type = scns[i].type;
+		if (elfts_new_section(e, &sh, scns[i].dtype, buf[i],
+		    gelf_fsize(e, scns[i].dtype, TS_NENTRIES,
+		    EV_CURRENT)) == NULL)
+			return (-1);
+	}
+
+	for (i = 0; i < TS_NENTRIES; i++) {
+		sym.st_name = (uint32_t) (i * 3);
+		sym.st_value = 0x1000 + i * 0x10;
+		sym.st_size = i;
+		sym.st_info = GELF_ST_INFO(i % 3, i % 4);
+		sym.st_other = (unsigned char) (i % 4);
+		sym.st_shndx = (uint16_t) (i % 5);
+
+		rela.r_offset = rel.r_offset = 0x2000 + i * 4;
+		rela.r_info = rel.r_info = ec == ELFCLASS32 ?
+		    GELF_R_INFO(i, i % 11) : GELF_R_INFO(i + 0x10000, i % 11);
+		rela.r_addend = (int64_t) i - 50;
+
+		if (!gelf_update_sym(elf_getdata(elf_getscn(e, TS_SYMNDX),
+		    NULL), (int) i, &sym) ||
+		    !gelf_update_rel(elf_getdata(elf_getscn(e, TS_RELNDX),
+		    NULL), (int) i, &rel) ||
+		    !gelf_update_rela(elf_getdata(elf_getscn(e, TS_RELANDX),
+		    NULL), (int) i, &rela)) {
+			tet_printf("U: cannot create file: \"%s\".",
+			    elf_errmsg(-1));
+			return (-1);
+		}
+	}
+
+	return (0);
+}
+
+static int
+make_file(int ec, int ed)
+{
+	return (elfts_make_file(TS_NEWFILE, ec, ed, ET_REL, add_sections,
+	    NULL));
+}
+
+/*
+ * Open TS_NEWFILE and retrieve the data for section `ndx'.
+ */
+static Elf_Data *
+open_data(Elf **e, int *fd, size_t ndx)
+{
+	Elf_Scn *scn;
+	Elf_Data *d;
+
+	if ((*e = elfts_open_file(TS_NEWFILE, ELF_C_READ, fd)) == NULL)
+		return (NULL);
+
+	if ((scn = elf_getscn(*e, ndx)) == NULL ||
+	    (d = elf_getdata(scn, NULL)) == NULL) {
+		tet_printf("U: cannot retrieve data: \"%s\".", elf_errmsg(-1));
+		(void) elf_end(*e);
+		*e = NULL;
+		(void) close(*fd);
+		return (NULL);
+	}
+
+	return (d);
+}
+
+/*
+ * NULL arguments are rejected.
+ */
+void
+tcArgsNull(void)
+{
+	int error, fd, result;
+	Elf *e;
+	Elf_Data *d;
+	GElf_Sym sym;
+	GElf_Rel rel;
+	GElf_Rela rela;
+
+	TP_CHECK_INITIALIZATION();
+
+	TP_ANNOUNCE("NULL arguments are rejected.");
+
+	if (make_file(ELFCLASS64, ELFDATA2LSB) < 0) {
+		tet_result(TET_UNRESOLVED);
+		return;
+	}
+
+	result = TET_PASS;
+
+	if (gelf_getsyms(NULL, 0, 1, &sym) != NULL ||
+	    (error = elf_errno()) != ELF_E_ARGUMENT)
+		TP_FAIL("gelf_getsyms(NULL) error=%d.", error);
+	else if (gelf_getrels(NULL, 0, 1, &rel) != NULL ||
+	    (error = elf_errno()) != ELF_E_ARGUMENT)
+		TP_FAIL("gelf_getrels(NULL) error=%d.", error);
+	else if (gelf_getrelas(NULL, 0, 1, &rela) != NULL ||
+	    (error = elf_errno()) != ELF_E_ARGUMENT)
+		TP_FAIL("gelf_getrelas(NULL) error=%d.", error);
+
+	if (result == TET_PASS) {
+		if ((d = open_data(&e, &fd, TS_SYMNDX)) == NULL) {
+			result = TET_UNRESOLVED;
+			goto done;
+		}
+		if (gelf_getsyms(d, 0, 1, NULL) != NULL ||
+		    (error = elf_errno()) != ELF_E_ARGUMENT)
+			TP_FAIL("gelf_getsyms(dst=NULL) error=%d.", error);
+		(void) elf_end(e);
+		(void) close(fd);
+	}
+
+ done:
+	(void) unlink(TS_NEWFILE);
+	tet_result(result);
+}
+
+/*
+ * Ranges extending beyond the end of the data are rejected, and empty
+ * ranges are accepted.
+ */
+define(`FN',`
+void
+tcArgsRange$1(void)
+{
+	int error, fd, result;
+	Elf *e;
+	Elf_Data *d;
+	GElf_Sym sym[2];
+
+	TP_CHECK_INITIALIZATION();
+
+	TP_ANNOUNCE("ELFCLASS$1: out of range entries are rejected.");
+
+	if (make_file(ELFCLASS$1, ELFDATA2LSB) < 0 ||
+	    (d = open_data(&e, &fd, TS_SYMNDX)) == NULL) {
+		tet_result(TET_UNRESOLVED);
+		return;
+	}
+
+	result = TET_PASS;
+
+	if (gelf_getsyms(d, TS_NENTRIES - 1, 2, sym) != NULL ||
+	    (error = elf_errno()) != ELF_E_ARGUMENT)
+		TP_FAIL("count past end: error=%d.", error);
+	else if (gelf_getsyms(d, TS_NENTRIES + 1, 0, sym) != NULL ||
+	    (error = elf_errno()) != ELF_E_ARGUMENT)
+		TP_FAIL("first past end: error=%d.", error);
+	else if (gelf_getsyms(d, 1, ~(size_t) 0, sym) != NULL ||
+	    (error = elf_errno()) != ELF_E_ARGUMENT)
+		TP_FAIL("overflowing count: error=%d.", error);
+	else if (gelf_getsyms(d, TS_NENTRIES, 0, sym) != sym)
+		TP_FAIL("empty range: \"%s\".", elf_errmsg(-1));
+
+	(void) elf_end(e);
+	(void) close(fd);
+	(void) unlink(TS_NEWFILE);
+	tet_result(result);
+}')
+
+FN(32)
+FN(64)
+
+/*
+ * Sections of the wrong type are rejected.
+ */
+void
+tcArgsType(void)
+{
+	int error, fd, result;
+	Elf *e;
+	Elf_Data *d;
+	GElf_Sym sym;
+	GElf_Rela rela;
+
+	TP_CHECK_INITIALIZATION();
+
+	TP_ANNOUNCE("sections of the wrong type are rejected.");
+
+	if (make_file(ELFCLASS32, ELFDATA2LSB) < 0 ||
+	    (d = open_data(&e, &fd, TS_RELNDX)) == NULL) {
+		tet_result(TET_UNRESOLVED);
+		return;
+	}
+
+	result = TET_PASS;
+
+	if (gelf_getsyms(d, 0, 1, &sym) != NULL ||
+	    (error = elf_errno()) != ELF_E_ARGUMENT)
+		TP_FAIL("gelf_getsyms(REL) error=%d.", error);
+	else if (gelf_getrelas(d, 0, 1, &rela) != NULL ||
+	    (error = elf_errno()) != ELF_E_ARGUMENT)
+		TP_FAIL("gelf_getrelas(REL) error=%d.", error);
+
+	(void) elf_end(e);
+	(void) close(fd);
+	(void) unlink(TS_NEWFILE);
+	tet_result(result);
+}
+
+/*
+ * The entries retrieved in batches match those retrieved one at a
+ * time.  ELFCLASS64 entries are returned in place.
+ *
+ * Arguments: class, byte order, type name, GElf type, section index.
+ */
+undefine(`FN')
+define(`FN',`
+void
+tc$3$1`'TOUPPER($2)(void)
+{
+	int fd, result;
+	size_t i, j, n;
+	Elf *e;
+	Elf_Data *d;
+	GElf_$3 buf[TS_BATCH], one;
+	const GElf_$3 *p;
+
+	TP_CHECK_INITIALIZATION();
+
+	TP_ANNOUNCE("TOUPPER($2)$1: gelf_get`'TOLOWER($3)s() "
+	    "matches gelf_get`'TOLOWER($3)().");
+
+	if (make_file(ELFCLASS$1, ELFDATA2`'TOUPPER($2)) < 0 ||
+	    (d = open_data(&e, &fd, $4)) == NULL) {
+		tet_result(TET_UNRESOLVED);
+		return;
+	}
+
+	result = TET_PASS;
+
+	for (i = 0; i < TS_NENTRIES && result == TET_PASS; i += n) {
+		n = TS_NENTRIES - i < TS_BATCH ? TS_NENTRIES - i : TS_BATCH;
+
+		if ((p = gelf_get`'TOLOWER($3)s(d, i, n, buf)) ==
+		    NULL) {
+			TP_FAIL("i=%d: \"%s\".", (int) i, elf_errmsg(-1));
+			break;
+		}
+
+		if (p != ifelse($1,32,`buf',
+		    `(const GElf_$3 *) d->d_buf + i')) {
+			TP_FAIL("i=%d: unexpected pointer.", (int) i);
+			break;
+		}
+
+		for (j = 0; j < n; j++) {
+			if (gelf_get`'TOLOWER($3)(d, (int) (i + j),
+			    &one) == NULL) {
+				TP_UNRESOLVED("i=%d: \"%s\".", (int) (i + j),
+				    elf_errmsg(-1));
+				break;
+			}
+			if (memcmp(&one, &p[j], sizeof(one)) != 0) {
+				TP_FAIL("entry %d differs.", (int) (i + j));
+				break;
+			}
+		}
+	}
+
+	(void) elf_end(e);
+	(void) close(fd);
+	(void) unlink(TS_NEWFILE);
+	tet_result(result);
+}')
+
+define(`MKFN',`
+FN(32,`lsb',$1,$2)
+FN(32,`msb',$1,$2)
+FN(64,`lsb',$1,$2)
+FN(64,`msb',$1,$2)')
+
+MKFN(`Sym',TS_SYMNDX)
+MKFN(`Rel',TS_RELNDX)
+MKFN(`Rela',TS_RELANDX)
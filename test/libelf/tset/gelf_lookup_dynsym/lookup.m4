@@ -0,0 +1,493 @@
+/*-
+ * Copyright (c) 2026, Elftoolchain Project Contributors.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE AUTHOR AND CONTRIBUTORS ``AS IS'' AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED.  IN NO EVENT SHALL THE AUTHOR OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS
+ * OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY
+ * OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+ * SUCH DAMAGE.
+ *
+ * $Id$
+ */
+
+#include <sys/types.h>
+
+#include <gelf.h>
+#include <libelf.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+#include "elfts.h"
+#include "tet_api.h"
+
+IC_REQUIRES_VERSION_INIT();
+
+include(`elfts.m4')
+
+/*
+ * Tests for the `gelf_lookup_dynsym' API.
+ *
+ * The test objects have a dynamic symbol table with undefined symbols
+ * followed by defined ones, and optionally a hash section.  Defined
+ * symbol "symN" has value TS_VALUE+N.
+ *
+ * Versioned test objects also have a SHT_GNU_versym section, and two
+ * of their names have a second definition that is marked hidden and
+ * has value zero.  One of these precedes the default definition in the
+ * symbol table, the other follows it.
+ */
+
+#define	TS_NSYMS	64		/* #entries in the symbol table */
+#define	TS_NUNDEF	8		/* #undefined symbols */
+#define	TS_NBUCKETS	7
+#define	TS_MASKWORDS	2
+#define	TS_SHIFT2	6
+#define	TS_NAMESZ	16
+#define	TS_VALUE	0x1000
+
+#define	TS_HASH_NONE	0
+#define	TS_HASH_GNU	1
+#define	TS_HASH_SYSV	2
+
+static char names[TS_NSYMS][TS_NAMESZ];
+static uint32_t hashes[TS_NSYMS];
+static int hidden[TS_NSYMS];
+
+static int
+cmp_bucket(const void *a, const void *b)
+{
+	uint32_t ba, bb;
+
+	ba = (uint32_t) elf_gnu_hash(a) % TS_NBUCKETS;
+	bb = (uint32_t) elf_gnu_hash(b) % TS_NBUCKETS;
+
+	return (ba < bb ? -1 : ba > bb);
+}
+
+/*
+ * Lay out the symbol names.  For SHT_GNU_HASH sections the defined
+ * symbols need to be grouped by hash bucket.
+ */
+static void
+make_names(int kind, int versioned)
+{
+	int i;
+
+	(void) memset(names, 0, sizeof(names));
+	(void) memset(hidden, 0, sizeof(hidden));
+
+	for (i = 1; i < TS_NSYMS; i++)
+		(void) snprintf(names[i], TS_NAMESZ, "%s%d",
+		    i <= TS_NUNDEF ? "undef" : "sym", i);
+
+	if (versioned) {
+		(void) strcpy(names[TS_NUNDEF + 2], names[TS_NUNDEF + 1]);
+		(void) strcpy(names[TS_NUNDEF + 4], names[TS_NUNDEF + 3]);
+	}
+
+	if (kind == TS_HASH_GNU)
+		qsort(names[TS_NUNDEF + 1], TS_NSYMS - TS_NUNDEF - 1,
+		    TS_NAMESZ, cmp_bucket);
+
+	/* Entries sharing a name remain adjacent after sorting. */
+	for (i = TS_NUNDEF + 1; versioned && i < TS_NSYMS - 1; i++) {
+		if (strcmp(names[i], names[i + 1]) != 0)
+			continue;
+		if (strtoul(names[i] + 3, NULL, 10) == TS_NUNDEF + 1)
+			hidden[i] = 1;
+		else
+			hidden[i + 1] = 1;
+	}
+
+	for (i = 1; i < TS_NSYMS; i++)
+		hashes[i] = (uint32_t) elf_gnu_hash(names[i]);
+}
+
+/*
+ * Build the contents of a SHT_GNU_HASH section.
+ */
+static void *
+make_gnu_hash(int ec, size_t *sz)
+{
+	Elf_GNU_Hash_Header *gh;
+	uint32_t *buckets, *chains, *bloom32, h;
+	uint64_t *bloom64;
+	size_t i, b, nbits, symoff, wordsz;
+	unsigned char *buf;
+
+	symoff = TS_NUNDEF + 1;
+	wordsz = ec == ELFCLASS32 ? sizeof(uint32_t) : sizeof(uint64_t);
+	nbits = wordsz * 8;
+
+	*sz = sizeof(*gh) + TS_MASKWORDS * wordsz +
+	    (TS_NBUCKETS + TS_NSYMS - symoff) * sizeof(uint32_t);
+	if ((buf = calloc(1, *sz)) == NULL)
+		return (NULL);
+
+	gh = (Elf_GNU_Hash_Header *) buf;
+	gh->gh_nbuckets = TS_NBUCKETS;
+	gh->gh_symndx = symoff;
+	gh->gh_maskwords = TS_MASKWORDS;
+	gh->gh_shift2 = TS_SHIFT2;
+
+	bloom32 = (uint32_t *) (buf + sizeof(*gh));
+	bloom64 = (uint64_t *) (buf + sizeof(*gh));
+	buckets = (uint32_t *) (buf + sizeof(*gh) + TS_MASKWORDS * wordsz);
+	chains = buckets + TS_NBUCKETS;
+
+	for (i = symoff; i < TS_NSYMS; i++) {
+		h = hashes[i];
+		b = (h / nbits) % TS_MASKWORDS;
+		if (ec == ELFCLASS32)
+			bloom32[b] |= (1U << (h % nbits)) |
+			    (1U << ((h >> TS_SHIFT2) % nbits));
+		else
+			bloom64[b] |= (1ULL << (h % nbits)) |
+			    (1ULL << ((h >> TS_SHIFT2) % nbits));
+
+		b = h % TS_NBUCKETS;
+		if (buckets[b] == 0)
+			buckets[b] = (uint32_t) i;
+
+		chains[i - symoff] = h & ~1U;
+		if (i == TS_NSYMS - 1 || hashes[i + 1] % TS_NBUCKETS != b)
+			chains[i - symoff] |= 1;
+	}
+
+	return (buf);
+}
+
+/*
+ * Build the contents of a SHT_HASH section.
+ */
+static void *
+make_sysv_hash(size_t *sz)
+{
+	uint32_t *buf, *buckets, *chains;
+	size_t b, i;
+
+	*sz = (2 + TS_NBUCKETS + TS_NSYMS) * sizeof(uint32_t);
+	if ((buf = calloc(1, *sz)) == NULL)
+		return (NULL);
+
+	buf[0] = TS_NBUCKETS;
+	buf[1] = TS_NSYMS;
+	buckets = buf + 2;
+	chains = buckets + TS_NBUCKETS;
+
+	for (i = 1; i < TS_NSYMS; i++) {
+		b = elf_hash(names[i]) % TS_NBUCKETS;
+		chains[i] = buckets[b];
+		buckets[b] = (uint32_t) i;
+	}
+
+	return (buf);
+}
+
+struct filespec {
+	int	kind;
+	int	versioned;
+	void	*hash;
+};
+
+/*
+ * Add a dynamic symbol table in sections 1 and 2, followed by a hash
+ * section of the specified kind and, for versioned objects, by a
+ * SHT_GNU_versym section.
+ */
+static int
+add_sections(Elf *e, void *arg)
+{
+	int ec;
+	size_t i, n, off;
+	Elf_Scn *scn;
+	GElf_Shdr sh;
+	GElf_Sym sym;
+	struct filespec *fs;
+	static char symtab[TS_NSYMS * sizeof(Elf64_Sym)];
+	static char strtab[TS_NSYMS * TS_NAMESZ];
+	static uint16_t versym[TS_NSYMS];
+
+	fs = arg;
+	ec = gelf_getclass(e);
+
+	(void) memset(strtab, 0, sizeof(strtab));
+	for (i = 1, off = 1; i < TS_NSYMS; i++) {
+		versym[i] = hidden[i] ? (VERSYM_HIDDEN | 2) : 1;
+		(void) strcpy(strtab + off, names[i]);
+		off += strlen(names[i]) + 1;
+	}
+
+	(void) memset(&sh, 0, sizeof(sh));
+	sh.sh_type = SHT_DYNSYM;
+	sh.sh_link = 2;
+	if ((scn = elfts_new_section(e, &sh, ELF_T_SYM, symtab,
+	    gelf_fsize(e, ELF_T_SYM, TS_NSYMS, EV_CURRENT))) == NULL)
+		return (-1);
+
+	for (i = 1, off = 1; i < TS_NSYMS; i++) {
+		(void) memset(&sym, 0, sizeof(sym));
+		sym.st_name = (uint32_t) off;
+		sym.st_info = GELF_ST_INFO(STB_GLOBAL, STT_FUNC);
+		if (i > TS_NUNDEF) {
+			sym.st_shndx = 1;
+			if (!hidden[i])
+				sym.st_value = TS_VALUE + strtoul(names[i] + 3,
+				    NULL, 10);
+		}
+		if (gelf_update_sym(elf_getdata(scn, NULL), (int) i,
+		    &sym) == 0) {
+			tet_printf("U: cannot create file: \"%s\".",
+			    elf_errmsg(-1));
+			return (-1);
+		}
+		off += strlen(names[i]) + 1;
+	}
+
+	(void) memset(&sh, 0, sizeof(sh));
+	sh.sh_type = SHT_STRTAB;
+	if (elfts_new_section(e, &sh, ELF_T_BYTE, strtab, off) == NULL)
+		return (-1);
+
+	if (fs->kind != TS_HASH_NONE) {
+		(void) memset(&sh, 0, sizeof(sh));
+		sh.sh_link = 1;
+		if (fs->kind == TS_HASH_GNU) {
+			sh.sh_type = SHT_GNU_HASH;
+			fs->hash = make_gnu_hash(ec, &n);
+		} else {
+			sh.sh_type = SHT_HASH;
+			sh.sh_entsize = sizeof(uint32_t);
+			fs->hash = make_sysv_hash(&n);
+		}
+		if (fs->hash == NULL) {
+			tet_printf("U: cannot allocate the hash section.");
+			return (-1);
+		}
+		if (elfts_new_section(e, &sh, fs->kind == TS_HASH_GNU ?
+		    ELF_T_GNUHASH : ELF_T_WORD, fs->hash, n) == NULL)
+			return (-1);
+	}
+
+	if (fs->versioned) {
+		(void) memset(&sh, 0, sizeof(sh));
+		sh.sh_type = SHT_GNU_versym;
+		sh.sh_link = 1;
+		sh.sh_entsize = sizeof(uint16_t);
+		if (elfts_new_section(e, &sh, ELF_T_HALF, versym,
+		    sizeof(versym)) == NULL)
+			return (-1);
+	}
+
+	return (0);
+}
+
+static int
+make_file(int ec, int ed, int kind, int versioned)
+{
+	int ret;
+	struct filespec fs;
+
+	make_names(kind, versioned);
+
+	fs.kind = kind;
+	fs.versioned = versioned;
+	fs.hash = NULL;
+
+	ret = elfts_make_file(TS_NEWFILE, ec, ed, ET_DYN, add_sections, &fs);
+
+	free(fs.hash);
+
+	return (ret);
+}
+
+/*
+ * Invalid arguments are rejected.
+ */
+void
+tcArgsInvalid(void)
+{
+	int error, fd, result;
+	Elf *e;
+	GElf_Sym sym;
+	char image[16];
+
+	TP_CHECK_INITIALIZATION();
+
+	TP_ANNOUNCE("invalid arguments are rejected.");
+
+	result = TET_PASS;
+
+	(void) memset(image, 0, sizeof(image));
+	if ((e = elf_memory(image, sizeof(image))) == NULL) {
+		TP_UNRESOLVED("elf_memory() failed: \"%s\".", elf_errmsg(-1));
+		goto done;
+	}
+
+	if (gelf_lookup_dynsym(NULL, "sym", &sym) != NULL ||
+	    (error = elf_errno()) != ELF_E_ARGUMENT)
+		TP_FAIL("elf=NULL: error=%d.", error);
+	else if (gelf_lookup_dynsym(e, "sym", &sym) != NULL ||
+	    (error = elf_errno()) != ELF_E_ARGUMENT)
+		TP_FAIL("non-ELF descriptor: error=%d.", error);
+
+	(void) elf_end(e);
+
+	if (result != TET_PASS ||
+	    make_file(ELFCLASS64, ELFDATA2LSB, TS_HASH_NONE, 0) < 0)
+		goto done;
+
+	if ((e = elfts_open_file(TS_NEWFILE, ELF_C_READ, &fd)) == NULL) {
+		result = TET_UNRESOLVED;
+		goto done;
+	}
+
+	if (gelf_lookup_dynsym(e, NULL, &sym) != NULL ||
+	    (error = elf_errno()) != ELF_E_ARGUMENT)
+		TP_FAIL("name=NULL: error=%d.", error);
+	else if (gelf_lookup_dynsym(e, "sym", NULL) != NULL ||
+	    (error = elf_errno()) != ELF_E_ARGUMENT)
+		TP_FAIL("dst=NULL: error=%d.", error);
+
+	(void) elf_end(e);
+	(void) close(fd);
+
+ done:
+	(void) unlink(TS_NEWFILE);
+	tet_result(result);
+}
+
+/*
+ * Lookups in an object without a dynamic symbol table fail without
+ * setting an error.
+ */
+void
+tcNoDynsym(void)
+{
+	int error, fd, result;
+	Elf *e;
+	GElf_Sym sym;
+
+	TP_CHECK_INITIALIZATION();
+
+	TP_ANNOUNCE("objects without a dynamic symbol table are handled.");
+
+	result = TET_UNRESOLVED;
+	e = NULL;
+
+	if (elfts_make_file(TS_NEWFILE, ELFCLASS64, ELFDATA2LSB, ET_NONE,
+	    NULL, NULL) < 0)
+		goto done;
+
+	if ((e = elfts_open_file(TS_NEWFILE, ELF_C_READ, &fd)) == NULL)
+		goto done;
+
+	result = TET_PASS;
+	(void) elf_errno();
+	if (gelf_lookup_dynsym(e, "sym10", &sym) != NULL ||
+	    (error = elf_errno()) != ELF_E_NONE)
+		TP_FAIL("error=%d.", error);
+
+ done:
+	if (e) {
+		(void) elf_end(e);
+		(void) close(fd);
+	}
+	(void) unlink(TS_NEWFILE);
+	tet_result(result);
+}
+
+/*
+ * Every defined symbol is found, while undefined and unknown names are
+ * not.  Names with several versions resolve to the default version.
+ *
+ * Arguments: hash section kind, class, byte order, and optionally
+ * `Versioned'.
+ */
+define(`FN',`
+void
+tcLookup$1$4$2`'TOUPPER($3)(void)
+{
+	int error, fd, result;
+	size_t i;
+	Elf *e;
+	GElf_Sym sym;
+
+	TP_CHECK_INITIALIZATION();
+
+	TP_ANNOUNCE("TOUPPER($3)$2: lookups with hash section kind "
+	    "\"TOLOWER($1)\" succeed`'ifelse($4,,,` for versioned names')`'.");
+
+	if (make_file(ELFCLASS$2, ELFDATA2`'TOUPPER($3),
+	    TS_HASH_`'TOUPPER($1), ifelse($4,,0,1)) < 0 ||
+	    (e = elfts_open_file(TS_NEWFILE, ELF_C_READ, &fd)) == NULL) {
+		tet_result(TET_UNRESOLVED);
+		return;
+	}
+
+	result = TET_PASS;
+	(void) elf_errno();
+
+	for (i = 1; i < TS_NSYMS; i++) {
+		if (i <= TS_NUNDEF) {
+			if (gelf_lookup_dynsym(e, names[i], &sym) != NULL) {
+				TP_FAIL("\"%s\" was found.", names[i]);
+				break;
+			}
+			continue;
+		}
+		if (gelf_lookup_dynsym(e, names[i], &sym) == NULL) {
+			TP_FAIL("\"%s\" not found: \"%s\".", names[i],
+			    elf_errmsg(-1));
+			break;
+		}
+		if (sym.st_value != TS_VALUE + strtoul(names[i] + 3, NULL,
+		    10)) {
+			TP_FAIL("\"%s\": unexpected value 0x%jx.", names[i],
+			    (uintmax_t) sym.st_value);
+			break;
+		}
+	}
+
+	if (result == TET_PASS &&
+	    (gelf_lookup_dynsym(e, "nonexistent", &sym) != NULL ||
+	    (error = elf_errno()) != ELF_E_NONE))
+		TP_FAIL("unknown name: error=%d.", error);
+
+	(void) elf_end(e);
+	(void) close(fd);
+	(void) unlink(TS_NEWFILE);
+	tet_result(result);
+}')
+
+define(`MKFN',`
+FN($1,32,`lsb',$2)
+FN($1,32,`msb',$2)
+FN($1,64,`lsb',$2)
+FN($1,64,`msb',$2)')
+
+MKFN(`Gnu')
+MKFN(`Sysv')
+MKFN(`None')
+MKFN(`Gnu',`Versioned')
+MKFN(`Sysv',`Versioned')
+MKFN(`None',`Versioned')
@@ -0,0 +1,185 @@
+/*-
+ * Copyright (c) 2026, Elftoolchain Project Contributors.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE AUTHOR AND CONTRIBUTORS ``AS IS'' AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED.  IN NO EVENT SHALL THE AUTHOR OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS
+ * OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY
+ * OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+ * SUCH DAMAGE.
+ *
+ * $Id$
+ */
+
+/*
+ * Measure the cost of building a large string table, as elfcopy(1)
+ * does when it rebuilds the symbol string table of an object.
+ *
+ * Distinct symbol-like names are inserted and looked up again.  A
+ * quarter of the strings are then removed, and the image of the table
+ * is retrieved, which compacts the table.  Finally, the tails of half
+ * of the names are added and a merged image, in which these share the
+ * storage of the full names, is built.
+ */
+
+#include <sys/types.h>
+#include <sys/resource.h>
+#include <sys/time.h>
+
+#include <err.h>
+#include <libelftc.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+
+#define	DEFAULT_NSTRINGS	10000000
+#define	NAMESZ			64
+
+static size_t	nstrings = DEFAULT_NSTRINGS;
+
+static double
+now(void)
+{
+	struct timespec ts;
+
+	if (clock_gettime(CLOCK_MONOTONIC, &ts) < 0)
+		err(1, "clock_gettime");
+
+	return ((double) ts.tv_sec + (double) ts.tv_nsec / 1e9);
+}
+
+/*
+ * Build the name of string `n', resembling a mangled C++ symbol.
+ */
+static void
+name(char *buf, size_t n)
+{
+	(void) snprintf(buf, NAMESZ, "_ZN%zuelftoolchain%zu6symbolEv",
+	    n % 97, n);
+}
+
+static void
+report(const char *op, size_t n, double t)
+{
+	(void) printf("%-16s %12.1f %12.0f\n", op, t * 1e9 / (double) n,
+	    (double) n / t);
+}
+
+static void
+usage(void)
+{
+	(void) fprintf(stderr, "usage: strtab-bench [-n nstrings]\n");
+	exit(1);
+}
+
+int
+main(int argc, char **argv)
+{
+	Elftc_String_Table *st;
+	struct rusage ru;
+	char buf[NAMESZ];
+	size_t i, msz, sz, tsz;
+	double t;
+	int c;
+
+	while ((c = getopt(argc, argv, "n:")) != -1) {
+		switch (c) {
+		case 'n':
+			if ((nstrings = (size_t) strtoul(optarg, NULL, 0)) ==
+			    0)
+				usage();
+			break;
+		default:
+			usage();
+		}
+	}
+
+	if ((st = elftc_string_table_create(0)) == NULL)
+		err(1, "elftc_string_table_create");
+
+	(void) printf("%-16s %12s %12s\n", "operation", "ns/op", "ops/s");
+
+	/* The time taken to build the names, included in the rows below. */
+	t = now();
+	for (i = 0, sz = 0; i < nstrings; i++) {
+		name(buf, i);
+		sz += (unsigned char) buf[sizeof("_ZN")];
+	}
+	report("format", nstrings, now() - t);
+	if (sz == 0)
+		errx(1, "unexpected names");
+
+	t = now();
+	for (i = 0; i < nstrings; i++) {
+		name(buf, i);
+		if (elftc_string_table_insert(st, buf) == 0)
+			err(1, "elftc_string_table_insert");
+	}
+	report("insert", nstrings, now() - t);
+
+	t = now();
+	for (i = 0; i < nstrings; i++) {
+		name(buf, i);
+		if (elftc_string_table_lookup(st, buf) == 0)
+			errx(1, "\"%s\" not found", buf);
+	}
+	report("lookup", nstrings, now() - t);
+
+	t = now();
+	for (i = 0; i < nstrings; i++) {
+		name(buf, i);
+		buf[0] = '?';
+		if (elftc_string_table_lookup(st, buf) != 0)
+			errx(1, "\"%s\" found", buf);
+	}
+	report("lookup-missing", nstrings, now() - t);
+
+	t = now();
+	for (i = 0; i < nstrings; i += 4) {
+		name(buf, i);
+		if (elftc_string_table_remove(st, buf) == 0)
+			errx(1, "\"%s\" not removed", buf);
+	}
+	if (elftc_string_table_image(st, &sz) == NULL)
+		errx(1, "elftc_string_table_image");
+	report("remove+compact", nstrings / 4, now() - t);
+
+	for (i = 1; i < nstrings; i += 2) {
+		name(buf, i);
+		if (elftc_string_table_insert(st, buf + sizeof("_ZN") - 1) ==
+		    0)
+			err(1, "elftc_string_table_insert");
+	}
+	if (elftc_string_table_image(st, &tsz) == NULL)
+		errx(1, "elftc_string_table_image");
+
+	t = now();
+	if (elftc_string_table_image_merged(st, &msz) == NULL)
+		err(1, "elftc_string_table_image_merged");
+	report("merge", nstrings - nstrings / 4 + nstrings / 2, now() - t);
+
+	if (getrusage(RUSAGE_SELF, &ru) < 0)
+		err(1, "getrusage");
+	(void) printf("image size %zu bytes, with tails %zu bytes, "
+	    "merged %zu bytes\nmaxrss %ld KB\n", sz, tsz, msz, ru.ru_maxrss);
+
+	elftc_string_table_destroy(st);
+	exit(0);
+}
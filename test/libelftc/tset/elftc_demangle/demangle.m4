@@ -0,0 +1,198 @@
+/*-
+ * Copyright (c) 2026, Elftoolchain Project Contributors.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE AUTHOR AND CONTRIBUTORS ``AS IS'' AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED.  IN NO EVENT SHALL THE AUTHOR OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS
+ * OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY
+ * OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+ * SUCH DAMAGE.
+ *
+ * $Id$
+ */
+
+#include <sys/types.h>
+
+#include <errno.h>
+#include <libelftc.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "tet_api.h"
+
+include(`elfts.m4')
+
+static struct {
+	const char	*mangled;
+	const char	*demangled;
+} names[] = {
+	{ "_ZN3foo3barEv",	"foo::bar()" },
+	{ "_Z1fi",		"f(int)" },
+	{ "_ZNSt6vectorIiSaIiEE9push_backERKi",
+	  "std::vector<int, std::allocator<int> >::push_back(int const&)" },
+	{ "_ZZN1AC1EvE1x",	"A::A()::x" },
+	{ "_ZN1A1fIiEEvT_",	"void A::f<int>(int)" }
+};
+
+#define	NNAMES		((int) (sizeof(names) / sizeof(names[0])))
+#define	BUFFER_SIZE	1024
+
+/*
+ * Verify that a context may be reused across names, and that its
+ * results match those of elftc_demangle().
+ */
+
+void
+tcCtxReuse(void)
+{
+	int n, pass, result;
+	Elftc_Demangle_Ctx *ctx;
+	char buf[BUFFER_SIZE], ref[BUFFER_SIZE];
+
+	TP_ANNOUNCE("A context demangles a sequence of names.");
+
+	result = TET_UNRESOLVED;
+
+	if ((ctx = elftc_demangle_ctx_create()) == NULL) {
+		TP_UNRESOLVED("elftc_demangle_ctx_create() failed: %s",
+		    strerror(errno));
+		goto done;
+	}
+
+	for (pass = 0; pass < 2; pass++) {
+		for (n = 0; n < NNAMES; n++) {
+			if (elftc_demangle_r(ctx, names[n].mangled, buf,
+			    sizeof(buf), ELFTC_DEM_GNU3) < 0) {
+				TP_FAIL("elftc_demangle_r(\"%s\") failed: %s",
+				    names[n].mangled, strerror(errno));
+				goto done;
+			}
+			if (strcmp(buf, names[n].demangled) != 0) {
+				TP_FAIL("\"%s\" demangled to \"%s\", "
+				    "expected \"%s\".", names[n].mangled, buf,
+				    names[n].demangled);
+				goto done;
+			}
+			if (elftc_demangle(names[n].mangled, ref,
+			    sizeof(ref), 0) < 0 || strcmp(buf, ref) != 0) {
+				TP_FAIL("elftc_demangle(\"%s\") mismatch.",
+				    names[n].mangled);
+				goto done;
+			}
+		}
+	}
+
+	result = TET_PASS;
+
+done:
+	elftc_demangle_ctx_destroy(ctx);
+	tet_result(result);
+}
+
+/*
+ * Verify the handling of a buffer that is too small.
+ */
+
+void
+tcCtxShortBuffer(void)
+{
+	int result;
+	Elftc_Demangle_Ctx *ctx;
+	char buf[BUFFER_SIZE];
+
+	TP_ANNOUNCE("A short buffer is reported as ENAMETOOLONG.");
+
+	result = TET_UNRESOLVED;
+
+	if ((ctx = elftc_demangle_ctx_create()) == NULL) {
+		TP_UNRESOLVED("elftc_demangle_ctx_create() failed: %s",
+		    strerror(errno));
+		goto done;
+	}
+
+	errno = 0;
+	if (elftc_demangle_r(ctx, names[2].mangled, buf,
+	    strlen(names[2].demangled), 0) != -1 || errno != ENAMETOOLONG) {
+		TP_FAIL("Short buffer: errno=%d.", errno);
+		goto done;
+	}
+
+	errno = 0;
+	if (elftc_demangle_r(ctx, names[2].mangled, NULL, 0, 0) != -1 ||
+	    errno != ENAMETOOLONG) {
+		TP_FAIL("NULL buffer: errno=%d.", errno);
+		goto done;
+	}
+
+	/* The context remains usable after a failure. */
+	if (elftc_demangle_r(ctx, names[2].mangled, buf,
+	    strlen(names[2].demangled) + 1, 0) < 0 ||
+	    strcmp(buf, names[2].demangled) != 0) {
+		TP_FAIL("Exact-sized buffer failed.");
+		goto done;
+	}
+
+	result = TET_PASS;
+
+done:
+	elftc_demangle_ctx_destroy(ctx);
+	tet_result(result);
+}
+
+/*
+ * Verify the handling of invalid arguments.
+ */
+
+void
+tcCtxInvalidArguments(void)
+{
+	int result;
+	Elftc_Demangle_Ctx *ctx;
+	char buf[BUFFER_SIZE];
+
+	TP_ANNOUNCE("Invalid arguments are reported as EINVAL.");
+
+	result = TET_UNRESOLVED;
+
+	if ((ctx = elftc_demangle_ctx_create()) == NULL) {
+		TP_UNRESOLVED("elftc_demangle_ctx_create() failed: %s",
+		    strerror(errno));
+		goto done;
+	}
+
+	errno = 0;
+	if (elftc_demangle_r(NULL, names[0].mangled, buf, sizeof(buf),
+	    0) != -1 || errno != EINVAL) {
+		TP_FAIL("NULL context: errno=%d.", errno);
+		goto done;
+	}
+
+	errno = 0;
+	if (elftc_demangle_r(ctx, "main", buf, sizeof(buf), 0) != -1 ||
+	    errno != EINVAL) {
+		TP_FAIL("Unmangled name: errno=%d.", errno);
+		goto done;
+	}
+
+	result = TET_PASS;
+
+done:
+	elftc_demangle_ctx_destroy(ctx);
+	tet_result(result);
+}
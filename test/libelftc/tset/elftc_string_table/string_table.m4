@@ -983,3 +983,335 @@ done:
 		(void) close(fd);
 	tet_result(result);
 }
+
+/*
+ * Verify that lookups work as the table grows well past its initial
+ * size.
+ */
+
+#define	TC_MANY_STRINGS	50000
+
+#define	TC_BUILD_MANY_STRING(buf, n) do {			\
+		(void) snprintf(buf, sizeof(buf), "sym%d", n);	\
+	} while (0)
+
+void
+tcManyStrings(void)
+{
+	int n, result;
+	char buf[TC_STRING_SIZE];
+	const char *str;
+	Elftc_String_Table *table;
+	size_t expectedoffset, offset;
+
+	result = TET_UNRESOLVED;
+
+	TP_ANNOUNCE("Lookups succeed after the table grows.");
+
+	if ((table = elftc_string_table_create(0)) == NULL) {
+		TP_UNRESOLVED("elftc_string_table_create() failed: %s",
+		    strerror(errno));
+		goto done;
+	}
+
+	expectedoffset = 1;
+	for (n = 0; n < TC_MANY_STRINGS; n++) {
+		TC_BUILD_MANY_STRING(buf, n);
+		if ((offset = elftc_string_table_insert(table, buf)) !=
+		    expectedoffset) {
+			TP_FAIL("Insertion of \"%s\": expected %zu, "
+			    "actual %zu", buf, expectedoffset, offset);
+			goto done;
+		}
+		expectedoffset += strlen(buf) + 1;
+	}
+
+	expectedoffset = 1;
+	for (n = 0; n < TC_MANY_STRINGS; n++) {
+		TC_BUILD_MANY_STRING(buf, n);
+		if ((offset = elftc_string_table_lookup(table, buf)) !=
+		    expectedoffset ||
+		    (str = elftc_string_table_to_string(table, offset)) ==
+		    NULL || strcmp(str, buf) != 0) {
+			TP_FAIL("Lookup of \"%s\" failed: expected %zu, "
+			    "actual %zu", buf, expectedoffset, offset);
+			goto done;
+		}
+		expectedoffset += strlen(buf) + 1;
+	}
+
+	result = TET_PASS;
+
+done:
+	if (table)
+		(void) elftc_string_table_destroy(table);
+
+	tet_result(result);
+}
+
+/*
+ * Verify that a large table remains consistent after deleted strings
+ * are compacted out of its image.
+ */
+
+void
+tcImageManyDeleted(void)
+{
+	int n, result;
+	char buf[TC_STRING_SIZE];
+	const char *image;
+	Elftc_String_Table *table;
+	size_t expectedsize, imagesz, offset;
+
+	result = TET_UNRESOLVED;
+
+	TP_ANNOUNCE("Lookups succeed after a large table is compacted.");
+
+	if ((table = elftc_string_table_create(0)) == NULL) {
+		TP_UNRESOLVED("elftc_string_table_create() failed: %s",
+		    strerror(errno));
+		goto done;
+	}
+
+	expectedsize = 1;
+	for (n = 0; n < TC_MANY_STRINGS; n++) {
+		TC_BUILD_MANY_STRING(buf, n);
+		if (elftc_string_table_insert(table, buf) == 0) {
+			TP_UNRESOLVED("String insertion failed for \"%s\".",
+			    buf);
+			goto done;
+		}
+		if (n % 3 != 0)
+			expectedsize += strlen(buf) + 1;
+	}
+
+	for (n = 0; n < TC_MANY_STRINGS; n += 3) {
+		TC_BUILD_MANY_STRING(buf, n);
+		if (elftc_string_table_remove(table, buf) == 0) {
+			TP_UNRESOLVED("String removal failed for \"%s\".",
+			    buf);
+			goto done;
+		}
+	}
+
+	imagesz = 0;
+	if ((image = elftc_string_table_image(table, &imagesz)) == NULL ||
+	    imagesz != expectedsize) {
+		TP_FAIL("Incorrect image size %zu != %zu", imagesz,
+		    expectedsize);
+		goto done;
+	}
+
+	for (n = 0; n < TC_MANY_STRINGS; n++) {
+		TC_BUILD_MANY_STRING(buf, n);
+		offset = elftc_string_table_lookup(table, buf);
+		if (n % 3 == 0 ? offset != 0 : (offset == 0 ||
+		    offset >= imagesz || strcmp(image + offset, buf) != 0)) {
+			TP_FAIL("Lookup of \"%s\" returned %zu.", buf, offset);
+			goto done;
+		}
+	}
+
+	/* Strings inserted again go at the end of the image. */
+	TC_BUILD_MANY_STRING(buf, 0);
+	if ((offset = elftc_string_table_insert(table, buf)) != imagesz) {
+		TP_FAIL("Reinsertion of \"%s\": expected %zu, actual %zu",
+		    buf, imagesz, offset);
+		goto done;
+	}
+
+	result = TET_PASS;
+
+done:
+	if (table)
+		(void) elftc_string_table_destroy(table);
+
+	tet_result(result);
+}
+
+/*
+ * Verify that strings which are suffixes of others share their
+ * storage in a merged image.
+ */
+
+static const char *merge_strings[] = {
+	"foo",
+	"bar",
+	"barfoo",
+	".rela.text",
+	".text",
+	"ext",
+	"xyz"
+};
+
+static const int nmergestrings = sizeof(merge_strings) /
+    sizeof(merge_strings[0]);
+
+void
+tcImageMerged(void)
+{
+	int n, result;
+	const char *image, *s;
+	Elftc_String_Table *table;
+	size_t expectedsize, imagesz, offset;
+
+	result = TET_UNRESOLVED;
+
+	TP_ANNOUNCE("Suffixes share storage in a merged image.");
+
+	if ((table = elftc_string_table_create(0)) == NULL) {
+		TP_UNRESOLVED("elftc_string_table_create() failed: %s",
+		    strerror(errno));
+		goto done;
+	}
+
+	for (n = 0; n < nmergestrings; n++)
+		if (elftc_string_table_insert(table, merge_strings[n]) == 0) {
+			TP_UNRESOLVED("String insertion failed for \"%s\".",
+			    merge_strings[n]);
+			goto done;
+		}
+
+	imagesz = 0;
+	expectedsize = 1 + sizeof("bar") + sizeof("barfoo") +
+	    sizeof(".rela.text") + sizeof("xyz");
+	if ((image = elftc_string_table_image_merged(table, &imagesz)) ==
+	    NULL || imagesz != expectedsize) {
+		TP_FAIL("Incorrect image size %zu != %zu", imagesz,
+		    expectedsize);
+		goto done;
+	}
+
+	if (image[0] != '\0' || image[imagesz - 1] != '\0') {
+		TP_FAIL("Image is not NUL-delimited.");
+		goto done;
+	}
+
+	for (n = 0; n < nmergestrings; n++) {
+		offset = elftc_string_table_lookup(table, merge_strings[n]);
+		if (offset == 0 || offset >= imagesz ||
+		    strcmp(image + offset, merge_strings[n]) != 0) {
+			TP_FAIL("Lookup of \"%s\" returned %zu.",
+			    merge_strings[n], offset);
+			goto done;
+		}
+		if ((s = elftc_string_table_to_string(table, offset)) ==
+		    NULL || strcmp(s, merge_strings[n]) != 0) {
+			TP_FAIL("elftc_string_table_to_string(%zu) failed.",
+			    offset);
+			goto done;
+		}
+	}
+
+	if (elftc_string_table_lookup(table, "foo") !=
+	    elftc_string_table_lookup(table, "barfoo") + 3) {
+		TP_FAIL("\"foo\" does not share the storage of \"barfoo\".");
+		goto done;
+	}
+
+	result = TET_PASS;
+
+done:
+	if (table)
+		(void) elftc_string_table_destroy(table);
+
+	tet_result(result);
+}
+
+/*
+ * Verify that a merged table remains consistent after insertions and
+ * deletions.
+ */
+
+#define	TC_BUILD_MANY_SUFFIX(buf, n) do {			\
+		(void) snprintf(buf, sizeof(buf), "m%d", n);	\
+	} while (0)
+
+void
+tcImageMergedDeleted(void)
+{
+	int n, result;
+	char buf[TC_STRING_SIZE];
+	const char *image;
+	Elftc_String_Table *table;
+	size_t expectedsize, imagesz, offset;
+
+	result = TET_UNRESOLVED;
+
+	TP_ANNOUNCE("Lookups succeed after a merged table is compacted.");
+
+	if ((table = elftc_string_table_create(0)) == NULL) {
+		TP_UNRESOLVED("elftc_string_table_create() failed: %s",
+		    strerror(errno));
+		goto done;
+	}
+
+	/* Every "m<n>" is a suffix of the corresponding "sym<n>". */
+	expectedsize = 1;
+	for (n = 0; n < TC_MANY_STRINGS; n++) {
+		TC_BUILD_MANY_SUFFIX(buf, n);
+		if (elftc_string_table_insert(table, buf) == 0) {
+			TP_UNRESOLVED("String insertion failed for \"%s\".",
+			    buf);
+			goto done;
+		}
+		TC_BUILD_MANY_STRING(buf, n);
+		if (elftc_string_table_insert(table, buf) == 0) {
+			TP_UNRESOLVED("String insertion failed for \"%s\".",
+			    buf);
+			goto done;
+		}
+		expectedsize += strlen(buf) + 1;
+	}
+
+	imagesz = 0;
+	if ((image = elftc_string_table_image_merged(table, &imagesz)) ==
+	    NULL || imagesz != expectedsize) {
+		TP_FAIL("Incorrect image size %zu != %zu", imagesz,
+		    expectedsize);
+		goto done;
+	}
+
+	/* Remove every third "sym<n>", leaving "m<n>" on its own. */
+	for (n = 0; n < TC_MANY_STRINGS; n += 3) {
+		TC_BUILD_MANY_STRING(buf, n);
+		if (elftc_string_table_remove(table, buf) == 0) {
+			TP_UNRESOLVED("String removal failed for \"%s\".",
+			    buf);
+			goto done;
+		}
+		expectedsize -= sizeof("sy") - 1;
+	}
+
+	if ((image = elftc_string_table_image(table, &imagesz)) == NULL ||
+	    imagesz != expectedsize) {
+		TP_FAIL("Incorrect image size %zu != %zu", imagesz,
+		    expectedsize);
+		goto done;
+	}
+
+	for (n = 0; n < TC_MANY_STRINGS; n++) {
+		TC_BUILD_MANY_SUFFIX(buf, n);
+		offset = elftc_string_table_lookup(table, buf);
+		if (offset == 0 || offset >= imagesz ||
+		    strcmp(image + offset, buf) != 0) {
+			TP_FAIL("Lookup of \"%s\" returned %zu.", buf, offset);
+			goto done;
+		}
+		TC_BUILD_MANY_STRING(buf, n);
+		offset = elftc_string_table_lookup(table, buf);
+		if (n % 3 == 0 ? offset != 0 : (offset == 0 ||
+		    offset >= imagesz || strcmp(image + offset, buf) != 0)) {
+			TP_FAIL("Lookup of \"%s\" returned %zu.", buf, offset);
+			goto done;
+		}
+	}
+
+	result = TET_PASS;
+
+done:
+	if (table)
+		(void) elftc_string_table_destroy(table);
+
+	tet_result(result);
+}